@@ -73,6 +73,21 @@ void spectralObj_eef(SpectralObj spectralObj,float *mDataArr,int isNorm,float *d
 // gamma 1/10/20... song 0.5
 void spectralObj_eer(SpectralObj spectralObj,float *mDataArr,int isNorm,float gamma,float *dataArr);
 
+/***
+	spectralObj_compute param
+	threshold 0.95 rolloff; isNorm 0 entropy
+	step 1,p 2,isPostive 0,isExp 0,type 0 flux
+****/
+void spectralObj_setComputeParam(SpectralObj spectralObj,float threshold,int isNorm,
+								int step,float p,int isPostive,int isExp,int type);
+
+/***
+	featureMask SpectralFeatureType bits, every selected feature in one pass per frame
+	outMatrix featureNum*timeLength, row order follow bit order
+	return featureNum
+****/
+int spectralObj_compute(SpectralObj spectralObj,float *mDataArr,int featureMask,float *outMatrix);
+
 // statistics
 void spectralObj_max(SpectralObj spectralObj,float *mDataArr,float *valueArr,float *freArr);
 void spectralObj_mean(SpectralObj spectralObj,float *mDataArr,float *valueArr,float *freArr);
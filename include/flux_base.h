@@ -115,6 +115,26 @@ typedef enum{
 	
 } SpectralNoveltyDataType;
 
+// spectralObj_compute featureMask bit, outMatrix row order follow bit order
+typedef enum{
+	SpectralFeature_Flatness=1<<0,
+	SpectralFeature_Flux=1<<1,
+	SpectralFeature_Rolloff=1<<2,
+
+	SpectralFeature_Centroid=1<<3,
+	SpectralFeature_Spread=1<<4,
+	SpectralFeature_Skewness=1<<5,
+	SpectralFeature_Kurtosis=1<<6,
+
+	SpectralFeature_Entropy=1<<7,
+	SpectralFeature_Crest=1<<8,
+	SpectralFeature_Slope=1<<9,
+	SpectralFeature_Decrease=1<<10,
+
+	SpectralFeature_HFC=1<<11,
+	
+} SpectralFeatureType;
+
 typedef enum{
 	ChromaDataNormal_None=0,
 
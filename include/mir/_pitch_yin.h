@@ -32,6 +32,15 @@ int pitchYINObj_new(PitchYINObj *pitchYINObj,
 void pitchYINObj_setThresh(PitchYINObj pitchYINObj,float thresh);
 int pitchYINObj_calTimeLength(PitchYINObj pitchYINObj,int dataLength);
 
+/***
+	caller workspace(yin caches, frame data copy), dataLength<=maxDataLength no allocation
+	workArr NULL => back to own cache; size small => -1
+	dataLength>maxDataLength still ok, back to own cache
+	workArr keep valid until useWorkspace(NULL)/free
+****/
+size_t pitchYINObj_calWorkspaceSize(PitchYINObj pitchYINObj,int maxDataLength);
+int pitchYINObj_useWorkspace(PitchYINObj pitchYINObj,void *workArr,size_t size,int maxDataLength);
+
 void pitchYINObj_pitch(PitchYINObj pitchYINObj,float *dataArr,int dataLength,
 					float *freArr,float *valueArr1,float *valueArr2);
 
@@ -0,0 +1,53 @@
+
+
+#ifndef SPECTROGRAMGRAPH_ALGORITHM_H
+#define SPECTROGRAMGRAPH_ALGORITHM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "flux_base.h"
+#include "spectrogram_algorithm.h"
+
+typedef struct OpaqueSpectrogramGraph *SpectrogramGraphObj;
+
+/***
+	one stft+power/mag pass shared by all views
+	radix2Exp 12
+	WindowType "hann"
+	slideLength fftLength/4
+****/
+int spectrogramGraphObj_new(SpectrogramGraphObj *spectrogramGraphObj,int radix2Exp,WindowType *windowType,int *slideLength,int *isContinue);
+
+/***
+	view spectrogramObj same radix2Exp as graph, not owned by graph
+	graph window/slideLength apply to every view(deep/deepChroma correct by window, use 'hamm')
+	ccNum>0 => view cepstrum(xxcc), rectifyType CepstralRectify_Log
+	return view index, -1 fftLength differ from graph
+****/
+int spectrogramGraphObj_addView(SpectrogramGraphObj spectrogramGraphObj,SpectrogramObj spectrogramObj,int ccNum,CepstralRectifyType *rectifyType);
+int spectrogramGraphObj_getViewNum(SpectrogramGraphObj spectrogramGraphObj);
+
+int spectrogramGraphObj_calTimeLength(SpectrogramGraphObj spectrogramGraphObj,int dataLength);
+
+/***
+	mSpectArrArr[i] view i spectrogram, same size as spectrogramObj_spectrogram
+	mCepsArrArr[i] view i timeLength*ccNum; mCepsArrArr or item can NULL
+****/
+void spectrogramGraphObj_spectrogram(SpectrogramGraphObj spectrogramGraphObj,float *dataArr,int dataLength,
+									float **mSpectArrArr,float **mCepsArrArr);
+
+// shared half spectrum of last call, timeLength*(fftLength/2+1); mag NULL if no view takes |X|
+float *spectrogramGraphObj_getPowerArr(SpectrogramGraphObj spectrogramGraphObj);
+float *spectrogramGraphObj_getMagArr(SpectrogramGraphObj spectrogramGraphObj);
+
+void spectrogramGraphObj_free(SpectrogramGraphObj spectrogramGraphObj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -27,15 +27,55 @@ float *stftObj_getWindowDataArr(STFTObj stftObj);
 // center zero padding
 void stftObj_enablePadding(STFTObj stftObj,int flag);
 void stftObj_enableContinue(STFTObj stftObj,int flag);
+// half spectrum, stft/istft matrix timeLength*(fftLength/2+1)
+void stftObj_enableHalfSpectrum(STFTObj stftObj,int flag);
 
 // set/enable后执行
 int stftObj_calTimeLength(STFTObj stftObj,int dataLength);
 int stftObj_calDataLength(STFTObj stftObj,int timeLength);
 
+/***
+	caller workspace(padding/continue copy, istft norm), no malloc/free per call for dataLength<=maxDataLength
+	per thread fft work(audioflux_getThreadNum)/istft window resolved here, not on first call
+	larger call back to own cache
+	size>=stftObj_calWorkspaceSize bytes, workArr valid until free/next use; workArr NULL => own cache
+	return 0 success, -1 size small
+	spectrogram/cqt/hpss/yin/resample/multirate *_useWorkspace same contract
+****/
+size_t stftObj_calWorkspaceSize(STFTObj stftObj,int maxDataLength);
+int stftObj_useWorkspace(STFTObj stftObj,void *workArr,size_t size,int maxDataLength);
+
 void stftObj_stft(STFTObj stftObj,float *dataArr,int dataLength,float *mRealArr,float *mImageArr);
+/***
+	stft without timeLength*fftLength matrix, frames pass to func by block(<=8) from per thread scratch
+	func(arg,mRealArr,mImageArr,start,length,threadIndex) frames [start,start+length), row same as stftObj_stft
+	called concurrently, threadIndex<audioflux_getThreadNum(); mRealArr/mImageArr writable, valid only in call
+	return timeLength
+****/
+typedef void (*STFTFrameFunc)(void *arg,float *mRealArr,float *mImageArr,int start,int length,int threadIndex);
+int stftObj_stftFrame(STFTObj stftObj,float *dataArr,int dataLength,STFTFrameFunc func,void *arg);
+// stftFrame per thread block scratch up front(workspace user), else first stftFrame call
+void stftObj_prepareFrame(STFTObj stftObj);
+
 // type 0(deault) 'weight overlap-add' 1 'overlap-add'
 void stftObj_istft(STFTObj stftObj,float *mRealArr,float *mImageArr,int nLength,int type,float *dataArr);
 
+/***
+	stream stft, push any size block then pull finished frames
+	frame start every slideLength of pushed data, no padding; ring buffer grow only when needed
+****/
+void stftObj_resetStream(STFTObj stftObj);
+void stftObj_pushData(STFTObj stftObj,float *dataArr,int dataLength);
+// frame number ready to pull
+int stftObj_getStreamTimeLength(STFTObj stftObj);
+// return frame number written, <=maxTimeLength
+int stftObj_pullSTFT(STFTObj stftObj,int maxTimeLength,float *mRealArr,float *mImageArr);
+
+// stream istft overlap-add; dataArr timeLength*slideLength, return sample number
+int stftObj_pushISTFT(STFTObj stftObj,float *mRealArr,float *mImageArr,int timeLength,int type,float *dataArr);
+// last fftLength-slideLength samples
+int stftObj_flushISTFT(STFTObj stftObj,float *dataArr);
+
 void stftObj_free(STFTObj stftObj);
 void stftObj_debug(STFTObj stftObj);
 
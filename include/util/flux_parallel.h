@@ -0,0 +1,24 @@
+
+#ifndef FLUX_PARALLEL_H
+#define FLUX_PARALLEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/***
+	library thread number, shared by stft/spectrogram/cqt/cwt/nsgt
+	threadNum<1 => default omp max threads/2; 1 serial
+	without HAVE_OMP always serial
+****/
+void audioflux_setThreadNum(int threadNum);
+int audioflux_getThreadNum();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
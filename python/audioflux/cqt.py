@@ -42,6 +42,7 @@ class CQTBase(Base):
         self.is_continue = is_continue
         self.normal_type = normal_type
         self.is_scale = is_scale
+        self.is_half_band = False
 
     def cal_time_length(self, data_length):
         """
@@ -104,6 +105,21 @@ class CQTBase(Base):
         fn(self._obj, c_int(int(flag)))
         self.is_scale = bool(flag)
 
+    def enable_half_band(self, flag=True):
+        """
+        Octave 2:1 decimation by half-band polyphase filter
+
+        Faster than the default resample, output differs by at most 2e-2 of max magnitude.
+
+        Parameters
+        ----------
+        flag: bool
+        """
+        fn = self._lib['cqtObj_enableHalfBand']
+        fn.argtypes = [POINTER(OpaqueCQT), c_int]
+        fn(self._obj, c_int(int(flag)))
+        self.is_half_band = bool(flag)
+
     def cqt(self, data_arr):
         """
         Get spectrogram data
@@ -35,6 +35,8 @@ class ResampleBase(Base):
         self.source_rate = None
         self.target_rate = None
 
+        self._stream_channel_shape = None
+
     def set_samplate(self, source_rate, target_rate):
         """
         Set samplate
@@ -49,11 +51,31 @@ class ResampleBase(Base):
         fn(self._obj, c_int(source_rate), c_int(target_rate))
         self.source_rate = source_rate
         self.target_rate = target_rate
+        self._stream_channel_shape = None
+
+    def enable_continue(self, flag):
+        """
+        Enable continue(streaming) mode
+
+        Each `resample` call outputs only the part whose filter window is complete,
+        call `flush` at stream end to get the rest.
+
+        Parameters
+        ----------
+        flag: bool
+        """
+        fn = self._lib['resampleObj_enableContinue']
+        fn.argtypes = [POINTER(OpaqueResample), c_int]
+        fn(self._obj, c_int(int(flag)))
+        self.is_continue = bool(flag)
+        self._stream_channel_shape = None
 
     def cal_data_length(self, data_length):
         """
         Compute the data length
 
+        In continue mode, output length of the next `resample` call; the tail comes from `flush`.
+
         Parameters
         ----------
         data_length: int
@@ -65,7 +87,7 @@ class ResampleBase(Base):
         fn = self._lib['resampleObj_calDataLength']
         fn.argtypes = [POINTER(OpaqueResample), c_int]
         fn.restype = c_int
-        fn(self._obj, c_int(data_length))
+        return fn(self._obj, c_int(data_length))
 
     def resample(self, data_arr):
         """
@@ -84,26 +106,71 @@ class ResampleBase(Base):
         data_arr = np.asarray(data_arr, dtype=np.float32, order='C')
         check_audio(data_arr, is_mono=False)
 
-        fn = self._lib['resampleObj_resample']
-        fn.argtypes = [POINTER(OpaqueResample),
-                       np.ctypeslib.ndpointer(dtype=np.float32, ndim=1, flags='C_CONTIGUOUS'),
-                       c_int,
-                       np.ctypeslib.ndpointer(dtype=np.float32, ndim=1, flags='C_CONTIGUOUS')]
         data_len = data_arr.shape[-1]
+        arr_len = max(self.cal_data_length(data_len), 1)
 
         if data_arr.ndim == 1:
-            ret_arr = np.zeros(data_len * 5, dtype=np.float32)
+            fn = self._lib['resampleObj_resample']
+            fn.argtypes = [POINTER(OpaqueResample),
+                           np.ctypeslib.ndpointer(dtype=np.float32, ndim=1, flags='C_CONTIGUOUS'),
+                           c_int,
+                           np.ctypeslib.ndpointer(dtype=np.float32, ndim=1, flags='C_CONTIGUOUS')]
+            fn.restype = c_int
+
+            ret_arr = np.zeros(arr_len, dtype=np.float32)
             new_arr_len = fn(self._obj, data_arr, c_int(data_len), ret_arr)
+            self._stream_channel_shape = ()
         else:
+            # channels interleave into one call, continue mode keep one stream for all channels
+            fn = self._lib['resampleObj_resampleInterleave']
+            fn.argtypes = [POINTER(OpaqueResample),
+                           np.ctypeslib.ndpointer(dtype=np.float32, ndim=1, flags='C_CONTIGUOUS'),
+                           c_int,
+                           c_int,
+                           np.ctypeslib.ndpointer(dtype=np.float32, ndim=1, flags='C_CONTIGUOUS')]
+            fn.restype = c_int
+
             data_arr, o_channel_shape = format_channel(data_arr, 1)
             channel_num = data_arr.shape[0]
 
-            ret_arr = np.zeros((channel_num, data_len * 5), dtype=np.float32)
-            new_arr_len = 0
-            for i in range(channel_num):
-                _new_arr_len = fn(self._obj, data_arr[i], c_int(data_len), ret_arr[i])
-                new_arr_len = max(new_arr_len, _new_arr_len)
+            ret_arr = np.zeros(arr_len * channel_num, dtype=np.float32)
+            new_arr_len = fn(self._obj, np.ascontiguousarray(data_arr.T).ravel(),
+                             c_int(data_len), c_int(channel_num), ret_arr)
+            ret_arr = np.ascontiguousarray(ret_arr.reshape(arr_len, channel_num).T)
             ret_arr = revoke_channel(ret_arr, o_channel_shape, 1)
+            self._stream_channel_shape = o_channel_shape
+
+        return ret_arr[..., :new_arr_len]
+
+    def flush(self):
+        """
+        Continue mode stream end, output the rest samples and reset stream
+
+        Returns
+        -------
+        out: np.ndarray [shape=(..., n)]
+            Same channel shape as the last `resample` input
+        """
+        len_fn = self._lib['resampleObj_calFlushLength']
+        len_fn.argtypes = [POINTER(OpaqueResample)]
+        len_fn.restype = c_int
+
+        fn = self._lib['resampleObj_flush']
+        fn.argtypes = [POINTER(OpaqueResample),
+                       np.ctypeslib.ndpointer(dtype=np.float32, ndim=1, flags='C_CONTIGUOUS')]
+        fn.restype = c_int
+
+        channel_shape = self._stream_channel_shape or ()
+        channel_num = int(np.prod(channel_shape)) if len(channel_shape) else 1
+
+        arr_len = max(len_fn(self._obj), 1)
+        ret_arr = np.zeros(arr_len * channel_num, dtype=np.float32)
+        new_arr_len = fn(self._obj, ret_arr)
+        self._stream_channel_shape = None
+
+        if len(channel_shape):
+            ret_arr = np.ascontiguousarray(ret_arr.reshape(arr_len, channel_num).T)
+            ret_arr = revoke_channel(ret_arr, channel_shape, 1)
 
         return ret_arr[..., :new_arr_len]
 
@@ -0,0 +1,30 @@
+import numpy as np
+import audioflux as af
+
+# cqtObj_enableHalfBand bound, max|diff| relative to max|cqt|
+HALF_BAND_TOLERANCE = 2e-2
+
+
+def _signal(samplate, data_length):
+    t = np.arange(data_length) / samplate
+    duration = t[-1]
+    chirp = np.sin(2 * np.pi * (50 * t + (8000 - 50) * t * t / (2 * duration)))
+    tone = np.sin(2 * np.pi * 440 * t)
+    noise = np.random.default_rng(0).uniform(-0.5, 0.5, data_length)
+    return [(0.3 * chirp + 0.5 * tone).astype(np.float32),
+            (0.5 * tone).astype(np.float32),
+            (0.3 * noise).astype(np.float32)]
+
+
+def test_cqt_half_band_tolerance():
+    samplate = 32000
+    for data_arr in _signal(samplate, samplate * 3):
+        ref_obj = af.CQT(num=84, samplate=samplate)
+        ref_arr = ref_obj.cqt(data_arr)
+
+        half_obj = af.CQT(num=84, samplate=samplate)
+        half_obj.enable_half_band(True)
+        half_arr = half_obj.cqt(data_arr)
+
+        err = np.abs(half_arr - ref_arr).max() / np.abs(ref_arr).max()
+        assert err <= HALF_BAND_TOLERANCE, err
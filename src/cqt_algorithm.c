@@ -7,13 +7,16 @@
 #include "vector/flux_complex.h"
 
 #include "util/flux_util.h"
+#include "util/flux_parallel.h"
 
 #include "dsp/fft_algorithm.h"
 #include "dsp/dct_algorithm.h"
 #include "dsp/resample_algorithm.h"
+#include "dsp/multirate_algorithm.h"
 
 #include "filterbank/cqt_filterBank.h"
 #include "filterbank/chroma_filterBank.h"
+#include "filterbank/filterBank_cache.h"
 
 #include "stft_algorithm.h"
 #include "cqt_algorithm.h"
@@ -23,7 +26,9 @@ struct OpaqueCQT{
 	int vFlag; // vqt标志
 
 	STFTObj stftObj;
-	ResampleObj resampleObj;
+	ResampleObj resampleObj; // 2:1 octave down, default
+	MultirateObj multirateObj; // half-band 2:1, isHalfBand 1
+	int isHalfBand;
 
 	int fftLength; // fftLength,timeLength,num
 	int timeLength; // cqt timeLength isContinue 0 ==stft timeLength
@@ -34,15 +39,21 @@ struct OpaqueCQT{
 	int octaveNum;
 	int binPerOctave;
 
-	float *mRealFilterBankArr; // num*(fftLength/2+1) -> binPerOctave*(fftLength/2+1)
+	float *mRealFilterBankArr; // banded weights of num(vqt)/binPerOctave*(fftLength/2+1) kernel
 	float *mImageFilterBankArr;
 
+	int *bandStartArr; // kernel row nonzero bins, num(vqt)/binPerOctave
+	int *bandLengthArr;
+	int *bandOffsetArr; // into mRealFilterBankArr/mImageFilterBankArr
+
 	float *freBandArr; // num
 	float *lenArr; // binPerOctave
 
 	float *sLenArr; // 针对 num sqrt
 	float *dLenArr; // 针对 octaveNum sqrt
 
+	FilterBankCacheObj filterBankCacheObj; // own filterBank/freBand/len/sLen/dLen
+
 	int samplate;
 	WindowType windowType;
 	SpectralFilterBankNormalType normType;
@@ -67,12 +78,34 @@ struct OpaqueCQT{
 	float *mRealArr2; // timeLength*binPerOctave
 	float *mImageArr2;
 
+	// caller workspace capacity, 0 => own cache
+	int workTimeLength; // stftTimeLength of mRealArr1/mRealArr2
+	int workDataLength; // validDataArr/preDataArr/curDataArr
+	float *preDataArr; // octave down data, workspace only
+	float *curDataArr;
+
+	// octave parallel, own cache; enableParallel before useWorkspace => caches/octave stft in workspace
+	int isParallel;
+	int isOctWork;
+	STFTObj *stftObjArr; // octaveNum, octave i slideLength>>(octaveNum-1-i)
+
+	float *octDataArr; // decimated octave octaveNum-2~0
+	int octDataLength;
+	int *octOffsetArr; // octaveNum
+	int *octLengthArr;
+
+	float *octRealArr1; // octaveNum*(stftTimeLength+1)*fftLength
+	float *octImageArr1;
+	float *octRealArr2; // octaveNum*(stftTimeLength+1)*binPerOctave
+	float *octImageArr2;
+	int octTimeLength;
+
 	int radix2Exp; // stft
 	int slideLength;
 
 	// dct相关
-	FFTObj fftObj; // dct加速
-	DCTObj dctObj; // 直接矩阵
+	float *mDCTArr; // 截断dct基 ccNum*num
+	int ccNum;
 
 	// deconv相关
 	FFTObj devFFTObj;
@@ -92,20 +125,37 @@ struct OpaqueCQT{
 static void _cqtObj_dealFilterBank(CQTObj cqtObj,int num,float minFre,int samplate,
 								int binPerOctave,SpectralFilterBankNormalType normType,WindowType winType,
 								float factor,float beta,float thresh,int vFlag);
+// cached entry item number/length match what cqt index, 0 => discard
+static int __cqtObj_checkFilterBank(FilterBankCacheObj cacheObj,int num,int binPerOctave,int vFlag);
 static void _cqtObj_dealStft(CQTObj cqtObj,int fftLength,int slideLength,int isContinue);
+static void _cqtObj_dealStftArr(CQTObj cqtObj);
 static void _cqtObj_dealResample(CQTObj cqtObj);
+static int _cqtObj_decimate(CQTObj cqtObj,float *dataArr1,int dataLength1,float *dataArr2);
 
 static void _cqtObj_dealDeconv(CQTObj cqtObj);
 
-static void _cqtObj_dealDCT(CQTObj cqtObj,int num);
-
 // 处理tail/cur Data
 static int _cqtObj_dealData(CQTObj cqtObj,float *dataArr,int dataLength);
+static size_t _cqtObj_carveCache(CQTObj cqtObj,int maxDataLength,void *workArr);
+static void _cqtObj_freeCache(CQTObj cqtObj);
 static void _cqtObj_cqt(CQTObj cqtObj,float *dataArr,int dataLength,float *mRealArr,float *mImageArr);
+static void _cqtObj_cqtParallel(CQTObj cqtObj,float *dataArr,int dataLength,int timeLength,int stftTimeLength,
+								float *mRealArr,float *mImageArr);
+static void _cqtObj_freeParallel(CQTObj cqtObj);
 
 static void __calTimeAndTailLen(int dataLength,int fftLength,int slideLength,int isContinue,int *timeLength,int *tailLength);
 
-static int _calRadix2(int length);
+// S.dot(sparse filterBank rows row~row+num-1) frame chunks on library threads, each frame all bands
+static void __cqtObj_filterDot(CQTObj cqtObj,float *mRealArr1,float *mImageArr1,
+							int timeLength,int mLength,int row,int num,
+							float *mRealArr3,float *mImageArr3);
+
+// octave i stft+S.dot+norm => mRealArr3/mImageArr3 columns i*binPerOctave~(i+1)*binPerOctave-1
+static void __cqtObj_octave(CQTObj cqtObj,STFTObj stftObj,int octave,
+							float *dataArr,int dataLength,int timeLength,
+							float *mRealArr1,float *mImageArr1,
+							float *mRealArr2,float *mImageArr2,
+							float *mRealArr3,float *mImageArr3);
 
 int cqtObj_new(CQTObj *cqtObj,int num,int samplate,float minFre,int *isContinue){
 	int status=0;
@@ -233,7 +283,6 @@ int cqtObj_newWith(CQTObj *cqtObj,int num,
 
 	_cqtObj_dealStft(cqt,cqt->fftLength,_slideLength,_isContinue);
 	_cqtObj_dealResample(cqt);
-	_cqtObj_dealDCT(cqt,num);
 
 	cqt->tailDataArr=tailDataArr;
 
@@ -246,23 +295,6 @@ int cqtObj_newWith(CQTObj *cqtObj,int num,
 	return status;
 }
 
-static void _cqtObj_dealDCT(CQTObj cqtObj,int num){
-	FFTObj fftObj=NULL;
-	DCTObj dctObj=NULL;
-	int r=0;
-
-	r=_calRadix2(num);
-	if(r){ // dct加速
-		fftObj_new(&fftObj, r);
-	}
-	else{ // 直接dct
-		dctObj_new(&dctObj, num,NULL);
-	}
-
-	cqtObj->fftObj=fftObj;
-	cqtObj->dctObj=dctObj;
-}
-
 int cqtObj_calTimeLength(CQTObj cqtObj,int dataLength){
 	int fftLength=0; 
 	int slideLength=0;
@@ -364,6 +396,11 @@ static int _cqtObj_dealData(CQTObj cqtObj,float *dataArr,int dataLength){
 
 	int totalLength=0;
 
+	if(cqtObj->workDataLength&&
+		dataLength+2*cqtObj->fftLength>cqtObj->workDataLength){ // over workspace, back to own cache
+		_cqtObj_freeCache(cqtObj);
+	}
+
 	isContinue=cqtObj->isContinue;
 
 	fftLength=cqtObj->fftLength;
@@ -395,8 +432,9 @@ static int _cqtObj_dealData(CQTObj cqtObj,float *dataArr,int dataLength){
 	}
 
 	if(status){
-		if(totalLength>validDataLength||
-			validDataLength>2*totalLength){
+		if(!cqtObj->workDataLength&&
+			(totalLength>validDataLength||
+			validDataLength>2*totalLength)){
 
 			free(validDataArr);
 			validDataArr=(float *)calloc(totalLength+fftLength, sizeof(float ));
@@ -460,6 +498,23 @@ void cqtObj_setScale(CQTObj cqtObj,int flag){
 	cqtObj->isScale=flag;
 }
 
+void cqtObj_enableParallel(CQTObj cqtObj,int flag){
+
+	if(flag&&!cqtObj->stftObjArr){
+		_cqtObj_dealStftArr(cqtObj);
+	}
+	else if(!flag){
+		_cqtObj_freeParallel(cqtObj);
+	}
+
+	cqtObj->isParallel=flag;
+}
+
+void cqtObj_enableHalfBand(CQTObj cqtObj,int flag){
+
+	cqtObj->isHalfBand=flag;
+}
+
 void cqtObj_cqt(CQTObj cqtObj,float *dataArr,int dataLength,float *mRealArr3,float *mImageArr3){
 	int status=0;
 
@@ -597,27 +652,15 @@ void cqtObj_chroma(CQTObj cqtObj,int *chromaNum,SpectralDataType *dataType,Chrom
 }
 
 void cqtObj_cqcc(CQTObj cqtObj,float *mDataArr1,int mLength,CepstralRectifyType *rectifyType,float *mDataArr2){
-	FFTObj fftObj=NULL;
-	DCTObj dctObj=NULL;
-
 	CepstralRectifyType recType=CepstralRectify_Log;
 
 	int num=0;
 	int timeLength=0;
 
-	float *mRealArr=NULL; 
-	float *mImageArr=NULL;
-
 	num=cqtObj->num;
 	timeLength=cqtObj->timeLength;
 
-	mRealArr=cqtObj->mRealArr1;
-	mImageArr=cqtObj->mImageArr1;
-
-	fftObj=cqtObj->fftObj;
-	dctObj=cqtObj->dctObj;
-
-	if(mLength>num){
+	if(mLength>num||mLength<1){
 		return;
 	}
 
@@ -625,38 +668,16 @@ void cqtObj_cqcc(CQTObj cqtObj,float *mDataArr1,int mLength,CepstralRectifyType
 		recType=*rectifyType;
 	}
 
-	if(recType==CepstralRectify_CubicRoot){
-		for(int i=0;i<timeLength*num;i++){
-			mRealArr[i]=powf(mDataArr1[i], 1.0/3);
-		}
-	}
-	else { // log
-		for(int i=0;i<timeLength*num;i++){
-			float _value=0;
-
-			_value=mDataArr1[i];
-			if(_value<1e-8){
-				_value=1e-8;
-			}
-
-			mRealArr[i]=log10f(_value); // matlab canonic
-		}
-	}
-
-	for(int i=0;i<timeLength;i++){
-		if(fftObj){
-			fftObj_dct(fftObj, mRealArr+i*num, mImageArr+i*num, 1);
-		}
-		else{
-			dctObj_dct(dctObj, mRealArr+i*num,1,mImageArr+i*num);
-		}
+	// 截断dct基 只算ccNum行
+	if(!cqtObj->mDCTArr||cqtObj->ccNum!=mLength){
+		free(cqtObj->mDCTArr);
+		cqtObj->mDCTArr=dct_createMatrix(num,mLength);
+		cqtObj->ccNum=mLength;
 	}
 
-	for(int i=0;i<timeLength;i++){
-		for(int j=0;j<mLength;j++){
-			mDataArr2[i*mLength+j]=mImageArr[i*num+j];
-		}
-	}
+	dct_cepstrum(mDataArr1,timeLength,num,
+				cqtObj->mDCTArr,mLength,recType,
+				cqtObj->mRealArr1,mDataArr2);
 }
 
 void cqtObj_cqhc(CQTObj cqtObj,float *mDataArr1,int hcNum,float *mDataArr2){
@@ -844,7 +865,6 @@ static void _cqtObj_dealDeconv(CQTObj cqtObj){
 
 static void _cqtObj_cqt(CQTObj cqtObj,float *dataArr,int dataLength,float *mRealArr3,float *mImageArr3){
 	STFTObj stftObj=NULL;
-	ResampleObj resampleObj=NULL;
 
 	int fftLength=0; // fftLength,timeLength,num
 	int timeLength=0;
@@ -856,15 +876,9 @@ static void _cqtObj_cqt(CQTObj cqtObj,float *dataArr,int dataLength,float *mReal
 	int binPerOctave=0;
 	int octaveNum=0;
 
-	float *mRealFilterBankArr=NULL; // num*(fftLength/2+1)
-	float *mImageFilterBankArr=NULL;
-
 	float *freBandArr=NULL; // num
 	float *lenArr=NULL;
 
-	float *sLenArr=NULL;
-	float *dLenArr=NULL;
-	
 	float *mRealArr1=NULL;
 	float *mImageArr1=NULL;
 
@@ -879,16 +893,11 @@ static void _cqtObj_cqt(CQTObj cqtObj,float *dataArr,int dataLength,float *mReal
 	int preDataLength=0;
 	int curDataLength=0;
 
-	int index1=0;
-	int vFlag=0;
-
 	int isContinue=0;
 
-	vFlag=cqtObj->vFlag;
 	isContinue=cqtObj->isContinue;
 
 	stftObj=cqtObj->stftObj;
-	resampleObj=cqtObj->resampleObj;
 
 	fftLength=cqtObj->fftLength;
 	
@@ -896,15 +905,9 @@ static void _cqtObj_cqt(CQTObj cqtObj,float *dataArr,int dataLength,float *mReal
 	binPerOctave=cqtObj->binPerOctave;
 	octaveNum=cqtObj->octaveNum;
 
-	mRealFilterBankArr=cqtObj->mRealFilterBankArr; // num*(fftLength/2+1)
-	mImageFilterBankArr=cqtObj->mImageFilterBankArr;
-
 	freBandArr=cqtObj->freBandArr;
 	lenArr=cqtObj->lenArr;
 
-	sLenArr=cqtObj->sLenArr;
-	dLenArr=cqtObj->dLenArr;
-
 	mRealArr1=cqtObj->mRealArr1; // timeLength*fftLength
 	mImageArr1=cqtObj->mImageArr1;
 
@@ -913,10 +916,6 @@ static void _cqtObj_cqt(CQTObj cqtObj,float *dataArr,int dataLength,float *mReal
 
 	normType=cqtObj->normType;
 
-	preDataArr=__vnew(dataLength, NULL);
-	curDataArr=__vnew(dataLength, NULL);
-	preDataLength=dataLength;
-
 	slideLength=cqtObj->slideLength;
 
 	stftTimeLength=dataLength/slideLength+1;
@@ -927,8 +926,26 @@ static void _cqtObj_cqt(CQTObj cqtObj,float *dataArr,int dataLength,float *mReal
 		timeLength=(dataLength-fftLength)/slideLength+1;
 	}
 
-	if(cqtObj->stftTimeLength<stftTimeLength||
-		cqtObj->stftTimeLength>stftTimeLength*2){ // 更新缓存
+	if(cqtObj->isParallel&&octaveNum>1){
+		_cqtObj_cqtParallel(cqtObj,dataArr,dataLength,timeLength,stftTimeLength,mRealArr3,mImageArr3);
+
+		cqtObj->timeLength=timeLength;
+		return;
+	}
+
+	if(cqtObj->workDataLength){
+		preDataArr=cqtObj->preDataArr;
+		curDataArr=cqtObj->curDataArr;
+	}
+	else{
+		preDataArr=__vnew(dataLength, NULL);
+		curDataArr=__vnew(dataLength, NULL);
+	}
+	preDataLength=dataLength;
+
+	if(!cqtObj->workTimeLength&&
+		(cqtObj->stftTimeLength<stftTimeLength||
+		cqtObj->stftTimeLength>stftTimeLength*2)){ // 更新缓存
 		free(mRealArr1);
 		free(mImageArr1);
 
@@ -949,145 +966,222 @@ static void _cqtObj_cqt(CQTObj cqtObj,float *dataArr,int dataLength,float *mReal
 
 	// 1. top octave
 	stftObj_setSlideLength(stftObj, slideLength);
-	stftObj_stft(stftObj,dataArr,dataLength,mRealArr1,mImageArr1);
+	__cqtObj_octave(cqtObj,stftObj,octaveNum-1,
+				dataArr,dataLength,timeLength,
+				mRealArr1,mImageArr1,
+				mRealArr2,mImageArr2,
+				mRealArr3,mImageArr3);
 
-	// t*fftLength => t*(fftLength/2+1)
-	for(int i=1;i<timeLength;i++){
-		for(int j=0;j<(fftLength/2+1);j++){
-			mRealArr1[i*(fftLength/2+1)+j]=mRealArr1[i*fftLength+j];
-			mImageArr1[i*(fftLength/2+1)+j]=mImageArr1[i*fftLength+j];
+	// 2. down
+	memcpy(preDataArr, dataArr, sizeof(float )*dataLength);
+	for(int i=octaveNum-2;i>=0;i--){
+		// 2:1 decimate
+		curDataLength=_cqtObj_decimate(cqtObj, preDataArr, preDataLength, curDataArr);
+		slideLength/=2;
+
+		stftObj_setSlideLength(stftObj, slideLength);
+		__cqtObj_octave(cqtObj,stftObj,i,
+					curDataArr,curDataLength,timeLength,
+					mRealArr1,mImageArr1,
+					mRealArr2,mImageArr2,
+					mRealArr3,mImageArr3);
+
+		// deal data, decimate overwrite => swap
+		{
+			float *_arr=NULL;
+
+			_arr=preDataArr;
+			preDataArr=curDataArr;
+			curDataArr=_arr;
 		}
+		preDataLength=curDataLength;
 	}
 
-	// S.dot(filterBank) t*(fftLength/2+1) @ num*(fftLength/2+1)
-	if(vFlag){ // vqt num
-		index1=(octaveNum-1)*binPerOctave*(fftLength/2+1);
+	if(!cqtObj->workDataLength){
+		free(preDataArr);
+		free(curDataArr);
 	}
-	__mcdot1(mRealArr1, mImageArr1, 
-			mRealFilterBankArr+index1, mImageFilterBankArr+index1,
-		 	timeLength, fftLength/2+1,
-		 	binPerOctave, fftLength/2+1, 
-		 	mRealArr2, mImageArr2);
 
-	for(int i=0;i<timeLength;i++){
-		for(int j=(octaveNum-1)*binPerOctave,k=0;j<octaveNum*binPerOctave;j++,k++){
-			float _value1=0;
-			float _value2=0;
+	cqtObj->timeLength=timeLength;
+	cqtObj->stftTimeLength=stftTimeLength;
 
-			_value1=mRealArr2[i*binPerOctave+k];
-			_value2=mImageArr2[i*binPerOctave+k];
+	cqtObj->mRealArr1=mRealArr1;
+	cqtObj->mImageArr1=mImageArr1;
 
-			// norm => similar fft 'orthi' sqrt(len)
-			if(cqtObj->isScale){
-				_value1/=sLenArr[j];
-				_value2/=sLenArr[j];
-			}
+	cqtObj->mRealArr2=mRealArr2;
+	cqtObj->mImageArr2=mImageArr2;
+}
 
-			mRealArr3[i*octaveNum*binPerOctave+j]=_value1;
-			mImageArr3[i*octaveNum*binPerOctave+j]=_value2;
+// _cqtObj_cqtParallel __parallel_for arg
+typedef struct{
+	CQTObj cqtObj;
+	float *dataArr; // top octave
+
+	int dataLength;
+	int timeLength;
+
+	int stftLength; // (stftTimeLength+1)*fftLength per octave
+	int bandLength; // (stftTimeLength+1)*binPerOctave
+
+	float *mRealArr3;
+	float *mImageArr3;
+
+} CQTOctaveChunkArg;
+
+static void __cqtObj_octaveChunk(void *arg,int start,int end,int threadIndex){
+	CQTOctaveChunkArg *chunkArg=NULL;
+	CQTObj cqtObj=NULL;
+
+	float *dataArr=NULL;
+	int dataLength=0;
+
+	chunkArg=(CQTOctaveChunkArg *)arg;
+	cqtObj=chunkArg->cqtObj;
+
+	for(int i=start;i<end;i++){
+		if(i==cqtObj->octaveNum-1){
+			dataArr=chunkArg->dataArr;
+			dataLength=chunkArg->dataLength;
 		}
+		else{
+			dataArr=cqtObj->octDataArr+cqtObj->octOffsetArr[i];
+			dataLength=cqtObj->octLengthArr[i];
+		}
+
+		// nested __parallel_for(filterDot/stft) serial in this thread
+		__cqtObj_octave(cqtObj,cqtObj->stftObjArr[i],i,
+					dataArr,dataLength,chunkArg->timeLength,
+					cqtObj->octRealArr1+i*chunkArg->stftLength,cqtObj->octImageArr1+i*chunkArg->stftLength,
+					cqtObj->octRealArr2+i*chunkArg->bandLength,cqtObj->octImageArr2+i*chunkArg->bandLength,
+					chunkArg->mRealArr3,chunkArg->mImageArr3);
 	}
+}
 
-	// 2. down
-	memcpy(preDataArr, dataArr, sizeof(float )*dataLength);
-	for(int i=octaveNum-2;i>=0;i--){
-		// resample
-		curDataLength=resampleObj_resample(resampleObj, preDataArr, preDataLength, curDataArr);
-		slideLength/=2;
+/***
+	1. decimate whole cascade(serial, cheap) => octDataArr
+	2. octave stft+S.dot on library threads, each octave own stftObj/buffer
+	result same as serial octave loop
+****/
+static void _cqtObj_cqtParallel(CQTObj cqtObj,float *dataArr,int dataLength,int timeLength,int stftTimeLength,
+								float *mRealArr3,float *mImageArr3){
+	CQTOctaveChunkArg chunkArg;
 
-		// stft t*fftLength
-		stftObj_setSlideLength(stftObj, slideLength);
-		stftObj_stft(stftObj,curDataArr,curDataLength,mRealArr1,mImageArr1);
+	int fftLength=0;
+	int binPerOctave=0;
+	int octaveNum=0;
 
-		// t*fftLength => t*(fftLength/2+1)
-		for(int j=1;j<timeLength;j++){
-			for(int k=0;k<(fftLength/2+1);k++){
-				mRealArr1[j*(fftLength/2+1)+k]=mRealArr1[j*fftLength+k];
-				mImageArr1[j*(fftLength/2+1)+k]=mImageArr1[j*fftLength+k];
-			}
-		}
+	float *preDataArr=NULL;
+	int preDataLength=0;
+	int offset=0;
 
-		// S.dot(filterBank) t*(fftLength/2+1) @ num*(fftLength/2+1)
-		if(vFlag){ // vqt num
-			index1=i*binPerOctave*(fftLength/2+1);
-		}
-		__mcdot1(mRealArr1, mImageArr1, 
-				mRealFilterBankArr+index1, mImageFilterBankArr+index1,
-			 	timeLength, fftLength/2+1,
-			 	binPerOctave, fftLength/2+1, 
-			 	mRealArr2, mImageArr2);
-
-		for(int n=0;n<timeLength;n++){
-			for(int j=i*binPerOctave,k=0;j<(i+1)*binPerOctave;j++,k++){
-				float _value1=0;
-				float _value2=0;
-
-				_value1=mRealArr2[n*binPerOctave+k];
-				_value2=mImageArr2[n*binPerOctave+k];
-
-				// norm => downsample 默认非scale sqrt(2^i)
-				_value1*=dLenArr[octaveNum-i-1];
-				_value2*=dLenArr[octaveNum-i-1];
-
-				// norm => similar fft 'orthi' sqrt(len)
-				if(cqtObj->isScale){
-					_value1/=sLenArr[j];
-					_value2/=sLenArr[j];
-				}
+	fftLength=cqtObj->fftLength;
+	binPerOctave=cqtObj->binPerOctave;
+	octaveNum=cqtObj->octaveNum;
 
-				mRealArr3[n*octaveNum*binPerOctave+j]=_value1;
-				mImageArr3[n*octaveNum*binPerOctave+j]=_value2;
-			}
-		}
+	if(!cqtObj->isOctWork&&
+		cqtObj->octTimeLength<stftTimeLength){ // 更新缓存, grow-only
+		free(cqtObj->octRealArr1);
+		free(cqtObj->octImageArr1);
 
-		// deal data
-		memset(preDataArr, 0, sizeof(float )*preDataLength);
-		memcpy(preDataArr, curDataArr, sizeof(float )*curDataLength);
-		memset(curDataArr, 0, sizeof(float )*curDataLength);
-		preDataLength=curDataLength;
+		free(cqtObj->octRealArr2);
+		free(cqtObj->octImageArr2);
+
+		cqtObj->octRealArr1=__vnew(octaveNum*(stftTimeLength+1)*fftLength, NULL);
+		cqtObj->octImageArr1=__vnew(octaveNum*(stftTimeLength+1)*fftLength, NULL);
+
+		cqtObj->octRealArr2=__vnew(octaveNum*(stftTimeLength+1)*binPerOctave, NULL);
+		cqtObj->octImageArr2=__vnew(octaveNum*(stftTimeLength+1)*binPerOctave, NULL);
+
+		cqtObj->octTimeLength=stftTimeLength;
 	}
 
-	free(preDataArr);
-	free(curDataArr);
+	// octave length sum<dataLength
+	if(!cqtObj->isOctWork&&
+		cqtObj->octDataLength<dataLength){
+		free(cqtObj->octDataArr);
 
-	cqtObj->timeLength=timeLength;
-	cqtObj->stftTimeLength=stftTimeLength;
+		cqtObj->octDataArr=__vnew(dataLength, NULL);
+		cqtObj->octDataLength=dataLength;
+	}
 
-	cqtObj->mRealArr1=mRealArr1;
-	cqtObj->mImageArr1=mImageArr1;
+	// 1. decimate
+	preDataArr=dataArr;
+	preDataLength=dataLength;
+	for(int i=octaveNum-2;i>=0;i--){
+		cqtObj->octOffsetArr[i]=offset;
+		cqtObj->octLengthArr[i]=_cqtObj_decimate(cqtObj, preDataArr, preDataLength, cqtObj->octDataArr+offset);
 
-	cqtObj->mRealArr2=mRealArr2;
-	cqtObj->mImageArr2=mImageArr2;
+		preDataArr=cqtObj->octDataArr+offset;
+		preDataLength=cqtObj->octLengthArr[i];
+		offset+=preDataLength;
+	}
+
+	// 2. octave
+	chunkArg.cqtObj=cqtObj;
+	chunkArg.dataArr=dataArr;
+
+	chunkArg.dataLength=dataLength;
+	chunkArg.timeLength=timeLength;
+
+	chunkArg.stftLength=(cqtObj->octTimeLength+1)*fftLength;
+	chunkArg.bandLength=(cqtObj->octTimeLength+1)*binPerOctave;
+
+	chunkArg.mRealArr3=mRealArr3;
+	chunkArg.mImageArr3=mImageArr3;
+
+	__parallel_for(octaveNum,1,0,__cqtObj_octaveChunk,&chunkArg);
 }
 
-void cqtObj_free(CQTObj cqtObj){
-	STFTObj stftObj=NULL; // octaveNum
-	ResampleObj resampleObj=NULL;
+static void _cqtObj_freeParallel(CQTObj cqtObj){
 
-	float *mRealFilterBankArr=NULL; // num*(fftLength/2+1)
-	float *mImageFilterBankArr=NULL;
+	if(cqtObj->stftObjArr){
+		for(int i=0;i<cqtObj->octaveNum;i++){
+			stftObj_free(cqtObj->stftObjArr[i]);
+		}
+	}
 
-	float *freBandArr=NULL; // num
-	float *lenArr=NULL; // binPerOctave
+	free(cqtObj->stftObjArr);
 
-	float *sLenArr=NULL;
-	float *dLenArr=NULL;
+	free(cqtObj->octOffsetArr);
+	free(cqtObj->octLengthArr);
 
-	float *mRealArr1=NULL; // stft r,i(timeLength*fftLength) -> power r(timeLength*(fftLength/2+1)) 
-	float *mImageArr1=NULL;
+	if(!cqtObj->isOctWork){
+		free(cqtObj->octDataArr);
 
-	float *mRealArr2=NULL; 
-	float *mImageArr2=NULL;
+		free(cqtObj->octRealArr1);
+		free(cqtObj->octImageArr1);
+
+		free(cqtObj->octRealArr2);
+		free(cqtObj->octImageArr2);
+	}
+
+	cqtObj->stftObjArr=NULL;
+
+	cqtObj->octDataArr=NULL;
+	cqtObj->octDataLength=0;
+	cqtObj->octOffsetArr=NULL;
+	cqtObj->octLengthArr=NULL;
+
+	cqtObj->octRealArr1=NULL;
+	cqtObj->octImageArr1=NULL;
+
+	cqtObj->octRealArr2=NULL;
+	cqtObj->octImageArr2=NULL;
+
+	cqtObj->octTimeLength=0;
+	cqtObj->isOctWork=0;
+}
+
+void cqtObj_free(CQTObj cqtObj){
+	STFTObj stftObj=NULL; // octaveNum
+	ResampleObj resampleObj=NULL;
+	MultirateObj multirateObj=NULL;
 
 	float *tailDataArr=NULL;
-	float *validDataArr=NULL;
 
 	float *mChromaFilterBank=NULL;
 	float *mSArr=NULL;
 
-	FFTObj fftObj=NULL; // dct加速
-	DCTObj dctObj=NULL;
-
 	FFTObj devFFTObj=NULL;
 
 	float *devDataArr=NULL; // spectral mag&fft mag
@@ -1104,30 +1198,13 @@ void cqtObj_free(CQTObj cqtObj){
 
 	stftObj=cqtObj->stftObj;
 	resampleObj=cqtObj->resampleObj;
-
-	mRealFilterBankArr=cqtObj->mRealFilterBankArr;
-	mImageFilterBankArr=cqtObj->mImageFilterBankArr;
-
-	freBandArr=cqtObj->freBandArr;
-	lenArr=cqtObj->lenArr;
-
-	sLenArr=cqtObj->sLenArr;
-	dLenArr=cqtObj->dLenArr;
-
-	mRealArr1=cqtObj->mRealArr1;
-	mImageArr1=cqtObj->mImageArr1;
-
-	mRealArr2=cqtObj->mRealArr2;
-	mImageArr2=cqtObj->mImageArr2;
+	multirateObj=cqtObj->multirateObj;
 
 	tailDataArr=cqtObj->tailDataArr;
-	validDataArr=cqtObj->validDataArr;
 
 	mChromaFilterBank=cqtObj->mChromaFilterBank;
 	mSArr=cqtObj->mSArr;
 
-	fftObj=cqtObj->fftObj;
-	dctObj=cqtObj->dctObj;
 
 	devFFTObj=cqtObj->devFFTObj;
 	devDataArr=cqtObj->devDataArr;
@@ -1138,32 +1215,21 @@ void cqtObj_free(CQTObj cqtObj){
 	devRealArr2=cqtObj->devRealArr2;
 	devImageArr2=cqtObj->devImageArr2;
 
+	_cqtObj_freeCache(cqtObj);
+	_cqtObj_freeParallel(cqtObj);
+
 	stftObj_free(stftObj);
 	resampleObj_free(resampleObj);
+	multirateObj_free(multirateObj);
 
-	free(mRealFilterBankArr);
-	free(mImageFilterBankArr);
-
-	free(freBandArr);
-	free(lenArr);
-
-	free(sLenArr);
-	free(dLenArr);
-
-	free(mRealArr1);
-	free(mImageArr1);
-
-	free(mRealArr2);
-	free(mImageArr2);
+	filterBankCacheObj_release(cqtObj->filterBankCacheObj);
 
 	free(tailDataArr);
-	free(validDataArr);
 
 	free(mChromaFilterBank);
 	free(mSArr);
 
-	fftObj_free(fftObj);
-	dctObj_free(dctObj);
+	free(cqtObj->mDCTArr);
 
 	fftObj_free(devFFTObj);
 	free(devDataArr);
@@ -1177,71 +1243,544 @@ void cqtObj_free(CQTObj cqtObj){
 	free(cqtObj);
 }
 
+/***
+	workspace order: validDataArr,preDataArr,curDataArr(maxDataLength+2*fftLength)
+	mRealArr1,mImageArr1((stftTimeLength+1)*fftLength), mRealArr2,mImageArr2((stftTimeLength+1)*binPerOctave)
+	decimate scratch, resample/multirate share(one per call)
+	parallel: octDataArr, octRealArr1~octImageArr2(octaveNum*), octave stft(length halve per octave)
+	workArr NULL => only bytes
+****/
+static size_t _cqtObj_carveCache(CQTObj cqtObj,int maxDataLength,void *workArr){
+	size_t offset=0;
+
+	int fftLength=0;
+	int binPerOctave=0;
+	int octaveNum=0;
+
+	int dataLength=0;
+	int stftTimeLength=0;
+
+	float *arrArr[7]={0};
+
+	float *decArr=NULL;
+	size_t decSize=0;
+
+	fftLength=cqtObj->fftLength;
+	binPerOctave=cqtObj->binPerOctave;
+	octaveNum=cqtObj->octaveNum;
+
+	dataLength=maxDataLength+2*fftLength; // tail<fftLength+fftLength
+	stftTimeLength=(maxDataLength+fftLength)/cqtObj->slideLength+1;
+
+	for(int i=0;i<3;i++){
+		arrArr[i]=__vcarve(workArr,&offset,dataLength);
+	}
+
+	arrArr[3]=__vcarve(workArr,&offset,(stftTimeLength+1)*fftLength);
+	arrArr[4]=__vcarve(workArr,&offset,(stftTimeLength+1)*fftLength);
+
+	arrArr[5]=__vcarve(workArr,&offset,(stftTimeLength+1)*binPerOctave);
+	arrArr[6]=__vcarve(workArr,&offset,(stftTimeLength+1)*binPerOctave);
+
+	decSize=resampleObj_calWorkspaceSize(cqtObj->resampleObj,dataLength);
+	if(decSize<multirateObj_calWorkspaceSize(cqtObj->multirateObj,dataLength)){
+		decSize=multirateObj_calWorkspaceSize(cqtObj->multirateObj,dataLength);
+	}
+
+	decArr=__vcarve(workArr,&offset,(decSize+3)/4);
+
+	if(workArr){
+		cqtObj->validDataArr=arrArr[0];
+		cqtObj->preDataArr=arrArr[1];
+		cqtObj->curDataArr=arrArr[2];
+
+		cqtObj->mRealArr1=arrArr[3];
+		cqtObj->mImageArr1=arrArr[4];
+
+		cqtObj->mRealArr2=arrArr[5];
+		cqtObj->mImageArr2=arrArr[6];
+
+		cqtObj->workDataLength=dataLength;
+		cqtObj->workTimeLength=stftTimeLength;
+
+		resampleObj_useWorkspace(cqtObj->resampleObj,decArr,decSize,dataLength);
+		multirateObj_useWorkspace(cqtObj->multirateObj,decArr,decSize,dataLength);
+	}
+
+	if(cqtObj->stftObjArr){
+		float *octArrArr[5]={0};
+		int length=0;
+
+		octArrArr[0]=__vcarve(workArr,&offset,dataLength);
+
+		octArrArr[1]=__vcarve(workArr,&offset,octaveNum*(stftTimeLength+1)*fftLength);
+		octArrArr[2]=__vcarve(workArr,&offset,octaveNum*(stftTimeLength+1)*fftLength);
+
+		octArrArr[3]=__vcarve(workArr,&offset,octaveNum*(stftTimeLength+1)*binPerOctave);
+		octArrArr[4]=__vcarve(workArr,&offset,octaveNum*(stftTimeLength+1)*binPerOctave);
+
+		if(workArr){
+			free(cqtObj->octDataArr);
+
+			free(cqtObj->octRealArr1);
+			free(cqtObj->octImageArr1);
+
+			free(cqtObj->octRealArr2);
+			free(cqtObj->octImageArr2);
+
+			cqtObj->octDataArr=octArrArr[0];
+			cqtObj->octDataLength=dataLength;
+
+			cqtObj->octRealArr1=octArrArr[1];
+			cqtObj->octImageArr1=octArrArr[2];
+
+			cqtObj->octRealArr2=octArrArr[3];
+			cqtObj->octImageArr2=octArrArr[4];
+
+			cqtObj->octTimeLength=stftTimeLength;
+			cqtObj->isOctWork=1;
+		}
+
+		// top octave same as serial stft, 2:1 decimate <=length/2+1
+		length=maxDataLength+fftLength;
+		for(int i=octaveNum-1;i>=0;i--){
+			float *arr=NULL;
+			size_t size=0;
+
+			size=stftObj_calWorkspaceSize(cqtObj->stftObjArr[i],length);
+			arr=__vcarve(workArr,&offset,(size+3)/4);
+			if(workArr){
+				stftObj_useWorkspace(cqtObj->stftObjArr[i],arr,size,length);
+			}
+
+			length=length/2+1;
+		}
+	}
+
+	return offset;
+}
+
+// own caches freed, workspace caches only detached
+static void _cqtObj_freeCache(CQTObj cqtObj){
+
+	if(!cqtObj->workDataLength){
+		free(cqtObj->validDataArr);
+
+		free(cqtObj->mRealArr1);
+		free(cqtObj->mImageArr1);
+
+		free(cqtObj->mRealArr2);
+		free(cqtObj->mImageArr2);
+	}
+
+	cqtObj->validDataArr=NULL;
+	cqtObj->validDataLength=0;
+
+	cqtObj->preDataArr=NULL;
+	cqtObj->curDataArr=NULL;
+
+	cqtObj->mRealArr1=NULL;
+	cqtObj->mImageArr1=NULL;
+
+	cqtObj->mRealArr2=NULL;
+	cqtObj->mImageArr2=NULL;
+
+	cqtObj->stftTimeLength=0;
+
+	if(cqtObj->workDataLength){
+		resampleObj_useWorkspace(cqtObj->resampleObj,NULL,0,0);
+		multirateObj_useWorkspace(cqtObj->multirateObj,NULL,0,0);
+	}
+
+	if(cqtObj->isOctWork){
+		for(int i=0;i<cqtObj->octaveNum;i++){
+			stftObj_useWorkspace(cqtObj->stftObjArr[i],NULL,0,0);
+		}
+
+		cqtObj->octDataArr=NULL;
+		cqtObj->octDataLength=0;
+
+		cqtObj->octRealArr1=NULL;
+		cqtObj->octImageArr1=NULL;
+
+		cqtObj->octRealArr2=NULL;
+		cqtObj->octImageArr2=NULL;
+
+		cqtObj->octTimeLength=0;
+		cqtObj->isOctWork=0;
+	}
+
+	cqtObj->workDataLength=0;
+	cqtObj->workTimeLength=0;
+}
+
+size_t cqtObj_calWorkspaceSize(CQTObj cqtObj,int maxDataLength){
+	size_t size=0;
+
+	if(maxDataLength<=0){
+		return 0;
+	}
+
+	size=_cqtObj_carveCache(cqtObj,maxDataLength,NULL)+64;
+	size+=stftObj_calWorkspaceSize(cqtObj->stftObj,maxDataLength+cqtObj->fftLength);
+
+	return size;
+}
+
+int cqtObj_useWorkspace(CQTObj cqtObj,void *workArr,size_t size,int maxDataLength){
+	size_t offset=0;
+
+	_cqtObj_freeCache(cqtObj);
+	if(!workArr){
+		stftObj_useWorkspace(cqtObj->stftObj,NULL,0,0);
+		return 0;
+	}
+
+	if(maxDataLength<=0||
+		size<cqtObj_calWorkspaceSize(cqtObj,maxDataLength)){
+		return -1;
+	}
+
+	offset=_cqtObj_carveCache(cqtObj,maxDataLength,workArr);
+	memset(workArr, 0, offset);
+
+	return stftObj_useWorkspace(cqtObj->stftObj,(char *)workArr+offset,size-offset,maxDataLength+cqtObj->fftLength);
+}
+
 // filterBank相关数据
+// __cqtObj_filterDot __parallel_for arg
+typedef struct{
+	float *mRealArr1;
+	float *mImageArr1;
+
+	float *mRealArr3;
+	float *mImageArr3;
+
+	int *startArr; // band row
+	int *lengthArr;
+	int *offsetArr;
+
+	float *realArr;
+	float *imageArr;
+
+	int mLength;
+	int num;
+
+} CQTDotChunkArg;
+
+static void __cqtObj_filterDotChunk(void *arg,int start,int end,int threadIndex){
+	CQTDotChunkArg *chunkArg=NULL;
+
+	int mLength=0;
+	int num=0;
+
+	chunkArg=(CQTDotChunkArg *)arg;
+
+	mLength=chunkArg->mLength;
+	num=chunkArg->num;
+
+	cqt_sparseDot(chunkArg->mRealArr1+start*mLength, chunkArg->mImageArr1+start*mLength,
+				end-start, mLength,
+				num,chunkArg->startArr,chunkArg->lengthArr,chunkArg->offsetArr,
+				chunkArg->realArr,chunkArg->imageArr,
+				chunkArg->mRealArr3+start*num, chunkArg->mImageArr3+start*num);
+}
+
+static void __cqtObj_filterDot(CQTObj cqtObj,float *mRealArr1,float *mImageArr1,
+							int timeLength,int mLength,int row,int num,
+							float *mRealArr3,float *mImageArr3){
+	CQTDotChunkArg chunkArg;
+
+	chunkArg.mRealArr1=mRealArr1;
+	chunkArg.mImageArr1=mImageArr1;
+
+	chunkArg.mRealArr3=mRealArr3;
+	chunkArg.mImageArr3=mImageArr3;
+
+	chunkArg.startArr=cqtObj->bandStartArr+row;
+	chunkArg.lengthArr=cqtObj->bandLengthArr+row;
+	chunkArg.offsetArr=cqtObj->bandOffsetArr+row;
+
+	chunkArg.realArr=cqtObj->mRealFilterBankArr;
+	chunkArg.imageArr=cqtObj->mImageFilterBankArr;
+
+	chunkArg.mLength=mLength;
+	chunkArg.num=num;
+
+	__parallel_for(timeLength,0,0,__cqtObj_filterDotChunk,&chunkArg);
+}
+
+static void __cqtObj_octave(CQTObj cqtObj,STFTObj stftObj,int octave,
+							float *dataArr,int dataLength,int timeLength,
+							float *mRealArr1,float *mImageArr1,
+							float *mRealArr2,float *mImageArr2,
+							float *mRealArr3,float *mImageArr3){
+	int fftLength=0;
+	int binPerOctave=0;
+	int octaveNum=0;
+
+	float *sLenArr=NULL;
+	float dLen=0;
+
+	int index1=0;
+
+	fftLength=cqtObj->fftLength;
+	binPerOctave=cqtObj->binPerOctave;
+	octaveNum=cqtObj->octaveNum;
+
+	sLenArr=cqtObj->sLenArr;
+	dLen=cqtObj->dLenArr[octaveNum-octave-1];
+
+	// stft t*fftLength
+	stftObj_stft(stftObj,dataArr,dataLength,mRealArr1,mImageArr1);
+
+	// t*fftLength => t*(fftLength/2+1)
+	for(int i=1;i<timeLength;i++){
+		for(int j=0;j<(fftLength/2+1);j++){
+			mRealArr1[i*(fftLength/2+1)+j]=mRealArr1[i*fftLength+j];
+			mImageArr1[i*(fftLength/2+1)+j]=mImageArr1[i*fftLength+j];
+		}
+	}
+
+	// S.dot(filterBank) t*(fftLength/2+1) @ num*(fftLength/2+1)
+	if(cqtObj->vFlag){ // vqt num
+		index1=octave*binPerOctave;
+	}
+	__cqtObj_filterDot(cqtObj,mRealArr1, mImageArr1, 
+		 	timeLength, fftLength/2+1,
+		 	index1, binPerOctave,
+		 	mRealArr2, mImageArr2);
+
+	for(int i=0;i<timeLength;i++){
+		for(int j=octave*binPerOctave,k=0;j<(octave+1)*binPerOctave;j++,k++){
+			float _value1=0;
+			float _value2=0;
+
+			_value1=mRealArr2[i*binPerOctave+k];
+			_value2=mImageArr2[i*binPerOctave+k];
+
+			// norm => downsample 默认非scale sqrt(2^i), top octave 1
+			_value1*=dLen;
+			_value2*=dLen;
+
+			// norm => similar fft 'orthi' sqrt(len)
+			if(cqtObj->isScale){
+				_value1/=sLenArr[j];
+				_value2/=sLenArr[j];
+			}
+
+			mRealArr3[i*octaveNum*binPerOctave+j]=_value1;
+			mImageArr3[i*octaveNum*binPerOctave+j]=_value2;
+		}
+	}
+}
+
+/***
+	arr realArr,imageArr(weightLength),freBandArr(num+2),lenArr(binPerOctave),sLenArr(num),dLenArr(octaveNum)
+	iArr fftLength(1),startArr,bLengthArr,offsetArr(rowNum); band in fftLength/2+1 and weightLength
+****/
+static int __cqtObj_checkFilterBank(FilterBankCacheObj cacheObj,int num,int binPerOctave,int vFlag){
+	int *fftLengthArr=NULL;
+	int *startArr=NULL;
+	int *bLengthArr=NULL;
+	int *offsetArr=NULL;
+
+	int fftLength=0;
+	int weightLength=0;
+	int rowNum=0;
+
+	rowNum=(vFlag?num:binPerOctave);
+
+	fftLengthArr=filterBankCacheObj_getIntArr(cacheObj,0);
+	startArr=filterBankCacheObj_getIntArr(cacheObj,1);
+	bLengthArr=filterBankCacheObj_getIntArr(cacheObj,2);
+	offsetArr=filterBankCacheObj_getIntArr(cacheObj,3);
+
+	weightLength=filterBankCacheObj_getArrLength(cacheObj,0);
+
+	if(!fftLengthArr||!startArr||!bLengthArr||!offsetArr||
+		filterBankCacheObj_getIntArrLength(cacheObj,0)!=1||
+		filterBankCacheObj_getIntArrLength(cacheObj,1)!=rowNum||
+		filterBankCacheObj_getIntArrLength(cacheObj,2)!=rowNum||
+		filterBankCacheObj_getIntArrLength(cacheObj,3)!=rowNum||
+		!filterBankCacheObj_getArr(cacheObj,0)||
+		!filterBankCacheObj_getArr(cacheObj,1)||
+		filterBankCacheObj_getArrLength(cacheObj,1)!=weightLength||
+		filterBankCacheObj_getArrLength(cacheObj,2)!=num+2||
+		filterBankCacheObj_getArrLength(cacheObj,3)!=binPerOctave||
+		filterBankCacheObj_getArrLength(cacheObj,4)!=num||
+		filterBankCacheObj_getArrLength(cacheObj,5)!=num/binPerOctave){
+
+		return 0;
+	}
+
+	fftLength=fftLengthArr[0];
+	if(fftLength<2||(fftLength&(fftLength-1))){
+		return 0;
+	}
+
+	for(int i=0;i<rowNum;i++){
+		if(startArr[i]<0||bLengthArr[i]<0||offsetArr[i]<0||
+			startArr[i]+bLengthArr[i]>fftLength/2+1||
+			offsetArr[i]+bLengthArr[i]>weightLength){
+
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
 static void _cqtObj_dealFilterBank(CQTObj cqtObj,int num,float minFre,int samplate,
 								int binPerOctave,SpectralFilterBankNormalType normType,WindowType winType,
 								float factor,float beta,float thresh,int vFlag){
+	FilterBankCacheObj cacheObj=NULL;
+	double paramArr[11]={0};
+
 	int fftLength=0; 
-	
-	float *freBandArr=NULL;
-	float *lenArr=NULL;
+	int octaveNum=0;
 
-	float *sLenArr=NULL;
-	float *dLenArr=NULL;
+	octaveNum=num/binPerOctave;
 
-	float *mRealFilterBankArr=NULL; // num*(fftLength/2+1)
-	float *mImageFilterBankArr=NULL;
+	paramArr[0]=num;
+	paramArr[1]=minFre;
+	paramArr[2]=samplate;
+	paramArr[3]=binPerOctave;
+	paramArr[4]=normType;
+	paramArr[5]=winType;
+	paramArr[6]=factor;
+	paramArr[7]=beta;
+	paramArr[8]=thresh;
+	paramArr[9]=vFlag;
+	paramArr[10]=1; // kernel layout banded, old dense entry(10 param) not match
+
+	cacheObj=filterBankCache_find(FilterBankCache_CQT,paramArr,11);
+	if(cacheObj&&!__cqtObj_checkFilterBank(cacheObj,num,binPerOctave,vFlag)){
+		filterBankCacheObj_discard(cacheObj);
+		cacheObj=NULL;
+	}
 
-	int octaveNum=0;
-	int index=0;
+	if(!cacheObj){
+		float *freBandArr=NULL;
+		float *lenArr=NULL;
 
-	octaveNum=num/binPerOctave;
-	index=(octaveNum-1)*binPerOctave;
+		float *sLenArr=NULL;
+		float *dLenArr=NULL;
 
-	lenArr=__vnew(binPerOctave, NULL);
-	sLenArr=__vnew(num, NULL);
-	dLenArr=__vnew(octaveNum, NULL);
+		float *mRealFilterBankArr=NULL; // num*(fftLength/2+1)
+		float *mImageFilterBankArr=NULL;
 
-	freBandArr=cqt_calFreArr(minFre,num,binPerOctave);
-	fftLength=cqt_calFFTLength(freBandArr[index],samplate,binPerOctave,&factor,&beta);
+		float *realArr=NULL; // banded
+		float *imageArr=NULL;
 
-	// vFlag 1 => vqt 设num 
-	mRealFilterBankArr=__vnew((vFlag?num:binPerOctave)*(fftLength/2+1), NULL);
-	mImageFilterBankArr=__vnew((vFlag?num:binPerOctave)*(fftLength/2+1), NULL);
-	
-	cqt_calLengthArr(binPerOctave,freBandArr+index,samplate,
-					binPerOctave,
-					&factor,&beta,
-					lenArr);
+		int *fftLengthArr=NULL;
+		int *startArr=NULL;
+		int *bLengthArr=NULL;
+		int *offsetArr=NULL;
 
-	cqt_calLengthArr(num,freBandArr,samplate,
-					binPerOctave,
-					&factor,&beta,
-					sLenArr);
+		int rowNum=0;
+		int weightLength=0;
+		int index=0;
 
-	for(int i=0;i<num;i++){
-		sLenArr[i]=sqrtf(sLenArr[i]);
-	}
+		float *arrArr[6]={0};
+		int lengthArr[6]={0};
 
-	dLenArr[0]=1;
-	for(int i=1;i<octaveNum;i++){
-		dLenArr[i]=sqrtf(1<<i);
-	}
+		int *iArrArr[4]={0};
+		int iLengthArr[4]={0};
+
+		index=(octaveNum-1)*binPerOctave;
 
-	// ??? cqt_filterBank替换
-	// cqt_downFilterBank(num,freBandArr,samplate,
-	// 				binPerOctave,normType,&winType,
-	// 				&factor,&beta,&thresh,
-	// 				lenArr,fftLength,
-	// 				mRealFilterBankArr,mImageFilterBankArr);
+		lenArr=__vnew(binPerOctave, NULL);
+		sLenArr=__vnew(num, NULL);
+		dLenArr=__vnew(octaveNum, NULL);
 
-	// vFlag 1 => vqt 设num 不能共用top octave freKernal
-	index=(vFlag?0:index);
-	cqt_downFilterBank(vFlag?num:binPerOctave,freBandArr+index,samplate,
-					binPerOctave,normType,&winType,
-					&factor,&beta,&thresh,
-					lenArr,fftLength,
-					mRealFilterBankArr,mImageFilterBankArr);
+		freBandArr=cqt_calFreArr(minFre,num,binPerOctave);
+		fftLength=cqt_calFFTLength(freBandArr[index],samplate,binPerOctave,&factor,&beta);
+
+		// vFlag 1 => vqt 设num 
+		mRealFilterBankArr=__vnew((vFlag?num:binPerOctave)*(fftLength/2+1), NULL);
+		mImageFilterBankArr=__vnew((vFlag?num:binPerOctave)*(fftLength/2+1), NULL);
+		
+		cqt_calLengthArr(binPerOctave,freBandArr+index,samplate,
+						binPerOctave,
+						&factor,&beta,
+						lenArr);
+
+		cqt_calLengthArr(num,freBandArr,samplate,
+						binPerOctave,
+						&factor,&beta,
+						sLenArr);
+
+		for(int i=0;i<num;i++){
+			sLenArr[i]=sqrtf(sLenArr[i]);
+		}
+
+		dLenArr[0]=1;
+		for(int i=1;i<octaveNum;i++){
+			dLenArr[i]=sqrtf(1<<i);
+		}
+
+		// ??? cqt_filterBank替换
+		// cqt_downFilterBank(num,freBandArr,samplate,
+		// 				binPerOctave,normType,&winType,
+		// 				&factor,&beta,&thresh,
+		// 				lenArr,fftLength,
+		// 				mRealFilterBankArr,mImageFilterBankArr);
+
+		// vFlag 1 => vqt 设num 不能共用top octave freKernal
+		index=(vFlag?0:index);
+		cqt_downFilterBank(vFlag?num:binPerOctave,freBandArr+index,samplate,
+						binPerOctave,normType,&winType,
+						&factor,&beta,&thresh,
+						lenArr,fftLength,
+						mRealFilterBankArr,mImageFilterBankArr);
+
+		// 4. banded sparse kernel, dense kernel not keep
+		rowNum=(vFlag?num:binPerOctave);
+		startArr=__vnewi(rowNum, NULL);
+		bLengthArr=__vnewi(rowNum, NULL);
+		offsetArr=__vnewi(rowNum, NULL);
+
+		weightLength=cqt_sparseFilterBank(mRealFilterBankArr,mImageFilterBankArr,rowNum,fftLength/2+1,
+										startArr,bLengthArr,offsetArr,
+										&realArr,&imageArr);
+
+		free(mRealFilterBankArr);
+		free(mImageFilterBankArr);
+
+		fftLengthArr=__vnewi(1, NULL);
+		fftLengthArr[0]=fftLength;
+
+		arrArr[0]=realArr;
+		arrArr[1]=imageArr;
+		arrArr[2]=freBandArr;
+		arrArr[3]=lenArr;
+		arrArr[4]=sLenArr;
+		arrArr[5]=dLenArr;
+
+		lengthArr[0]=(weightLength>0?weightLength:1);
+		lengthArr[1]=lengthArr[0];
+		lengthArr[2]=num+2;
+		lengthArr[3]=binPerOctave;
+		lengthArr[4]=num;
+		lengthArr[5]=octaveNum;
+
+		iArrArr[0]=fftLengthArr;
+		iArrArr[1]=startArr;
+		iArrArr[2]=bLengthArr;
+		iArrArr[3]=offsetArr;
+
+		iLengthArr[0]=1;
+		iLengthArr[1]=rowNum;
+		iLengthArr[2]=rowNum;
+		iLengthArr[3]=rowNum;
+
+		cacheObj=filterBankCache_insert(FilterBankCache_CQT,paramArr,11,
+										arrArr,lengthArr,6,
+										iArrArr,iLengthArr,4);
+	}
+
+	fftLength=filterBankCacheObj_getIntArr(cacheObj,0)[0];
 
 	cqtObj->fftLength=fftLength;
 
@@ -1249,14 +1788,20 @@ static void _cqtObj_dealFilterBank(CQTObj cqtObj,int num,float minFre,int sampla
 	cqtObj->octaveNum=octaveNum;
 	cqtObj->binPerOctave=binPerOctave;
 
-	cqtObj->mRealFilterBankArr=mRealFilterBankArr;
-	cqtObj->mImageFilterBankArr=mImageFilterBankArr;
+	cqtObj->filterBankCacheObj=cacheObj;
+
+	cqtObj->mRealFilterBankArr=filterBankCacheObj_getArr(cacheObj,0);
+	cqtObj->mImageFilterBankArr=filterBankCacheObj_getArr(cacheObj,1);
+
+	cqtObj->bandStartArr=filterBankCacheObj_getIntArr(cacheObj,1);
+	cqtObj->bandLengthArr=filterBankCacheObj_getIntArr(cacheObj,2);
+	cqtObj->bandOffsetArr=filterBankCacheObj_getIntArr(cacheObj,3);
 
-	cqtObj->freBandArr=freBandArr;
-	cqtObj->lenArr=lenArr;
+	cqtObj->freBandArr=filterBankCacheObj_getArr(cacheObj,2);
+	cqtObj->lenArr=filterBankCacheObj_getArr(cacheObj,3);
 
-	cqtObj->sLenArr=sLenArr;
-	cqtObj->dLenArr=dLenArr;
+	cqtObj->sLenArr=filterBankCacheObj_getArr(cacheObj,4);
+	cqtObj->dLenArr=filterBankCacheObj_getArr(cacheObj,5);
 
 	cqtObj->samplate=samplate;
 
@@ -1266,40 +1811,60 @@ static void _cqtObj_dealFilterBank(CQTObj cqtObj,int num,float minFre,int sampla
 
 static void _cqtObj_dealResample(CQTObj cqtObj){
 	ResampleObj resampleObj=NULL;
+	MultirateObj multirateObj=NULL;
 
 	ResampleQualityType type=ResampleQuality_Fast;
+	int factor=2;
 	int isScale=1;
 
 	resampleObj_new(&resampleObj,&type,&isScale,NULL);
 	resampleObj_setSamplate(resampleObj,2,1); // 降采样
 
+	multirateObj_new(&multirateObj,&factor,NULL,NULL,&isScale);
+
 	cqtObj->resampleObj=resampleObj;
+	cqtObj->multirateObj=multirateObj;
 }
 
-// stft数据相关 winType rect
-static void _cqtObj_dealStftArr(CQTObj cqtObj,int fftLength,int slideLength){
+// 2:1, dataArr2 overwrite; return dataLength1/2
+static int _cqtObj_decimate(CQTObj cqtObj,float *dataArr1,int dataLength1,float *dataArr2){
+
+	if(cqtObj->isHalfBand){
+		return multirateObj_decimate(cqtObj->multirateObj, dataArr1, dataLength1, dataArr2);
+	}
+
+	return resampleObj_resample(cqtObj->resampleObj, dataArr1, dataLength1, dataArr2);
+}
+
+// octave parallel stft, same padding as _cqtObj_dealStft
+static void _cqtObj_dealStftArr(CQTObj cqtObj){
 	STFTObj *stftObjArr=NULL;
 
+	PaddingPositionType pType=PaddingPosition_Right;
 	int octaveNum=0;
-	int radix2Exp=0;
+	int slideLength=0;
 
 	octaveNum=cqtObj->octaveNum;
-	radix2Exp=util_powerTwoBit(fftLength);
-
-	cqtObj->radix2Exp=radix2Exp;
-	cqtObj->slideLength=slideLength;
+	slideLength=cqtObj->slideLength;
 	
 	stftObjArr=(STFTObj *)calloc(octaveNum, sizeof(STFTObj ));
-	stftObj_new(stftObjArr,radix2Exp,NULL,&slideLength,NULL);
+	for(int i=octaveNum-1;i>=0;i--){
+		stftObj_new(stftObjArr+i,cqtObj->radix2Exp,NULL,&slideLength,NULL);
+		stftObj_enablePadding(stftObjArr[i],1);
 
-	for(int i=1;i<octaveNum;i++){
-		slideLength/=2;
-		stftObj_new(stftObjArr+i,radix2Exp,NULL,&slideLength,NULL);
-	}	
+		if(cqtObj->isContinue){
+			stftObj_setPadding(stftObjArr[i], &pType, NULL, NULL, NULL);
+		}
 
-	// cqtObj->stftObjArr=stftObjArr;
-}
+		if(slideLength>1){ // serial setSlideLength skip 0
+			slideLength/=2;
+		}
+	}
 
+	cqtObj->stftObjArr=stftObjArr;
+	cqtObj->octOffsetArr=__vnewi(octaveNum, NULL);
+	cqtObj->octLengthArr=__vnewi(octaveNum, NULL);
+}
 static void _cqtObj_dealStft(CQTObj cqtObj,int fftLength,int slideLength,int isContinue){
 	STFTObj stftObj=NULL;
 
@@ -1321,27 +1886,5 @@ static void _cqtObj_dealStft(CQTObj cqtObj,int fftLength,int slideLength,int isC
 	cqtObj->stftObj=stftObj;
 }
 
-static int _calRadix2(int length){
-	int r=0;
-	int m=0;
-
-	while(1){
-		m=length%2;
-		if(!m){ //
-			r++;
-			length=length/2;
-			if(length==1){
-				break;
-			}
-		}
-		else{
-			r=0;
-			break;
-		}
-	}
-
-	return r;
-}
-
 
 
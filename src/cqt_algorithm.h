@@ -41,6 +41,27 @@ float *cqtObj_getFreBandArr(CQTObj cqtObj);
 
 void cqtObj_setScale(CQTObj cqtObj,int flag);
 
+/***
+	octave parallel, default 0
+	decimate all octaves first, then each octave stft+S.dot on library threads
+	own cache(not workspace) about octaveNum*stft buffer+dataLength
+****/
+void cqtObj_enableParallel(CQTObj cqtObj,int flag);
+
+/***
+	octave 2:1 decimate, default 0 => resample Fast(rollOff 0.85)
+	1 => half-band polyphase(multirate), about 20x faster decimate
+		cutoff exact half band, output differ from 0 by max|diff|<=2e-2*max|cqt|(measured 0.7%~1%, tone/chirp/noise)
+****/
+void cqtObj_enableHalfBand(CQTObj cqtObj,int flag);
+
+/***
+	caller workspace for data/stft/octave/decimate caches, contract see stftObj_useWorkspace
+	enableParallel before, else octave parallel caches stay own
+****/
+size_t cqtObj_calWorkspaceSize(CQTObj cqtObj,int maxDataLength);
+int cqtObj_useWorkspace(CQTObj cqtObj,void *workArr,size_t size,int maxDataLength);
+
 void cqtObj_cqt(CQTObj cqtObj,float *dataArr,int dataLength,float *mRealArr,float *mImageArr);
 /***
 	chromaNum 12
@@ -8,6 +8,7 @@
 #include "vector/flux_complex.h"
 
 #include "util/flux_util.h"
+#include "util/flux_parallel.h"
 
 #include "dsp/flux_correct.h"
 #include "dsp/fft_algorithm.h"
@@ -15,6 +16,7 @@
 
 #include "filterbank/auditory_filterBank.h"
 #include "filterbank/cwt_filterBank.h"
+#include "filterbank/filterBank_cache.h"
 
 #include "cwt_algorithm.h"
 
@@ -22,6 +24,9 @@ struct OpaqueCWT{
 	FFTObj fftObj;
 	DFTObj dftObj;
 
+	FFTWorkObj *workObjArr; // per thread fft workspace, grow to thread number
+	int workNum;
+
 	int fftLength; // 1<<radix2Exp+2*padLength
 	int dataLength; // data length=1<<radix2Exp
 	int padLength; // 0||dataLength/2||log2(dataLength) ???
@@ -34,6 +39,8 @@ struct OpaqueCWT{
 	float *mFilterBankArr; // num*fftLength
 	float *mFilterBankDetArr; // j
 
+	FilterBankCacheObj filterBankCacheObj; // own binBand/freBand/filterBank
+
 	float *realArr1; // fft data result
 	float *imageArr1;
 
@@ -61,8 +68,24 @@ struct OpaqueCWT{
 };
 
 static void __cwtObj_init(CWTObj cwtObj);
+static int __cwtObj_checkFilterBank(FilterBankCacheObj cacheObj,int num,int fftLength);
 static void __cwtObj_cwt(CWTObj cwtObj,float *dataArr,float *mFilterBankArr,int iFlag,float *mRealArr4,float *mImageArr4);
 
+// __cwtObj_bandChunk arg
+typedef struct{
+	CWTObj cwtObj;
+
+	float *mFilterBankArr;
+	int iFlag;
+
+	float *mRealArr4;
+	float *mImageArr4;
+
+} CWTBandChunkArg;
+
+// bands [start,end) filter+ifft
+static void __cwtObj_bandChunk(void *arg,int start,int end,int threadIndex);
+
 /***
 	waveletType 
 		'morse' gamma->wc+ beta->bin+ default
@@ -362,27 +385,22 @@ static void __cwtObj_cwt(CWTObj cwtObj,float *dataArr,float *mFilterBankArr,int
 	FFTObj fftObj=NULL;
 	DFTObj dftObj=NULL;
 
-	int fftLength=0; // 1<<radix2Exp+2*padLength
 	int dataLength=0; // data length=1<<radix2Exp
 	int padLength=0; // 0||dataLength/2||log2(dataLength) ???
 
 	int num=0;
+	int threadNum=0;
 
 	float *realArr1=NULL; // fft data result
 	float *imageArr1=NULL;
 
-	float *mRealArr2=NULL; // mFilterBankArr.dot(fftData)  
-	float *mImageArr2=NULL;
-
-	float *mRealArr3=NULL; // ifft(mArr2) !isPad not use
-	float *mImageArr3=NULL;
-
 	float *curDataArr=NULL; 
 
+	CWTBandChunkArg chunkArg;
+
 	fftObj=cwtObj->fftObj;
 	dftObj=cwtObj->dftObj;
 
-	fftLength=cwtObj->fftLength;
 	dataLength=cwtObj->dataLength;
 	padLength=cwtObj->padLength;
 
@@ -391,12 +409,6 @@ static void __cwtObj_cwt(CWTObj cwtObj,float *dataArr,float *mFilterBankArr,int
 	realArr1=cwtObj->realArr1;
 	imageArr1=cwtObj->imageArr1;
 
-	mRealArr2=cwtObj->mRealArr2;
-	mImageArr2=cwtObj->mImageArr2;
-
-	mRealArr3=cwtObj->mRealArr3;
-	mImageArr3=cwtObj->mImageArr3;
-
 	curDataArr=cwtObj->curDataArr;
 
 	if(dataArr){
@@ -422,64 +434,117 @@ static void __cwtObj_cwt(CWTObj cwtObj,float *dataArr,float *mFilterBankArr,int
 		}
 	}
 	
- 	// 3. mFilterBankArr.dot(fftData) 
-	for(int i=0;i<num;i++){
+ 	// 3. mFilterBankArr.dot(fftData), 4. ifft; bands on library threads
+	chunkArg.cwtObj=cwtObj;
+	chunkArg.mFilterBankArr=mFilterBankArr;
+	chunkArg.iFlag=iFlag;
+	chunkArg.mRealArr4=mRealArr4;
+	chunkArg.mImageArr4=mImageArr4;
+
+	if(fftObj){
+		threadNum=audioflux_getThreadNum();
+		fftWorkObj_growArr(&cwtObj->workObjArr,&cwtObj->workNum,threadNum,fftObj);
+
+		__parallel_for(num,1,threadNum,__cwtObj_bandChunk,&chunkArg);
+	}
+	else{ // dftObj not reentrant
+		__cwtObj_bandChunk(&chunkArg,0,num,0);
+	}
+}
+
+static void __cwtObj_bandChunk(void *arg,int start,int end,int threadIndex){
+	CWTBandChunkArg *chunkArg=NULL;
+	CWTObj cwtObj=NULL;
+
+	FFTObj fftObj=NULL;
+	DFTObj dftObj=NULL;
+
+	int fftLength=0;
+	int dataLength=0;
+	int padLength=0;
+
+	int iFlag=0;
+	float *mFilterBankArr=NULL;
+
+	float *realArr1=NULL;
+	float *imageArr1=NULL;
+
+	float *mRealArr2=NULL;
+	float *mImageArr2=NULL;
+
+	float *mRealArr3=NULL;
+	float *mImageArr3=NULL;
+
+	float *mRealArr4=NULL;
+	float *mImageArr4=NULL;
+
+	chunkArg=(CWTBandChunkArg *)arg;
+	cwtObj=chunkArg->cwtObj;
+
+	fftObj=cwtObj->fftObj;
+	dftObj=cwtObj->dftObj;
+
+	fftLength=cwtObj->fftLength;
+	dataLength=cwtObj->dataLength;
+	padLength=cwtObj->padLength;
+
+	iFlag=chunkArg->iFlag;
+	mFilterBankArr=chunkArg->mFilterBankArr;
+
+	realArr1=cwtObj->realArr1;
+	imageArr1=cwtObj->imageArr1;
+
+	mRealArr2=cwtObj->mRealArr2;
+	mImageArr2=cwtObj->mImageArr2;
+
+	mRealArr3=cwtObj->mRealArr3;
+	mImageArr3=cwtObj->mImageArr3;
+
+	mRealArr4=chunkArg->mRealArr4;
+	mImageArr4=chunkArg->mImageArr4;
+
+	for(int i=start;i<end;i++){
+		float *realArr2=NULL;
+		float *imageArr2=NULL;
+
+		float *realArr3=NULL; // ifft result
+		float *imageArr3=NULL;
+
+		realArr2=mRealArr2+i*fftLength;
+		imageArr2=mImageArr2+i*fftLength;
+
 		for(int j=0;j<fftLength;j++){
 			if(!iFlag){ // mFilterBankArr
-				mRealArr2[j+i*fftLength]=mFilterBankArr[j+i*fftLength]*realArr1[j];
-				mImageArr2[j+i*fftLength]=mFilterBankArr[j+i*fftLength]*imageArr1[j];
+				realArr2[j]=mFilterBankArr[j+i*fftLength]*realArr1[j];
+				imageArr2[j]=mFilterBankArr[j+i*fftLength]*imageArr1[j];
 			}
 			else{ // mFilterBankDetArr j
-				mRealArr2[j+i*fftLength]=-mFilterBankArr[j+i*fftLength]*imageArr1[j];
-				mImageArr2[j+i*fftLength]=mFilterBankArr[j+i*fftLength]*realArr1[j];
+				realArr2[j]=-mFilterBankArr[j+i*fftLength]*imageArr1[j];
+				imageArr2[j]=mFilterBankArr[j+i*fftLength]*realArr1[j];
 			}
 		}
-	}
 
- 	// 4. ifft
-	if(fftObj){
 		if(padLength){ // has padding
-			for(int i=0;i<num;i++){
-				fftObj_ifft(fftObj, mRealArr2+i*fftLength, mImageArr2+i*fftLength, 
-							mRealArr3+i*fftLength, mImageArr3+i*fftLength);
-			}
-
-			for(int i=0;i<num;i++){
-				for(int j=padLength,k=0;j<padLength+dataLength;j++,k++){
-					mRealArr4[k+i*dataLength]=mRealArr3[j+i*fftLength];
-					mImageArr4[k+i*dataLength]=mImageArr3[j+i*fftLength];
-				}
-			}
+			realArr3=mRealArr3+i*fftLength;
+			imageArr3=mImageArr3+i*fftLength;
 		}
 		else{
-			for(int i=0;i<num;i++){
-				fftObj_ifft(fftObj, mRealArr2+i*fftLength, mImageArr2+i*fftLength, 
-							mRealArr4+i*fftLength, mImageArr4+i*fftLength);
-			}
+			realArr3=mRealArr4+i*fftLength;
+			imageArr3=mImageArr4+i*fftLength;
 		}
-	}
-	else{
-		if(padLength){ // has padding
-			for(int i=0;i<num;i++){
-				dftObj_idft(dftObj, mRealArr2+i*fftLength, mImageArr2+i*fftLength, 
-							mRealArr3+i*fftLength, mImageArr3+i*fftLength);
-			}
 
-			for(int i=0;i<num;i++){
-				for(int j=padLength,k=0;j<padLength+dataLength;j++,k++){
-					mRealArr4[k+i*dataLength]=mRealArr3[j+i*fftLength];
-					mImageArr4[k+i*dataLength]=mImageArr3[j+i*fftLength];
-				}
-			}
+		if(fftObj){
+			fftObj_ifftWork(fftObj, cwtObj->workObjArr[threadIndex], realArr2, imageArr2, realArr3, imageArr3);
 		}
 		else{
-			for(int i=0;i<num;i++){
-				dftObj_idft(dftObj, mRealArr2+i*fftLength, mImageArr2+i*fftLength, 
-							mRealArr4+i*fftLength, mImageArr4+i*fftLength);
-			}
+			dftObj_idft(dftObj, realArr2, imageArr2, realArr3, imageArr3);
 		}
-	}
 
+		if(padLength){
+			memcpy(mRealArr4+i*dataLength, realArr3+padLength, sizeof(float )*dataLength);
+			memcpy(mImageArr4+i*dataLength, imageArr3+padLength, sizeof(float )*dataLength);
+		}
+	}
 }
 
 void cwtObj_enableDet(CWTObj cwtObj,int flag){
@@ -531,10 +596,6 @@ void cwtObj_free(CWTObj cwtObj){
 	FFTObj fftObj=NULL;
 	DFTObj dftObj=NULL;
 
-	int *binBandArr=NULL;
-	float *freBandArr=NULL;
-
-	float *mFilterBankArr=NULL; // num*fftLength
 	float *mFilterBankDetArr=NULL;
 
 	float *realArr1=NULL; // fft data result
@@ -552,10 +613,6 @@ void cwtObj_free(CWTObj cwtObj){
 		fftObj=cwtObj->fftObj;
 		dftObj=cwtObj->dftObj;
 
-		binBandArr=cwtObj->binBandArr;
-		freBandArr=cwtObj->freBandArr;
-
-		mFilterBankArr=cwtObj->mFilterBankArr;
 		mFilterBankDetArr=cwtObj->mFilterBankDetArr;
 
 		realArr1=cwtObj->realArr1;
@@ -569,13 +626,15 @@ void cwtObj_free(CWTObj cwtObj){
 
 		curDataArr=cwtObj->curDataArr;
 
+		for(int i=0;i<cwtObj->workNum;i++){
+			fftWorkObj_free(cwtObj->workObjArr[i]);
+		}
+		free(cwtObj->workObjArr);
+
 		fftObj_free(fftObj);
 		dftObj_free(dftObj);
 
-		free(binBandArr);
-		free(freBandArr);
-
-		free(mFilterBankArr);
+		filterBankCacheObj_release(cwtObj->filterBankCacheObj);
 		free(mFilterBankDetArr);
 
 		free(realArr1);
@@ -593,11 +652,21 @@ void cwtObj_free(CWTObj cwtObj){
 	}
 }
 
-static void __cwtObj_init(CWTObj cwtObj){
-	int *binBandArr=NULL;
-	float *freBandArr=NULL;
+// imported entry shape must match what init indexes
+static int __cwtObj_checkFilterBank(FilterBankCacheObj cacheObj,int num,int fftLength){
+	if(filterBankCacheObj_getArrLength(cacheObj,0)!=num*fftLength||
+		filterBankCacheObj_getArrLength(cacheObj,1)!=num+2||
+		filterBankCacheObj_getIntArrLength(cacheObj,0)!=num+2){
 
-	float *mFilterBankArr=NULL;
+		return 0;
+	}
+
+	return 1;
+}
+
+static void __cwtObj_init(CWTObj cwtObj){
+	FilterBankCacheObj cacheObj=NULL;
+	double paramArr[11]={0};
 
 	int num=0;
 	int dataLength=0;
@@ -631,21 +700,56 @@ static void __cwtObj_init(CWTObj cwtObj){
 	highFre=cwtObj->highFre;
 	binPerOctave=cwtObj->binPerOctave;
 
-	mFilterBankArr=__vnew(num*fftLength, NULL);
-	freBandArr=__vnew(num+2, NULL);
-	binBandArr=__vnewi(num+2, NULL);
-
-	cwt_filterBank(num,dataLength,samplate,padLength,
-				waveletType,gamma,beta,
-				scaleType,
-				lowFre,highFre,binPerOctave,
-				mFilterBankArr,
-				freBandArr,
-				binBandArr);
-
-	cwtObj->mFilterBankArr=mFilterBankArr;
-	cwtObj->freBandArr=freBandArr;
-	cwtObj->binBandArr=binBandArr;
+	paramArr[0]=num;
+	paramArr[1]=dataLength;
+	paramArr[2]=samplate;
+	paramArr[3]=padLength;
+	paramArr[4]=waveletType;
+	paramArr[5]=gamma;
+	paramArr[6]=beta;
+	paramArr[7]=scaleType;
+	paramArr[8]=lowFre;
+	paramArr[9]=highFre;
+	paramArr[10]=binPerOctave;
+
+	cacheObj=filterBankCache_find(FilterBankCache_CWT,paramArr,11);
+	if(cacheObj&&!__cwtObj_checkFilterBank(cacheObj,num,fftLength)){
+		filterBankCacheObj_discard(cacheObj);
+		cacheObj=NULL;
+	}
+	if(!cacheObj){
+		float *arrArr[2]={0}; // mFilterBankArr,freBandArr
+		int lengthArr[2]={0};
+
+		int *binBandArr=NULL;
+		int binLength=0;
+
+		arrArr[0]=__vnew(num*fftLength, NULL);
+		arrArr[1]=__vnew(num+2, NULL);
+		binBandArr=__vnewi(num+2, NULL);
+
+		cwt_filterBank(num,dataLength,samplate,padLength,
+					waveletType,gamma,beta,
+					scaleType,
+					lowFre,highFre,binPerOctave,
+					arrArr[0],
+					arrArr[1],
+					binBandArr);
+
+		lengthArr[0]=num*fftLength;
+		lengthArr[1]=num+2;
+		binLength=num+2;
+
+		cacheObj=filterBankCache_insert(FilterBankCache_CWT,paramArr,11,
+										arrArr,lengthArr,2,
+										&binBandArr,&binLength,1);
+	}
+
+	cwtObj->filterBankCacheObj=cacheObj;
+
+	cwtObj->mFilterBankArr=filterBankCacheObj_getArr(cacheObj,0);
+	cwtObj->freBandArr=filterBankCacheObj_getArr(cacheObj,1);
+	cwtObj->binBandArr=filterBankCacheObj_getIntArr(cacheObj,0);
 
 	// debug
 	// {
@@ -0,0 +1,312 @@
+//
+
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#if defined(__GNUC__)&&(defined(__x86_64__)||defined(__i386__))
+#include <immintrin.h>
+#define FFT_KERNEL_X86
+
+#elif defined(__ARM_NEON)||defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FFT_KERNEL_NEON
+
+#endif
+
+#include "_fft_kernel.h"
+
+/***
+	fused radix-2 stage pair, half size s, block 4s
+	y0=x0+W1*x1 y1=x0-W1*x1 y2=x2+W1*x3 y3=x2-W1*x3
+	z0=y0+W2*y2 z2=y0-W2*y2 z1=y1-j*W2*y3 z3=y1+j*W2*y3
+****/
+typedef void (*FFTKernelStageFunc)(float *realArr,float *imageArr,int length,int s,
+								float *cosArr1,float *sinArr1,float *cosArr2,float *sinArr2);
+
+// resolve once, concurrent first fft from library threads
+static FFTKernelStageFunc __stageFunc=NULL;
+static pthread_once_t __stageOnce=PTHREAD_ONCE_INIT;
+
+static FFTKernelStageFunc __fftKernel_dispatch();
+static void __fftKernel_initStage();
+
+static void __fftKernel_stage(float *realArr,float *imageArr,int length,int s,
+							float *cosArr1,float *sinArr1,float *cosArr2,float *sinArr2);
+
+void __fftKernel_createStageWArr(float *cosArr1,float *sinArr1,float *cosArr2,float *sinArr2,int length){
+	for(int s=1;s<=length;s*=2){
+		if(s-1+s>length){
+			break;
+		}
+
+		for(int g=0;g<s;g++){
+			double value1=0;
+			double value2=0;
+
+			value1=2*M_PI*g/(2*s);
+			value2=2*M_PI*g/(4*s);
+
+			cosArr1[s-1+g]=cos(value1);
+			sinArr1[s-1+g]=-sin(value1);
+
+			cosArr2[s-1+g]=cos(value2);
+			sinArr2[s-1+g]=-sin(value2);
+		}
+	}
+}
+
+void __fftKernel_butterfly(float *realArr,float *imageArr,int radix2Exp,
+						float *cosArr1,float *sinArr1,float *cosArr2,float *sinArr2){
+	int length=0;
+	int p=0;
+
+	pthread_once(&__stageOnce,__fftKernel_initStage);
+
+	length=1<<radix2Exp;
+
+	// odd => first radix-2 stage, w=1
+	if(radix2Exp&1){
+		for(int b=0;b<length;b+=2){
+			float r1=0;
+			float i1=0;
+
+			r1=realArr[b+1];
+			i1=imageArr[b+1];
+
+			realArr[b+1]=realArr[b]-r1;
+			imageArr[b+1]=imageArr[b]-i1;
+
+			realArr[b]+=r1;
+			imageArr[b]+=i1;
+		}
+
+		p=1;
+	}
+
+	for(;p<radix2Exp;p+=2){
+		int s=0;
+
+		s=1<<p;
+		__stageFunc(realArr,imageArr,length,s,
+					cosArr1+s-1,sinArr1+s-1,cosArr2+s-1,sinArr2+s-1);
+	}
+}
+
+static void __fftKernel_initStage(){
+
+	__stageFunc=__fftKernel_dispatch();
+}
+
+static void __fftKernel_stage(float *realArr,float *imageArr,int length,int s,
+							float *cosArr1,float *sinArr1,float *cosArr2,float *sinArr2){
+
+	for(int b=0;b<length;b+=4*s){
+		float *r0=realArr+b;
+		float *i0=imageArr+b;
+
+		for(int g=0;g<s;g++){
+			float x0r=0,x0i=0,x1r=0,x1i=0,x2r=0,x2i=0,x3r=0,x3i=0;
+			float y0r=0,y0i=0,y1r=0,y1i=0,y2r=0,y2i=0,y3r=0,y3i=0;
+			float tr=0,ti=0;
+			float ur=0,ui=0;
+
+			x0r=r0[g]; x0i=i0[g];
+			x1r=r0[g+s]; x1i=i0[g+s];
+			x2r=r0[g+2*s]; x2i=i0[g+2*s];
+			x3r=r0[g+3*s]; x3i=i0[g+3*s];
+
+			tr=x1r*cosArr1[g]-x1i*sinArr1[g];
+			ti=x1r*sinArr1[g]+x1i*cosArr1[g];
+			y0r=x0r+tr; y0i=x0i+ti;
+			y1r=x0r-tr; y1i=x0i-ti;
+
+			tr=x3r*cosArr1[g]-x3i*sinArr1[g];
+			ti=x3r*sinArr1[g]+x3i*cosArr1[g];
+			y2r=x2r+tr; y2i=x2i+ti;
+			y3r=x2r-tr; y3i=x2i-ti;
+
+			tr=y2r*cosArr2[g]-y2i*sinArr2[g];
+			ti=y2r*sinArr2[g]+y2i*cosArr2[g];
+			r0[g]=y0r+tr; i0[g]=y0i+ti;
+			r0[g+2*s]=y0r-tr; i0[g+2*s]=y0i-ti;
+
+			ur=y3r*cosArr2[g]-y3i*sinArr2[g];
+			ui=y3r*sinArr2[g]+y3i*cosArr2[g];
+			r0[g+s]=y1r+ui; i0[g+s]=y1i-ur;
+			r0[g+3*s]=y1r-ui; i0[g+3*s]=y1i+ur;
+		}
+	}
+}
+
+#ifdef FFT_KERNEL_X86
+// SSE2 x86 base, 4 float
+static void __fftKernel_stageSSE(float *realArr,float *imageArr,int length,int s,
+								float *cosArr1,float *sinArr1,float *cosArr2,float *sinArr2){
+	if(s<4){
+		__fftKernel_stage(realArr,imageArr,length,s,cosArr1,sinArr1,cosArr2,sinArr2);
+		return;
+	}
+
+	for(int b=0;b<length;b+=4*s){
+		float *r0=realArr+b;
+		float *i0=imageArr+b;
+
+		for(int g=0;g<s;g+=4){
+			__m128 x0r,x0i,x1r,x1i,x2r,x2i,x3r,x3i;
+			__m128 y0r,y0i,y1r,y1i,y2r,y2i,y3r,y3i;
+			__m128 c1,s1,c2,s2;
+			__m128 tr,ti,ur,ui;
+
+			x0r=_mm_loadu_ps(r0+g); x0i=_mm_loadu_ps(i0+g);
+			x1r=_mm_loadu_ps(r0+g+s); x1i=_mm_loadu_ps(i0+g+s);
+			x2r=_mm_loadu_ps(r0+g+2*s); x2i=_mm_loadu_ps(i0+g+2*s);
+			x3r=_mm_loadu_ps(r0+g+3*s); x3i=_mm_loadu_ps(i0+g+3*s);
+
+			c1=_mm_loadu_ps(cosArr1+g); s1=_mm_loadu_ps(sinArr1+g);
+			c2=_mm_loadu_ps(cosArr2+g); s2=_mm_loadu_ps(sinArr2+g);
+
+			tr=_mm_sub_ps(_mm_mul_ps(x1r,c1),_mm_mul_ps(x1i,s1));
+			ti=_mm_add_ps(_mm_mul_ps(x1r,s1),_mm_mul_ps(x1i,c1));
+			y0r=_mm_add_ps(x0r,tr); y0i=_mm_add_ps(x0i,ti);
+			y1r=_mm_sub_ps(x0r,tr); y1i=_mm_sub_ps(x0i,ti);
+
+			tr=_mm_sub_ps(_mm_mul_ps(x3r,c1),_mm_mul_ps(x3i,s1));
+			ti=_mm_add_ps(_mm_mul_ps(x3r,s1),_mm_mul_ps(x3i,c1));
+			y2r=_mm_add_ps(x2r,tr); y2i=_mm_add_ps(x2i,ti);
+			y3r=_mm_sub_ps(x2r,tr); y3i=_mm_sub_ps(x2i,ti);
+
+			tr=_mm_sub_ps(_mm_mul_ps(y2r,c2),_mm_mul_ps(y2i,s2));
+			ti=_mm_add_ps(_mm_mul_ps(y2r,s2),_mm_mul_ps(y2i,c2));
+			_mm_storeu_ps(r0+g,_mm_add_ps(y0r,tr)); _mm_storeu_ps(i0+g,_mm_add_ps(y0i,ti));
+			_mm_storeu_ps(r0+g+2*s,_mm_sub_ps(y0r,tr)); _mm_storeu_ps(i0+g+2*s,_mm_sub_ps(y0i,ti));
+
+			ur=_mm_sub_ps(_mm_mul_ps(y3r,c2),_mm_mul_ps(y3i,s2));
+			ui=_mm_add_ps(_mm_mul_ps(y3r,s2),_mm_mul_ps(y3i,c2));
+			_mm_storeu_ps(r0+g+s,_mm_add_ps(y1r,ui)); _mm_storeu_ps(i0+g+s,_mm_sub_ps(y1i,ur));
+			_mm_storeu_ps(r0+g+3*s,_mm_sub_ps(y1r,ui)); _mm_storeu_ps(i0+g+3*s,_mm_add_ps(y1i,ur));
+		}
+	}
+}
+
+// AVX2 8 float, s<8 => SSE2
+__attribute__((target("avx2")))
+static void __fftKernel_stageAVX(float *realArr,float *imageArr,int length,int s,
+								float *cosArr1,float *sinArr1,float *cosArr2,float *sinArr2){
+	if(s<8){
+		__fftKernel_stageSSE(realArr,imageArr,length,s,cosArr1,sinArr1,cosArr2,sinArr2);
+		return;
+	}
+
+	for(int b=0;b<length;b+=4*s){
+		float *r0=realArr+b;
+		float *i0=imageArr+b;
+
+		for(int g=0;g<s;g+=8){
+			__m256 x0r,x0i,x1r,x1i,x2r,x2i,x3r,x3i;
+			__m256 y0r,y0i,y1r,y1i,y2r,y2i,y3r,y3i;
+			__m256 c1,s1,c2,s2;
+			__m256 tr,ti,ur,ui;
+
+			x0r=_mm256_loadu_ps(r0+g); x0i=_mm256_loadu_ps(i0+g);
+			x1r=_mm256_loadu_ps(r0+g+s); x1i=_mm256_loadu_ps(i0+g+s);
+			x2r=_mm256_loadu_ps(r0+g+2*s); x2i=_mm256_loadu_ps(i0+g+2*s);
+			x3r=_mm256_loadu_ps(r0+g+3*s); x3i=_mm256_loadu_ps(i0+g+3*s);
+
+			c1=_mm256_loadu_ps(cosArr1+g); s1=_mm256_loadu_ps(sinArr1+g);
+			c2=_mm256_loadu_ps(cosArr2+g); s2=_mm256_loadu_ps(sinArr2+g);
+
+			tr=_mm256_sub_ps(_mm256_mul_ps(x1r,c1),_mm256_mul_ps(x1i,s1));
+			ti=_mm256_add_ps(_mm256_mul_ps(x1r,s1),_mm256_mul_ps(x1i,c1));
+			y0r=_mm256_add_ps(x0r,tr); y0i=_mm256_add_ps(x0i,ti);
+			y1r=_mm256_sub_ps(x0r,tr); y1i=_mm256_sub_ps(x0i,ti);
+
+			tr=_mm256_sub_ps(_mm256_mul_ps(x3r,c1),_mm256_mul_ps(x3i,s1));
+			ti=_mm256_add_ps(_mm256_mul_ps(x3r,s1),_mm256_mul_ps(x3i,c1));
+			y2r=_mm256_add_ps(x2r,tr); y2i=_mm256_add_ps(x2i,ti);
+			y3r=_mm256_sub_ps(x2r,tr); y3i=_mm256_sub_ps(x2i,ti);
+
+			tr=_mm256_sub_ps(_mm256_mul_ps(y2r,c2),_mm256_mul_ps(y2i,s2));
+			ti=_mm256_add_ps(_mm256_mul_ps(y2r,s2),_mm256_mul_ps(y2i,c2));
+			_mm256_storeu_ps(r0+g,_mm256_add_ps(y0r,tr)); _mm256_storeu_ps(i0+g,_mm256_add_ps(y0i,ti));
+			_mm256_storeu_ps(r0+g+2*s,_mm256_sub_ps(y0r,tr)); _mm256_storeu_ps(i0+g+2*s,_mm256_sub_ps(y0i,ti));
+
+			ur=_mm256_sub_ps(_mm256_mul_ps(y3r,c2),_mm256_mul_ps(y3i,s2));
+			ui=_mm256_add_ps(_mm256_mul_ps(y3r,s2),_mm256_mul_ps(y3i,c2));
+			_mm256_storeu_ps(r0+g+s,_mm256_add_ps(y1r,ui)); _mm256_storeu_ps(i0+g+s,_mm256_sub_ps(y1i,ur));
+			_mm256_storeu_ps(r0+g+3*s,_mm256_sub_ps(y1r,ui)); _mm256_storeu_ps(i0+g+3*s,_mm256_add_ps(y1i,ur));
+		}
+	}
+}
+
+#elif defined FFT_KERNEL_NEON
+// NEON 4 float
+static void __fftKernel_stageNEON(float *realArr,float *imageArr,int length,int s,
+								float *cosArr1,float *sinArr1,float *cosArr2,float *sinArr2){
+	if(s<4){
+		__fftKernel_stage(realArr,imageArr,length,s,cosArr1,sinArr1,cosArr2,sinArr2);
+		return;
+	}
+
+	for(int b=0;b<length;b+=4*s){
+		float *r0=realArr+b;
+		float *i0=imageArr+b;
+
+		for(int g=0;g<s;g+=4){
+			float32x4_t x0r,x0i,x1r,x1i,x2r,x2i,x3r,x3i;
+			float32x4_t y0r,y0i,y1r,y1i,y2r,y2i,y3r,y3i;
+			float32x4_t c1,s1,c2,s2;
+			float32x4_t tr,ti,ur,ui;
+
+			x0r=vld1q_f32(r0+g); x0i=vld1q_f32(i0+g);
+			x1r=vld1q_f32(r0+g+s); x1i=vld1q_f32(i0+g+s);
+			x2r=vld1q_f32(r0+g+2*s); x2i=vld1q_f32(i0+g+2*s);
+			x3r=vld1q_f32(r0+g+3*s); x3i=vld1q_f32(i0+g+3*s);
+
+			c1=vld1q_f32(cosArr1+g); s1=vld1q_f32(sinArr1+g);
+			c2=vld1q_f32(cosArr2+g); s2=vld1q_f32(sinArr2+g);
+
+			tr=vsubq_f32(vmulq_f32(x1r,c1),vmulq_f32(x1i,s1));
+			ti=vaddq_f32(vmulq_f32(x1r,s1),vmulq_f32(x1i,c1));
+			y0r=vaddq_f32(x0r,tr); y0i=vaddq_f32(x0i,ti);
+			y1r=vsubq_f32(x0r,tr); y1i=vsubq_f32(x0i,ti);
+
+			tr=vsubq_f32(vmulq_f32(x3r,c1),vmulq_f32(x3i,s1));
+			ti=vaddq_f32(vmulq_f32(x3r,s1),vmulq_f32(x3i,c1));
+			y2r=vaddq_f32(x2r,tr); y2i=vaddq_f32(x2i,ti);
+			y3r=vsubq_f32(x2r,tr); y3i=vsubq_f32(x2i,ti);
+
+			tr=vsubq_f32(vmulq_f32(y2r,c2),vmulq_f32(y2i,s2));
+			ti=vaddq_f32(vmulq_f32(y2r,s2),vmulq_f32(y2i,c2));
+			vst1q_f32(r0+g,vaddq_f32(y0r,tr)); vst1q_f32(i0+g,vaddq_f32(y0i,ti));
+			vst1q_f32(r0+g+2*s,vsubq_f32(y0r,tr)); vst1q_f32(i0+g+2*s,vsubq_f32(y0i,ti));
+
+			ur=vsubq_f32(vmulq_f32(y3r,c2),vmulq_f32(y3i,s2));
+			ui=vaddq_f32(vmulq_f32(y3r,s2),vmulq_f32(y3i,c2));
+			vst1q_f32(r0+g+s,vaddq_f32(y1r,ui)); vst1q_f32(i0+g+s,vsubq_f32(y1i,ur));
+			vst1q_f32(r0+g+3*s,vsubq_f32(y1r,ui)); vst1q_f32(i0+g+3*s,vaddq_f32(y1i,ur));
+		}
+	}
+}
+
+#endif
+
+static FFTKernelStageFunc __fftKernel_dispatch(){
+	FFTKernelStageFunc func=__fftKernel_stage;
+
+	#ifdef FFT_KERNEL_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")){
+		func=__fftKernel_stageAVX;
+	}
+	else if(__builtin_cpu_supports("sse2")){
+		func=__fftKernel_stageSSE;
+	}
+
+	#elif defined FFT_KERNEL_NEON
+	func=__fftKernel_stageNEON;
+
+	#endif
+
+	return func;
+}
@@ -0,0 +1,26 @@
+#ifndef _FFT_KERNEL_H
+#define _FFT_KERNEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/***
+	radix-2^2 stage w cache, stage half size s=1,2,4...; offset s-1, length s
+	cosArr1/sinArr1 W(2s)^g, cosArr2/sinArr2 W(4s)^g; sin is -sin
+	length>=fftLength/2 cover fftLength and fftLength/2
+****/
+void __fftKernel_createStageWArr(float *cosArr1,float *sinArr1,float *cosArr2,float *sinArr2,int length);
+
+// in-place on reverse order data; scalar/SSE2/AVX2/NEON by runtime cpu
+void __fftKernel_butterfly(float *realArr,float *imageArr,int radix2Exp,
+						float *cosArr1,float *sinArr1,float *cosArr2,float *sinArr2);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,6 +4,8 @@
 #include <math.h>
 
 #include "../vector/flux_vector.h"
+#include "../vector/flux_vectorOp.h"
+#include "../util/flux_parallel.h"
 
 #include "dct_algorithm.h"
 
@@ -33,6 +35,8 @@ struct OpaqueDCT{
 // void dctObj_debug(DCTObj dctObj);
 
 static float *__calCosMatrix(int length);
+
+static void __dct_cepstrumChunk(void *arg,int start,int end,int threadIndex);
 static void _vdot(float **arrArr,float *dataArr,float *outArr,int length);
 
 int dctObj_new(DCTObj *dctObj,int length,DCTType *type){
@@ -167,6 +171,129 @@ void dctObj_free(DCTObj dctObj){
 	free(dctObj);
 }
 
+float *dct_createMatrix(int length,int ccNum){
+	float *mDCTArr=NULL;
+
+	double s0=0,s1=0;
+
+	if(length<=0||ccNum<=0||ccNum>length){
+		return NULL;
+	}
+
+	s0=sqrt(1.0/length);
+	s1=sqrt(2.0/length);
+
+	mDCTArr=__vnew(ccNum*length, NULL);
+	for(int i=0;i<ccNum;i++){
+		for(int j=0;j<length;j++){
+			mDCTArr[i*length+j]=(i?s1:s0)*cos(M_PI*(j+0.5)*i/length);
+		}
+	}
+
+	return mDCTArr;
+}
+
+// dct_cepstrum __parallel_for arg
+typedef struct{
+	float *mDataArr1;
+	float *mDCTArr;
+	float *mRectArr;
+	float *mDataArr2;
+
+	int length;
+	int ccNum;
+	CepstralRectifyType rectifyType;
+
+	int isDot; // 0 rectify only(blas gemm after)
+
+} DCTCepstrumArg;
+
+void dct_cepstrum(float *mDataArr1,int timeLength,int length,
+				float *mDCTArr,int ccNum,CepstralRectifyType rectifyType,
+				float *mRectArr,float *mDataArr2){
+	DCTCepstrumArg cepsArg;
+
+	cepsArg.mDataArr1=mDataArr1;
+	cepsArg.mDCTArr=mDCTArr;
+	cepsArg.mRectArr=mRectArr;
+	cepsArg.mDataArr2=mDataArr2;
+
+	cepsArg.length=length;
+	cepsArg.ccNum=ccNum;
+	cepsArg.rectifyType=rectifyType;
+
+	#if (defined HAVE_ACCELERATE) || (defined HAVE_OPENBLAS) || (defined HAVE_MKL)
+	// rectify, then one gemm timeLength*length@(ccNum*length)^T
+	cepsArg.isDot=0;
+	__parallel_for(timeLength,0,0,__dct_cepstrumChunk,&cepsArg);
+
+	__mdot1(mRectArr,mDCTArr,
+		timeLength,length,
+		ccNum,length,
+		mDataArr2);
+	#else
+	// rectify row stay in cache for ccNum dot
+	cepsArg.isDot=1;
+	__parallel_for(timeLength,0,0,__dct_cepstrumChunk,&cepsArg);
+	#endif
+}
+
+static void __dct_cepstrumChunk(void *arg,int start,int end,int threadIndex){
+	DCTCepstrumArg *cepsArg=NULL;
+
+	int length=0;
+	int ccNum=0;
+
+	cepsArg=(DCTCepstrumArg *)arg;
+
+	length=cepsArg->length;
+	ccNum=cepsArg->ccNum;
+
+	for(int i=start;i<end;i++){
+		float *dataArr1=NULL;
+		float *rectArr=NULL;
+
+		dataArr1=cepsArg->mDataArr1+i*length;
+		rectArr=cepsArg->mRectArr+i*length;
+
+		if(cepsArg->rectifyType==CepstralRectify_CubicRoot){
+			__vpow(dataArr1, 1.0/3, length, rectArr);
+		}
+		else{ // log
+			for(int j=0;j<length;j++){
+				rectArr[j]=(dataArr1[j]<1e-8?1e-8:dataArr1[j]);
+			}
+
+			__vlog10(rectArr, length, NULL); // matlab canonic
+		}
+
+		if(!cepsArg->isDot){
+			continue;
+		}
+
+		for(int k=0;k<ccNum;k++){
+			float *dctArr=NULL;
+
+			float v0=0,v1=0,v2=0,v3=0;
+			int j=0;
+
+			dctArr=cepsArg->mDCTArr+k*length;
+			for(;j+4<=length;j+=4){
+				v0+=dctArr[j]*rectArr[j];
+				v1+=dctArr[j+1]*rectArr[j+1];
+				v2+=dctArr[j+2]*rectArr[j+2];
+				v3+=dctArr[j+3]*rectArr[j+3];
+			}
+
+			for(;j<length;j++){
+				v0+=dctArr[j]*rectArr[j];
+			}
+
+			cepsArg->mDataArr2[i*ccNum+k]=(v0+v1)+(v2+v3);
+		}
+	}
+}
+
 static float *__calCosMatrix(int length){
 	float *mArr=NULL;
 
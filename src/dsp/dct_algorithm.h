@@ -33,6 +33,21 @@ void dctObj_idct(DCTObj dctObj,float *dataArr1,int isNorm,float *dataArr2);
 
 void dctObj_free(DCTObj dctObj);
 
+/***
+	truncated orthonormal DCT-II basis ccNum*length
+	row k s(k)cos(PI/N*(n+0.5)*k); s(0)=sqrt(1/N),other sqrt(2/N)
+****/
+float *dct_createMatrix(int length,int ccNum);
+
+/***
+	cepstrum of all frames, rectify(log10 clip 1e-8|cubic root) fused with truncated DCT
+	mDataArr1 timeLength*length, mDCTArr ccNum*length
+	mRectArr timeLength*length rectify cache, mDataArr2 timeLength*ccNum
+****/
+void dct_cepstrum(float *mDataArr1,int timeLength,int length,
+				float *mDCTArr,int ccNum,CepstralRectifyType rectifyType,
+				float *mRectArr,float *mDataArr2);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,4 +1,4 @@
-// clang -g -c 
+// clang -g -c
 
 #include <string.h>
 #include <math.h>
@@ -6,24 +6,60 @@
 #include "../vector/flux_vector.h"
 #include "../vector/flux_complex.h"
 
+#include "fft_algorithm.h"
 #include "dft_algorithm.h"
 
+/***
+	length=2^a*3^b*5^c => mixed radix(4/2/3/5)
+	other => bluestein, chirp convolution by fft(2^n>=2*length-1)
+****/
 struct OpaqueDFT{
 	int length; // data length
 
 	float *realArr; // dft input r,i cache
 	float *imageArr;
 
-	double *mCosArr; // length*length cache
-	double *mSinArr;
+	// mixed radix
+	int factorNum;
+	int factorArr[64]; // p1,m1,p2,m2... m=length/(p1*...*pn)
+
+	float *wCosArr; // length cache cos(2*pi*k/length)
+	float *wSinArr; // -sin(2*pi*k/length)
+
+	// bluestein
+	FFTObj fftObj;
+	int fftLength;
+
+	float *chirpRealArr; // length exp(-j*pi*n^2/length)
+	float *chirpImageArr;
+
+	float *bRealArr; // fftLength fft(conj(chirp))
+	float *bImageArr;
+
+	float *realArr1; // fftLength cache
+	float *imageArr1;
+
+	float *realArr2;
+	float *imageArr2;
 
 };
 
-static void __dot(double *mRealArr1,double *mImageArr1,
-				float *mRealArr2,float *mImageArr2,
-				int nLength1,int mLength1,
-				int nLength2,int mLength2,
-				float *mRealArr3,float *mImageArr3);
+static int __dftObj_factor(int length,int *factorArr);
+
+static void _dftObj_initBluestein(DFTObj dftObj,int length);
+
+static void _dftObj_dft(DFTObj dftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2);
+static void _dftObj_bluestein(DFTObj dftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2);
+
+static void __dftObj_work(float *realArr1,float *imageArr1,
+						float *realArr2,float *imageArr2,
+						int fStride,int *factorArr,
+						float *wCosArr,float *wSinArr);
+
+static void __dftObj_butterfly2(float *realArr,float *imageArr,int fStride,int mLength,float *wCosArr,float *wSinArr);
+static void __dftObj_butterfly3(float *realArr,float *imageArr,int fStride,int mLength,float *wCosArr,float *wSinArr);
+static void __dftObj_butterfly4(float *realArr,float *imageArr,int fStride,int mLength,float *wCosArr,float *wSinArr);
+static void __dftObj_butterfly5(float *realArr,float *imageArr,int fStride,int mLength,float *wCosArr,float *wSinArr);
 
 int dftObj_new(DFTObj *dftObj,int length){
 	int status=0;
@@ -32,53 +68,61 @@ int dftObj_new(DFTObj *dftObj,int length){
 	float *realArr=NULL; // dft input r,i cache
 	float *imageArr=NULL;
 
-	double *mCosArr=NULL; // fft w cache
-	double *mSinArr=NULL;
+	float *wCosArr=NULL; // w cache
+	float *wSinArr=NULL;
 
+	int factorNum=0;
 	double value=0;
 
+	if(length<1){
+		printf("length is error!\n");
+		return -1;
+	}
+
 	dft=*dftObj=(DFTObj )calloc(1, sizeof(struct OpaqueDFT ));
 
 	realArr=__vnew(length, NULL);
 	imageArr=__vnew(length, NULL);
 
-	mCosArr=(double *)calloc(length*length, sizeof(double ));
-	mSinArr=(double *)calloc(length*length, sizeof(double ));
-	for(int i=0;i<length;i++){
-		for(int j=0;j<length;j++){
-			value=2*M_PI*i*j/length;
-			mCosArr[i*length+j]=cos(value);
-			mSinArr[i*length+j]=-sin(value);
+	factorNum=__dftObj_factor(length, dft->factorArr);
+	if(factorNum>=0){ // 2/3/5
+		wCosArr=__vnew(length, NULL);
+		wSinArr=__vnew(length, NULL);
+		for(int i=0;i<length;i++){
+			value=2*M_PI*i/length;
+			wCosArr[i]=cos(value);
+			wSinArr[i]=-sin(value);
 		}
 	}
+	else{
+		_dftObj_initBluestein(dft,length);
+	}
 
 	dft->length=length;
 
 	dft->realArr=realArr;
 	dft->imageArr=imageArr;
 
-	dft->mCosArr=mCosArr;
-	dft->mSinArr=mSinArr;
+	dft->factorNum=factorNum;
+
+	dft->wCosArr=wCosArr;
+	dft->wSinArr=wSinArr;
 
 	return status;
 }
 
-// Y=W*X nLen*nLen@nLen*1 => nLen*1
 void dftObj_dft(DFTObj dftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2){
 	int length=0;
 
 	float *realArr=NULL;
 	float *imageArr=NULL;
 
-	double *mCosArr=NULL; // length*length cache
-	double *mSinArr=NULL;
-
 	length=dftObj->length;
 
 	realArr=dftObj->realArr;
 	imageArr=dftObj->imageArr;
 
-	// ??? 
+	// ???
 	if(realArr1){
 		memcpy(realArr, realArr1, sizeof(float )*length);
 	}
@@ -93,14 +137,7 @@ void dftObj_dft(DFTObj dftObj,float *realArr1,float *imageArr1,float *realArr2,f
 		memset(imageArr, 0, sizeof(float )*length);
 	}
 
-	mCosArr=dftObj->mCosArr;
-	mSinArr=dftObj->mSinArr;
-
-	__dot(mCosArr,mSinArr,
-			realArr,imageArr,
-			length,length,
-			length,1,
-			realArr2,imageArr2);
+	_dftObj_dft(dftObj,realArr,imageArr,realArr2,imageArr2);
 }
 
 void dftObj_idft(DFTObj dftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2){
@@ -109,15 +146,12 @@ void dftObj_idft(DFTObj dftObj,float *realArr1,float *imageArr1,float *realArr2,
 	float *realArr=NULL;
 	float *imageArr=NULL;
 
-	double *mCosArr=NULL; // length*length cache
-	double *mSinArr=NULL;
-
 	length=dftObj->length;
 
 	realArr=dftObj->realArr;
 	imageArr=dftObj->imageArr;
 
-	// ??? 
+	// ???
 	if(realArr1){
 		memcpy(realArr, realArr1, sizeof(float )*length);
 	}
@@ -136,14 +170,7 @@ void dftObj_idft(DFTObj dftObj,float *realArr1,float *imageArr1,float *realArr2,
 		imageArr[i]=-imageArr[i];
 	}
 
-	mCosArr=dftObj->mCosArr;
-	mSinArr=dftObj->mSinArr;
-
-	__dot(mCosArr,mSinArr,
-			realArr,imageArr,
-			length,length,
-			length,1,
-			realArr2,imageArr2);
+	_dftObj_dft(dftObj,realArr,imageArr,realArr2,imageArr2);
 
 	for(int i=0;i<length;i++){
 		realArr2[i]/=length;
@@ -152,65 +179,465 @@ void dftObj_idft(DFTObj dftObj,float *realArr1,float *imageArr1,float *realArr2,
 }
 
 void dftObj_free(DFTObj dftObj){
-	float *realArr=NULL; // dft input r,i cache
-	float *imageArr=NULL;
-
-	double *mCosArr=NULL; // length*length cache
-	double *mSinArr=NULL;
 
 	if(!dftObj){
 		return;
 	}
 
-	realArr=dftObj->realArr;
-	imageArr=dftObj->imageArr;
+	free(dftObj->realArr);
+	free(dftObj->imageArr);
+
+	free(dftObj->wCosArr);
+	free(dftObj->wSinArr);
 
-	mCosArr=dftObj->mCosArr;
-	mSinArr=dftObj->mSinArr;
+	fftObj_free(dftObj->fftObj);
 
-	free(realArr);
-	free(imageArr);
+	free(dftObj->chirpRealArr);
+	free(dftObj->chirpImageArr);
 
-	free(mCosArr);
-	free(mSinArr);
+	free(dftObj->bRealArr);
+	free(dftObj->bImageArr);
+
+	free(dftObj->realArr1);
+	free(dftObj->imageArr1);
+
+	free(dftObj->realArr2);
+	free(dftObj->imageArr2);
 
 	free(dftObj);
 }
 
-static void __dot(double *mRealArr1,double *mImageArr1,
-				float *mRealArr2,float *mImageArr2,
-				int nLength1,int mLength1,
-				int nLength2,int mLength2,
-				float *mRealArr3,float *mImageArr3){
-	if(mLength1!=nLength2){
-		return;
+// realArr1 is input cache, realArr2 must not alias it
+static void _dftObj_dft(DFTObj dftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2){
+
+	if(dftObj->factorNum<0){
+		_dftObj_bluestein(dftObj,realArr1,imageArr1,realArr2,imageArr2);
+	}
+	else if(dftObj->factorNum==0){ // length 1
+		realArr2[0]=realArr1[0];
+		imageArr2[0]=imageArr1[0];
+	}
+	else{
+		__dftObj_work(realArr1,imageArr1,
+					realArr2,imageArr2,
+					1,dftObj->factorArr,
+					dftObj->wCosArr,dftObj->wSinArr);
+	}
+}
+
+// factor 4/2/3/5; -1 has other prime factor
+static int __dftObj_factor(int length,int *factorArr){
+	int num=0;
+	int p=0;
+
+	while(length>1){
+		if(length%4==0){
+			p=4;
+		}
+		else if(length%2==0){
+			p=2;
+		}
+		else if(length%3==0){
+			p=3;
+		}
+		else if(length%5==0){
+			p=5;
+		}
+		else{
+			return -1;
+		}
+
+		length/=p;
+		factorArr[2*num]=p;
+		factorArr[2*num+1]=length;
+		num++;
+	}
+
+	return num;
+}
+
+/***
+	X[k]=w[k]*sum(x[n]*w[n]*conj(w[k-n])), w[n]=exp(-j*pi*n^2/N)
+	conv => fftLength 2^n>=2*N-1
+****/
+static void _dftObj_initBluestein(DFTObj dftObj,int length){
+	FFTObj fftObj=NULL;
+	int radix2Exp=0;
+	int fftLength=0;
+
+	float *chirpRealArr=NULL;
+	float *chirpImageArr=NULL;
+
+	float *bRealArr=NULL;
+	float *bImageArr=NULL;
+
+	double value=0;
+
+	while((1<<radix2Exp)<2*length-1){
+		radix2Exp++;
+	}
+
+	fftObj_new(&fftObj, radix2Exp);
+	fftLength=(1<<radix2Exp);
+
+	chirpRealArr=__vnew(length, NULL);
+	chirpImageArr=__vnew(length, NULL);
+	for(long long i=0;i<length;i++){
+		// n^2 mod 2N keep precision for large n
+		value=M_PI*((i*i)%(2*(long long )length))/length;
+		chirpRealArr[i]=cos(value);
+		chirpImageArr[i]=-sin(value);
+	}
+
+	// b=conj(chirp) circular
+	bRealArr=__vnew(fftLength, NULL);
+	bImageArr=__vnew(fftLength, NULL);
+	for(int i=0;i<length;i++){
+		bRealArr[i]=chirpRealArr[i];
+		bImageArr[i]=-chirpImageArr[i];
+	}
+	for(int i=1;i<length;i++){
+		bRealArr[fftLength-i]=chirpRealArr[i];
+		bImageArr[fftLength-i]=-chirpImageArr[i];
+	}
+
+	fftObj_fft(fftObj, bRealArr, bImageArr, bRealArr, bImageArr);
+
+	dftObj->fftObj=fftObj;
+	dftObj->fftLength=fftLength;
+
+	dftObj->chirpRealArr=chirpRealArr;
+	dftObj->chirpImageArr=chirpImageArr;
+
+	dftObj->bRealArr=bRealArr;
+	dftObj->bImageArr=bImageArr;
+
+	dftObj->realArr1=__vnew(fftLength, NULL);
+	dftObj->imageArr1=__vnew(fftLength, NULL);
+
+	dftObj->realArr2=__vnew(fftLength, NULL);
+	dftObj->imageArr2=__vnew(fftLength, NULL);
+}
+
+static void _dftObj_bluestein(DFTObj dftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2){
+	FFTObj fftObj=NULL;
+	int length=0;
+	int fftLength=0;
+
+	float *chirpRealArr=NULL;
+	float *chirpImageArr=NULL;
+
+	float *bRealArr=NULL;
+	float *bImageArr=NULL;
+
+	float *_realArr1=NULL;
+	float *_imageArr1=NULL;
+
+	float *_realArr2=NULL;
+	float *_imageArr2=NULL;
+
+	fftObj=dftObj->fftObj;
+	length=dftObj->length;
+	fftLength=dftObj->fftLength;
+
+	chirpRealArr=dftObj->chirpRealArr;
+	chirpImageArr=dftObj->chirpImageArr;
+
+	bRealArr=dftObj->bRealArr;
+	bImageArr=dftObj->bImageArr;
+
+	_realArr1=dftObj->realArr1;
+	_imageArr1=dftObj->imageArr1;
+
+	_realArr2=dftObj->realArr2;
+	_imageArr2=dftObj->imageArr2;
+
+	// 1. a=x*chirp, [length,fftLength) keep 0
+	for(int i=0;i<length;i++){
+		_realArr1[i]=realArr1[i]*chirpRealArr[i]-imageArr1[i]*chirpImageArr[i];
+		_imageArr1[i]=realArr1[i]*chirpImageArr[i]+imageArr1[i]*chirpRealArr[i];
 	}
 
-	for(int i=0;i<nLength1;i++){
-		for(int j=0;j<mLength2;j++){
-			double _value1=0;
-			double _value2=0;
+	// 2. ifft(fft(a)*B)
+	fftObj_fft(fftObj, _realArr1, _imageArr1, _realArr2, _imageArr2);
+	for(int i=0;i<fftLength;i++){
+		float r1=0;
+		float i1=0;
 
-			double r1=0;
-			double r2=0;
+		r1=_realArr2[i];
+		i1=_imageArr2[i];
 
-			double i1=0;
-			double i2=0;
+		_realArr2[i]=r1*bRealArr[i]-i1*bImageArr[i];
+		_imageArr2[i]=r1*bImageArr[i]+i1*bRealArr[i];
+	}
+	fftObj_ifft(fftObj, _realArr2, _imageArr2, _realArr2, _imageArr2);
+
+	// 3. X=y*chirp
+	for(int i=0;i<length;i++){
+		realArr2[i]=_realArr2[i]*chirpRealArr[i]-_imageArr2[i]*chirpImageArr[i];
+		imageArr2[i]=_realArr2[i]*chirpImageArr[i]+_imageArr2[i]*chirpRealArr[i];
+	}
+}
+
+/***
+	decimation in time, out-of-place
+	factorArr p,m => p sub dft(length m, stride fStride*p), then radix-p butterfly
+****/
+static void __dftObj_work(float *realArr1,float *imageArr1,
+						float *realArr2,float *imageArr2,
+						int fStride,int *factorArr,
+						float *wCosArr,float *wSinArr){
+	int p=0;
+	int m=0;
+
+	p=factorArr[0];
+	m=factorArr[1];
+
+	if(m==1){
+		for(int i=0;i<p;i++){
+			realArr2[i]=realArr1[i*fStride];
+			imageArr2[i]=imageArr1[i*fStride];
+		}
+	}
+	else{
+		for(int i=0;i<p;i++){
+			__dftObj_work(realArr1+i*fStride,imageArr1+i*fStride,
+						realArr2+i*m,imageArr2+i*m,
+						fStride*p,factorArr+2,
+						wCosArr,wSinArr);
+		}
+	}
+
+	if(p==4){
+		__dftObj_butterfly4(realArr2,imageArr2,fStride,m,wCosArr,wSinArr);
+	}
+	else if(p==2){
+		__dftObj_butterfly2(realArr2,imageArr2,fStride,m,wCosArr,wSinArr);
+	}
+	else if(p==3){
+		__dftObj_butterfly3(realArr2,imageArr2,fStride,m,wCosArr,wSinArr);
+	}
+	else{
+		__dftObj_butterfly5(realArr2,imageArr2,fStride,m,wCosArr,wSinArr);
+	}
+}
+
+static void __dftObj_butterfly2(float *realArr,float *imageArr,int fStride,int mLength,float *wCosArr,float *wSinArr){
+	float *realArr1=NULL;
+	float *imageArr1=NULL;
+
+	realArr1=realArr+mLength;
+	imageArr1=imageArr+mLength;
+	for(int k=0;k<mLength;k++){
+		float tr=0;
+		float ti=0;
+
+		float wr=0;
+		float wi=0;
 
-			for(int k=0;k<mLength1;k++){ // arr1.row*arr2.col
-				r1=mRealArr1[i*mLength1+k];
-				r2=mRealArr2[j+k*mLength2];
+		wr=wCosArr[k*fStride];
+		wi=wSinArr[k*fStride];
 
-				i1=mImageArr1[i*mLength1+k];
-				i2=mImageArr2[j+k*mLength2];
+		tr=realArr1[k]*wr-imageArr1[k]*wi;
+		ti=realArr1[k]*wi+imageArr1[k]*wr;
 
-				_value1+=(r1*r2-i1*i2);
-				_value2+=(i1*r2+r1*i2);
-			}
+		realArr1[k]=realArr[k]-tr;
+		imageArr1[k]=imageArr[k]-ti;
 
-			mRealArr3[i*mLength2+j]=_value1;
-			mImageArr3[i*mLength2+j]=_value2;
+		realArr[k]+=tr;
+		imageArr[k]+=ti;
+	}
+}
+
+static void __dftObj_butterfly3(float *realArr,float *imageArr,int fStride,int mLength,float *wCosArr,float *wSinArr){
+	float *realArr1=NULL;
+	float *imageArr1=NULL;
+
+	float *realArr2=NULL;
+	float *imageArr2=NULL;
+
+	float epi3=0; // imag(exp(-j*2*pi/3))
+
+	realArr1=realArr+mLength;
+	imageArr1=imageArr+mLength;
+
+	realArr2=realArr+2*mLength;
+	imageArr2=imageArr+2*mLength;
+
+	epi3=wSinArr[fStride*mLength];
+	for(int k=0;k<mLength;k++){
+		float r1=0,i1=0;
+		float r2=0,i2=0;
+
+		float r3=0,i3=0;
+		float r0=0,i0=0;
+
+		float wr=0,wi=0;
+
+		wr=wCosArr[k*fStride];
+		wi=wSinArr[k*fStride];
+		r1=realArr1[k]*wr-imageArr1[k]*wi;
+		i1=realArr1[k]*wi+imageArr1[k]*wr;
+
+		wr=wCosArr[2*k*fStride];
+		wi=wSinArr[2*k*fStride];
+		r2=realArr2[k]*wr-imageArr2[k]*wi;
+		i2=realArr2[k]*wi+imageArr2[k]*wr;
+
+		r3=r1+r2;
+		i3=i1+i2;
+
+		r0=(r1-r2)*epi3;
+		i0=(i1-i2)*epi3;
+
+		realArr1[k]=realArr[k]-r3*0.5f;
+		imageArr1[k]=imageArr[k]-i3*0.5f;
+
+		realArr[k]+=r3;
+		imageArr[k]+=i3;
+
+		realArr2[k]=realArr1[k]+i0;
+		imageArr2[k]=imageArr1[k]-r0;
+
+		realArr1[k]-=i0;
+		imageArr1[k]+=r0;
+	}
+}
+
+static void __dftObj_butterfly4(float *realArr,float *imageArr,int fStride,int mLength,float *wCosArr,float *wSinArr){
+	float *realArr1=NULL;
+	float *imageArr1=NULL;
+
+	float *realArr2=NULL;
+	float *imageArr2=NULL;
+
+	float *realArr3=NULL;
+	float *imageArr3=NULL;
+
+	realArr1=realArr+mLength;
+	imageArr1=imageArr+mLength;
+
+	realArr2=realArr+2*mLength;
+	imageArr2=imageArr+2*mLength;
+
+	realArr3=realArr+3*mLength;
+	imageArr3=imageArr+3*mLength;
+	for(int k=0;k<mLength;k++){
+		float r0=0,i0=0;
+		float r1=0,i1=0;
+		float r2=0,i2=0;
+
+		float r3=0,i3=0;
+		float r4=0,i4=0;
+		float r5=0,i5=0;
+
+		float wr=0,wi=0;
+
+		wr=wCosArr[k*fStride];
+		wi=wSinArr[k*fStride];
+		r0=realArr1[k]*wr-imageArr1[k]*wi;
+		i0=realArr1[k]*wi+imageArr1[k]*wr;
+
+		wr=wCosArr[2*k*fStride];
+		wi=wSinArr[2*k*fStride];
+		r1=realArr2[k]*wr-imageArr2[k]*wi;
+		i1=realArr2[k]*wi+imageArr2[k]*wr;
+
+		wr=wCosArr[3*k*fStride];
+		wi=wSinArr[3*k*fStride];
+		r2=realArr3[k]*wr-imageArr3[k]*wi;
+		i2=realArr3[k]*wi+imageArr3[k]*wr;
+
+		r5=realArr[k]-r1;
+		i5=imageArr[k]-i1;
+
+		realArr[k]+=r1;
+		imageArr[k]+=i1;
+
+		r3=r0+r2;
+		i3=i0+i2;
+
+		r4=r0-r2;
+		i4=i0-i2;
+
+		realArr2[k]=realArr[k]-r3;
+		imageArr2[k]=imageArr[k]-i3;
+
+		realArr[k]+=r3;
+		imageArr[k]+=i3;
+
+		realArr1[k]=r5+i4;
+		imageArr1[k]=i5-r4;
+
+		realArr3[k]=r5-i4;
+		imageArr3[k]=i5+r4;
+	}
+}
+
+static void __dftObj_butterfly5(float *realArr,float *imageArr,int fStride,int mLength,float *wCosArr,float *wSinArr){
+	float *rArr[5]={0};
+	float *iArr[5]={0};
+
+	float yar=0,yai=0; // exp(-j*2*pi/5)
+	float ybr=0,ybi=0; // exp(-j*4*pi/5)
+
+	for(int i=0;i<5;i++){
+		rArr[i]=realArr+i*mLength;
+		iArr[i]=imageArr+i*mLength;
+	}
+
+	yar=wCosArr[fStride*mLength];
+	yai=wSinArr[fStride*mLength];
+
+	ybr=wCosArr[2*fStride*mLength];
+	ybi=wSinArr[2*fStride*mLength];
+	for(int k=0;k<mLength;k++){
+		float sr[13]={0};
+		float si[13]={0};
+
+		sr[0]=rArr[0][k];
+		si[0]=iArr[0][k];
+		for(int i=1;i<5;i++){
+			float wr=0,wi=0;
+
+			wr=wCosArr[i*k*fStride];
+			wi=wSinArr[i*k*fStride];
+
+			sr[i]=rArr[i][k]*wr-iArr[i][k]*wi;
+			si[i]=rArr[i][k]*wi+iArr[i][k]*wr;
 		}
+
+		sr[7]=sr[1]+sr[4]; si[7]=si[1]+si[4];
+		sr[10]=sr[1]-sr[4]; si[10]=si[1]-si[4];
+		sr[8]=sr[2]+sr[3]; si[8]=si[2]+si[3];
+		sr[9]=sr[2]-sr[3]; si[9]=si[2]-si[3];
+
+		rArr[0][k]=sr[0]+sr[7]+sr[8];
+		iArr[0][k]=si[0]+si[7]+si[8];
+
+		sr[5]=sr[0]+sr[7]*yar+sr[8]*ybr;
+		si[5]=si[0]+si[7]*yar+si[8]*ybr;
+
+		sr[6]=si[10]*yai+si[9]*ybi;
+		si[6]=-sr[10]*yai-sr[9]*ybi;
+
+		rArr[1][k]=sr[5]-sr[6];
+		iArr[1][k]=si[5]-si[6];
+
+		rArr[4][k]=sr[5]+sr[6];
+		iArr[4][k]=si[5]+si[6];
+
+		sr[11]=sr[0]+sr[7]*ybr+sr[8]*yar;
+		si[11]=si[0]+si[7]*ybr+si[8]*yar;
+
+		sr[12]=-si[10]*ybi+si[9]*yai;
+		si[12]=sr[10]*ybi-sr[9]*yai;
+
+		rArr[2][k]=sr[11]+sr[12];
+		iArr[2][k]=si[11]+si[12];
+
+		rArr[3][k]=sr[11]-sr[12];
+		iArr[3][k]=si[11]-si[12];
 	}
 }
 
@@ -2,13 +2,13 @@
 
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
 
 #ifdef HAVE_ACCELERATE
 #include <Accelerate/Accelerate.h>
 
 #elif defined HAVE_FFTW3F
 #include <fftw3.h>
-#include <pthread.h>
 
 #elif defined HAVE_MKL
 #include <mkl.h>
@@ -16,6 +16,7 @@
 
 #endif
 
+#include "_fft_kernel.h"
 #include "fft_algorithm.h"
 
 typedef enum{
@@ -24,13 +25,23 @@ typedef enum{
 	FFTExec_FFT,
 	FFTExec_IFFT,
 
+	FFTExec_RFFT,
+	FFTExec_IRFFT,
+	FFTExec_RFFTBatch,
+
 	FFTExec_DCT,
 	FFTExec_IDCT,
 
 } FFTExecType;
 
-struct OpaqueFFT{
-	FFTExecType execType;
+typedef struct OpaqueFFTPlan *FFTPlanObj;
+
+/***
+	plan, read only after create, shared by every fftObj of same length
+	refCount guard by __planMutex
+****/
+struct OpaqueFFTPlan{
+	int refCount;
 
 	int radix2Exp; // 2 power
 	int fftLength; // length
@@ -40,32 +51,62 @@ struct OpaqueFFT{
 	float s1;
 
 	int *indexArr; // reverse order cache
+	int *indexArr2; // rfft half length reverse order cache; wLength
 
 	float *wCosArr; // fft w cache
 	float *wSinArr;
 
+	float *sCosArr1; // native radix-2^2 stage w cache; wLength
+	float *sSinArr1;
+	float *sCosArr2;
+	float *sSinArr2;
+
 	float *wCosArr1; // dct w cache; fftLength
 	float *wSinArr1;
 
-	float *realArr1; // fft input r,i cache
-	float *imageArr1;
-
-	float *realArr2; // fft output r,i cache
-	float *imageArr2;
-
-	int rFlag; // real flag
-
 	#ifdef HAVE_ACCELERATE
 	FFTSetup setup;
 
-	DSPSplitComplex inData;
-	DSPSplitComplex outData;
-
 	#elif defined HAVE_FFTW3F
 	fftwf_plan planReal; // real
 	fftwf_plan planComplex; // complex
 	fftwf_plan planInverse; // inverse
+	fftwf_plan planRealInverse; // real inverse
+
+	#elif defined HAVE_MKL
+	DFTI_DESCRIPTOR_HANDLE handleReal; // real
+	DFTI_DESCRIPTOR_HANDLE handleComplex; // complex
+	DFTI_DESCRIPTOR_HANDLE handleInverse; // inverse
+
+	#endif
+};
+
+/***
+	cached plan+default workspace
+	planObj shareable across threads, workObj/execType only for fftObj_fft...
+****/
+struct OpaqueFFT{
+	FFTExecType execType; // default workspace debug
+
+	FFTPlanObj planObj;
+	FFTWorkObj workObj; // default workspace for fftObj_fft...
+};
+
+// per thread scratch
+struct OpaqueFFTWork{
+	int fftLength;
 
+	float *realArr1; // fft input r,i cache
+	float *imageArr1;
+
+	float *realArr2; // fft output r,i cache
+	float *imageArr2;
+
+	// rfft batch plan key
+	int batchStride1;
+	int batchStride2;
+
+	#ifdef HAVE_FFTW3F
 	float *inData1;
 	fftwf_complex *outData1;
 
@@ -75,11 +116,13 @@ struct OpaqueFFT{
 	fftwf_complex *inData3;
 	fftwf_complex *outData3;
 
-	#elif defined HAVE_MKL
-	DFTI_DESCRIPTOR_HANDLE handleReal; // real
-	DFTI_DESCRIPTOR_HANDLE handleComplex; // complex
-	DFTI_DESCRIPTOR_HANDLE handleInverse; // inverse
+	fftwf_complex *inData4;
+	float *outData4;
+
+	fftwf_plan planBatch; // real batch, split output
+	float *inData5; // windowed batch frames __batchNum*fftLength
 
+	#elif defined HAVE_MKL
 	float *outData1;
 
 	MKL_Complex8 *inData2;
@@ -88,9 +131,31 @@ struct OpaqueFFT{
 	MKL_Complex8 *inData3;
 	MKL_Complex8 *outData3;
 
+	DFTI_DESCRIPTOR_HANDLE handleBatch; // real batch
+	float *inData5; // windowed batch frames __batchNum*fftLength
+	MKL_Complex8 *outData5; // __batchNum*(fftLength/2+1)
+
 	#endif
 };
 
+#if defined HAVE_FFTW3F || defined HAVE_MKL
+// rfft batch frame number, fftw/mkl multiple transforms
+static int __batchNum=8;
+#endif
+
+/***
+	process plan cache, index radix2Exp; one entry serve fft/ifft/rfft/irfft/dct
+	backend is fixed by build, so length is the whole key
+	unused entry stay cached until fftObj_clearPlanCache
+****/
+static FFTPlanObj __planArr[31];
+static pthread_mutex_t __planMutex=PTHREAD_MUTEX_INITIALIZER;
+
+#ifdef HAVE_FFTW3F
+// fftw planner is not thread safe, execute with new array is
+static pthread_mutex_t __fftwMutex=PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 static int *_createIndexArr(int n,int length);
 
 static void _createWArr(float *wCosArr,float *wSinArr,int wLength);
@@ -98,217 +163,439 @@ static void _createWArr1(float *wCosArr,float *wSinArr,int wLength);
 
 static void _vmulReal(float *realArr,float *imageArr,float *wCosArr,float *wSinArr,int length);
 
-static void _fftObj_init(FFTObj fftObj);
+#if defined HAVE_FFTW3F || defined HAVE_MKL
+// num rows of mDataArr1*windowArr => mDataArr2(stride length)
+static void __fftObj_windowRows(float *mDataArr1,int stride1,int num,float *windowArr,int length,float *mDataArr2);
+#endif
+
+static FFTPlanObj _fftPlanObj_new(int radix2Exp);
+static void _fftPlanObj_free(FFTPlanObj planObj);
+
+// flag 0 forward 1 backward; rFlag real input
+static void _fftObj_fft(FFTPlanObj planObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2,int flag,int rFlag);
+
+// real<->half spectrum fftLength/2+1
+static void _fftObj_rfft(FFTPlanObj planObj,FFTWorkObj workObj,float *dataArr1,float *realArr2,float *imageArr2);
+static void _fftObj_irfft(FFTPlanObj planObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *dataArr2);
 
-// flag 0 forward 1 backward
-static void _fftObj_fft(FFTObj fftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2,int flag);
+static void _fftObj_rfftBatch(FFTPlanObj planObj,FFTWorkObj workObj,float *mDataArr1,int stride1,int count,float *windowArr,float *mRealArr2,float *mImageArr2,int stride2);
 
 int fftObj_new(FFTObj *fftObj,int radix2Exp){
 	int status=0;
 	FFTObj fft=NULL;
 
-	int length=0;
-	int wLength=0;
+	FFTPlanObj planObj=NULL;
 
-	float s0=0;
-	float s1=0;
+	if(radix2Exp<1||radix2Exp>30){
+		status=-100;
+		return status;
+	}
 
-	float *realArr1=NULL;
-	float *imageArr1=NULL;
+	pthread_mutex_lock(&__planMutex);
 
-	float *realArr2=NULL;
-	float *imageArr2=NULL;
+	planObj=__planArr[radix2Exp];
+	if(!planObj){
+		planObj=__planArr[radix2Exp]=_fftPlanObj_new(radix2Exp);
+	}
+	planObj->refCount++;
 
-	// int *indexArr=NULL; // reverse order cache
-	// float *wCosArr=NULL; // fft w cache
-	// float *wSinArr=NULL;
+	pthread_mutex_unlock(&__planMutex);
 
-	// float *wCosArr1=NULL; // dct w cache; length
-	// float *wSinArr1=NULL;
+	fft=*fftObj=(FFTObj )calloc(1, sizeof(struct OpaqueFFT ));
 
-	if(radix2Exp<1||radix2Exp>30){
-		status=-100;
-		return status;
+	fft->planObj=planObj;
+	fftWorkObj_new(&fft->workObj, fft);
+
+	return status;
+}
+
+void fftObj_clearPlanCache(){
+
+	pthread_mutex_lock(&__planMutex);
+
+	for(int i=1;i<=30;i++){
+		if(__planArr[i]&&!__planArr[i]->refCount){
+			_fftPlanObj_free(__planArr[i]);
+			__planArr[i]=NULL;
+		}
 	}
 
-	fft=*fftObj=(FFTObj )calloc(1, sizeof(struct OpaqueFFT ));
+	pthread_mutex_unlock(&__planMutex);
+}
 
-	length=1<<radix2Exp;
-	wLength=1<<(radix2Exp-1);
+int fftObj_importWisdom(char *fileName){
+	int status=-1;
 
-	s0=sqrtf(1.0/length);
-	s1=sqrtf(2.0/length);
+	#ifdef HAVE_FFTW3F
+	pthread_mutex_lock(&__fftwMutex);
+	if(fftwf_import_wisdom_from_filename(fileName)){
+		status=0;
+	}
+	pthread_mutex_unlock(&__fftwMutex);
+	#endif
 
-	realArr1=(float *)calloc(length, sizeof(float ));
-	imageArr1=(float *)calloc(length,sizeof(float ));
+	return status;
+}
 
-	realArr2=(float *)calloc(length, sizeof(float ));
-	imageArr2=(float *)calloc(length,sizeof(float ));
+int fftObj_exportWisdom(char *fileName){
+	int status=-1;
 
-	// reverse order cache
-	// indexArr=_createIndexArr(radix2Exp, length);
+	#ifdef HAVE_FFTW3F
+	pthread_mutex_lock(&__fftwMutex);
+	if(fftwf_export_wisdom_to_filename(fileName)){
+		status=0;
+	}
+	pthread_mutex_unlock(&__fftwMutex);
+	#endif
+
+	return status;
+}
+
+int fftWorkObj_new(FFTWorkObj *fftWorkObj,FFTObj fftObj){
+	int status=0;
+	FFTWorkObj work=NULL;
+
+	int fftLength=0;
+
+	fftLength=fftObj->planObj->fftLength;
+
+	work=*fftWorkObj=(FFTWorkObj )calloc(1, sizeof(struct OpaqueFFTWork ));
+
+	work->fftLength=fftLength;
 
-	// // w cache
-	// wCosArr=(float *)calloc(wLength, sizeof(float ));
-	// wSinArr=(float *)calloc(wLength, sizeof(float ));
-	// _createWArr(wCosArr, wSinArr, wLength);
+	work->realArr1=(float *)calloc(fftLength, sizeof(float ));
+	work->imageArr1=(float *)calloc(fftLength, sizeof(float ));
 
-	// wCosArr1=(float *)calloc(length, sizeof(float ));
-	// wSinArr1=(float *)calloc(length, sizeof(float ));
-	// _createWArr1(wCosArr1, wSinArr1, length);
+	work->realArr2=(float *)calloc(fftLength, sizeof(float ));
+	work->imageArr2=(float *)calloc(fftLength, sizeof(float ));
 
-	fft->radix2Exp=radix2Exp;
-	fft->fftLength=length;
-	fft->wLength=wLength;
+	#ifdef HAVE_FFTW3F
+	// fftwf_malloc keep alignment same as plan arrays
+	work->inData1=(float *)fftwf_malloc(fftLength*sizeof(float ));
+	work->outData1=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
 
-	fft->s0=s0;
-	fft->s1=s1;
+	work->inData2=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
+	work->outData2=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
 
-	fft->realArr1=realArr1;
-	fft->imageArr1=imageArr1;
+	work->inData3=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
+	work->outData3=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
 
-	fft->realArr2=realArr2;
-	fft->imageArr2=imageArr2;
+	work->inData4=(fftwf_complex *)fftwf_malloc((fftLength/2+1)*sizeof(fftwf_complex ));
+	work->outData4=(float *)fftwf_malloc(fftLength*sizeof(float ));
 
-	// fft->indexArr=indexArr;
-	
-	// fft->wCosArr=wCosArr;
-	// fft->wSinArr=wSinArr;
+	#elif defined HAVE_MKL
+	work->outData1=(float *)calloc(fftLength+2, sizeof(float ));
+
+	work->inData2=(MKL_Complex8 *)mkl_calloc(fftLength,sizeof(MKL_Complex8 ),64);
+	work->outData2=(MKL_Complex8 *)mkl_calloc(fftLength,sizeof(MKL_Complex8 ),64);
 
-	// fft->wCosArr1=wCosArr1;
-	// fft->wSinArr1=wSinArr1;
+	work->inData3=(MKL_Complex8 *)mkl_calloc(fftLength,sizeof(MKL_Complex8 ),64);
+	work->outData3=(MKL_Complex8 *)mkl_calloc(fftLength,sizeof(MKL_Complex8 ),64);
 
-	// _fftObj_init(fft);
+	#endif
 
 	return status;
 }
 
-static void _fftObj_init(FFTObj fftObj){
-	int radix2Exp=0; // 2 power
+
+void fftWorkObj_growArr(FFTWorkObj **workObjArr,int *length,int newLength,FFTObj fftObj){
+	FFTWorkObj *arr=NULL;
+
+	if(newLength<=*length){
+		return;
+	}
+
+	arr=(FFTWorkObj *)calloc(newLength, sizeof(FFTWorkObj ));
+	if(*length){
+		memcpy(arr, *workObjArr, sizeof(FFTWorkObj )*(*length));
+	}
+	free(*workObjArr);
+
+	for(int i=*length;i<newLength;i++){
+		fftWorkObj_new(arr+i, fftObj);
+	}
+
+	*workObjArr=arr;
+	*length=newLength;
+}
+
+static FFTPlanObj _fftPlanObj_new(int radix2Exp){
+	FFTPlanObj planObj=NULL;
+
 	int fftLength=0;
+	int wLength=0;
+
+	#ifdef HAVE_FFTW3F
+	float *inData1=NULL;
+	fftwf_complex *outData1=NULL;
+	fftwf_complex *inData2=NULL;
+	fftwf_complex *outData2=NULL;
+	#endif
 
-	radix2Exp=fftObj->radix2Exp;
-	fftLength=fftObj->fftLength;
+	planObj=(FFTPlanObj )calloc(1, sizeof(struct OpaqueFFTPlan ));
+
+	fftLength=1<<radix2Exp;
+	wLength=1<<(radix2Exp-1);
+
+	planObj->radix2Exp=radix2Exp;
+	planObj->fftLength=fftLength;
+	planObj->wLength=wLength;
+
+	planObj->s0=sqrtf(1.0/fftLength);
+	planObj->s1=sqrtf(2.0/fftLength);
+
+	// dct w cache
+	planObj->wCosArr1=(float *)calloc(fftLength, sizeof(float ));
+	planObj->wSinArr1=(float *)calloc(fftLength, sizeof(float ));
+	_createWArr1(planObj->wCosArr1, planObj->wSinArr1, fftLength);
 
 	#ifdef HAVE_ACCELERATE
-	fftObj->setup=vDSP_create_fftsetup(radix2Exp,FFT_RADIX2);
+	planObj->setup=vDSP_create_fftsetup(radix2Exp,FFT_RADIX2);
 
 	#elif defined HAVE_FFTW3F
-	fftObj->inData1=(float *)fftwf_malloc(fftLength*sizeof(float ));
-	fftObj->outData1=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
+	// plan on scratch arrays, workspaces use new-array execute(same fftwf_malloc alignment)
+	inData1=(float *)fftwf_malloc(fftLength*sizeof(float ));
+	outData1=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
+	inData2=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
+	outData2=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
 
-	fftObj->planReal=fftwf_plan_dft_r2c_1d(fftLength,
-												fftObj->inData1,fftObj->outData1,
-												FFTW_ESTIMATE);
+	pthread_mutex_lock(&__fftwMutex);
 
-	fftObj->inData2=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
-	fftObj->outData2=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
+	planObj->planReal=fftwf_plan_dft_r2c_1d(fftLength,
+											inData1,outData1,
+											FFTW_ESTIMATE);
 
-	fftObj->planComplex=fftwf_plan_dft_1d(fftLength,
-										fftObj->inData2,fftObj->outData2,
+	planObj->planComplex=fftwf_plan_dft_1d(fftLength,
+										inData2,outData2,
 										FFTW_FORWARD,FFTW_ESTIMATE);
 
-	fftObj->inData3=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
-	fftObj->outData3=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
-
-	fftObj->planInverse=fftwf_plan_dft_1d(fftLength,
-										fftObj->inData3,fftObj->outData3,
+	planObj->planInverse=fftwf_plan_dft_1d(fftLength,
+										inData2,outData2,
 										FFTW_BACKWARD,FFTW_ESTIMATE);
 
+	planObj->planRealInverse=fftwf_plan_dft_c2r_1d(fftLength,
+												outData1,inData1,
+												FFTW_ESTIMATE);
+
+	pthread_mutex_unlock(&__fftwMutex);
+
+	fftwf_free(inData1);
+	fftwf_free(outData1);
+	fftwf_free(inData2);
+	fftwf_free(outData2);
+
 	#elif defined HAVE_MKL
-	DftiCreateDescriptor(&fftObj->handleReal, DFTI_SINGLE, DFTI_REAL, 1, fftLength);
-	DftiSetValue(fftObj->handleReal, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-	DftiCommitDescriptor(fftObj->handleReal);
+	DftiCreateDescriptor(&planObj->handleReal, DFTI_SINGLE, DFTI_REAL, 1, fftLength);
+	DftiSetValue(planObj->handleReal, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
+	DftiSetValue(planObj->handleReal, DFTI_BACKWARD_SCALE, 1.0/fftLength);
+	DftiCommitDescriptor(planObj->handleReal);
 
-	fftObj->outData1=(float *)calloc(fftLength+2, sizeof(float ));
+	DftiCreateDescriptor(&planObj->handleComplex, DFTI_SINGLE, DFTI_COMPLEX, 1, fftLength);
+	DftiSetValue(planObj->handleComplex, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
+	DftiCommitDescriptor(planObj->handleComplex);
 
-	DftiCreateDescriptor(&fftObj->handleComplex, DFTI_SINGLE, DFTI_COMPLEX, 1, fftLength);
-	DftiSetValue(fftObj->handleComplex, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-	DftiCommitDescriptor(fftObj->handleComplex);
+	DftiCreateDescriptor(&planObj->handleInverse, DFTI_SINGLE, DFTI_COMPLEX, 1, fftLength);
+	DftiSetValue(planObj->handleInverse, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
+	DftiSetValue(planObj->handleInverse, DFTI_BACKWARD_SCALE, 1.0/fftLength);
+	DftiCommitDescriptor(planObj->handleInverse);
 
-	fftObj->inData2=(MKL_Complex8 *)mkl_calloc(fftLength,sizeof(MKL_Complex8 ),64);
-	fftObj->outData2=(MKL_Complex8 *)mkl_calloc(fftLength,sizeof(MKL_Complex8 ),64);
+	#else
+	// reverse order cache
+	planObj->indexArr=_createIndexArr(radix2Exp, fftLength);
+	planObj->indexArr2=_createIndexArr(radix2Exp-1, wLength);
 
-	DftiCreateDescriptor(&fftObj->handleInverse, DFTI_SINGLE, DFTI_COMPLEX, 1, fftLength);
-	DftiSetValue(fftObj->handleInverse, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-	DftiSetValue(fftObj->handleInverse, DFTI_BACKWARD_SCALE, 1.0/fftLength);
-	DftiCommitDescriptor(fftObj->handleInverse);
+	// w cache
+	planObj->wCosArr=(float *)calloc(wLength, sizeof(float ));
+	planObj->wSinArr=(float *)calloc(wLength, sizeof(float ));
+	_createWArr(planObj->wCosArr, planObj->wSinArr, wLength);
 
-	fftObj->inData3=(MKL_Complex8 *)mkl_calloc(fftLength,sizeof(MKL_Complex8 ),64);
-	fftObj->outData3=(MKL_Complex8 *)mkl_calloc(fftLength,sizeof(MKL_Complex8 ),64);
+	// stage w cache
+	planObj->sCosArr1=(float *)calloc(wLength, sizeof(float ));
+	planObj->sSinArr1=(float *)calloc(wLength, sizeof(float ));
+	planObj->sCosArr2=(float *)calloc(wLength, sizeof(float ));
+	planObj->sSinArr2=(float *)calloc(wLength, sizeof(float ));
+	__fftKernel_createStageWArr(planObj->sCosArr1, planObj->sSinArr1, planObj->sCosArr2, planObj->sSinArr2, wLength);
 
 	#endif
-	
+
+	return planObj;
 }
 
-#ifdef HAVE_ACCELERATE
-static void _fftObj_fft(FFTObj fftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2,int flag){
-	int radix2Exp=0;
-	int fftLength=0;
+static void _fftPlanObj_free(FFTPlanObj planObj){
 
-	int rFlag=0;
+	free(planObj->indexArr);
+	free(planObj->indexArr2);
+
+	free(planObj->wCosArr);
+	free(planObj->wSinArr);
+
+	free(planObj->wCosArr1);
+	free(planObj->wSinArr1);
 
-	radix2Exp=fftObj->radix2Exp;
-	fftLength=fftObj->fftLength;
+	free(planObj->sCosArr1);
+	free(planObj->sSinArr1);
+	free(planObj->sCosArr2);
+	free(planObj->sSinArr2);
 
-	rFlag=fftObj->rFlag;
+	#ifdef HAVE_ACCELERATE
+	vDSP_destroy_fftsetup(planObj->setup);
+
+	#elif defined HAVE_FFTW3F
+	pthread_mutex_lock(&__fftwMutex);
 
-	if(!fftObj->setup){
-		fftObj->setup=vDSP_create_fftsetup(radix2Exp,FFT_RADIX2);
+	fftwf_destroy_plan(planObj->planReal);
+	fftwf_destroy_plan(planObj->planComplex);
+	fftwf_destroy_plan(planObj->planInverse);
+	fftwf_destroy_plan(planObj->planRealInverse);
+
+	pthread_mutex_unlock(&__fftwMutex);
+
+	#elif defined HAVE_MKL
+	DftiFreeDescriptor(&planObj->handleReal);
+	DftiFreeDescriptor(&planObj->handleComplex);
+	DftiFreeDescriptor(&planObj->handleInverse);
+
+	#endif
+
+	free(planObj);
+}
+
+#if defined HAVE_FFTW3F || defined HAVE_MKL
+static void __fftObj_windowRows(float *mDataArr1,int stride1,int num,float *windowArr,int length,float *mDataArr2){
+
+	for(int i=0;i<num;i++){
+		float *dataArr1=NULL;
+		float *dataArr2=NULL;
+
+		dataArr1=mDataArr1+i*stride1;
+		dataArr2=mDataArr2+i*length;
+		for(int j=0;j<length;j++){
+			dataArr2[j]=dataArr1[j]*windowArr[j];
+		}
 	}
+}
+#endif
+
+#ifdef HAVE_ACCELERATE
+static void _fftObj_fft(FFTPlanObj planObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2,int flag,int rFlag){
+	int radix2Exp=0;
+
+	DSPSplitComplex inData;
+	DSPSplitComplex outData;
 
-	fftObj->inData.realp=realArr1;
-	fftObj->inData.imagp=imageArr1;
+	radix2Exp=planObj->radix2Exp;
 
-	fftObj->outData.realp=realArr2;
-	fftObj->outData.imagp=imageArr2;
+	inData.realp=realArr1;
+	inData.imagp=imageArr1;
 
-	// if(rFlag){ // real to complex fft has problem !!!
-	// 	vDSP_fft_zrop(fftObj->setup,
-	// 				&fftObj->inData,1,&fftObj->outData,1,
-	// 				radix2Exp,FFT_FORWARD);
-	// }
-	// else{
-	// 	vDSP_fft_zop(fftObj->setup,
-	// 				&fftObj->inData,1,&fftObj->outData,1,
-	// 				radix2Exp,FFT_FORWARD);
-	// }
+	outData.realp=realArr2;
+	outData.imagp=imageArr2;
 
-	vDSP_fft_zop(fftObj->setup,
-				&fftObj->inData,1,&fftObj->outData,1,
+	// real to complex fft has problem !!! rFlag not use
+	vDSP_fft_zop(planObj->setup,
+				&inData,1,&outData,1,
 				radix2Exp,flag?FFT_INVERSE:FFT_FORWARD);
 
 }
 
-#elif defined HAVE_FFTW3F
-static void _fftObj_fft(FFTObj fftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2,int flag){
-	int radix2Exp=0;
+// real to complex has problem, use complex fft and keep half
+static void _fftObj_rfft(FFTPlanObj planObj,FFTWorkObj workObj,float *dataArr1,float *realArr2,float *imageArr2){
 	int fftLength=0;
 
-	int rFlag=0;
+	float *_realArr1=NULL;
+	float *_imageArr1=NULL;
 
-	radix2Exp=fftObj->radix2Exp;
-	fftLength=fftObj->fftLength;
+	float *_realArr2=NULL;
+	float *_imageArr2=NULL;
 
-	rFlag=fftObj->rFlag;
+	fftLength=planObj->fftLength;
 
-	if(rFlag&&!flag){ // real&&forward
-		if(!fftObj->planReal){
-			fftObj->inData1=(float *)fftwf_malloc(fftLength*sizeof(float ));
-			fftObj->outData1=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
+	_realArr1=workObj->realArr1;
+	_imageArr1=workObj->imageArr1;
 
-			fftObj->planReal=fftwf_plan_dft_r2c_1d(fftLength,
-												fftObj->inData1,fftObj->outData1,
-												FFTW_ESTIMATE);
+	_realArr2=workObj->realArr2;
+	_imageArr2=workObj->imageArr2;
+
+	memcpy(_realArr1, dataArr1, sizeof(float )*fftLength);
+	memset(_imageArr1, 0, sizeof(float )*fftLength);
+
+	_fftObj_fft(planObj,workObj,_realArr1,_imageArr1,_realArr2,_imageArr2,0,1);
+
+	memcpy(realArr2, _realArr2, sizeof(float )*(fftLength/2+1));
+	memcpy(imageArr2, _imageArr2, sizeof(float )*(fftLength/2+1));
+}
+
+static void _fftObj_irfft(FFTPlanObj planObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *dataArr2){
+	int fftLength=0;
+
+	float *_realArr1=NULL;
+	float *_imageArr1=NULL;
+
+	float *_realArr2=NULL;
+	float *_imageArr2=NULL;
+
+	fftLength=planObj->fftLength;
+
+	_realArr1=workObj->realArr1;
+	_imageArr1=workObj->imageArr1;
+
+	_realArr2=workObj->realArr2;
+	_imageArr2=workObj->imageArr2;
+
+	// conj hermitian spectrum
+	for(int i=0;i<=fftLength/2;i++){
+		_realArr1[i]=realArr1[i];
+		_imageArr1[i]=-imageArr1[i];
+	}
+
+	for(int i=fftLength/2+1;i<fftLength;i++){
+		_realArr1[i]=realArr1[fftLength-i];
+		_imageArr1[i]=imageArr1[fftLength-i];
+	}
+
+	_fftObj_fft(planObj,workObj,_realArr1,_imageArr1,_realArr2,_imageArr2,0,0);
+
+	for(int i=0;i<fftLength;i++){
+		dataArr2[i]=_realArr2[i]/fftLength;
+	}
+}
+
+// vDSP no real multiple transform, row by row; window multiply straight into fft input
+static void _fftObj_rfftBatch(FFTPlanObj planObj,FFTWorkObj workObj,float *mDataArr1,int stride1,int count,float *windowArr,float *mRealArr2,float *mImageArr2,int stride2){
+	int fftLength=0;
+
+	fftLength=planObj->fftLength;
+
+	for(int i=0;i<count;i++){
+		if(windowArr){
+			vDSP_vmul(mDataArr1+i*stride1,1,windowArr,1,workObj->realArr1,1,fftLength);
+			memset(workObj->imageArr1, 0, sizeof(float )*fftLength);
+
+			_fftObj_fft(planObj,workObj,workObj->realArr1,workObj->imageArr1,workObj->realArr2,workObj->imageArr2,0,1);
+
+			memcpy(mRealArr2+i*stride2, workObj->realArr2, sizeof(float )*(fftLength/2+1));
+			memcpy(mImageArr2+i*stride2, workObj->imageArr2, sizeof(float )*(fftLength/2+1));
+		}
+		else{
+			_fftObj_rfft(planObj,workObj,mDataArr1+i*stride1,mRealArr2+i*stride2,mImageArr2+i*stride2);
 		}
+	}
+}
 
-		memcpy(fftObj->inData1, realArr1, sizeof(float )*fftLength);
+#elif defined HAVE_FFTW3F
+static void _fftObj_fft(FFTPlanObj planObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2,int flag,int rFlag){
+	int fftLength=0;
+
+	fftLength=planObj->fftLength;
+
+	if(rFlag&&!flag){ // real&&forward
+		memcpy(workObj->inData1, realArr1, sizeof(float )*fftLength);
 
-		fftwf_execute(fftObj->planReal);
+		fftwf_execute_dft_r2c(planObj->planReal,workObj->inData1,workObj->outData1);
 
 		for(int i=0;i<=fftLength/2;i++){
-			realArr2[i]=fftObj->outData1[i][0];
-			imageArr2[i]=fftObj->outData1[i][1];
+			realArr2[i]=workObj->outData1[i][0];
+			imageArr2[i]=workObj->outData1[i][1];
 		}
 
 		for(int i=fftLength/2+1,j=fftLength/2-1;i<fftLength;i++,j--){
@@ -318,78 +605,164 @@ static void _fftObj_fft(FFTObj fftObj,float *realArr1,float *imageArr1,float *re
 	}
 	else{ // complex
 		if(!flag){ // forward
-			if(!fftObj->planComplex){
-				fftObj->inData2=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
-				fftObj->outData2=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
-
-				fftObj->planComplex=fftwf_plan_dft_1d(fftLength,
-													fftObj->inData2,fftObj->outData2,
-													FFTW_FORWARD,FFTW_ESTIMATE);
-			}
-
 			for(int i=0;i<fftLength;i++){
-				fftObj->inData2[i][0]=realArr1[i];
-				fftObj->inData2[i][1]=imageArr1[i];
+				workObj->inData2[i][0]=realArr1[i];
+				workObj->inData2[i][1]=imageArr1[i];
 			}
 
-			fftwf_execute(fftObj->planComplex);
+			fftwf_execute_dft(planObj->planComplex,workObj->inData2,workObj->outData2);
 
 			for(int i=0;i<fftLength;i++){
-				realArr2[i]=fftObj->outData2[i][0];
-				imageArr2[i]=fftObj->outData2[i][1];
+				realArr2[i]=workObj->outData2[i][0];
+				imageArr2[i]=workObj->outData2[i][1];
 			}
 		}
 		else{ // inverse
-			if(!fftObj->planInverse){
-				fftObj->inData3=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
-				fftObj->outData3=(fftwf_complex *)fftwf_malloc(fftLength*sizeof(fftwf_complex ));
-
-				fftObj->planInverse=fftwf_plan_dft_1d(fftLength,
-													fftObj->inData3,fftObj->outData3,
-													FFTW_BACKWARD,FFTW_ESTIMATE);
-			}
-
 			for(int i=0;i<fftLength;i++){
-				fftObj->inData3[i][0]=realArr1[i];
-				fftObj->inData3[i][1]=imageArr1[i];
+				workObj->inData3[i][0]=realArr1[i];
+				workObj->inData3[i][1]=imageArr1[i];
 			}
 
-			fftwf_execute(fftObj->planInverse);
+			fftwf_execute_dft(planObj->planInverse,workObj->inData3,workObj->outData3);
 
 			for(int i=0;i<fftLength;i++){
-				realArr2[i]=fftObj->outData3[i][0];
-				imageArr2[i]=fftObj->outData3[i][1];
+				realArr2[i]=workObj->outData3[i][0];
+				imageArr2[i]=workObj->outData3[i][1];
 			}
 		}
 	}
 }
 
-#elif defined HAVE_MKL
-static void _fftObj_fft(FFTObj fftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2,int flag){
-	int radix2Exp=0;
+static void _fftObj_rfft(FFTPlanObj planObj,FFTWorkObj workObj,float *dataArr1,float *realArr2,float *imageArr2){
 	int fftLength=0;
 
-	int rFlag=0;
+	fftLength=planObj->fftLength;
 
-	radix2Exp=fftObj->radix2Exp;
-	fftLength=fftObj->fftLength;
+	memcpy(workObj->inData1, dataArr1, sizeof(float )*fftLength);
 
-	rFlag=fftObj->rFlag;
+	fftwf_execute_dft_r2c(planObj->planReal,workObj->inData1,workObj->outData1);
 
-	if(rFlag&&!flag){ // real&&forward
-		if(!fftObj->handleReal){
-			DftiCreateDescriptor(&fftObj->handleReal, DFTI_SINGLE, DFTI_REAL, 1, fftLength);
-			DftiSetValue(fftObj->handleReal, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-			DftiCommitDescriptor(fftObj->handleReal);
+	for(int i=0;i<=fftLength/2;i++){
+		realArr2[i]=workObj->outData1[i][0];
+		imageArr2[i]=workObj->outData1[i][1];
+	}
+}
+
+static void _fftObj_irfft(FFTPlanObj planObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *dataArr2){
+	int fftLength=0;
+
+	fftLength=planObj->fftLength;
+
+	for(int i=0;i<=fftLength/2;i++){
+		workObj->inData4[i][0]=realArr1[i];
+		workObj->inData4[i][1]=imageArr1[i];
+	}
+
+	fftwf_execute_dft_c2r(planObj->planRealInverse,workObj->inData4,workObj->outData4);
+
+	for(int i=0;i<fftLength;i++){
+		dataArr2[i]=workObj->outData4[i]/fftLength;
+	}
+}
+
+/***
+	guru split r2c on __batchNum rows, read/write caller rows directly; replan when stride change
+	window: frames*window staged in inData5(stride fftLength), the only copy before execute
+****/
+static void _fftObj_rfftBatch(FFTPlanObj planObj,FFTWorkObj workObj,float *mDataArr1,int stride1,int count,float *windowArr,float *mRealArr2,float *mImageArr2,int stride2){
+	int fftLength=0;
+	int bNum=0;
+	int n=0;
+
+	float *dataArr1=NULL;
+	int _stride1=0;
+
+	fftwf_iodim dim;
+	fftwf_iodim batchDim;
+
+	fftLength=planObj->fftLength;
+	bNum=__batchNum;
+
+	_stride1=stride1;
+	if(windowArr){
+		if(!workObj->inData5){
+			workObj->inData5=(float *)fftwf_malloc(bNum*fftLength*sizeof(float ));
+		}
+
+		stride1=fftLength;
+	}
+
+	if(!workObj->planBatch||
+		workObj->batchStride1!=stride1||
+		workObj->batchStride2!=stride2){
+
+		pthread_mutex_lock(&__fftwMutex);
+
+		if(workObj->planBatch){
+			fftwf_destroy_plan(workObj->planBatch);
+		}
+
+		dim.n=planObj->fftLength;
+		dim.is=1;
+		dim.os=1;
+
+		batchDim.n=bNum;
+		batchDim.is=stride1;
+		batchDim.os=stride2;
 
-			fftObj->outData1=(float *)calloc(fftLength+2, sizeof(float ));
+		workObj->planBatch=fftwf_plan_guru_split_dft_r2c(1,&dim,1,&batchDim,
+														windowArr?workObj->inData5:mDataArr1,mRealArr2,mImageArr2,
+														FFTW_ESTIMATE|FFTW_UNALIGNED|FFTW_PRESERVE_INPUT);
+
+		pthread_mutex_unlock(&__fftwMutex);
+
+		workObj->batchStride1=stride1;
+		workObj->batchStride2=stride2;
+	}
+
+	for(n=0;n+bNum<=count;n+=bNum){
+		dataArr1=mDataArr1+n*_stride1;
+		if(windowArr){
+			__fftObj_windowRows(dataArr1,_stride1,bNum,windowArr,fftLength,workObj->inData5);
+			dataArr1=workObj->inData5;
 		}
 
-		DftiComputeForward(fftObj->handleReal, realArr1, fftObj->outData1);
+		fftwf_execute_split_dft_r2c(workObj->planBatch,
+									dataArr1,
+									mRealArr2+n*stride2,mImageArr2+n*stride2);
+	}
+
+	for(;n<count;n++){
+		dataArr1=mDataArr1+n*_stride1;
+		if(windowArr){
+			__fftObj_windowRows(dataArr1,_stride1,1,windowArr,fftLength,workObj->inData1);
+
+			fftwf_execute_dft_r2c(planObj->planReal,workObj->inData1,workObj->outData1);
+
+			for(int i=0;i<=fftLength/2;i++){
+				mRealArr2[n*stride2+i]=workObj->outData1[i][0];
+				mImageArr2[n*stride2+i]=workObj->outData1[i][1];
+			}
+		}
+		else{
+			_fftObj_rfft(planObj,workObj,dataArr1,mRealArr2+n*stride2,mImageArr2+n*stride2);
+		}
+	}
+}
+
+#elif defined HAVE_MKL
+// committed descriptor is shared, compute is thread safe
+static void _fftObj_fft(FFTPlanObj planObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2,int flag,int rFlag){
+	int fftLength=0;
+
+	fftLength=planObj->fftLength;
+
+	if(rFlag&&!flag){ // real&&forward
+		DftiComputeForward(planObj->handleReal, realArr1, workObj->outData1);
 
 		for(int i=0;i<fftLength/2+1;i++){
-			realArr2[i]=fftObj->outData1[2*i];
-			imageArr2[i]=fftObj->outData1[2*i+1];
+			realArr2[i]=workObj->outData1[2*i];
+			imageArr2[i]=workObj->outData1[2*i+1];
 		}
 
 		for(int i=fftLength/2+1;i<fftLength;i++){
@@ -399,140 +772,355 @@ static void _fftObj_fft(FFTObj fftObj,float *realArr1,float *imageArr1,float *re
 	}
 	else{ // complex
 		if(!flag){ // forward
-			if(!fftObj->handleComplex){
-				DftiCreateDescriptor(&fftObj->handleComplex, DFTI_SINGLE, DFTI_COMPLEX, 1, fftLength);
-				DftiSetValue(fftObj->handleComplex, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-				DftiCommitDescriptor(fftObj->handleComplex);
-
-				fftObj->inData2=(MKL_Complex8 *)mkl_calloc(fftLength,sizeof(MKL_Complex8 ),64);
-				fftObj->outData2=(MKL_Complex8 *)mkl_calloc(fftLength,sizeof(MKL_Complex8 ),64);
-			}
-
 			for(int i=0;i<fftLength;i++){
-				fftObj->inData2[i].real=realArr1[i];
-				fftObj->inData2[i].imag=imageArr1[i];
+				workObj->inData2[i].real=realArr1[i];
+				workObj->inData2[i].imag=imageArr1[i];
 			}
 
-			DftiComputeForward(fftObj->handleComplex, fftObj->inData2, fftObj->outData2);
+			DftiComputeForward(planObj->handleComplex, workObj->inData2, workObj->outData2);
 
 			for(int i=0;i<fftLength;i++){
-				realArr2[i]=fftObj->outData2[i].real;
-				imageArr2[i]=fftObj->outData2[i].imag;
+				realArr2[i]=workObj->outData2[i].real;
+				imageArr2[i]=workObj->outData2[i].imag;
 			}
 		}
 		else{ // inverse
-			if(!fftObj->handleInverse){
-				DftiCreateDescriptor(&fftObj->handleInverse, DFTI_SINGLE, DFTI_COMPLEX, 1, fftLength);
-				DftiSetValue(fftObj->handleInverse, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-				DftiSetValue(fftObj->handleInverse, DFTI_BACKWARD_SCALE, 1.0/fftLength);
-				DftiCommitDescriptor(fftObj->handleInverse);
-
-				fftObj->inData3=(MKL_Complex8 *)mkl_calloc(fftLength,sizeof(MKL_Complex8 ),64);
-				fftObj->outData3=(MKL_Complex8 *)mkl_calloc(fftLength,sizeof(MKL_Complex8 ),64);
+			for(int i=0;i<fftLength;i++){
+				workObj->inData3[i].real=realArr1[i];
+				workObj->inData3[i].imag=imageArr1[i];
 			}
 
+			DftiComputeBackward(planObj->handleInverse, workObj->inData3, workObj->outData3);
+
 			for(int i=0;i<fftLength;i++){
-				fftObj->inData3[i].real=realArr1[i];
-				fftObj->inData3[i].imag=imageArr1[i];
+				realArr2[i]=workObj->outData3[i].real;
+				imageArr2[i]=workObj->outData3[i].imag;
 			}
+		}
+	}
+}
 
-			DftiComputeBackward(fftObj->handleInverse, fftObj->inData3, fftObj->outData3);
+static void _fftObj_rfft(FFTPlanObj planObj,FFTWorkObj workObj,float *dataArr1,float *realArr2,float *imageArr2){
+	int fftLength=0;
 
-			for(int i=0;i<fftLength;i++){
-				realArr2[i]=fftObj->outData3[i].real;
-				imageArr2[i]=fftObj->outData3[i].imag;
+	fftLength=planObj->fftLength;
+
+	DftiComputeForward(planObj->handleReal, dataArr1, workObj->outData1);
+
+	for(int i=0;i<fftLength/2+1;i++){
+		realArr2[i]=workObj->outData1[2*i];
+		imageArr2[i]=workObj->outData1[2*i+1];
+	}
+}
+
+static void _fftObj_irfft(FFTPlanObj planObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *dataArr2){
+	int fftLength=0;
+
+	fftLength=planObj->fftLength;
+
+	// CCE in, real out
+	for(int i=0;i<fftLength/2+1;i++){
+		workObj->outData1[2*i]=realArr1[i];
+		workObj->outData1[2*i+1]=imageArr1[i];
+	}
+
+	DftiComputeBackward(planObj->handleReal, workObj->outData1, dataArr2);
+}
+
+// __batchNum transforms read caller rows directly, CCE out => split; descriptor per workspace
+static void _fftObj_rfftBatch(FFTPlanObj planObj,FFTWorkObj workObj,float *mDataArr1,int stride1,int count,float *windowArr,float *mRealArr2,float *mImageArr2,int stride2){
+	int fftLength=0;
+	int halfLength=0;
+	int bNum=0;
+	int n=0;
+
+	float *dataArr1=NULL;
+	int _stride1=0;
+
+	MKL_Complex8 *outData5=NULL;
+
+	fftLength=planObj->fftLength;
+	halfLength=fftLength/2+1;
+	bNum=__batchNum;
+
+	// window: frames*window staged in inData5(stride fftLength)
+	_stride1=stride1;
+	if(windowArr){
+		if(!workObj->inData5){
+			workObj->inData5=(float *)mkl_calloc(bNum*fftLength,sizeof(float ),64);
+		}
+
+		stride1=fftLength;
+	}
+
+	if(!workObj->handleBatch||
+		workObj->batchStride1!=stride1){
+
+		if(workObj->handleBatch){
+			DftiFreeDescriptor(&workObj->handleBatch);
+		}
+		else{
+			workObj->outData5=(MKL_Complex8 *)mkl_calloc(bNum*halfLength,sizeof(MKL_Complex8 ),64);
+		}
+
+		DftiCreateDescriptor(&workObj->handleBatch, DFTI_SINGLE, DFTI_REAL, 1, fftLength);
+		DftiSetValue(workObj->handleBatch, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
+		DftiSetValue(workObj->handleBatch, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
+		DftiSetValue(workObj->handleBatch, DFTI_NUMBER_OF_TRANSFORMS, (MKL_LONG )bNum);
+		DftiSetValue(workObj->handleBatch, DFTI_INPUT_DISTANCE, (MKL_LONG )stride1);
+		DftiSetValue(workObj->handleBatch, DFTI_OUTPUT_DISTANCE, (MKL_LONG )halfLength);
+		DftiCommitDescriptor(workObj->handleBatch);
+
+		workObj->batchStride1=stride1;
+	}
+
+	outData5=workObj->outData5;
+
+	for(n=0;n+bNum<=count;n+=bNum){
+		dataArr1=mDataArr1+n*_stride1;
+		if(windowArr){
+			__fftObj_windowRows(dataArr1,_stride1,bNum,windowArr,fftLength,workObj->inData5);
+			dataArr1=workObj->inData5;
+		}
+
+		DftiComputeForward(workObj->handleBatch, dataArr1, outData5);
+
+		for(int i=0;i<bNum;i++){
+			float *realArr2=NULL;
+			float *imageArr2=NULL;
+
+			realArr2=mRealArr2+(n+i)*stride2;
+			imageArr2=mImageArr2+(n+i)*stride2;
+			for(int j=0;j<halfLength;j++){
+				realArr2[j]=outData5[i*halfLength+j].real;
+				imageArr2[j]=outData5[i*halfLength+j].imag;
 			}
 		}
 	}
+
+	for(;n<count;n++){
+		dataArr1=mDataArr1+n*_stride1;
+		if(windowArr){
+			__fftObj_windowRows(dataArr1,_stride1,1,windowArr,fftLength,workObj->inData5);
+			dataArr1=workObj->inData5;
+		}
+
+		_fftObj_rfft(planObj,workObj,dataArr1,mRealArr2+n*stride2,mImageArr2+n*stride2);
+	}
 }
 
 #else
-static void _fftObj_fft(FFTObj fftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2,int flag){
+static void __fftObj_rfftSplit(FFTPlanObj planObj,float *_realArr,float *_imageArr,float *realArr2,float *imageArr2);
+
+static void _fftObj_fft(FFTPlanObj planObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2,int flag,int rFlag){
 	int radix2Exp=0;
 	int length=0;
-	int wLength=0;
 
 	int *indexArr=NULL; // reverse order cache
 
-	float *wCosArr=NULL; // w cache
+	radix2Exp=planObj->radix2Exp;
+	length=planObj->fftLength;
+
+	indexArr=planObj->indexArr;
+
+	// reverse
+	for(int i=0;i<length;i++){
+		realArr2[i]=realArr1[indexArr[i]];
+		imageArr2[i]=imageArr1[indexArr[i]];
+	}
+
+	__fftKernel_butterfly(realArr2,imageArr2,radix2Exp,
+						planObj->sCosArr1,planObj->sSinArr1,planObj->sCosArr2,planObj->sSinArr2);
+}
+
+/***
+	real fft by half length complex fft
+	z[n]=x[2n]+i*x[2n+1] => Z=fft(z) (length/2)
+	X[k]=(Z[k]+conj(Z[M-k]))/2+W^k*(Z[k]-conj(Z[M-k]))/(2i)
+****/
+static void _fftObj_rfft(FFTPlanObj planObj,FFTWorkObj workObj,float *dataArr1,float *realArr2,float *imageArr2){
+	int halfLength=0;
+
+	int *indexArr2=NULL;
+
+	float *_realArr=NULL;
+	float *_imageArr=NULL;
+
+	halfLength=planObj->wLength;
+
+	indexArr2=planObj->indexArr2;
+
+	_realArr=workObj->realArr2;
+	_imageArr=workObj->imageArr2;
+
+	// even/odd => complex, reverse
+	for(int i=0;i<halfLength;i++){
+		_realArr[i]=dataArr1[2*indexArr2[i]];
+		_imageArr[i]=dataArr1[2*indexArr2[i]+1];
+	}
+
+	__fftObj_rfftSplit(planObj,_realArr,_imageArr,realArr2,imageArr2);
+}
+
+// Z(reverse order) => stage kernel => X[0~length/2]
+static void __fftObj_rfftSplit(FFTPlanObj planObj,float *_realArr,float *_imageArr,float *realArr2,float *imageArr2){
+	int radix2Exp=0;
+	int halfLength=0;
+
+	float *wCosArr=NULL;
 	float *wSinArr=NULL;
 
-	int p=0; // 2 power
-	int s=0; // step
-	int w=0; // w
-	int g=0; // group
-	int b=0; // butterfly
+	radix2Exp=planObj->radix2Exp;
+	halfLength=planObj->wLength;
+
+	wCosArr=planObj->wCosArr;
+	wSinArr=planObj->wSinArr;
 
-	float wCos=0;
-	float wSin=0;
+	__fftKernel_butterfly(_realArr,_imageArr,radix2Exp-1,
+						planObj->sCosArr1,planObj->sSinArr1,planObj->sCosArr2,planObj->sSinArr2);
 
-	float tReal=0;
-	float tImage=0;
+	// split
+	realArr2[0]=_realArr[0]+_imageArr[0];
+	imageArr2[0]=0;
 
-	radix2Exp=fftObj->radix2Exp;
-	length=fftObj->fftLength;
-	wLength=fftObj->wLength;
+	realArr2[halfLength]=_realArr[0]-_imageArr[0];
+	imageArr2[halfLength]=0;
 
-	if(!fftObj->indexArr){
-		// reverse order cache
-		fftObj->indexArr=_createIndexArr(radix2Exp, length);
+	for(int k=1;k<halfLength;k++){
+		float eReal=0;
+		float eImage=0;
 
-		// w cache
-		fftObj->wCosArr=(float *)calloc(wLength, sizeof(float ));
-		fftObj->wSinArr=(float *)calloc(wLength, sizeof(float ));
-		_createWArr(fftObj->wCosArr, fftObj->wSinArr, wLength);
+		float oReal=0;
+		float oImage=0;
+
+		eReal=(_realArr[k]+_realArr[halfLength-k])/2;
+		eImage=(_imageArr[k]-_imageArr[halfLength-k])/2;
+
+		oReal=(_imageArr[k]+_imageArr[halfLength-k])/2;
+		oImage=-(_realArr[k]-_realArr[halfLength-k])/2;
+
+		realArr2[k]=eReal+wCosArr[k]*oReal-wSinArr[k]*oImage;
+		imageArr2[k]=eImage+wCosArr[k]*oImage+wSinArr[k]*oReal;
 	}
+}
 
-	indexArr=fftObj->indexArr;
+static void _fftObj_irfft(FFTPlanObj planObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *dataArr2){
+	int radix2Exp=0;
+	int halfLength=0;
 
-	wCosArr=fftObj->wCosArr;
-	wSinArr=fftObj->wSinArr;
+	int *indexArr2=NULL;
 
-	// reverse
-	for(int i=0;i<length;i++){
-		realArr2[i]=realArr1[indexArr[i]];
-		imageArr2[i]=imageArr1[indexArr[i]];
+	float *wCosArr=NULL;
+	float *wSinArr=NULL;
+
+	float *_realArr=NULL;
+	float *_imageArr=NULL;
+
+	radix2Exp=planObj->radix2Exp;
+	halfLength=planObj->wLength;
+
+	indexArr2=planObj->indexArr2;
+
+	wCosArr=planObj->wCosArr;
+	wSinArr=planObj->wSinArr;
+
+	_realArr=workObj->realArr2;
+	_imageArr=workObj->imageArr2;
+
+	// merge => Z, conj for inverse, reverse
+	for(int k=0;k<halfLength;k++){
+		float eReal=0;
+		float eImage=0;
+
+		float dReal=0;
+		float dImage=0;
+
+		float oReal=0;
+		float oImage=0;
+
+		eReal=(realArr1[k]+realArr1[halfLength-k])/2;
+		eImage=(imageArr1[k]-imageArr1[halfLength-k])/2;
+
+		dReal=(realArr1[k]-realArr1[halfLength-k])/2;
+		dImage=(imageArr1[k]+imageArr1[halfLength-k])/2;
+
+		oReal=dReal*wCosArr[k]+dImage*wSinArr[k];
+		oImage=dImage*wCosArr[k]-dReal*wSinArr[k];
+
+		_realArr[indexArr2[k]]=eReal-oImage;
+		_imageArr[indexArr2[k]]=-(eImage+oReal);
 	}
 
-	// butterfly algorithm
-	for(p=1;p<=radix2Exp;p++){
-		s=1<<(p-1);
+	__fftKernel_butterfly(_realArr,_imageArr,radix2Exp-1,
+						planObj->sCosArr1,planObj->sSinArr1,planObj->sCosArr2,planObj->sSinArr2);
 
-		for(g=0;g<=s-1;g++){
-			w=g*(1<<(radix2Exp-p));
-			wCos=wCosArr[w];
-			wSin=wSinArr[w];
+	for(int i=0;i<halfLength;i++){
+		dataArr2[2*i]=_realArr[i]/halfLength;
+		dataArr2[2*i+1]=-_imageArr[i]/halfLength;
+	}
+}
 
-			for(b=g;b<=length-1;b=b+(1<<p)){
-				tReal=realArr2[b+s]*wCos-imageArr2[b+s]*wSin;
-				tImage=realArr2[b+s]*wSin+imageArr2[b+s]*wCos;
+/***
+	row by row through the stage kernel(SIMD), frame in cache for the whole transform
+	window applied in the gather, no extra pass
+****/
+static void _fftObj_rfftBatch(FFTPlanObj planObj,FFTWorkObj workObj,float *mDataArr1,int stride1,int count,float *windowArr,float *mRealArr2,float *mImageArr2,int stride2){
+	int halfLength=0;
 
-				realArr2[b+s]=realArr2[b]-tReal;
-				imageArr2[b+s]=imageArr2[b]-tImage;
+	int *indexArr2=NULL;
 
-				realArr2[b]=realArr2[b]+tReal;
-				imageArr2[b]=imageArr2[b]+tImage;
+	float *_realArr=NULL;
+	float *_imageArr=NULL;
 
-			}
+	if(!windowArr){
+		for(int n=0;n<count;n++){
+			_fftObj_rfft(planObj,workObj,mDataArr1+n*stride1,mRealArr2+n*stride2,mImageArr2+n*stride2);
 		}
+
+		return;
+	}
+
+	halfLength=planObj->wLength;
+
+	indexArr2=planObj->indexArr2;
+
+	_realArr=workObj->realArr2;
+	_imageArr=workObj->imageArr2;
+	for(int n=0;n<count;n++){
+		float *dataArr1=NULL;
+
+		dataArr1=mDataArr1+n*stride1;
+
+		// even/odd => complex, reverse
+		for(int i=0;i<halfLength;i++){
+			int j=0;
+
+			j=2*indexArr2[i];
+			_realArr[i]=dataArr1[j]*windowArr[j];
+			_imageArr[i]=dataArr1[j+1]*windowArr[j+1];
+		}
+
+		__fftObj_rfftSplit(planObj,_realArr,_imageArr,mRealArr2+n*stride2,mImageArr2+n*stride2);
 	}
 }
 
 #endif
 
-void fftObj_fft(FFTObj fftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2){
+
+void fftObj_fftWork(FFTObj fftObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2){
 	int length=0;
+	int rFlag=0;
 
 	float *_realArr1=NULL;
 	float *_imageArr1=NULL;
 
-	length=fftObj->fftLength;
+	length=fftObj->planObj->fftLength;
 
-	_realArr1=fftObj->realArr1;
-	_imageArr1=fftObj->imageArr1;
+	_realArr1=workObj->realArr1;
+	_imageArr1=workObj->imageArr1;
 
 	if(realArr1&&!imageArr1){
-		fftObj->rFlag=1;
+		rFlag=1;
 	}
 
 	// ???
@@ -550,26 +1138,19 @@ void fftObj_fft(FFTObj fftObj,float *realArr1,float *imageArr1,float *realArr2,f
 		memset(_imageArr1, 0, sizeof(float )*length);
 	}
 
-	_fftObj_fft(fftObj,_realArr1,_imageArr1,realArr2,imageArr2,0);
-
-	fftObj->execType=FFTExec_FFT;
-	fftObj->rFlag=0;
+	_fftObj_fft(fftObj->planObj,workObj,_realArr1,_imageArr1,realArr2,imageArr2,0,rFlag);
 }
 
-void fftObj_ifft(FFTObj fftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2){
+void fftObj_ifftWork(FFTObj fftObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2){
 	int length=0;
 
 	float *_realArr1=NULL;
 	float *_imageArr1=NULL;
 
-	length=fftObj->fftLength;
+	length=fftObj->planObj->fftLength;
 
-	_realArr1=fftObj->realArr1;
-	_imageArr1=fftObj->imageArr1;
-
-	// if(realArr1&&!imageArr1){
-	// 	fftObj->rFlag=1;
-	// }
+	_realArr1=workObj->realArr1;
+	_imageArr1=workObj->imageArr1;
 
 	// ???
 	if(realArr1){
@@ -586,43 +1167,47 @@ void fftObj_ifft(FFTObj fftObj,float *realArr1,float *imageArr1,float *realArr2,
 		memset(_imageArr1, 0, sizeof(float )*length);
 	}
 
-	// #ifdef HAVE_ACCELERATE
-	// _fftObj_fft(fftObj,_realArr1,_imageArr1,realArr2,imageArr2,1);
+	for(int i=0;i<length;i++){
+		_imageArr1[i]=-_imageArr1[i];
+	}
 
-	// #elif defined HAVE_FFTW3F
-	// _fftObj_fft(fftObj,_realArr1,_imageArr1,realArr2,imageArr2,1);
+	_fftObj_fft(fftObj->planObj,workObj,_realArr1,_imageArr1,realArr2,imageArr2,0,0);
 
-	// #else
+	for(int i=0;i<length;i++){
+		realArr2[i]=realArr2[i]/length;
+		imageArr2[i]=-imageArr2[i]/length;
+	}
+}
 
-	// for(int i=0;i<length;i++){
-	// 	_imageArr1[i]=-_imageArr1[i];
-	// }
+void fftObj_rfftWork(FFTObj fftObj,FFTWorkObj workObj,float *dataArr1,float *realArr2,float *imageArr2){
 
-	// _fftObj_fft(fftObj,_realArr1,_imageArr1,realArr2,imageArr2,1);
+	_fftObj_rfft(fftObj->planObj,workObj,dataArr1,realArr2,imageArr2);
+}
 
-	// for(int i=0;i<length;i++){
-	// 	realArr2[i]=realArr2[i]/length;
-	// 	imageArr2[i]=-imageArr2[i]/length;
-	// }
+void fftObj_irfftWork(FFTObj fftObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *dataArr2){
 
-	// #endif
+	_fftObj_irfft(fftObj->planObj,workObj,realArr1,imageArr1,dataArr2);
+}
 
-	for(int i=0;i<length;i++){
-		_imageArr1[i]=-_imageArr1[i];
+void fftObj_rfftBatchWork(FFTObj fftObj,FFTWorkObj workObj,float *mDataArr1,int stride1,int count,float *mRealArr2,float *mImageArr2,int stride2){
+
+	if(count<1){
+		return;
 	}
 
-	_fftObj_fft(fftObj,_realArr1,_imageArr1,realArr2,imageArr2,0);
+	_fftObj_rfftBatch(fftObj->planObj,workObj,mDataArr1,stride1,count,NULL,mRealArr2,mImageArr2,stride2);
+}
+
+void fftObj_rfftBatchWindowWork(FFTObj fftObj,FFTWorkObj workObj,float *mDataArr1,int stride1,int count,float *windowArr,float *mRealArr2,float *mImageArr2,int stride2){
 
-	for(int i=0;i<length;i++){
-		realArr2[i]=realArr2[i]/length;
-		imageArr2[i]=-imageArr2[i]/length;
+	if(count<1){
+		return;
 	}
 
-	fftObj->execType=FFTExec_IFFT;
-	fftObj->rFlag=0;
+	_fftObj_rfftBatch(fftObj->planObj,workObj,mDataArr1,stride1,count,windowArr,mRealArr2,mImageArr2,stride2);
 }
 
-void fftObj_dct(FFTObj fftObj,float *dataArr1,float *dataArr2,int isNorm){
+void fftObj_dctWork(FFTObj fftObj,FFTWorkObj workObj,float *dataArr1,float *dataArr2,int isNorm){
 	int length=0;
 
 	float *wCosArr1=NULL;
@@ -631,27 +1216,17 @@ void fftObj_dct(FFTObj fftObj,float *dataArr1,float *dataArr2,int isNorm){
 	float *_realArr1=NULL;
 	float *_imageArr1=NULL;
 
-	float *_realArr2=NULL;
 	float *_imageArr2=NULL;
 
-	length=fftObj->fftLength;
-
-	if(!fftObj->wCosArr1){
-		fftObj->wCosArr1=(float *)calloc(length, sizeof(float ));
-		fftObj->wSinArr1=(float *)calloc(length, sizeof(float ));
-		_createWArr1(fftObj->wCosArr1, fftObj->wSinArr1, length);
-	}
-
-	wCosArr1=fftObj->wCosArr1;
-	wSinArr1=fftObj->wSinArr1;
+	length=fftObj->planObj->fftLength;
 
-	_realArr1=fftObj->realArr1;
-	_imageArr1=fftObj->imageArr1;
+	wCosArr1=fftObj->planObj->wCosArr1;
+	wSinArr1=fftObj->planObj->wSinArr1;
 
-	_realArr2=fftObj->realArr2;
-	_imageArr2=fftObj->imageArr2;
+	_realArr1=workObj->realArr1;
+	_imageArr1=workObj->imageArr1;
 
-	fftObj->rFlag=1;
+	_imageArr2=workObj->imageArr2;
 
 	memset(_imageArr1,0,sizeof(float )*length);
 	for(int i=0;i<length/2;i++){
@@ -659,21 +1234,18 @@ void fftObj_dct(FFTObj fftObj,float *dataArr1,float *dataArr2,int isNorm){
 		_realArr1[length-1-i]=dataArr1[i*2+1];
 	}
 
-	_fftObj_fft(fftObj,_realArr1,_imageArr1,dataArr2,_imageArr2, 0);
+	_fftObj_fft(fftObj->planObj,workObj,_realArr1,_imageArr1,dataArr2,_imageArr2,0,1);
 	_vmulReal(dataArr2,_imageArr2,wCosArr1,wSinArr1,length);
 
 	if(isNorm){
-		dataArr2[0]=dataArr2[0]*fftObj->s0;
+		dataArr2[0]=dataArr2[0]*fftObj->planObj->s0;
 		for(int i=1;i<length;i++){
-			dataArr2[i]=dataArr2[i]*fftObj->s1;
+			dataArr2[i]=dataArr2[i]*fftObj->planObj->s1;
 		}
 	}
-
-	fftObj->execType=FFTExec_DCT;
-	fftObj->rFlag=0;
 }
 
-void fftObj_idct(FFTObj fftObj,float *dataArr1,float *dataArr2,int isNorm){
+void fftObj_idctWork(FFTObj fftObj,FFTWorkObj workObj,float *dataArr1,float *dataArr2,int isNorm){
 	int length=0;
 
 	float *wCosArr1=NULL;
@@ -685,50 +1257,95 @@ void fftObj_idct(FFTObj fftObj,float *dataArr1,float *dataArr2,int isNorm){
 	float *_realArr2=NULL;
 	float *_imageArr2=NULL;
 
-	length=fftObj->fftLength;
+	length=fftObj->planObj->fftLength;
 
-	if(!fftObj->wCosArr1){
-		fftObj->wCosArr1=(float *)calloc(length, sizeof(float ));
-		fftObj->wSinArr1=(float *)calloc(length, sizeof(float ));
-		_createWArr1(fftObj->wCosArr1, fftObj->wSinArr1, length);
-	}
+	wCosArr1=fftObj->planObj->wCosArr1;
+	wSinArr1=fftObj->planObj->wSinArr1;
 
-	wCosArr1=fftObj->wCosArr1;
-	wSinArr1=fftObj->wSinArr1;
+	_realArr1=workObj->realArr1;
+	_imageArr1=workObj->imageArr1;
 
-	_realArr1=fftObj->realArr1;
-	_imageArr1=fftObj->imageArr1;
-
-	_realArr2=fftObj->realArr2;
-	_imageArr2=fftObj->imageArr2;
+	_realArr2=workObj->realArr2;
+	_imageArr2=workObj->imageArr2;
 
 	if(isNorm){
-		dataArr1[0]/=fftObj->s0;
+		dataArr1[0]/=fftObj->planObj->s0;
 		for(int i=1;i<length;i++){
-			dataArr1[i]/=fftObj->s1;
+			dataArr1[i]/=fftObj->planObj->s1;
 		}
 	}
 
 	dataArr1[0]/=2;
 	for(int i=0;i<length;i++){
-		dataArr1[i]/=fftObj->wLength;
+		dataArr1[i]/=fftObj->planObj->wLength;
 		_realArr1[i]=dataArr1[i]*wCosArr1[i];
 		_imageArr1[i]=dataArr1[i]*wSinArr1[i];
 	}
 
-	_fftObj_fft(fftObj,_realArr1,_imageArr1,_realArr2,_imageArr2,0);
+	_fftObj_fft(fftObj->planObj,workObj,_realArr1,_imageArr1,_realArr2,_imageArr2,0,0);
 
 	for(int i=0;i<length/2;i++){
 		dataArr2[i*2]=_realArr2[i];
 		dataArr2[i*2+1]=_realArr2[length-1-i];
 	}
+}
+
+void fftObj_fft(FFTObj fftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2){
+
+	fftObj_fftWork(fftObj,fftObj->workObj,realArr1,imageArr1,realArr2,imageArr2);
+
+	fftObj->execType=FFTExec_FFT;
+}
+
+void fftObj_ifft(FFTObj fftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2){
+
+	fftObj_ifftWork(fftObj,fftObj->workObj,realArr1,imageArr1,realArr2,imageArr2);
+
+	fftObj->execType=FFTExec_IFFT;
+}
+
+void fftObj_rfft(FFTObj fftObj,float *dataArr1,float *realArr2,float *imageArr2){
+
+	_fftObj_rfft(fftObj->planObj,fftObj->workObj,dataArr1,realArr2,imageArr2);
+
+	fftObj->execType=FFTExec_RFFT;
+}
+
+void fftObj_irfft(FFTObj fftObj,float *realArr1,float *imageArr1,float *dataArr2){
+
+	_fftObj_irfft(fftObj->planObj,fftObj->workObj,realArr1,imageArr1,dataArr2);
+
+	fftObj->execType=FFTExec_IRFFT;
+}
+
+void fftObj_rfftBatch(FFTObj fftObj,float *mDataArr1,int stride1,int count,float *mRealArr2,float *mImageArr2,int stride2){
+
+	if(count<1){
+		return;
+	}
+
+	_fftObj_rfftBatch(fftObj->planObj,fftObj->workObj,mDataArr1,stride1,count,NULL,mRealArr2,mImageArr2,stride2);
+
+	fftObj->execType=FFTExec_RFFTBatch;
+}
+
+void fftObj_dct(FFTObj fftObj,float *dataArr1,float *dataArr2,int isNorm){
+
+	fftObj_dctWork(fftObj,fftObj->workObj,dataArr1,dataArr2,isNorm);
+
+	fftObj->execType=FFTExec_DCT;
+}
+
+void fftObj_idct(FFTObj fftObj,float *dataArr1,float *dataArr2,int isNorm){
+
+	fftObj_idctWork(fftObj,fftObj->workObj,dataArr1,dataArr2,isNorm);
 
 	fftObj->execType=FFTExec_IDCT;
 }
 
 int fftObj_getFFTLength(FFTObj fftObj){
 
-	return fftObj->fftLength;
+	return fftObj->planObj->fftLength;
 }
 
 void fftObj_debug(FFTObj fftObj){
@@ -736,10 +1353,10 @@ void fftObj_debug(FFTObj fftObj){
 	float *imageArr2=NULL;
 	int length=0;
 
-	length=fftObj->fftLength;
+	length=fftObj->planObj->fftLength;
 
-	realArr2=fftObj->realArr2;
-	imageArr2=fftObj->imageArr2;
+	realArr2=fftObj->workObj->realArr2;
+	imageArr2=fftObj->workObj->imageArr2;
 
 	if(fftObj->execType!=FFTExec_None){
 		if(fftObj->execType==FFTExec_FFT){
@@ -748,6 +1365,15 @@ void fftObj_debug(FFTObj fftObj){
 		else if(fftObj->execType==FFTExec_IFFT){
 			printf("ifft ");
 		}
+		else if(fftObj->execType==FFTExec_RFFT){
+			printf("rfft ");
+		}
+		else if(fftObj->execType==FFTExec_IRFFT){
+			printf("irfft ");
+		}
+		else if(fftObj->execType==FFTExec_RFFTBatch){
+			printf("rfft batch ");
+		}
 		else if(fftObj->execType==FFTExec_DCT){
 			printf("dct ");
 		}
@@ -762,84 +1388,71 @@ void fftObj_debug(FFTObj fftObj){
 	}
 }
 
-void fftObj_free(FFTObj fftObj){
-	int *indexArr=NULL; // reverse order cache
-
-	float *wCosArr=NULL; // w cache
-	float *wSinArr=NULL;
+void fftWorkObj_free(FFTWorkObj fftWorkObj){
 
-	float *wCosArr1=NULL;
-	float *wSinArr1=NULL;
-
-	float *realArr1=NULL;
-	float *imageArr1=NULL;
-
-	float *realArr2=NULL;
-	float *imageArr2=NULL;
-
-	if(!fftObj){
+	if(!fftWorkObj){
 		return;
 	}
 
-	indexArr=fftObj->indexArr;
-
-	wCosArr=fftObj->wCosArr;
-	wSinArr=fftObj->wSinArr;
+	free(fftWorkObj->realArr1);
+	free(fftWorkObj->imageArr1);
 
-	wCosArr1=fftObj->wCosArr1;
-	wSinArr1=fftObj->wSinArr1;
+	free(fftWorkObj->realArr2);
+	free(fftWorkObj->imageArr2);
 
-	realArr1=fftObj->realArr1;
-	imageArr1=fftObj->imageArr1;
+	#ifdef HAVE_FFTW3F
+	fftwf_free(fftWorkObj->inData1);
+	fftwf_free(fftWorkObj->outData1);
 
-	realArr2=fftObj->realArr2;
-	imageArr2=fftObj->imageArr2;
+	fftwf_free(fftWorkObj->inData2);
+	fftwf_free(fftWorkObj->outData2);
 
-	free(indexArr);
+	fftwf_free(fftWorkObj->inData3);
+	fftwf_free(fftWorkObj->outData3);
 
-	free(wCosArr);
-	free(wSinArr);
+	fftwf_free(fftWorkObj->inData4);
+	fftwf_free(fftWorkObj->outData4);
 
-	free(wCosArr1);
-	free(wSinArr1);
+	fftwf_free(fftWorkObj->inData5);
 
-	free(realArr1);
-	free(imageArr1);
+	if(fftWorkObj->planBatch){
+		pthread_mutex_lock(&__fftwMutex);
+		fftwf_destroy_plan(fftWorkObj->planBatch);
+		pthread_mutex_unlock(&__fftwMutex);
+	}
 
-	free(realArr2);
-	free(imageArr2);
+	#elif defined HAVE_MKL
+	free(fftWorkObj->outData1);
 
-	#ifdef HAVE_ACCELERATE
-	vDSP_destroy_fftsetup(fftObj->setup);
+	mkl_free(fftWorkObj->inData2);
+	mkl_free(fftWorkObj->outData2);
 
-	#elif defined HAVE_FFTW3F
-	fftwf_destroy_plan(fftObj->planReal);
-	fftwf_destroy_plan(fftObj->planComplex);
-	fftwf_destroy_plan(fftObj->planInverse);
+	mkl_free(fftWorkObj->inData3);
+	mkl_free(fftWorkObj->outData3);
 
-	fftwf_free(fftObj->inData1);
-	fftwf_free(fftObj->outData1);
-
-	fftwf_free(fftObj->inData2);
-	fftwf_free(fftObj->outData2);
+	if(fftWorkObj->handleBatch){
+		DftiFreeDescriptor(&fftWorkObj->handleBatch);
+	}
+	mkl_free(fftWorkObj->inData5);
+	mkl_free(fftWorkObj->outData5);
 
-	fftwf_free(fftObj->inData3);
-	fftwf_free(fftObj->outData3);
+	#endif
 
-	#elif defined HAVE_MKL
-	DftiFreeDescriptor(&fftObj->handleReal);
-	DftiFreeDescriptor(&fftObj->handleComplex);
-	DftiFreeDescriptor(&fftObj->handleInverse);
+	free(fftWorkObj);
+}
 
-	free(fftObj->outData1);
+void fftObj_free(FFTObj fftObj){
 
-	mkl_free(fftObj->inData2);
-	mkl_free(fftObj->outData2);
+	if(!fftObj){
+		return;
+	}
 
-	mkl_free(fftObj->inData3);
-	mkl_free(fftObj->outData3);
+	fftWorkObj_free(fftObj->workObj);
 
-	#endif
+	// plan stay in cache
+	pthread_mutex_lock(&__planMutex);
+	fftObj->planObj->refCount--;
+	pthread_mutex_unlock(&__planMutex);
 
 	free(fftObj);
 }
@@ -18,16 +18,58 @@ typedef enum{
 } FFTError;
 
 typedef struct OpaqueFFT *FFTObj;
+typedef struct OpaqueFFTWork *FFTWorkObj;
 
+// plan(twiddle/reverse table/backend plan) from process cache, shared by same radix2Exp
 int fftObj_new(FFTObj *fftObj,int radix2Exp);
 
+// free cached plans no fftObj use
+void fftObj_clearPlanCache();
+
+// fftw wisdom file; 0 success, -1 fail or not fftw
+int fftObj_importWisdom(char *fileName);
+int fftObj_exportWisdom(char *fileName);
+
+/***
+	FFTObj is read only after new, one plan can be shared by threads
+	each thread use own FFTWorkObj(same fftObj) with *Work functions
+	fftObj_fft... use fftObj internal workspace, not reentrant
+****/
+int fftWorkObj_new(FFTWorkObj *fftWorkObj,FFTObj fftObj);
+void fftWorkObj_free(FFTWorkObj fftWorkObj);
+
+// per thread workspace array, grow *workObjArr from *length to newLength
+void fftWorkObj_growArr(FFTWorkObj **workObjArr,int *length,int newLength,FFTObj fftObj);
+
 int fftObj_getFFTLength(FFTObj fftObj);
 
 void fftObj_fft(FFTObj fftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2);
 void fftObj_ifft(FFTObj fftObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2);
+
+// real input; realArr2/imageArr2 fftLength/2+1
+void fftObj_rfft(FFTObj fftObj,float *dataArr1,float *realArr2,float *imageArr2);
+// realArr1/imageArr1 fftLength/2+1; dataArr2 fftLength
+void fftObj_irfft(FFTObj fftObj,float *realArr1,float *imageArr1,float *dataArr2);
+
+// real input batch; row i at mDataArr1+i*stride1(may overlap), half spectrum row i at mRealArr2+i*stride2
+void fftObj_rfftBatch(FFTObj fftObj,float *mDataArr1,int stride1,int count,float *mRealArr2,float *mImageArr2,int stride2);
+
 void fftObj_dct(FFTObj fftObj,float *dataArr1,float *dataArr2,int isNorm);
 void fftObj_idct(FFTObj fftObj,float *dataArr1,float *dataArr2,int isNorm);
 
+void fftObj_fftWork(FFTObj fftObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2);
+void fftObj_ifftWork(FFTObj fftObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *realArr2,float *imageArr2);
+
+void fftObj_rfftWork(FFTObj fftObj,FFTWorkObj workObj,float *dataArr1,float *realArr2,float *imageArr2);
+void fftObj_irfftWork(FFTObj fftObj,FFTWorkObj workObj,float *realArr1,float *imageArr1,float *dataArr2);
+
+void fftObj_rfftBatchWork(FFTObj fftObj,FFTWorkObj workObj,float *mDataArr1,int stride1,int count,float *mRealArr2,float *mImageArr2,int stride2);
+// count frames*windowArr(fftLength), window applied while loading fft input, no alloc after first call
+void fftObj_rfftBatchWindowWork(FFTObj fftObj,FFTWorkObj workObj,float *mDataArr1,int stride1,int count,float *windowArr,float *mRealArr2,float *mImageArr2,int stride2);
+
+void fftObj_dctWork(FFTObj fftObj,FFTWorkObj workObj,float *dataArr1,float *dataArr2,int isNorm);
+void fftObj_idctWork(FFTObj fftObj,FFTWorkObj workObj,float *dataArr1,float *dataArr2,int isNorm);
+
 void fftObj_free(FFTObj fftObj);
 void fftObj_debug(FFTObj fftObj);
 
@@ -51,23 +51,25 @@ void correct_rect(float cur,float left,float right,float *det,float *value){
 		_det-=1;
 	}
 
-	// 2. value计算
-	if(_det>=0){
-		n=floorf(_det);
-	}
-	else{
-		n=ceilf(_det);
-	}
-	s=_det-n;
+	// 2. value计算, det only skip
+	if(value){
+		if(_det>=0){
+			n=floorf(_det);
+		}
+		else{
+			n=ceilf(_det);
+		}
+		s=_det-n;
 	
-	if(fabs(s)<1e-8){
-		s=1e-8;
-	}
+		if(fabs(s)<1e-8){
+			s=1e-8;
+		}
 
-	c1=n+s;
-	c2=M_PI*c1/sinf(M_PI*c1);
+		c1=n+s;
+		c2=M_PI*c1/sinf(M_PI*c1);
 
-	_value=cur*c2;
+		_value=cur*c2;
+	}
 
 	if(det){
 		*det=_det;
@@ -121,23 +123,25 @@ void correct_hann(float cur,float left,float right,float *det,float *value){
 		_det-=1;
 	}
 
-	// 2. value计算
-	if(_det>=0){
-		n=floorf(_det);
-	}
-	else{
-		n=ceilf(_det);
-	}
-	s=_det-n;
+	// 2. value计算, det only skip
+	if(value){
+		if(_det>=0){
+			n=floorf(_det);
+		}
+		else{
+			n=ceilf(_det);
+		}
+		s=_det-n;
 	
-	if(fabs(s)<1e-8){
-		s=1e-8;
-	}
+		if(fabs(s)<1e-8){
+			s=1e-8;
+		}
 
-	c1=n+s;
-	c2=M_PI*c1/sinf(M_PI*c1);
+		c1=n+s;
+		c2=M_PI*c1/sinf(M_PI*c1);
 
-	_value=cur*c2*(1-c1*c1)*2;
+		_value=cur*c2*(1-c1*c1)*2;
+	}
 
 	if(det){
 		*det=_det;
@@ -194,23 +198,25 @@ void correct_hamm(float cur,float left,float right,float *det,float *value){
 		_det-=1;
 	}
 
-	// 2. value计算
-	if(_det>=0){
-		n=floorf(_det);
-	}
-	else{
-		n=ceilf(_det);
-	}
-	s=_det-n;
+	// 2. value计算, det only skip
+	if(value){
+		if(_det>=0){
+			n=floorf(_det);
+		}
+		else{
+			n=ceilf(_det);
+		}
+		s=_det-n;
 	
-	if(fabs(s)<1e-8){
-		s=1e-8;
-	}
+		if(fabs(s)<1e-8){
+			s=1e-8;
+		}
 
-	c1=n+s;
-	c2=M_PI*c1/sinf(M_PI*c1);
+		c1=n+s;
+		c2=M_PI*c1/sinf(M_PI*c1);
 
-	_value=cur*c2*(1-c1*c1)/(0.54-0.08*c1*c1);
+		_value=cur*c2*(1-c1*c1)/(0.54-0.08*c1*c1);
+	}
 
 	if(det){
 		*det=_det;
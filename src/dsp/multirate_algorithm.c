@@ -0,0 +1,377 @@
+//
+
+#include <string.h>
+#include <math.h>
+
+#include "../vector/flux_vector.h"
+#include "../vector/_math_kernel.h"
+
+#include "flux_window.h"
+#include "multirate_algorithm.h"
+
+struct OpaqueMultirate{
+	int factor;
+	int zeroNum;
+	int isScale;
+
+	int padLength; // each side of phase data
+
+	// phase p taps, decimate h[q*factor+p] q>=startArr1[p]; interpolate factor*h[p-k*factor] k>=startArr2[p]
+	float *coefArr1; // factor*coefLength
+	int *startArr1;
+	int *lengthArr1;
+
+	float *coefArr2;
+	int *startArr2;
+	int *lengthArr2;
+
+	int coefLength; // 2*zeroNum+1
+
+	float *cacheArr; // phase data, interpolate padded data+phase result
+	int cacheLength;
+	int workCacheLength; // >0 cacheArr in caller workspace, capacity
+};
+
+static void _multirateObj_dealCoef(MultirateObj multirateObj,float beta);
+static float *_multirateObj_dealCache(MultirateObj multirateObj,int length);
+// decimate/interpolate cache length bound for dataLength
+static int __multirateObj_calCacheLength(MultirateObj multirateObj,int dataLength);
+
+int multirateObj_new(MultirateObj *multirateObj,int *factor,int *zeroNum,float *beta,int *isScale){
+	int status=0;
+	MultirateObj mulObj=NULL;
+
+	int _factor=2;
+	int _zeroNum=16;
+	float _beta=8.5555046;
+	int _isScale=0;
+
+	if(factor){
+		if(*factor>1){
+			_factor=*factor;
+		}
+	}
+
+	if(zeroNum){
+		if(*zeroNum>0){
+			_zeroNum=*zeroNum;
+		}
+	}
+
+	if(beta){
+		if(*beta>0){
+			_beta=*beta;
+		}
+	}
+
+	if(isScale){
+		_isScale=*isScale;
+	}
+
+	mulObj=*multirateObj=(MultirateObj )calloc(1, sizeof(struct OpaqueMultirate ));
+
+	mulObj->factor=_factor;
+	mulObj->zeroNum=_zeroNum;
+	mulObj->isScale=_isScale;
+
+	mulObj->padLength=_zeroNum+1;
+	mulObj->coefLength=2*_zeroNum+1;
+
+	_multirateObj_dealCoef(mulObj,_beta);
+
+	return status;
+}
+
+int multirateObj_getFactor(MultirateObj multirateObj){
+
+	return multirateObj->factor;
+}
+
+int multirateObj_calDecimateLength(MultirateObj multirateObj,int dataLength){
+
+	return dataLength/multirateObj->factor;
+}
+
+int multirateObj_calInterpolateLength(MultirateObj multirateObj,int dataLength){
+
+	return dataLength*multirateObj->factor;
+}
+
+/***
+	polyphase, phase p data P[j]=x[j*factor+p] zero padded
+	y[i]=sum_p sum_q h[q*factor+p]*P[i+q]; phase 0 only center tap
+****/
+int multirateObj_decimate(MultirateObj multirateObj,float *dataArr1,int dataLength1,float *dataArr2){
+	int factor=0;
+	int padLength=0;
+	int coefLength=0;
+
+	int length=0;
+	int phaseLength=0;
+
+	float *cacheArr=NULL;
+
+	factor=multirateObj->factor;
+	padLength=multirateObj->padLength;
+	coefLength=multirateObj->coefLength;
+
+	length=dataLength1/factor;
+	if(length<=0){
+		return 0;
+	}
+
+	phaseLength=length+2*padLength;
+	cacheArr=_multirateObj_dealCache(multirateObj,factor*phaseLength);
+
+	// 1. deinterleave phase
+	for(int p=0;p<factor;p++){
+		float *arr=NULL;
+
+		arr=cacheArr+p*phaseLength;
+		for(int j=-padLength,k=0;k<phaseLength;j++,k++){
+			int _index=0;
+
+			_index=j*factor+p;
+			arr[k]=(_index>=0&&_index<dataLength1?dataArr1[_index]:0);
+		}
+	}
+
+	// 2. phase fir
+	memset(dataArr2, 0, sizeof(float )*length);
+	for(int p=0;p<factor;p++){
+		__mathKernel_fir(cacheArr+p*phaseLength+padLength+multirateObj->startArr1[p],
+						multirateObj->coefArr1+p*coefLength,multirateObj->lengthArr1[p],
+						length,dataArr2);
+	}
+
+	return length;
+}
+
+/***
+	polyphase, y[i*factor+p]=sum_k factor*h[p-k*factor]*x[i+k]
+	phase 0 only center tap => x[i]
+****/
+int multirateObj_interpolate(MultirateObj multirateObj,float *dataArr1,int dataLength1,float *dataArr2){
+	int factor=0;
+	int padLength=0;
+	int coefLength=0;
+
+	int length=0;
+
+	float *cacheArr=NULL;
+	float *padArr=NULL;
+	float *phaseArr=NULL;
+
+	factor=multirateObj->factor;
+	padLength=multirateObj->padLength;
+	coefLength=multirateObj->coefLength;
+
+	if(dataLength1<=0){
+		return 0;
+	}
+
+	length=dataLength1*factor;
+	cacheArr=_multirateObj_dealCache(multirateObj,2*dataLength1+2*padLength);
+
+	padArr=cacheArr;
+	phaseArr=cacheArr+dataLength1+2*padLength;
+
+	memset(padArr, 0, sizeof(float )*padLength);
+	memcpy(padArr+padLength, dataArr1, sizeof(float )*dataLength1);
+	memset(padArr+padLength+dataLength1, 0, sizeof(float )*padLength);
+
+	for(int p=0;p<factor;p++){
+		memset(phaseArr, 0, sizeof(float )*dataLength1);
+		__mathKernel_fir(padArr+padLength+multirateObj->startArr2[p],
+						multirateObj->coefArr2+p*coefLength,multirateObj->lengthArr2[p],
+						dataLength1,phaseArr);
+
+		for(int i=0;i<dataLength1;i++){
+			dataArr2[i*factor+p]=phaseArr[i];
+		}
+	}
+
+	return length;
+}
+
+size_t multirateObj_calWorkspaceSize(MultirateObj multirateObj,int maxDataLength){
+	size_t size=0;
+
+	if(maxDataLength<=0){
+		return 0;
+	}
+
+	__vcarve(NULL,&size,__multirateObj_calCacheLength(multirateObj,maxDataLength));
+
+	return size+64;
+}
+
+int multirateObj_useWorkspace(MultirateObj multirateObj,void *workArr,size_t size,int maxDataLength){
+	size_t offset=0;
+
+	if(!multirateObj->workCacheLength){
+		free(multirateObj->cacheArr);
+	}
+
+	multirateObj->cacheArr=NULL;
+	multirateObj->cacheLength=0;
+	multirateObj->workCacheLength=0;
+	if(!workArr){
+		return 0;
+	}
+
+	if(maxDataLength<=0||
+		size<multirateObj_calWorkspaceSize(multirateObj,maxDataLength)){
+		return -1;
+	}
+
+	multirateObj->cacheLength=__multirateObj_calCacheLength(multirateObj,maxDataLength);
+	multirateObj->cacheArr=__vcarve(workArr,&offset,multirateObj->cacheLength);
+	multirateObj->workCacheLength=multirateObj->cacheLength;
+
+	return 0;
+}
+
+void multirateObj_free(MultirateObj multirateObj){
+
+	if(!multirateObj){
+		return;
+	}
+
+	free(multirateObj->coefArr1);
+	free(multirateObj->startArr1);
+	free(multirateObj->lengthArr1);
+
+	free(multirateObj->coefArr2);
+	free(multirateObj->startArr2);
+	free(multirateObj->lengthArr2);
+
+	if(!multirateObj->workCacheLength){
+		free(multirateObj->cacheArr);
+	}
+
+	free(multirateObj);
+}
+
+/***
+	h[n]=sinc(n/factor)/factor*kaiser, n in [-zeroNum*factor,zeroNum*factor]
+	h[n]=0 for n=k*factor(k!=0), phase 0 keep center only
+****/
+static void _multirateObj_dealCoef(MultirateObj multirateObj,float beta){
+	int factor=0;
+	int zeroNum=0;
+	int coefLength=0;
+
+	int order=0; // zeroNum*factor
+	float *hArr=NULL;
+	float *winArr=NULL;
+
+	float scale1=1; // decimate
+	float scale2=1; // interpolate
+
+	factor=multirateObj->factor;
+	zeroNum=multirateObj->zeroNum;
+	coefLength=multirateObj->coefLength;
+
+	order=zeroNum*factor;
+
+	// 1. windowed sinc
+	winArr=window_createKaiser(2*order+1,0,&beta);
+	hArr=__vnew(2*order+1, NULL);
+	for(int n=-order;n<=order;n++){
+		float _value=0;
+
+		if(n%factor==0){
+			_value=(n==0?1:0);
+		}
+		else{
+			_value=M_PI*n/factor;
+			_value=sinf(_value)/_value;
+		}
+
+		hArr[n+order]=_value/factor*winArr[n+order];
+	}
+
+	if(multirateObj->isScale){
+		scale1=sqrtf(factor);
+		scale2=1/sqrtf(factor);
+	}
+
+	// 2. phase
+	multirateObj->coefArr1=__vnew(factor*coefLength, NULL);
+	multirateObj->startArr1=__vnewi(factor, NULL);
+	multirateObj->lengthArr1=__vnewi(factor, NULL);
+
+	multirateObj->coefArr2=__vnew(factor*coefLength, NULL);
+	multirateObj->startArr2=__vnewi(factor, NULL);
+	multirateObj->lengthArr2=__vnewi(factor, NULL);
+
+	for(int p=0;p<factor;p++){
+		int start=0;
+		int end=0;
+
+		float *arr=NULL;
+
+		// decimate h[q*factor+p], q*factor+p in [-order,order]
+		if(p==0){
+			start=end=0;
+		}
+		else{
+			start=-zeroNum;
+			end=zeroNum-1;
+		}
+
+		arr=multirateObj->coefArr1+p*coefLength;
+		for(int q=start,k=0;q<=end;q++,k++){
+			arr[k]=hArr[q*factor+p+order]*scale1;
+		}
+
+		multirateObj->startArr1[p]=start;
+		multirateObj->lengthArr1[p]=end-start+1;
+
+		// interpolate factor*h[p-k*factor], p-k*factor in [-order,order]
+		if(p==0){
+			start=end=0;
+		}
+		else{
+			start=-zeroNum+1;
+			end=zeroNum;
+		}
+
+		arr=multirateObj->coefArr2+p*coefLength;
+		for(int q=start,k=0;q<=end;q++,k++){
+			arr[k]=hArr[p-q*factor+order]*factor*scale2;
+		}
+
+		multirateObj->startArr2[p]=start;
+		multirateObj->lengthArr2[p]=end-start+1;
+	}
+
+	free(hArr);
+	free(winArr);
+}
+
+static float *_multirateObj_dealCache(MultirateObj multirateObj,int length){
+
+	if(multirateObj->cacheLength<length){ // grow-only, cqt shrinks it every octave; over workspace back to own cache
+		if(!multirateObj->workCacheLength){
+			free(multirateObj->cacheArr);
+		}
+
+		multirateObj->cacheArr=__vnew(length, NULL);
+		multirateObj->cacheLength=length;
+		multirateObj->workCacheLength=0;
+	}
+
+	return multirateObj->cacheArr;
+}
+
+static int __multirateObj_calCacheLength(MultirateObj multirateObj,int dataLength){
+	int length1=0;
+	int length2=0;
+
+	length1=multirateObj->factor*(dataLength/multirateObj->factor+2*multirateObj->padLength);
+	length2=2*dataLength+2*multirateObj->padLength;
+
+	return (length1>length2?length1:length2);
+}
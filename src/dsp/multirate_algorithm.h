@@ -0,0 +1,50 @@
+
+
+#ifndef MULTIRATE_ALGORITHM_H
+#define MULTIRATE_ALGORITHM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../flux_base.h"
+
+typedef struct OpaqueMultirate *MultirateObj;
+
+/***
+	integer factor polyphase fir, kaiser windowed sinc cutoff samplate/(2*factor)
+	taps at multiple of factor zero(nyquist), skipped; factor 2 => half-band
+	factor 2
+	zeroNum 16, zero-crossing each side, fir length 2*zeroNum*factor+1
+	beta 8.5555 kaiser(same as resample Fast)
+	isScale 0, 1 => same energy scale as resampleObj isScale, decimate*sqrt(factor) interpolate/sqrt(factor)
+****/
+int multirateObj_new(MultirateObj *multirateObj,int *factor,int *zeroNum,float *beta,int *isScale);
+
+int multirateObj_getFactor(MultirateObj multirateObj);
+
+// dataLength/factor, dataLength*factor
+int multirateObj_calDecimateLength(MultirateObj multirateObj,int dataLength);
+int multirateObj_calInterpolateLength(MultirateObj multirateObj,int dataLength);
+
+/***
+	dataArr2[i] center dataArr1[i*factor], outside data zero; dataArr2 overwrite
+	return length
+****/
+int multirateObj_decimate(MultirateObj multirateObj,float *dataArr1,int dataLength1,float *dataArr2);
+// dataArr2[i*factor] keep dataArr1[i](*scale)
+int multirateObj_interpolate(MultirateObj multirateObj,float *dataArr1,int dataLength1,float *dataArr2);
+
+// caller workspace for decimate/interpolate cache, contract see stftObj_useWorkspace
+size_t multirateObj_calWorkspaceSize(MultirateObj multirateObj,int maxDataLength);
+int multirateObj_useWorkspace(MultirateObj multirateObj,void *workArr,size_t size,int maxDataLength);
+
+void multirateObj_free(MultirateObj multirateObj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
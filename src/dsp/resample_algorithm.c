@@ -5,6 +5,7 @@
 
 #include "../vector/flux_vector.h"
 #include "../vector/flux_vectorOp.h"
+#include "../vector/_math_kernel.h"
 
 #include "../util/flux_util.h"
 
@@ -12,6 +13,11 @@
 #include "filterDesign_fir.h"
 #include "resample_algorithm.h"
 
+// polyphase table max float(16MB), larger => sinc interp each output
+#define RESAMPLE_PHASE_MAX (1<<22)
+// continue block frame, stream cache channelNum*(phaseLength+RESAMPLE_BLOCK)
+#define RESAMPLE_BLOCK 1024
+
 struct OpaqueResample{
 	int isContinue;
 	int isScale;
@@ -37,18 +43,50 @@ struct OpaqueResample{
 	int sourceDataLength;
 	int targetDataLength;
 
-	// continue==1 cache
-	float *tailDataArr; // gcd
-	int tailDataLength;
+	// window k => x[n-leftLength+1+k], k<phaseLength
+	int isTap; // window/table valid for current ratio
+	int leftLength;
+	int phaseLength;
+
+	float scale; // min(ratio,1)
+	int step;
+
+	float *phaseArr; // p*phaseLength, p/q known&&<=RESAMPLE_PHASE_MAX; NULL => sinc interp
+
+	float *padArr; // zero padded channel data
+	int padLength;
+	int workPadLength; // >0 padArr in caller workspace, capacity
+
+	// continue stream, per channel history+block
+	float *streamArr; // channelNum*streamCapacity
+	int streamCapacity; // phaseLength+RESAMPLE_BLOCK
+	int streamLength; // valid frame
+	long long streamStart; // frame index of streamArr[0]
+	long long inLength; // input frame, flush zero not count
+	long long outLength; // output frame
+	int channelNum;
+	int streamTotalLength;
+	int isStream; // stream state valid for current tap/channelNum
 
 };
 
 static void _resampleObj_calInterpArr(ResampleObj resampleObj);
 static void _resampleObj_calInterpDeltaArr(ResampleObj resampleObj);
 
-// NULL dataArr1
-static float *_resampleObj_dealData(ResampleObj resampleObj,float *dataArr1,int dataLength1);
-static void _resampleObj_resample(ResampleObj resampleObj,float *dataArr1,float *dataArr2);
+static int _resampleObj_resampleChannel(ResampleObj resampleObj,float *dataArr1,int dataLength1,int channelNum,float *dataArr2);
+static int _resampleObj_stream(ResampleObj resampleObj,float *dataArr1,int dataLength1,int channelNum,int isFlush,float *dataArr2);
+
+static void _resampleObj_dealTap(ResampleObj resampleObj);
+static void _resampleObj_resetStream(ResampleObj resampleObj,int channelNum);
+
+// output index => n and table row/factor; value over window x[n-leftLength+1]~
+static void __resampleObj_calIndex(ResampleObj resampleObj,long long index,long long *n,float **tapArr,float *factor);
+static float __resampleObj_calValue(ResampleObj resampleObj,float *tapArr,float factor,float *dataArr);
+
+// one-shot N => N*p/q, ratio floorf(N*ratio)
+static long long __resampleObj_calTargetLength(ResampleObj resampleObj,long long dataLength);
+// continue, output count window complete with dataLength frame
+static long long __resampleObj_calWindowLength(ResampleObj resampleObj,long long dataLength);
 
 /***
 	qualType beat, use kaiser
@@ -195,8 +233,6 @@ int resampleObj_newWithWindow(ResampleObj *resampleObj,
 	resObj->p=1;
 	resObj->q=2;
 
-	resObj->tailDataArr=__vnew(resObj->q+1, NULL);
-
 	resObj->sourceRate=32000;
 	resObj->targetRate=16000;
 
@@ -212,42 +248,59 @@ int resampleObj_newWithWindow(ResampleObj *resampleObj,
 
 /***
 	continue 0 
-		sourceDataLength=dataLength
+		dataLength*p/q(setSamplate), floorf(dataLength*ratio)(setSamplateRatio)
 	conttinue 1
-		sourceDataLength=dataLength-dataLength%q
+		next resample call output, window complete part; rest by resampleObj_flush
+		sum of all call+flush == continue 0 on concatenated data
 ****/
 int resampleObj_calDataLength(ResampleObj resampleObj,int dataLength){
-	int isContinue=0;
+	long long targetDataLength=0;
+	long long length=0;
 
-	float ratio=0;
-	int p=0;
-	int q=0;
+	_resampleObj_dealTap(resampleObj);
 
-	int sourceDataLength=0;
-	int targetDataLength=0;
+	if(!resampleObj->isContinue){
+		targetDataLength=__resampleObj_calTargetLength(resampleObj,dataLength);
+	}
+	else{
+		if(!resampleObj->isStream){
+			_resampleObj_resetStream(resampleObj,(resampleObj->channelNum>0?resampleObj->channelNum:1));
+		}
 
-	isContinue=resampleObj->isContinue;
+		length=resampleObj->inLength+dataLength;
 
-	ratio=resampleObj->ratio;
-	p=resampleObj->p; // up
-	q=resampleObj->q; // down
+		targetDataLength=__resampleObj_calTargetLength(resampleObj,length);
+		if(targetDataLength>__resampleObj_calWindowLength(resampleObj,length)){
+			targetDataLength=__resampleObj_calWindowLength(resampleObj,length);
+		}
 
-	if(!isContinue){
-		sourceDataLength=dataLength;
-		targetDataLength=floorf(dataLength*ratio);
-	}
-	else{
-		if(q>1){ // down
-			sourceDataLength=dataLength-dataLength%q;
-			targetDataLength=sourceDataLength*p/q;
+		targetDataLength-=resampleObj->outLength;
+		if(targetDataLength<0){
+			targetDataLength=0;
 		}
 	}
 
-	resampleObj->sourceDataLength=sourceDataLength;
+	resampleObj->sourceDataLength=dataLength;
 	resampleObj->targetDataLength=targetDataLength;
 
 	return targetDataLength;
+}
 
+int resampleObj_calFlushLength(ResampleObj resampleObj){
+	long long length=0;
+
+	if(!resampleObj->isContinue){
+		return 0;
+	}
+
+	_resampleObj_dealTap(resampleObj);
+	if(!resampleObj->isStream){
+		return 0;
+	}
+
+	length=__resampleObj_calTargetLength(resampleObj,resampleObj->inLength)-resampleObj->outLength;
+
+	return (length>0?length:0);
 }
 
 void resampleObj_setSamplate(ResampleObj resampleObj,int sourceRate,int targetRate){
@@ -272,11 +325,6 @@ void resampleObj_setSamplate(ResampleObj resampleObj,int sourceRate,int targetRa
 	p=targetRate/gcd; // up->target
 	q=sourceRate/gcd; // down->source
 
-	if(q>resampleObj->q){
-		free(resampleObj->tailDataArr);
-		resampleObj->tailDataArr=__vnew(q+1, NULL);
-	}
-
 	ratio=targetRate/(float )sourceRate;
 	if(ratio!=resampleObj->ratio&&
 		(resampleObj->ratio<1||ratio<1)){ // update interpArr/interpDeltaArr
@@ -298,13 +346,15 @@ void resampleObj_setSamplate(ResampleObj resampleObj,int sourceRate,int targetRa
 
 	resampleObj->p=p;
 	resampleObj->q=q;
+
+	resampleObj->isTap=0; // new stream
 }
 
 void resampleObj_setSamplateRatio(ResampleObj resampleObj,float ratio){
 	float *interpArr=NULL; 
 	int interpLength=0;
 	
-	if(ratio<0){
+	if(ratio<=0){
 		return;
 	}
 
@@ -329,195 +379,598 @@ void resampleObj_setSamplateRatio(ResampleObj resampleObj,float ratio){
 
 	resampleObj->p=0;
 	resampleObj->q=0;
+
+	resampleObj->isTap=0; // new stream
 }
 
 void resampleObj_enableContinue(ResampleObj resampleObj,int flag){
 
-	if(!flag){ // not real-time change
-		resampleObj->tailDataLength=0;
-	}
 	resampleObj->isContinue=flag;
-
+	resampleObj->isStream=0; // new stream
 }
 
 /***
-	1. dealData
-	2. calDataLength
-	3. resample
-	4. tailData
-	5. scale
+	1. dealTap
+	2. continue 0 => zero padded channel, one window per output
+	   continue 1 => stream
+	3. scale
 ****/
 int resampleObj_resample(ResampleObj resampleObj,float *dataArr1,int dataLength1,float *dataArr2){
-	int length=0;
 
-	float *dealArr=NULL;
-	float *curArr=NULL;
+	return _resampleObj_resampleChannel(resampleObj,dataArr1,dataLength1,1,dataArr2);
+}
 
-	int length1=0;
-	int tailDataLength=0;
+int resampleObj_resampleInterleave(ResampleObj resampleObj,float *dataArr1,int dataLength1,int channelNum,float *dataArr2){
 
-	// 1. dealData
-	dealArr=_resampleObj_dealData(resampleObj,dataArr1,dataLength1);
-	if(dealArr){ 
-		curArr=dealArr;
-		length1=dataLength1+resampleObj->tailDataLength;
+	if(channelNum<1){
+		channelNum=1;
 	}
-	else{
-		curArr=dataArr1;
-		length1=dataLength1;
+
+	return _resampleObj_resampleChannel(resampleObj,dataArr1,dataLength1,channelNum,dataArr2);
+}
+
+size_t resampleObj_calWorkspaceSize(ResampleObj resampleObj,int maxDataLength){
+	size_t size=0;
+
+	if(maxDataLength<=0){
+		return 0;
 	}
 
-	// 2. calDataLength
-	resampleObj_calDataLength(resampleObj,length1);
+	_resampleObj_dealTap(resampleObj);
+	__vcarve(NULL,&size,maxDataLength+resampleObj->phaseLength+1);
 
-	// 3. resample
-	_resampleObj_resample(resampleObj,curArr,dataArr2);
+	return size+64;
+}
 
-	// 4. tailData
-	if(resampleObj->isContinue&&dealArr){ // real-time
-		tailDataLength=length1-resampleObj->sourceDataLength;
-		for(int i=0;i<tailDataLength;i++){
-			resampleObj->tailDataArr[i]=dealArr[resampleObj->sourceDataLength+i];
-		}
+int resampleObj_useWorkspace(ResampleObj resampleObj,void *workArr,size_t size,int maxDataLength){
+	size_t offset=0;
+
+	if(!resampleObj->workPadLength){
+		free(resampleObj->padArr);
+	}
+
+	resampleObj->padArr=NULL;
+	resampleObj->padLength=0;
+	resampleObj->workPadLength=0;
+	if(!workArr){
+		return 0;
+	}
+
+	if(maxDataLength<=0||
+		size<resampleObj_calWorkspaceSize(resampleObj,maxDataLength)){
+		return -1;
+	}
+
+	resampleObj->padLength=maxDataLength+resampleObj->phaseLength+1;
+	resampleObj->padArr=__vcarve(workArr,&offset,resampleObj->padLength);
+	resampleObj->workPadLength=resampleObj->padLength;
+
+	return 0;
+}
+
+int resampleObj_flush(ResampleObj resampleObj,float *dataArr2){
+	int channelNum=0;
+
+	if(!resampleObj->isContinue){
+		return 0;
+	}
+
+	_resampleObj_dealTap(resampleObj);
+	channelNum=(resampleObj->channelNum>0?resampleObj->channelNum:1);
+
+	return _resampleObj_stream(resampleObj,NULL,0,channelNum,1,dataArr2);
+}
+
+static int _resampleObj_resampleChannel(ResampleObj resampleObj,float *dataArr1,int dataLength1,int channelNum,float *dataArr2){
+	int leftLength=0;
+	int phaseLength=0;
+
+	int sourceDataLength=0;
+	int targetDataLength=0;
+
+	float *padArr=NULL;
+	int padLength=0;
+
+	float scaleValue=1;
+
+	_resampleObj_dealTap(resampleObj);
+	if(resampleObj->isContinue){
+		return _resampleObj_stream(resampleObj,dataArr1,dataLength1,channelNum,0,dataArr2);
+	}
+
+	leftLength=resampleObj->leftLength;
+	phaseLength=resampleObj->phaseLength;
 
-		resampleObj->tailDataLength=tailDataLength;
+	sourceDataLength=dataLength1;
+	targetDataLength=resampleObj_calDataLength(resampleObj,dataLength1);
+	if(targetDataLength<=0){
+		return 0;
 	}
 
-	// 5. scale
 	if(resampleObj->isScale){
-		int _len=0;
-		float _value=0;
+		scaleValue=sqrtf(resampleObj->ratio);
+	}
 
-		_len=resampleObj->targetDataLength;
-		_value=sqrtf(resampleObj->ratio);
-		for(int i=0;i<_len;i++){
-			dataArr2[i]/=_value;
+	// pad k => x[k-leftLength+1]
+	padLength=sourceDataLength+phaseLength+1;
+	if(resampleObj->padLength<padLength){ // grow-only, cqt shrinks it every octave; over workspace back to own cache
+		if(!resampleObj->workPadLength){
+			free(resampleObj->padArr);
 		}
+
+		resampleObj->padArr=__vnew(padLength, NULL);
+		resampleObj->padLength=padLength;
+		resampleObj->workPadLength=0;
 	}
 
-	length=resampleObj->targetDataLength;
-	if(dealArr){
-		free(dealArr);
+	padArr=resampleObj->padArr;
+	for(int c=0;c<channelNum;c++){
+		memset(padArr, 0, sizeof(float )*(leftLength-1));
+		for(int i=0;i<sourceDataLength;i++){
+			padArr[leftLength-1+i]=dataArr1[i*channelNum+c];
+		}
+		memset(padArr+leftLength-1+sourceDataLength, 0, sizeof(float )*(padLength-(leftLength-1+sourceDataLength)));
+
+		for(int i=0;i<targetDataLength;i++){
+			long long n=0;
+			float *tapArr=NULL;
+			float factor=0;
+
+			__resampleObj_calIndex(resampleObj,i,&n,&tapArr,&factor);
+			dataArr2[i*channelNum+c]=__resampleObj_calValue(resampleObj,tapArr,factor,padArr+n);
+		}
 	}
-	return length;
+
+	if(resampleObj->isScale){
+		for(int i=0;i<targetDataLength*channelNum;i++){
+			dataArr2[i]/=scaleValue;
+		}
+	}
+
+	return targetDataLength;
 }
 
-// NULL ==> dataArr1
-static float *_resampleObj_dealData(ResampleObj resampleObj,float *dataArr1,int dataLength1){
-	float *dataArr2=NULL;
+/***
+	streamArr channel c => x[streamStart+k], k<streamLength, keep from next output window start
+	1. append block(input or flush zero)
+	2. output window complete, index<target(inLength); same window/value as continue 0
+	3. slide to next window start
+	no heap in call after first(channelNum/ratio change realloc)
+****/
+static int _resampleObj_stream(ResampleObj resampleObj,float *dataArr1,int dataLength1,int channelNum,int isFlush,float *dataArr2){
+	int leftLength=0;
+
+	float *streamArr=NULL;
+	int streamCapacity=0;
 
-	int isContinue=0;
-	float *tailDataArr=NULL; 
-	int tailDataLength=0;
+	long long startLength=0;
+	int pos=0;
+
+	float scaleValue=1;
+	int length=0;
+
+	if(!resampleObj->isStream||resampleObj->channelNum!=channelNum){
+		_resampleObj_resetStream(resampleObj,channelNum);
+	}
+
+	leftLength=resampleObj->leftLength;
+
+	streamArr=resampleObj->streamArr;
+	streamCapacity=resampleObj->streamCapacity;
+
+	startLength=resampleObj->outLength;
+	if(resampleObj->isScale){
+		scaleValue=sqrtf(resampleObj->ratio);
+	}
 
-	isContinue=resampleObj->isContinue;
-	tailDataArr=resampleObj->tailDataArr;
-	tailDataLength=resampleObj->tailDataLength;
-	if(isContinue&&tailDataLength){ 
-		dataArr2=__vnew(dataLength1+tailDataLength, NULL);
-		for(int i=0;i<tailDataLength;i++){
-			dataArr2[i]=tailDataArr[i];
+	while(1){
+		int blockLength=0;
+		long long endLength=0;
+		long long windowLength=0;
+
+		long long n=0;
+		long long dropLength=0;
+
+		// 1. append
+		blockLength=streamCapacity-resampleObj->streamLength;
+		if(!isFlush){
+			if(blockLength>dataLength1-pos){
+				blockLength=dataLength1-pos;
+			}
+
+			for(int c=0;c<channelNum;c++){
+				float *arr=NULL;
+
+				arr=streamArr+c*streamCapacity+resampleObj->streamLength;
+				for(int i=0;i<blockLength;i++){
+					arr[i]=dataArr1[(pos+i)*channelNum+c];
+				}
+			}
+
+			pos+=blockLength;
+			resampleObj->inLength+=blockLength;
+		}
+		else{
+			for(int c=0;c<channelNum;c++){
+				memset(streamArr+c*streamCapacity+resampleObj->streamLength, 0, sizeof(float )*blockLength);
+			}
+		}
+
+		resampleObj->streamLength+=blockLength;
+
+		// 2. output
+		endLength=__resampleObj_calTargetLength(resampleObj,resampleObj->inLength);
+		windowLength=__resampleObj_calWindowLength(resampleObj,resampleObj->streamStart+resampleObj->streamLength);
+		if(endLength>windowLength){
+			endLength=windowLength;
+		}
+
+		for(long long i=resampleObj->outLength;i<endLength;i++){
+			float *tapArr=NULL;
+			float factor=0;
+
+			float *arr=NULL;
+			int _index=0;
+
+			__resampleObj_calIndex(resampleObj,i,&n,&tapArr,&factor);
+			_index=n-leftLength+1-resampleObj->streamStart;
+
+			arr=dataArr2+(i-startLength)*channelNum;
+			for(int c=0;c<channelNum;c++){
+				arr[c]=__resampleObj_calValue(resampleObj,tapArr,factor,streamArr+c*streamCapacity+_index);
+				if(resampleObj->isScale){
+					arr[c]/=scaleValue;
+				}
+			}
+		}
+
+		if(endLength>resampleObj->outLength){
+			resampleObj->outLength=endLength;
 		}
 
-		for(int i=0;i<dataLength1;i++){
-			dataArr2[i+tailDataLength]=dataArr1[i];
+		// 3. slide
+		__resampleObj_calIndex(resampleObj,resampleObj->outLength,&n,NULL,NULL);
+		dropLength=n-leftLength+1-resampleObj->streamStart;
+		if(dropLength>resampleObj->streamLength){
+			dropLength=resampleObj->streamLength;
 		}
+
+		if(dropLength>0){
+			for(int c=0;c<channelNum;c++){
+				float *arr=NULL;
+
+				arr=streamArr+c*streamCapacity;
+				memmove(arr, arr+dropLength, sizeof(float )*(resampleObj->streamLength-dropLength));
+			}
+
+			resampleObj->streamStart+=dropLength;
+			resampleObj->streamLength-=dropLength;
+		}
+
+		if(isFlush){
+			if(resampleObj->outLength>=__resampleObj_calTargetLength(resampleObj,resampleObj->inLength)){
+				break;
+			}
+		}
+		else if(pos>=dataLength1){
+			break;
+		}
+
+		if(!blockLength&&dropLength<=0){ // not progress
+			break;
+		}
+	}
+
+	length=resampleObj->outLength-startLength;
+	if(isFlush){ // stream end
+		_resampleObj_resetStream(resampleObj,channelNum);
 	}
 
-	return dataArr2;
+	return length;
 }
 
-static void _resampleObj_resample(ResampleObj resampleObj,float *dataArr1,float *dataArr2){
-	float ratio=0; // newSamplate/origSamplate
+/***
+	window k => x[n-leftLength+1+k]
+	p/q => left/right max over p phase, table p*phaseLength if <=RESAMPLE_PHASE_MAX
+	ratio/large table => interpLength/step each side, sinc interp per output
+****/
+static void _resampleObj_dealTap(ResampleObj resampleObj){
+	int p=0;
 
-	int bitLength=0; // 1<<nbit
-	float *interpArr=NULL; // ratio<1 *ration
+	float ratio=0;
+	int bitLength=0;
+	float *interpArr=NULL;
 	float *interpDeltaArr=NULL;
 	int interpLength=0;
-	
-	int sourceDataLength=0;
-	int targetDataLength=0;
 
 	float scale=0;
-	float t=0;
 	int step=0;
 
-	ratio=resampleObj->ratio;
+	int leftLength=0;
+	int rightLength=0;
+	int phaseLength=0;
+
+	float *phaseArr=NULL;
 
+	if(resampleObj->isTap){
+		return;
+	}
+
+	free(resampleObj->phaseArr);
+	resampleObj->phaseArr=NULL;
+
+	p=resampleObj->p;
+
+	ratio=resampleObj->ratio;
 	bitLength=resampleObj->bitLength;
 	interpArr=resampleObj->interpArr;
 	interpDeltaArr=resampleObj->interpDeltaArr;
 	interpLength=resampleObj->interpLength;
 
-	sourceDataLength=resampleObj->sourceDataLength;
-	targetDataLength=resampleObj->targetDataLength;
-
 	scale=(1.0>ratio?ratio:1.0);
 	step=floorf(scale*bitLength);
+	if(step<1){
+		step=1;
+	}
 
-	// {	
-	// 	printf("interpArr is \n");
-	// 	__vdebug(interpArr, interpLength, 1);
-	// 	printf("\n");
+	resampleObj->scale=scale;
+	resampleObj->step=step;
 
-	// 	printf("interpDeltaArr is \n");
-	// 	__vdebug(interpDeltaArr, interpLength, 1);
-	// 	printf("\n");
-	// }
+	// 1. max left/right taps
+	if(p>0){
+		for(int i=0;i<p;i++){
+			float factor=0;
+			int offset=0;
 
-	for(int i=0;i<targetDataLength;i++){
-		int leftLen=0;
-		int rightLen=0;
+			factor=scale*(i/(double )p);
+			offset=floorf(factor*bitLength);
+			if(leftLength<(interpLength-offset)/step){
+				leftLength=(interpLength-offset)/step;
+			}
 
-		int n=0;
-		float factor=0;
-		float factorValue=0;
-		int offset=0;
+			offset=floorf((scale-factor)*bitLength);
+			if(rightLength<(interpLength-offset)/step){
+				rightLength=(interpLength-offset)/step;
+			}
+		}
+	}
+	else{
+		leftLength=rightLength=interpLength/step;
+	}
 
-		float delta=0;
-		float w=0;
+	phaseLength=leftLength+rightLength;
 
-		int _value1=0;
-		int _value2=0;
+	// 2. phase taps at exact phase i/p(double, no float time drift), zero outside phase own left/right length
+	if(p>0&&(long long )p*phaseLength<=RESAMPLE_PHASE_MAX){
+		phaseArr=__vnew(p*phaseLength, NULL);
+		for(int i=0;i<p;i++){
+			float *arr=NULL;
 
-		t=i*1.0/ratio;
-		n=floorf(t);
+			double factor=0;
+			double factorValue=0;
+			int offset=0;
+			float delta=0;
 
-		// 1. left cal
-		factor=scale*(t-n);
+			int len=0;
 
-		factorValue=factor*bitLength;
-		offset=floorf(factorValue);
-		delta=factorValue-offset;
+			arr=phaseArr+i*phaseLength;
 
-		_value1=n+1;
-		_value2=(interpLength-offset)/step;
-		leftLen=(_value1>_value2?_value2:_value1);
-		for(int j=0;j<leftLen;j++){
-			w=interpArr[offset+j*step]+delta*interpDeltaArr[offset+j*step];
-			dataArr2[i]+=w*dataArr1[n-j];
+			// left x[n-j] => k=leftLength-1-j
+			factor=scale*(i/(double )p);
+			factorValue=factor*bitLength;
+			offset=floor(factorValue);
+			delta=factorValue-offset;
+
+			len=(interpLength-offset)/step;
+			for(int j=0;j<len;j++){
+				arr[leftLength-1-j]=interpArr[offset+j*step]+delta*interpDeltaArr[offset+j*step];
+			}
+
+			// right x[n+1+j] => k=leftLength+j
+			factor=scale-factor;
+			factorValue=factor*bitLength;
+			offset=floor(factorValue);
+			delta=factorValue-offset;
+
+			len=(interpLength-offset)/step;
+			for(int j=0;j<len;j++){
+				arr[leftLength+j]=interpArr[offset+j*step]+delta*interpDeltaArr[offset+j*step];
+			}
 		}
+	}
+
+	resampleObj->phaseArr=phaseArr;
+	resampleObj->leftLength=leftLength;
+	resampleObj->phaseLength=phaseLength;
+
+	resampleObj->isTap=1;
+	resampleObj->isStream=0;
+}
+
+// history leftLength-1 zero, stream index -leftLength+1; cache keep when size fit
+static void _resampleObj_resetStream(ResampleObj resampleObj,int channelNum){
+	int streamCapacity=0;
+	int leftLength=0;
+
+	leftLength=resampleObj->leftLength;
+	streamCapacity=resampleObj->phaseLength+RESAMPLE_BLOCK;
+
+	if(resampleObj->streamTotalLength<channelNum*streamCapacity||
+		resampleObj->streamTotalLength>channelNum*streamCapacity*2){
+		free(resampleObj->streamArr);
+
+		resampleObj->streamArr=__vnew(channelNum*streamCapacity, NULL);
+		resampleObj->streamTotalLength=channelNum*streamCapacity;
+	}
+
+	for(int c=0;c<channelNum;c++){
+		memset(resampleObj->streamArr+c*streamCapacity, 0, sizeof(float )*(leftLength-1));
+	}
+
+	resampleObj->streamCapacity=streamCapacity;
+	resampleObj->streamLength=leftLength-1;
+	resampleObj->streamStart=-(leftLength-1);
 
-		// 2. right cal
-		// invert
-		factor=scale-factor;
+	resampleObj->inLength=0;
+	resampleObj->outLength=0;
+	resampleObj->channelNum=channelNum;
+
+	resampleObj->isStream=1;
+}
 
-		factorValue=factor*bitLength;
-		offset=floorf(factorValue);
-		delta=factorValue-offset;
+/***
+	p/q => n=(index*q)/p, phase (index*q)%p, exact
+	ratio => t=index/ratio double, factor=scale*(t-n)
+	tapArr NULL => sinc interp by factor
+****/
+static void __resampleObj_calIndex(ResampleObj resampleObj,long long index,long long *n,float **tapArr,float *factor){
+	int p=0;
+	int q=0;
 
-		_value1=sourceDataLength-n-1;
-		_value2=(interpLength-offset)/step;
-		rightLen=(_value1>_value2?_value2:_value1);
-		for(int j=0;j<rightLen;j++){
-			w=interpArr[offset+j*step]+delta*interpDeltaArr[offset+j*step];
-			dataArr2[i]+=w*dataArr1[n+j+1];
+	float _factor=0;
+	float *_tapArr=NULL;
+
+	p=resampleObj->p;
+	q=resampleObj->q;
+
+	if(p>0){
+		long long _index=0;
+		int phase=0;
+
+		_index=index*q;
+		*n=_index/p;
+		phase=_index%p;
+
+		if(resampleObj->phaseArr){
+			_tapArr=resampleObj->phaseArr+phase*resampleObj->phaseLength;
 		}
+		else{
+			_factor=resampleObj->scale*(phase/(double )p);
+		}
+	}
+	else{
+		double t=0;
 
-		// 3. update t
-		// t+=1.0/ratio;
+		t=index/(double )resampleObj->ratio;
+		*n=floor(t);
+		_factor=resampleObj->scale*(t-*n);
+	}
+
+	if(tapArr){
+		*tapArr=_tapArr;
+	}
+
+	if(factor){
+		*factor=_factor;
+	}
+}
+
+// dataArr window start x[n-leftLength+1], phaseLength valid
+static float __resampleObj_calValue(ResampleObj resampleObj,float *tapArr,float factor,float *dataArr){
+	int leftLength=0;
+
+	int bitLength=0;
+	float *interpArr=NULL;
+	float *interpDeltaArr=NULL;
+	int interpLength=0;
+	int step=0;
+
+	float factorValue=0;
+	int offset=0;
+	float delta=0;
+	int len=0;
+
+	float sum=0;
+
+	if(tapArr){
+		return __mathKernel_dot(tapArr,dataArr,resampleObj->phaseLength);
+	}
+
+	leftLength=resampleObj->leftLength;
+
+	bitLength=resampleObj->bitLength;
+	interpArr=resampleObj->interpArr;
+	interpDeltaArr=resampleObj->interpDeltaArr;
+	interpLength=resampleObj->interpLength;
+	step=resampleObj->step;
+
+	// 1. left x[n-j]
+	factorValue=factor*bitLength;
+	offset=floorf(factorValue);
+	delta=factorValue-offset;
+
+	len=(interpLength-offset)/step;
+	for(int j=0;j<len;j++){
+		float w=0;
+
+		w=interpArr[offset+j*step]+delta*interpDeltaArr[offset+j*step];
+		sum+=w*dataArr[leftLength-1-j];
+	}
+
+	// 2. right x[n+1+j], invert
+	factor=resampleObj->scale-factor;
+
+	factorValue=factor*bitLength;
+	offset=floorf(factorValue);
+	delta=factorValue-offset;
 
+	len=(interpLength-offset)/step;
+	for(int j=0;j<len;j++){
+		float w=0;
+
+		w=interpArr[offset+j*step]+delta*interpDeltaArr[offset+j*step];
+		sum+=w*dataArr[leftLength+j];
+	}
+
+	return sum;
+}
+
+static long long __resampleObj_calTargetLength(ResampleObj resampleObj,long long dataLength){
+	long long length=0;
+
+	if(resampleObj->p>0){
+		length=dataLength*resampleObj->p/resampleObj->q;
+	}
+	else{
+		length=floorf(dataLength*resampleObj->ratio);
+	}
+
+	return length;
+}
+
+// count index n<=dataLength-1-rightLength
+static long long __resampleObj_calWindowLength(ResampleObj resampleObj,long long dataLength){
+	long long maxIndex=0;
+	long long length=0;
+
+	int p=0;
+	int q=0;
+	double ratio=0;
+
+	p=resampleObj->p;
+	q=resampleObj->q;
+	ratio=resampleObj->ratio;
+
+	maxIndex=dataLength-1-(resampleObj->phaseLength-resampleObj->leftLength);
+	if(maxIndex<0){
+		return 0;
+	}
+
+	if(p>0){
+		length=((maxIndex+1)*p+q-1)/q;
 	}
+	else{
+		// same floor(index/ratio) as calIndex
+		length=ceil((maxIndex+1)*ratio);
+		while(length>0&&floor((length-1)/ratio)>maxIndex){
+			length--;
+		}
+		while(floor(length/ratio)<=maxIndex){
+			length++;
+		}
+	}
+
+	return length;
 }
 
 static void _resampleObj_calInterpDeltaArr(ResampleObj resampleObj){
@@ -636,7 +1089,6 @@ static void _resampleObj_calInterpArr(ResampleObj resampleObj){
 void resampleObj_free(ResampleObj resampleObj){
 	float *interpArr=NULL; // ratio<1 *ration
 	float *interpDeltaArr=NULL;
-	float *tailDataArr=NULL; // gcd
 
 	if(!resampleObj){
 		return;
@@ -644,11 +1096,15 @@ void resampleObj_free(ResampleObj resampleObj){
 
 	interpArr=resampleObj->interpArr;
 	interpDeltaArr=resampleObj->interpDeltaArr;
-	tailDataArr=resampleObj->tailDataArr;
 
 	free(interpArr);
 	free(interpDeltaArr);
-	free(tailDataArr);
+
+	free(resampleObj->phaseArr);
+	if(!resampleObj->workPadLength){
+		free(resampleObj->padArr);
+	}
+	free(resampleObj->streamArr);
 
 	free(resampleObj);
 }
@@ -44,6 +44,12 @@ int resampleObj_newWithWindow(ResampleObj *resampleObj,
 							int *isScale,
 							int *isContinue);
 
+/***
+	continue 0 => output length of dataLength
+	continue 1 => next resample call output length, only window complete part(right taps lag)
+		stream end must call resampleObj_flush(calFlushLength size) else tail sample lost
+		sum of resample call+flush == continue 0 length of concatenated data
+****/
 int resampleObj_calDataLength(ResampleObj resampleObj,int dataLength);
 
 // 32000/16000
@@ -51,7 +57,33 @@ void resampleObj_setSamplate(ResampleObj resampleObj,int sourceRate,int targetRa
 void resampleObj_setSamplateRatio(ResampleObj resampleObj,float ratio);
 void resampleObj_enableContinue(ResampleObj resampleObj,int flag);
 
+/***
+	setSamplate p/q ratio use precomputed polyphase table(p branch), setSamplateRatio use sinc interp
+	branch coef at exact phase (i*q)%p/p, same sinc interp formula; vs exact-phase direct sum <=1e-6 abs(float sum order)
+	before table output time t=i/ratio was float, drift grow with i(~1e-3 abs after 1e5 sample) => that much diff vs old
+	dataArr2 overwrite; return length
+****/
 int resampleObj_resample(ResampleObj resampleObj,float *dataArr1,int dataLength1,float *dataArr2);
+/***
+	dataArr1 interleave dataLength1*channelNum, dataLength1 frame; dataArr2 interleave
+	continue keep same channelNum between call; return frame length
+****/
+int resampleObj_resampleInterleave(ResampleObj resampleObj,float *dataArr1,int dataLength1,int channelNum,float *dataArr2);
+
+/***
+	continue 1 stream, any chunk split same as continue 0 on concatenated data(sample exact)
+	flush output rest(zero tail) then reset stream; calFlushLength frame length
+	setSamplate/setSamplateRatio/enableContinue start new stream
+****/
+int resampleObj_calFlushLength(ResampleObj resampleObj);
+int resampleObj_flush(ResampleObj resampleObj,float *dataArr2);
+
+/***
+	caller workspace for continue 0 pad cache, contract see stftObj_useWorkspace
+	size depend on current ratio(tap window), set samplate first
+****/
+size_t resampleObj_calWorkspaceSize(ResampleObj resampleObj,int maxDataLength);
+int resampleObj_useWorkspace(ResampleObj resampleObj,void *workArr,size_t size,int maxDataLength);
 
 void resampleObj_free(ResampleObj resampleObj);
 void resampleObj_debug(ResampleObj resampleObj);
@@ -8,6 +8,7 @@
 #include "../vector/flux_complex.h"
 
 #include "../util/flux_util.h"
+#include "../util/flux_parallel.h"
 
 #include "../dsp/flux_window.h"
 
@@ -45,6 +46,16 @@ struct OpaqueSpectral{
 
 	int isMean;
 
+	// spectralObj_compute param
+	float threshold; // rolloff
+	int isNorm; // entropy
+
+	int step; // flux
+	float p;
+	int isPostive;
+	int isExp;
+	int type;
+
 };
 
 // 计算高频sum/c1/c2
@@ -54,6 +65,8 @@ static void __spectralObj_calC2(SpectralObj spectralObj,float *mDataArr);
 static void __spectralObj_calEntropy(SpectralObj spectralObj,float *mDataArr,int isNorm);
 static void __spectralObj_calMean(SpectralObj spectralObj,float *mDataArr);
 
+static void __spectralObj_computeChunk(void *arg,int start,int end,int threadIndex);
+
 int spectralObj_new(SpectralObj *spectralObj,int num,float *freBandArr){
 	int status=0;
 
@@ -88,6 +101,10 @@ int spectralObj_new(SpectralObj *spectralObj,int num,float *freBandArr){
 	sp->indexArr=indexArr;
 	sp->indexLength=indexLength;
 
+	sp->threshold=0.95;
+	sp->step=1;
+	sp->p=2;
+
 	return status;
 }
 
@@ -851,6 +868,382 @@ void spectralObj_eer(SpectralObj spectralObj,float *mDataArr,int isEnNorm,float
 	}
 }
 
+void spectralObj_setComputeParam(SpectralObj spectralObj,float threshold,int isNorm,
+								int step,float p,int isPostive,int isExp,int type){
+
+	spectralObj->threshold=threshold;
+	spectralObj->isNorm=isNorm;
+
+	spectralObj->step=(step<1?1:step);
+	spectralObj->p=p;
+	spectralObj->isPostive=isPostive;
+	spectralObj->isExp=isExp;
+	spectralObj->type=type;
+}
+
+static int __spectralMomentMask=SpectralFeature_Centroid|SpectralFeature_Spread|
+								SpectralFeature_Skewness|SpectralFeature_Kurtosis;
+
+// spectralObj_compute __parallel_for arg
+typedef struct{
+	SpectralObj spectralObj;
+
+	float *mDataArr;
+	float *outMatrix;
+
+	int featureMask;
+	int rowArr[12]; // feature bit => outMatrix row, -1 not select
+
+	float meanFre; // slope
+
+} SpectralComputeArg;
+
+int spectralObj_compute(SpectralObj spectralObj,float *mDataArr,int featureMask,float *outMatrix){
+	int timeLength=0;
+
+	int *indexArr=0;
+	int indexLength=0;
+
+	float *freArr=NULL;
+
+	int featureNum=0;
+	SpectralComputeArg computeArg;
+
+	timeLength=spectralObj->timeLength;
+
+	indexArr=spectralObj->indexArr;
+	indexLength=spectralObj->indexLength;
+
+	freArr=spectralObj->freBandArr;
+
+	memset(&computeArg, 0, sizeof(SpectralComputeArg ));
+	for(int k=0;k<12;k++){
+		computeArg.rowArr[k]=-1;
+		if(featureMask&(1<<k)){
+			computeArg.rowArr[k]=featureNum;
+			featureNum++;
+		}
+	}
+
+	computeArg.spectralObj=spectralObj;
+	computeArg.mDataArr=mDataArr;
+	computeArg.outMatrix=outMatrix;
+	computeArg.featureMask=featureMask;
+
+	if(featureMask&SpectralFeature_Slope){
+		for(int j=0;j<indexLength;j++){
+			computeArg.meanFre+=freArr[indexArr[j]];
+		}
+		computeArg.meanFre=computeArg.meanFre/indexLength;
+	}
+
+	__parallel_for(timeLength,0,0,__spectralObj_computeChunk,&computeArg);
+
+	// per-feature api reuse cache
+	spectralObj->isSum=1;
+	if(featureMask&__spectralMomentMask){
+		spectralObj->isC1=1;
+	}
+
+	if(featureMask&(__spectralMomentMask&~SpectralFeature_Centroid)){
+		spectralObj->isC2=1;
+	}
+
+	if(featureMask&SpectralFeature_Entropy){
+		spectralObj->isEntropy=1;
+		spectralObj->isEnNorm=spectralObj->isNorm;
+	}
+
+	if(featureMask&SpectralFeature_Slope){
+		spectralObj->isMean=1;
+	}
+
+	return featureNum;
+}
+
+/***
+	frame row read once, pass1 sum/flatness/crest/decrease/hfc/flux
+	pass2 on cache-resident row for value need sum/centroid
+	same operation order as spectral_xxx
+****/
+static void __spectralObj_computeChunk(void *arg,int start,int end,int threadIndex){
+	SpectralComputeArg *computeArg=NULL;
+	SpectralObj spectralObj=NULL;
+
+	int num=0;
+	int timeLength=0;
+
+	int *indexArr=0;
+	int indexLength=0;
+
+	float *freArr=NULL;
+	float *outMatrix=NULL;
+	int *rowArr=NULL;
+	int featureMask=0;
+
+	int step=0;
+	float p=0;
+
+	int isC1=0;
+	int isC2=0;
+	int isPass2=0;
+
+	computeArg=(SpectralComputeArg *)arg;
+	spectralObj=computeArg->spectralObj;
+
+	num=spectralObj->num;
+	timeLength=spectralObj->timeLength;
+
+	indexArr=spectralObj->indexArr;
+	indexLength=spectralObj->indexLength;
+
+	freArr=spectralObj->freBandArr;
+	outMatrix=computeArg->outMatrix;
+	rowArr=computeArg->rowArr;
+	featureMask=computeArg->featureMask;
+
+	step=spectralObj->step;
+	p=spectralObj->p;
+
+	isC1=(featureMask&__spectralMomentMask)!=0;
+	isC2=(featureMask&(__spectralMomentMask&~SpectralFeature_Centroid))!=0;
+	isPass2=isC2||(featureMask&(SpectralFeature_Rolloff|SpectralFeature_Entropy|SpectralFeature_Slope));
+
+	for(int i=start;i<end;i++){
+		float *dataArr=NULL;
+		float *preArr=NULL;
+
+		float sum=0;
+		float c1=0;
+		float c2=0;
+
+		double logSum=0; // flatness
+		float maxValue=0; // crest
+		float decrease=0;
+		float hfc=0;
+		float flux=0;
+
+		float n2=0; // (f-c1)^2..^4
+		float n3=0;
+		float n4=0;
+		float entropy=0;
+		float slope1=0;
+		float slope2=0;
+		float meanValue=0;
+
+		int rolloffIndex=0;
+
+		dataArr=computeArg->mDataArr+i*num;
+		if(i>=step){
+			preArr=dataArr-step*num;
+		}
+
+		maxValue=dataArr[indexArr[0]];
+
+		// 1. pass1
+		for(int j=0;j<indexLength;j++){
+			int _index=0;
+			float v=0;
+
+			_index=indexArr[j];
+			v=dataArr[_index];
+
+			sum+=v;
+			if(isC1){
+				c1+=freArr[_index]*v;
+			}
+
+			if(featureMask&SpectralFeature_Flatness){
+				logSum+=logf(v+2.0e-16);
+			}
+
+			if(maxValue<v){
+				maxValue=v;
+			}
+
+			if(j&&(featureMask&SpectralFeature_Decrease)){
+				decrease+=(v-dataArr[indexArr[0]])/(_index);
+			}
+
+			hfc+=v*_index;
+
+			if(preArr&&(featureMask&SpectralFeature_Flux)){
+				float v1=0;
+
+				v1=v-preArr[_index];
+				if(spectralObj->isPostive){
+					v1=(v1>0?v1:0);
+				}
+				else{
+					v1=fabsf(v1);
+				}
+
+				if(p==2.0){
+					v1*=v1;
+				}
+				else{
+					v1=powf(v1, p);
+				}
+
+				flux+=v1;
+			}
+		}
+
+		c1=(sum?c1/sum:0);
+		meanValue=sum/indexLength;
+
+		// 2. pass2
+		if(isPass2){
+			float rolloffSum=0;
+			float rolloffThreshold=0;
+			int isRolloff=0;
+
+			rolloffThreshold=sum*spectralObj->threshold;
+			for(int j=0;j<indexLength;j++){
+				int _index=0;
+				float v=0;
+				float v1=0;
+
+				_index=indexArr[j];
+				v=dataArr[_index];
+
+				if(isC2){
+					v1=(freArr[_index]-c1);
+					n2+=v1*v1*v;
+					n3+=v1*v1*v1*v;
+					n4+=v1*v1*v1*v1*v;
+				}
+
+				if(featureMask&SpectralFeature_Entropy){
+					v1=v/sum;
+					entropy+=v1*log2f(v1+1e-16);
+				}
+
+				if(!isRolloff&&(featureMask&SpectralFeature_Rolloff)){
+					rolloffSum+=fabsf(v);
+					if(rolloffSum>=rolloffThreshold){
+						rolloffIndex=_index;
+						isRolloff=1;
+					}
+				}
+
+				if(featureMask&SpectralFeature_Slope){
+					v1=(freArr[_index]-computeArg->meanFre);
+					slope1+=v1*(v-meanValue);
+					slope2+=v1*v1;
+				}
+			}
+		}
+
+		c2=(sum?sqrtf(n2/sum):0);
+
+		// 3. cache for per-feature api
+		spectralObj->sumArr[i]=sum;
+		if(isC1){
+			spectralObj->cArr1[i]=c1;
+		}
+
+		if(isC2){
+			spectralObj->cArr2[i]=c2;
+		}
+
+		if(featureMask&SpectralFeature_Entropy){
+			if(spectralObj->isNorm){ // matlab
+				float m1=0;
+
+				m1=log2f(indexLength);
+				entropy=(m1?-entropy/m1:0);
+			}
+			else{ // song
+				entropy=-entropy;
+			}
+
+			spectralObj->entropyArr[i]=entropy;
+		}
+
+		if(featureMask&SpectralFeature_Slope){
+			spectralObj->meanFreArr[i]=computeArg->meanFre;
+			spectralObj->meanValueArr[i]=meanValue;
+		}
+
+		// 4. out
+		if(rowArr[0]>=0){ // flatness
+			double n1=0;
+			float m1=0;
+
+			n1=expf(logSum/indexLength);
+			m1=sum/indexLength;
+			outMatrix[rowArr[0]*timeLength+i]=(m1?n1/m1:0);
+		}
+
+		if(rowArr[1]>=0){ // flux
+			if(preArr){
+				if(spectralObj->type){ // mean
+					flux/=indexLength;
+				}
+
+				if(spectralObj->isExp){
+					flux=powf(flux, 1.0/p);
+				}
+			}
+
+			outMatrix[rowArr[1]*timeLength+i]=flux;
+		}
+
+		if(rowArr[2]>=0){ // rolloff
+			outMatrix[rowArr[2]*timeLength+i]=freArr[rolloffIndex];
+		}
+
+		if(rowArr[3]>=0){ // centroid
+			outMatrix[rowArr[3]*timeLength+i]=c1;
+		}
+
+		if(rowArr[4]>=0){ // spread
+			outMatrix[rowArr[4]*timeLength+i]=c2;
+		}
+
+		if(rowArr[5]>=0){ // skewness
+			float m1=0;
+
+			m1=c2*c2*c2*sum;
+			outMatrix[rowArr[5]*timeLength+i]=(m1?n3/m1:0);
+		}
+
+		if(rowArr[6]>=0){ // kurtosis
+			float m1=0;
+
+			m1=c2*c2*c2*c2*sum;
+			outMatrix[rowArr[6]*timeLength+i]=(m1?n4/m1:0);
+		}
+
+		if(rowArr[7]>=0){ // entropy
+			outMatrix[rowArr[7]*timeLength+i]=entropy;
+		}
+
+		if(rowArr[8]>=0){ // crest
+			float m1=0;
+
+			m1=sum/indexLength;
+			outMatrix[rowArr[8]*timeLength+i]=(m1?maxValue/m1:0);
+		}
+
+		if(rowArr[9]>=0){ // slope
+			outMatrix[rowArr[9]*timeLength+i]=(slope2?slope1/slope2:0);
+		}
+
+		if(rowArr[10]>=0){ // decrease
+			float m1=0;
+
+			m1=sum-dataArr[indexArr[0]];
+			outMatrix[rowArr[10]*timeLength+i]=(m1?decrease/m1:0);
+		}
+
+		if(rowArr[11]>=0){ // hfc
+			outMatrix[rowArr[11]*timeLength+i]=hfc;
+		}
+	}
+}
+
 // statistics
 void spectralObj_max(SpectralObj spectralObj,float *mDataArr,float *valueArr,float *freArr2){
 	int nLength=0;
@@ -9,7 +9,6 @@
 
 #include "../util/flux_util.h"
 
-#include "../dsp/fft_algorithm.h"
 #include "../dsp/dct_algorithm.h"
 
 #include "xxcc_algorithm.h"
@@ -19,15 +18,15 @@ struct OpaqueXXCC{
 	int timeLength;
 
 	// dct
-	FFTObj fftObj; // dct accelerate
-	DCTObj dctObj; // direct matrix
+	float *mDCTArr; // truncated basis ccNum*num
+	int ccNum;
 
 	float *mRealArr; // timeLength*num
 	float *mImageArr;
 
 };
 
-static int _calRadix2(int length);
+static void __xxccObj_dealDCT(XXCCObj xxccObj,int ccNum);
 
 int xxccObj_new(XXCCObj *xxccObj,int num){
 	int status=0;
@@ -37,27 +36,12 @@ int xxccObj_new(XXCCObj *xxccObj,int num){
 		return -1;
 	}
 
-	FFTObj fftObj=NULL;
-	DCTObj dctObj=NULL;
-	int r=0;
-
 	XXCCObj xc=NULL;
 
 	xc=*xxccObj=(XXCCObj )calloc(1, sizeof(struct OpaqueXXCC ));
 
-	r=_calRadix2(num);
-	if(r){ // dct accelerate
-		fftObj_new(&fftObj, r);
-	}
-	else{ // direct matrix
-		dctObj_new(&dctObj, num,NULL);
-	}
-
 	xc->num=num;
 
-	xc->fftObj=fftObj;
-	xc->dctObj=dctObj;
-
 	return status;
 }
 
@@ -93,27 +77,15 @@ void xxccObj_setTimeLength(XXCCObj xxccObj,int timeLength){
 	2. delta/deltaDelta
 ****/
 void xxccObj_xxcc(XXCCObj xxccObj,float *mDataArr1,int mLength,CepstralRectifyType *rectifyType,float *mDataArr2){
-	FFTObj fftObj=NULL;
-	DCTObj dctObj=NULL;
-
 	CepstralRectifyType recType=CepstralRectify_Log;
 
 	int num=0;
 	int timeLength=0;
 
-	float *mRealArr=NULL; 
-	float *mImageArr=NULL;
-
 	num=xxccObj->num;
 	timeLength=xxccObj->timeLength;
 
-	mRealArr=xxccObj->mRealArr;
-	mImageArr=xxccObj->mImageArr;
-
-	fftObj=xxccObj->fftObj;
-	dctObj=xxccObj->dctObj;
-
-	if(mLength>num){
+	if(mLength>num||mLength<1){
 		return;
 	}
 
@@ -121,38 +93,11 @@ void xxccObj_xxcc(XXCCObj xxccObj,float *mDataArr1,int mLength,CepstralRectifyTy
 		recType=*rectifyType;
 	}
 
-	if(recType==CepstralRectify_CubicRoot){
-		for(int i=0;i<timeLength*num;i++){
-			mRealArr[i]=powf(mDataArr1[i], 1.0/3);
-		}
-	}
-	else { // log
-		for(int i=0;i<timeLength*num;i++){
-			float _value=0;
-
-			_value=mDataArr1[i];
-			if(_value<1e-8){
-				_value=1e-8;
-			}
-
-			mRealArr[i]=log10f(_value); // matlab canonic
-		}
-	}
-
-	for(int i=0;i<timeLength;i++){
-		if(fftObj){
-			fftObj_dct(fftObj, mRealArr+i*num, mImageArr+i*num, 1);
-		}
-		else{
-			dctObj_dct(dctObj, mRealArr+i*num,1,mImageArr+i*num);
-		}
-	}
-
-	for(int i=0;i<timeLength;i++){
-		for(int j=0;j<mLength;j++){
-			mDataArr2[i*mLength+j]=mImageArr[i*num+j];
-		}
-	}
+	// rectify+truncated dct, only ccNum rows
+	__xxccObj_dealDCT(xxccObj,mLength);
+	dct_cepstrum(mDataArr1,timeLength,num,
+				xxccObj->mDCTArr,mLength,recType,
+				xxccObj->mRealArr,mDataArr2);
 }
 
 /***
@@ -172,9 +117,6 @@ void xxccObj_xxccStandard(XXCCObj xxccObj,float *mDataArr1,int mLength,float *en
 	CepstralEnergyType eType=CepstralEnergy_Replace;
 	CepstralRectifyType rType=CepstralRectify_Log;
 
-	FFTObj fftObj=NULL;
-	DCTObj dctObj=NULL;
-
 	int num=0;
 	int timeLength=0;
 
@@ -192,10 +134,7 @@ void xxccObj_xxccStandard(XXCCObj xxccObj,float *mDataArr1,int mLength,float *en
 	mRealArr=xxccObj->mRealArr;
 	mImageArr=xxccObj->mImageArr;
 
-	fftObj=xxccObj->fftObj;
-	dctObj=xxccObj->dctObj;
-
-	if(mLength>num){
+	if(mLength>num||mLength<1){
 		return;
 	}
 
@@ -213,32 +152,11 @@ void xxccObj_xxccStandard(XXCCObj xxccObj,float *mDataArr1,int mLength,float *en
 		rType=*rectifyType;
 	}
 
-	if(rType==CepstralRectify_CubicRoot){
-		for(int i=0;i<timeLength*num;i++){
-			mRealArr[i]=powf(mDataArr1[i], 1.0/3);
-		}
-	}
-	else { // log
-		for(int i=0;i<timeLength*num;i++){
-			float _value=0;
-
-			_value=mDataArr1[i];
-			if(_value<1e-8){
-				_value=1e-8;
-			}
-
-			mRealArr[i]=log10f(_value); // matlab canonic
-		}
-	}
-
-	for(int i=0;i<timeLength;i++){
-		if(fftObj){
-			fftObj_dct(fftObj, mRealArr+i*num, mImageArr+i*num, 1);
-		}
-		else{
-			dctObj_dct(dctObj, mRealArr+i*num,1,mImageArr+i*num);
-		}
-	}
+	// mImageArr timeLength*ccNum
+	__xxccObj_dealDCT(xxccObj,mLength);
+	dct_cepstrum(mDataArr1,timeLength,num,
+				xxccObj->mDCTArr,mLength,rType,
+				mRealArr,mImageArr);
 
 	// 1. coef
 	for(int i=0;i<timeLength;i++){
@@ -257,7 +175,7 @@ void xxccObj_xxccStandard(XXCCObj xxccObj,float *mDataArr1,int mLength,float *en
 					mCoeArr[i*mLength+j]=energy;
 				}
 				else{
-					mCoeArr[i*mLength+j]=mImageArr[i*num+j];
+					mCoeArr[i*mLength+j]=mImageArr[i*mLength+j];
 				}
 			}
 			else if(eType==CepstralEnergy_Append){
@@ -265,10 +183,10 @@ void xxccObj_xxccStandard(XXCCObj xxccObj,float *mDataArr1,int mLength,float *en
 					mCoeArr[i*(mLength+1)+j]=energy;
 				}
 				
-				mCoeArr[i*(mLength+1)+(j+1)]=mImageArr[i*num+j];
+				mCoeArr[i*(mLength+1)+(j+1)]=mImageArr[i*mLength+j];
 			}
 			else{
-				mCoeArr[i*mLength+j]=mImageArr[i*num+j];
+				mCoeArr[i*mLength+j]=mImageArr[i*mLength+j];
 			}
 		}
 	}
@@ -296,21 +214,14 @@ void xxccObj_xxccStandard(XXCCObj xxccObj,float *mDataArr1,int mLength,float *en
 }
 
 void xxccObj_free(XXCCObj xxccObj){
-	FFTObj fftObj=NULL; // dct accelerate
-	DCTObj dctObj=NULL; // direct matrix
-
 	float *mRealArr=NULL; // timeLength*num
 	float *mImageArr=NULL;
 
 	if(xxccObj){
-		fftObj=xxccObj->fftObj;
-		dctObj=xxccObj->dctObj;
-
 		mRealArr=xxccObj->mRealArr;
 		mImageArr=xxccObj->mImageArr;
 
-		fftObj_free(fftObj);
-		dctObj_free(dctObj);
+		free(xxccObj->mDCTArr);
 
 		free(mRealArr);
 		free(mImageArr);
@@ -319,37 +230,14 @@ void xxccObj_free(XXCCObj xxccObj){
 	}
 }
 
-static int _calRadix2(int length){
-	int r=0;
-	int m=0;
-
-	while(1){
-		m=length%2;
-		if(!m){ //
-			r++;
-			length=length/2;
-			if(length==1){
-				break;
-			}
-		}
-		else{
-			r=0;
-			break;
-		}
+static void __xxccObj_dealDCT(XXCCObj xxccObj,int ccNum){
+
+	if(xxccObj->mDCTArr&&xxccObj->ccNum==ccNum){
+		return;
 	}
 
-	return r;
+	free(xxccObj->mDCTArr);
+	xxccObj->mDCTArr=dct_createMatrix(xxccObj->num,ccNum);
+	xxccObj->ccNum=ccNum;
 }
 
-
-
-
-
-
-
-
-
-
-
-
-
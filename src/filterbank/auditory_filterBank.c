@@ -206,6 +206,79 @@ void auditory_filterBank(int num,int fftLength,int samplate,int isPseudo,
 	free(bArr);
 }
 
+int auditory_sparseFilterBank(float *mFilterBankArr,int num,int mLength,
+							int *startArr,int *lengthArr,int *offsetArr,float **weightArr){
+	int totalLength=0;
+	float *wArr=NULL;
+
+	for(int i=0;i<num;i++){
+		int start=0;
+		int end=-1;
+
+		for(int j=0;j<mLength;j++){
+			if(mFilterBankArr[i*mLength+j]!=0){
+				if(end<0){
+					start=j;
+				}
+
+				end=j;
+			}
+		}
+
+		startArr[i]=start;
+		lengthArr[i]=end-start+1;
+		offsetArr[i]=totalLength;
+
+		totalLength+=lengthArr[i];
+	}
+
+	wArr=__vnew(totalLength>0?totalLength:1, NULL);
+	for(int i=0;i<num;i++){
+		memcpy(wArr+offsetArr[i], mFilterBankArr+i*mLength+startArr[i], sizeof(float )*lengthArr[i]);
+	}
+
+	*weightArr=wArr;
+	return totalLength;
+}
+
+// 4 partial sums per band, contiguous bins
+void auditory_sparseDot(float *mDataArr1,int timeLength,int mLength,
+						int num,int *startArr,int *lengthArr,int *offsetArr,float *weightArr,
+						float *mDataArr2){
+
+	for(int i=0;i<timeLength;i++){
+		for(int k=0;k<num;k++){
+			float *dataArr=NULL;
+			float *wArr=NULL;
+			int length=0;
+
+			float v1=0;
+			float v2=0;
+			float v3=0;
+			float v4=0;
+
+			int j=0;
+
+			dataArr=mDataArr1+i*mLength+startArr[k];
+			wArr=weightArr+offsetArr[k];
+			length=lengthArr[k];
+
+			for(j=0;j+4<=length;j+=4){
+				v1+=dataArr[j]*wArr[j];
+				v2+=dataArr[j+1]*wArr[j+1];
+				v3+=dataArr[j+2]*wArr[j+2];
+				v4+=dataArr[j+3]*wArr[j+3];
+			}
+
+			for(;j<length;j++){
+				v1+=dataArr[j]*wArr[j];
+			}
+
+			mDataArr2[i*num+k]=(v1+v2)+(v3+v4);
+		}
+	}
+}
+
 // rect~guass 窗函数设计法
 static void __auditory_windowFilterBank(int num,int fftLength,int samplate,int isPseudo,
 									SpectralFilterBankStyleType winType,
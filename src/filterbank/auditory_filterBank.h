@@ -25,6 +25,19 @@ void auditory_filterBank(int num,int fftLength,int samplate,int isPseudo,
 						float *freBandArr,
 						int *binBandArr);
 
+/***
+	banded form of dense num*mLength filterBank
+	row i nonzero bins startArr[i]~startArr[i]+lengthArr[i]-1, weights at *weightArr+offsetArr[i]
+	return total weight length
+****/
+int auditory_sparseFilterBank(float *mFilterBankArr,int num,int mLength,
+							int *startArr,int *lengthArr,int *offsetArr,float **weightArr);
+
+// mDataArr1 timeLength*mLength dot banded filterBank => mDataArr2 timeLength*num
+void auditory_sparseDot(float *mDataArr1,int timeLength,int mLength,
+						int num,int *startArr,int *lengthArr,int *offsetArr,float *weightArr,
+						float *mDataArr2);
+
 // linear scale
 float auditory_freToLinear(float fre,float detFre);
 float auditory_linearToFre(float value,float detFre);
@@ -39,6 +39,7 @@ static void __cqt_filterBank(int num,float *freBandArr,int samplate,
 	2. freKernel计算
 	3. 阈值过滤
 	mFilterBankArr=>num*(fftLength/2+1) num即length 非稀疏矩阵 
+	cqt_sparseFilterBank => banded sparse, thresh越大越稀疏
 ****/
 void cqt_filterBank(int num,float *freBandArr,int samplate,
 				int binPerOctave,SpectralFilterBankNormalType normType,WindowType *winType,
@@ -147,6 +148,98 @@ void cqt_downFilterBank(int num,float *freBandArr,int samplate,
 	fftObj_free(fftObj);
 }
 
+int cqt_sparseFilterBank(float *mRealFilterBankArr,float *mImageFilterBankArr,int num,int mLength,
+						int *startArr,int *lengthArr,int *offsetArr,
+						float **realArr,float **imageArr){
+	int totalLength=0;
+
+	float *rArr=NULL;
+	float *iArr=NULL;
+
+	for(int i=0;i<num;i++){
+		int start=0;
+		int end=-1;
+
+		for(int j=0;j<mLength;j++){
+			if(mRealFilterBankArr[i*mLength+j]!=0||
+				mImageFilterBankArr[i*mLength+j]!=0){
+				if(end<0){
+					start=j;
+				}
+
+				end=j;
+			}
+		}
+
+		startArr[i]=start;
+		lengthArr[i]=end-start+1;
+		offsetArr[i]=totalLength;
+
+		totalLength+=lengthArr[i];
+	}
+
+	rArr=__vnew(totalLength>0?totalLength:1, NULL);
+	iArr=__vnew(totalLength>0?totalLength:1, NULL);
+	for(int i=0;i<num;i++){
+		memcpy(rArr+offsetArr[i], mRealFilterBankArr+i*mLength+startArr[i], sizeof(float )*lengthArr[i]);
+		memcpy(iArr+offsetArr[i], mImageFilterBankArr+i*mLength+startArr[i], sizeof(float )*lengthArr[i]);
+	}
+
+	*realArr=rArr;
+	*imageArr=iArr;
+
+	return totalLength;
+}
+
+// 2 partial sums per band, contiguous bins
+void cqt_sparseDot(float *mRealArr1,float *mImageArr1,int timeLength,int mLength,
+				int num,int *startArr,int *lengthArr,int *offsetArr,
+				float *realArr,float *imageArr,
+				float *mRealArr2,float *mImageArr2){
+
+	for(int i=0;i<timeLength;i++){
+		for(int k=0;k<num;k++){
+			float *rArr1=NULL;
+			float *iArr1=NULL;
+
+			float *rArr2=NULL;
+			float *iArr2=NULL;
+
+			int length=0;
+
+			float r1=0;
+			float i1=0;
+			float r2=0;
+			float i2=0;
+
+			int j=0;
+
+			rArr1=mRealArr1+i*mLength+startArr[k];
+			iArr1=mImageArr1+i*mLength+startArr[k];
+
+			rArr2=realArr+offsetArr[k];
+			iArr2=imageArr+offsetArr[k];
+
+			length=lengthArr[k];
+			for(j=0;j+2<=length;j+=2){
+				r1+=rArr1[j]*rArr2[j]-iArr1[j]*iArr2[j];
+				i1+=iArr1[j]*rArr2[j]+rArr1[j]*iArr2[j];
+
+				r2+=rArr1[j+1]*rArr2[j+1]-iArr1[j+1]*iArr2[j+1];
+				i2+=iArr1[j+1]*rArr2[j+1]+rArr1[j+1]*iArr2[j+1];
+			}
+
+			for(;j<length;j++){
+				r1+=rArr1[j]*rArr2[j]-iArr1[j]*iArr2[j];
+				i1+=iArr1[j]*rArr2[j]+rArr1[j]*iArr2[j];
+			}
+
+			mRealArr2[i*num+k]=r1+r2;
+			mImageArr2[i*num+k]=i1+i2;
+		}
+	}
+}
+
 // factor 1.0  sacle/(2^(1/binPerOctave)-1)
 float cqt_calQ(int binPerOctave,float factor){
 	float q=0;
@@ -24,6 +24,21 @@ void cqt_downFilterBank(int num,float *freBandArr,int samplate,
 				float *lenArr,int fftLength,
 				float *mRealFilterBankArr,float *mImageFilterBankArr);
 
+/***
+	banded complex form of thresholded dense num*mLength kernel(Brown-Puckette sparse kernel)
+	row i nonzero bins startArr[i]~startArr[i]+lengthArr[i]-1, weights at (*realArr)+offsetArr[i], (*imageArr)+offsetArr[i]
+	return total weight length
+****/
+int cqt_sparseFilterBank(float *mRealFilterBankArr,float *mImageFilterBankArr,int num,int mLength,
+						int *startArr,int *lengthArr,int *offsetArr,
+						float **realArr,float **imageArr);
+
+// complex mRealArr1/mImageArr1 timeLength*mLength dot banded kernel => timeLength*num
+void cqt_sparseDot(float *mRealArr1,float *mImageArr1,int timeLength,int mLength,
+				int num,int *startArr,int *lengthArr,int *offsetArr,
+				float *realArr,float *imageArr,
+				float *mRealArr2,float *mImageArr2);
+
 float cqt_calQ(int binPerOctave,float factor);
 float *cqt_calFreArr(float minFre,int num,int binPerOctave);
 
@@ -0,0 +1,538 @@
+//
+
+#include <string.h>
+#include <pthread.h>
+
+#include "filterBank_cache.h"
+
+#define FILTERBANK_CACHE_PARAM 16
+#define FILTERBANK_CACHE_ARR 8
+#define FILTERBANK_CACHE_BUCKET 64
+
+// file head 'AFFB'+version
+#define FILTERBANK_CACHE_MAGIC 0x42464641
+#define FILTERBANK_CACHE_VERSION 1
+
+struct OpaqueFilterBankCache{
+	FilterBankCacheType type;
+
+	double paramArr[FILTERBANK_CACHE_PARAM];
+	int paramLength;
+
+	unsigned int hash;
+
+	int refCount;
+	int isCache; // in bucket
+
+	float *arrArr[FILTERBANK_CACHE_ARR];
+	int lengthArr[FILTERBANK_CACHE_ARR];
+	int arrLength;
+
+	int *iArrArr[FILTERBANK_CACHE_ARR];
+	int iLengthArr[FILTERBANK_CACHE_ARR];
+	int iArrLength;
+
+	struct OpaqueFilterBankCache *next;
+};
+
+static FilterBankCacheObj __bucketArr[FILTERBANK_CACHE_BUCKET];
+static pthread_mutex_t __cacheMutex=PTHREAD_MUTEX_INITIALIZER;
+
+static int __isEnable=1;
+
+static unsigned int __filterBankCache_hash(FilterBankCacheType type,double *paramArr,int paramLength);
+
+// lock hold
+static FilterBankCacheObj __filterBankCache_lookup(FilterBankCacheType type,double *paramArr,int paramLength,unsigned int hash);
+static void __filterBankCache_link(FilterBankCacheObj cacheObj);
+
+static FilterBankCacheObj __filterBankCacheObj_new(FilterBankCacheType type,double *paramArr,int paramLength,
+												float **arrArr,int *lengthArr,int arrLength,
+												int **iArrArr,int *iLengthArr,int iArrLength);
+static void __filterBankCacheObj_free(FilterBankCacheObj cacheObj);
+
+static FilterBankCacheObj __filterBankCacheObj_read(FILE *fp);
+static int __filterBankCacheObj_write(FilterBankCacheObj cacheObj,FILE *fp);
+
+FilterBankCacheObj filterBankCache_find(FilterBankCacheType type,double *paramArr,int paramLength){
+	FilterBankCacheObj cacheObj=NULL;
+	unsigned int hash=0;
+
+	if(paramLength<0||paramLength>FILTERBANK_CACHE_PARAM){
+		return NULL;
+	}
+
+	hash=__filterBankCache_hash(type,paramArr,paramLength);
+
+	pthread_mutex_lock(&__cacheMutex);
+
+	if(__isEnable){
+		cacheObj=__filterBankCache_lookup(type,paramArr,paramLength,hash);
+		if(cacheObj){
+			cacheObj->refCount++;
+		}
+	}
+
+	pthread_mutex_unlock(&__cacheMutex);
+
+	return cacheObj;
+}
+
+FilterBankCacheObj filterBankCache_insert(FilterBankCacheType type,double *paramArr,int paramLength,
+										float **arrArr,int *lengthArr,int arrLength,
+										int **iArrArr,int *iLengthArr,int iArrLength){
+	FilterBankCacheObj cacheObj=NULL;
+	FilterBankCacheObj curObj=NULL;
+
+	if(paramLength<0||paramLength>FILTERBANK_CACHE_PARAM||
+		arrLength<0||arrLength>FILTERBANK_CACHE_ARR||
+		iArrLength<0||iArrLength>FILTERBANK_CACHE_ARR){
+		return NULL;
+	}
+
+	cacheObj=__filterBankCacheObj_new(type,paramArr,paramLength,
+									arrArr,lengthArr,arrLength,
+									iArrArr,iLengthArr,iArrLength);
+	cacheObj->refCount=1;
+
+	pthread_mutex_lock(&__cacheMutex);
+
+	if(__isEnable){
+		curObj=__filterBankCache_lookup(type,paramArr,paramLength,cacheObj->hash);
+		if(curObj){ // built twice, keep first
+			curObj->refCount++;
+		}
+		else{
+			__filterBankCache_link(cacheObj);
+		}
+	}
+
+	pthread_mutex_unlock(&__cacheMutex);
+
+	if(curObj){
+		__filterBankCacheObj_free(cacheObj);
+		cacheObj=curObj;
+	}
+
+	return cacheObj;
+}
+
+float *filterBankCacheObj_getArr(FilterBankCacheObj cacheObj,int index){
+
+	if(index<0||index>=cacheObj->arrLength){
+		return NULL;
+	}
+
+	return cacheObj->arrArr[index];
+}
+
+int *filterBankCacheObj_getIntArr(FilterBankCacheObj cacheObj,int index){
+
+	if(index<0||index>=cacheObj->iArrLength){
+		return NULL;
+	}
+
+	return cacheObj->iArrArr[index];
+}
+
+int filterBankCacheObj_getArrLength(FilterBankCacheObj cacheObj,int index){
+
+	if(index<0||index>=cacheObj->arrLength){
+		return 0;
+	}
+
+	return cacheObj->lengthArr[index];
+}
+
+int filterBankCacheObj_getIntArrLength(FilterBankCacheObj cacheObj,int index){
+
+	if(index<0||index>=cacheObj->iArrLength){
+		return 0;
+	}
+
+	return cacheObj->iLengthArr[index];
+}
+
+void filterBankCacheObj_discard(FilterBankCacheObj cacheObj){
+
+	if(!cacheObj){
+		return;
+	}
+
+	pthread_mutex_lock(&__cacheMutex);
+
+	if(cacheObj->isCache){
+		FilterBankCacheObj *curArr=NULL;
+
+		curArr=&__bucketArr[cacheObj->hash%FILTERBANK_CACHE_BUCKET];
+		while(*curArr&&*curArr!=cacheObj){
+			curArr=&(*curArr)->next;
+		}
+
+		if(*curArr){
+			*curArr=cacheObj->next;
+		}
+
+		cacheObj->isCache=0;
+		cacheObj->next=NULL;
+	}
+
+	pthread_mutex_unlock(&__cacheMutex);
+
+	filterBankCacheObj_release(cacheObj);
+}
+
+void filterBankCacheObj_release(FilterBankCacheObj cacheObj){
+	int isFree=0;
+
+	if(!cacheObj){
+		return;
+	}
+
+	pthread_mutex_lock(&__cacheMutex);
+
+	cacheObj->refCount--;
+	if(!cacheObj->refCount&&!cacheObj->isCache){
+		isFree=1;
+	}
+
+	pthread_mutex_unlock(&__cacheMutex);
+
+	if(isFree){
+		__filterBankCacheObj_free(cacheObj);
+	}
+}
+
+void filterBankCache_enable(int flag){
+
+	pthread_mutex_lock(&__cacheMutex);
+	__isEnable=(flag?1:0);
+	pthread_mutex_unlock(&__cacheMutex);
+}
+
+void filterBankCache_clear(){
+
+	pthread_mutex_lock(&__cacheMutex);
+
+	for(int i=0;i<FILTERBANK_CACHE_BUCKET;i++){
+		FilterBankCacheObj *curArr=NULL;
+
+		curArr=&__bucketArr[i];
+		while(*curArr){
+			FilterBankCacheObj cacheObj=NULL;
+
+			cacheObj=*curArr;
+			if(!cacheObj->refCount){
+				*curArr=cacheObj->next;
+				__filterBankCacheObj_free(cacheObj);
+			}
+			else{ // in use, free at last release
+				*curArr=cacheObj->next;
+				cacheObj->isCache=0;
+				cacheObj->next=NULL;
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&__cacheMutex);
+}
+
+int filterBankCache_import(char *fileName){
+	FILE *fp=NULL;
+
+	int head[3]={0};
+	int status=0;
+
+	fp=fopen(fileName, "rb");
+	if(!fp){
+		return -1;
+	}
+
+	if(fread(head, sizeof(int ), 3, fp)!=3||
+		head[0]!=FILTERBANK_CACHE_MAGIC||
+		head[1]!=FILTERBANK_CACHE_VERSION||
+		head[2]<0){
+		fclose(fp);
+		return -1;
+	}
+
+	pthread_mutex_lock(&__cacheMutex);
+
+	for(int i=0;i<head[2];i++){
+		FilterBankCacheObj cacheObj=NULL;
+
+		cacheObj=__filterBankCacheObj_read(fp);
+		if(!cacheObj){
+			status=-1;
+			break;
+		}
+
+		if(__filterBankCache_lookup(cacheObj->type,cacheObj->paramArr,cacheObj->paramLength,cacheObj->hash)){
+			__filterBankCacheObj_free(cacheObj);
+		}
+		else{
+			__filterBankCache_link(cacheObj);
+		}
+	}
+
+	pthread_mutex_unlock(&__cacheMutex);
+
+	fclose(fp);
+	return status;
+}
+
+int filterBankCache_export(char *fileName){
+	FILE *fp=NULL;
+
+	int head[3]={0};
+	int status=0;
+
+	fp=fopen(fileName, "wb");
+	if(!fp){
+		return -1;
+	}
+
+	pthread_mutex_lock(&__cacheMutex);
+
+	head[0]=FILTERBANK_CACHE_MAGIC;
+	head[1]=FILTERBANK_CACHE_VERSION;
+	for(int i=0;i<FILTERBANK_CACHE_BUCKET;i++){
+		for(FilterBankCacheObj cacheObj=__bucketArr[i];cacheObj;cacheObj=cacheObj->next){
+			head[2]++;
+		}
+	}
+
+	if(fwrite(head, sizeof(int ), 3, fp)!=3){
+		status=-1;
+	}
+
+	for(int i=0;i<FILTERBANK_CACHE_BUCKET&&!status;i++){
+		for(FilterBankCacheObj cacheObj=__bucketArr[i];cacheObj&&!status;cacheObj=cacheObj->next){
+			status=__filterBankCacheObj_write(cacheObj,fp);
+		}
+	}
+
+	pthread_mutex_unlock(&__cacheMutex);
+
+	if(fclose(fp)){
+		status=-1;
+	}
+
+	return status;
+}
+
+// FNV-1a
+static unsigned int __filterBankCache_hash(FilterBankCacheType type,double *paramArr,int paramLength){
+	unsigned int hash=2166136261u;
+	unsigned char *byteArr=NULL;
+
+	hash=(hash^(unsigned int )type)*16777619u;
+	hash=(hash^(unsigned int )paramLength)*16777619u;
+
+	byteArr=(unsigned char *)paramArr;
+	for(int i=0;i<(int )(paramLength*sizeof(double ));i++){
+		hash=(hash^byteArr[i])*16777619u;
+	}
+
+	return hash;
+}
+
+static FilterBankCacheObj __filterBankCache_lookup(FilterBankCacheType type,double *paramArr,int paramLength,unsigned int hash){
+	FilterBankCacheObj cacheObj=NULL;
+
+	cacheObj=__bucketArr[hash%FILTERBANK_CACHE_BUCKET];
+	for(;cacheObj;cacheObj=cacheObj->next){
+		if(cacheObj->hash==hash&&
+			cacheObj->type==type&&
+			cacheObj->paramLength==paramLength&&
+			!memcmp(cacheObj->paramArr, paramArr, sizeof(double )*paramLength)){
+
+			break;
+		}
+	}
+
+	return cacheObj;
+}
+
+static void __filterBankCache_link(FilterBankCacheObj cacheObj){
+	int index=0;
+
+	index=cacheObj->hash%FILTERBANK_CACHE_BUCKET;
+
+	cacheObj->isCache=1;
+	cacheObj->next=__bucketArr[index];
+	__bucketArr[index]=cacheObj;
+}
+
+static FilterBankCacheObj __filterBankCacheObj_new(FilterBankCacheType type,double *paramArr,int paramLength,
+												float **arrArr,int *lengthArr,int arrLength,
+												int **iArrArr,int *iLengthArr,int iArrLength){
+	FilterBankCacheObj cacheObj=NULL;
+
+	cacheObj=(FilterBankCacheObj )calloc(1, sizeof(struct OpaqueFilterBankCache ));
+
+	cacheObj->type=type;
+	if(paramLength){
+		memcpy(cacheObj->paramArr, paramArr, sizeof(double )*paramLength);
+	}
+	cacheObj->paramLength=paramLength;
+	cacheObj->hash=__filterBankCache_hash(type,paramArr,paramLength);
+
+	for(int i=0;i<arrLength;i++){
+		cacheObj->arrArr[i]=arrArr[i];
+		cacheObj->lengthArr[i]=(arrArr[i]?lengthArr[i]:0);
+	}
+	cacheObj->arrLength=arrLength;
+
+	for(int i=0;i<iArrLength;i++){
+		cacheObj->iArrArr[i]=iArrArr[i];
+		cacheObj->iLengthArr[i]=(iArrArr[i]?iLengthArr[i]:0);
+	}
+	cacheObj->iArrLength=iArrLength;
+
+	return cacheObj;
+}
+
+static void __filterBankCacheObj_free(FilterBankCacheObj cacheObj){
+
+	for(int i=0;i<cacheObj->arrLength;i++){
+		free(cacheObj->arrArr[i]);
+	}
+
+	for(int i=0;i<cacheObj->iArrLength;i++){
+		free(cacheObj->iArrArr[i]);
+	}
+
+	free(cacheObj);
+}
+
+/***
+	entry record
+	type,paramLength,paramArr
+	arrLength,(length,data)...
+	iArrLength,(length,data)...
+****/
+static FilterBankCacheObj __filterBankCacheObj_read(FILE *fp){
+	FilterBankCacheObj cacheObj=NULL;
+
+	int head[2]={0};
+	double paramArr[FILTERBANK_CACHE_PARAM]={0};
+
+	float *arrArr[FILTERBANK_CACHE_ARR]={0};
+	int lengthArr[FILTERBANK_CACHE_ARR]={0};
+	int arrLength=0;
+
+	int *iArrArr[FILTERBANK_CACHE_ARR]={0};
+	int iLengthArr[FILTERBANK_CACHE_ARR]={0};
+	int iArrLength=0;
+
+	int status=0;
+
+	if(fread(head, sizeof(int ), 2, fp)!=2||
+		head[1]<0||head[1]>FILTERBANK_CACHE_PARAM||
+		fread(paramArr, sizeof(double ), head[1], fp)!=(size_t )head[1]){
+		return NULL;
+	}
+
+	if(fread(&arrLength, sizeof(int ), 1, fp)!=1||
+		arrLength<0||arrLength>FILTERBANK_CACHE_ARR){
+		return NULL;
+	}
+
+	for(int i=0;i<arrLength&&!status;i++){
+		if(fread(lengthArr+i, sizeof(int ), 1, fp)!=1||lengthArr[i]<0){
+			status=-1;
+			break;
+		}
+
+		if(lengthArr[i]){
+			arrArr[i]=(float *)malloc(sizeof(float )*lengthArr[i]);
+			if(fread(arrArr[i], sizeof(float ), lengthArr[i], fp)!=(size_t )lengthArr[i]){
+				status=-1;
+			}
+		}
+	}
+
+	if(!status&&(fread(&iArrLength, sizeof(int ), 1, fp)!=1||
+				iArrLength<0||iArrLength>FILTERBANK_CACHE_ARR)){
+		iArrLength=0;
+		status=-1;
+	}
+
+	for(int i=0;i<iArrLength&&!status;i++){
+		if(fread(iLengthArr+i, sizeof(int ), 1, fp)!=1||iLengthArr[i]<0){
+			status=-1;
+			break;
+		}
+
+		if(iLengthArr[i]){
+			iArrArr[i]=(int *)malloc(sizeof(int )*iLengthArr[i]);
+			if(fread(iArrArr[i], sizeof(int ), iLengthArr[i], fp)!=(size_t )iLengthArr[i]){
+				status=-1;
+			}
+		}
+	}
+
+	if(status){
+		for(int i=0;i<FILTERBANK_CACHE_ARR;i++){
+			free(arrArr[i]);
+			free(iArrArr[i]);
+		}
+
+		return NULL;
+	}
+
+	cacheObj=__filterBankCacheObj_new((FilterBankCacheType )head[0],paramArr,head[1],
+									arrArr,lengthArr,arrLength,
+									iArrArr,iLengthArr,iArrLength);
+
+	return cacheObj;
+}
+
+static int __filterBankCacheObj_write(FilterBankCacheObj cacheObj,FILE *fp){
+	int head[2]={0};
+	size_t count=0;
+
+	head[0]=cacheObj->type;
+	head[1]=cacheObj->paramLength;
+
+	count+=fwrite(head, sizeof(int ), 2, fp);
+	count+=fwrite(cacheObj->paramArr, sizeof(double ), cacheObj->paramLength, fp);
+	if(count!=(size_t )(2+cacheObj->paramLength)){
+		return -1;
+	}
+
+	if(fwrite(&cacheObj->arrLength, sizeof(int ), 1, fp)!=1){
+		return -1;
+	}
+
+	for(int i=0;i<cacheObj->arrLength;i++){
+		if(fwrite(cacheObj->lengthArr+i, sizeof(int ), 1, fp)!=1){
+			return -1;
+		}
+
+		// empty item(NULL&&length 0) write length only
+		if(cacheObj->lengthArr[i]>0&&cacheObj->arrArr[i]&&
+			fwrite(cacheObj->arrArr[i], sizeof(float ), cacheObj->lengthArr[i], fp)!=(size_t )cacheObj->lengthArr[i]){
+			return -1;
+		}
+	}
+
+	if(fwrite(&cacheObj->iArrLength, sizeof(int ), 1, fp)!=1){
+		return -1;
+	}
+
+	for(int i=0;i<cacheObj->iArrLength;i++){
+		if(fwrite(cacheObj->iLengthArr+i, sizeof(int ), 1, fp)!=1){
+			return -1;
+		}
+
+		// empty item(NULL&&length 0) write length only
+		if(cacheObj->iLengthArr[i]>0&&cacheObj->iArrArr[i]&&
+			fwrite(cacheObj->iArrArr[i], sizeof(int ), cacheObj->iLengthArr[i], fp)!=(size_t )cacheObj->iLengthArr[i]){
+			return -1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,67 @@
+
+
+#ifndef FILTERBANK_CACHE_H
+#define FILTERBANK_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef enum{
+	FilterBankCache_Auditory=0, // spectrogram mel/bark/erb/octave/linspace/log/logChroma
+	FilterBankCache_CQT,
+	FilterBankCache_CWT,
+	FilterBankCache_NSGT,
+
+} FilterBankCacheType;
+
+typedef struct OpaqueFilterBankCache *FilterBankCacheObj;
+
+/***
+	process filterBank cache, key type+paramArr(<=16, exact compare)
+	entry immutable after insert, refCount guard by cache mutex
+	find hit => one reference, NULL miss
+****/
+FilterBankCacheObj filterBankCache_find(FilterBankCacheType type,double *paramArr,int paramLength);
+
+/***
+	insert own arrArr/iArrArr item(<=8 each, item can NULL&&length 0)
+	key already cached(other thread) => items free, cached entry return
+	return entry hold one reference
+****/
+FilterBankCacheObj filterBankCache_insert(FilterBankCacheType type,double *paramArr,int paramLength,
+										float **arrArr,int *lengthArr,int arrLength,
+										int **iArrArr,int *iLengthArr,int iArrLength);
+
+// index out of range => NULL/0
+float *filterBankCacheObj_getArr(FilterBankCacheObj cacheObj,int index);
+int *filterBankCacheObj_getIntArr(FilterBankCacheObj cacheObj,int index);
+int filterBankCacheObj_getArrLength(FilterBankCacheObj cacheObj,int index);
+int filterBankCacheObj_getIntArrLength(FilterBankCacheObj cacheObj,int index);
+
+/***
+	entry shape not what consumer index(e.g. imported file of other build) => discard
+	unlink from cache and release the reference; next find miss, insert rebuild
+****/
+void filterBankCacheObj_discard(FilterBankCacheObj cacheObj);
+
+void filterBankCacheObj_release(FilterBankCacheObj cacheObj);
+
+// flag 0 => new entry not cached, freed by last release; default 1
+void filterBankCache_enable(int flag);
+
+// free cached entry no object use
+void filterBankCache_clear();
+
+// cache file; 0 success, -1 fail; import skip key already cached
+int filterBankCache_import(char *fileName);
+int filterBankCache_export(char *fileName);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
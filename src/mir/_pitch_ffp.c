@@ -105,7 +105,7 @@ struct OpaquePitchFFP{
 	int *fastLenArr4;
 
 	// cache
-	float *mRealArr; // timeLength*fftLength
+	float *mRealArr; // timeLength*(fftLength/2+1)
 	float *mImageArr;
 
 	int *domIndexArr;
@@ -240,6 +240,7 @@ int pitchFFPObj_new(PitchFFPObj *pitchFFPObj,
 	peakLength=(maxIndex-minIndex)/2+1;
 
 	stftObj_new(&stftObj, _radix2Exp, &_winType, &_slideLength, &_isContinue);
+	stftObj_enableHalfSpectrum(stftObj, 1);
 	
 	pitch->isContinue=_isContinue;
 
@@ -2312,7 +2313,7 @@ static void __pitchFFPObj_stft(PitchFFPObj pitchFFPObj,float *dataArr,int dataLe
 	float *maxDBArr=NULL;
 
 	// cache
-	float *mRealArr=NULL; // timeLength*fftLength
+	float *mRealArr=NULL; // timeLength*(fftLength/2+1)
 	float *mImageArr=NULL;
 
 	int len=0;
@@ -2384,8 +2385,8 @@ static void __pitchFFPObj_stft(PitchFFPObj pitchFFPObj,float *dataArr,int dataLe
 	rLen=maxIndex-minIndex+1;
 	for(int i=0;i<timeLength;i++){
 		for(int j=minIndex,k=0;j<=maxIndex;j++,k++){
-			v1=mRealArr[i*fftLength+j];
-			v2=mImageArr[i*fftLength+j];
+			v1=mRealArr[i*(fftLength/2+1)+j];
+			v2=mImageArr[i*(fftLength/2+1)+j];
 			cur=v1*v1+v2*v2;
 
 			mPowerArr[i*rLen+k]=cur;
@@ -2761,8 +2762,8 @@ static void __pitchFFPObj_dealData(PitchFFPObj pitchFFPObj,int dataLength){
 		pitchFFPObj->mFastIndexArr4=__vnewi(timeLen*peakLength, NULL);
 		pitchFFPObj->fastLenArr4=__vnewi(timeLen, NULL);
 
-		pitchFFPObj->mRealArr=__vnew(timeLen*fftLength, NULL);
-		pitchFFPObj->mImageArr=__vnew(timeLen*fftLength, NULL);
+		pitchFFPObj->mRealArr=__vnew(timeLen*(fftLength/2+1), NULL);
+		pitchFFPObj->mImageArr=__vnew(timeLen*(fftLength/2+1), NULL);
 	}
 	
 	pitchFFPObj->timeLength=timeLen;
@@ -52,7 +52,7 @@ struct OpaquePitchSTFT{
 	int *lenArr;
 
 	// cache
-	float *mRealArr; // timeLength*fftLength
+	float *mRealArr; // timeLength*(fftLength/2+1)
 	float *mImageArr;
 
 	int samplate;
@@ -165,6 +165,7 @@ int pitchSTFTObj_new(PitchSTFTObj *pitchSTFTObj,
 	peakLength=(maxIndex-minIndex)/2+1;
 
 	stftObj_new(&stftObj, _radix2Exp, &_winType, &_slideLength, &_isContinue);
+	stftObj_enableHalfSpectrum(stftObj, 1);
 	
 	pitch->isContinue=_isContinue;
 
@@ -324,7 +325,7 @@ static void __pitchSTFTObj_stft(PitchSTFTObj pitchSTFTObj,float *dataArr,int dat
 	float compareValue=2.6;
 
 	// cache
-	float *mRealArr=NULL; // timeLength*fftLength
+	float *mRealArr=NULL; // timeLength*(fftLength/2+1)
 	float *mImageArr=NULL;
 
 	int len=0;
@@ -398,16 +399,16 @@ static void __pitchSTFTObj_stft(PitchSTFTObj pitchSTFTObj,float *dataArr,int dat
 		countArr1[i]=0;
 		countArr2[i]=0;
 		for(int j=minIndex+1;j<maxIndex;j++){
-			v1=mRealArr[i*fftLength+j-1];
-			v2=mImageArr[i*fftLength+j-1];
+			v1=mRealArr[i*(fftLength/2+1)+j-1];
+			v2=mImageArr[i*(fftLength/2+1)+j-1];
 			pre=v1*v1+v2*v2;
 
-			v1=mRealArr[i*fftLength+j];
-			v2=mImageArr[i*fftLength+j];
+			v1=mRealArr[i*(fftLength/2+1)+j];
+			v2=mImageArr[i*(fftLength/2+1)+j];
 			cur=v1*v1+v2*v2;
 
-			v1=mRealArr[i*fftLength+j+1];
-			v2=mImageArr[i*fftLength+j+1];
+			v1=mRealArr[i*(fftLength/2+1)+j+1];
+			v2=mImageArr[i*(fftLength/2+1)+j+1];
 			nex=v1*v1+v2*v2;
 
 			if(cur>pre&&cur>nex){ // peak
@@ -449,21 +450,21 @@ static void __pitchSTFTObj_stft(PitchSTFTObj pitchSTFTObj,float *dataArr,int dat
 				// left height
 				left=pre;
 				if(j-2>=0){
-					v1=mRealArr[i*fftLength+j-2];
-					v2=mImageArr[i*fftLength+j-2];
+					v1=mRealArr[i*(fftLength/2+1)+j-2];
+					v2=mImageArr[i*(fftLength/2+1)+j-2];
 					left=v1*v1+v2*v2;
 
 					if(left<pre){
 						if(j-3>=0){
-							v1=mRealArr[i*fftLength+j-3];
-							v2=mImageArr[i*fftLength+j-3];
+							v1=mRealArr[i*(fftLength/2+1)+j-3];
+							v2=mImageArr[i*(fftLength/2+1)+j-3];
 							pre=v1*v1+v2*v2;
 
 							if(pre<left){
 								left=pre;
 								// if(j-4>=0){
-								// 	v1=mRealArr[i*fftLength+j-4];
-								// 	v2=mImageArr[i*fftLength+j-4];
+								// 	v1=mRealArr[i*(fftLength/2+1)+j-4];
+								// 	v2=mImageArr[i*(fftLength/2+1)+j-4];
 								// 	pre=v1*v1+v2*v2;
 
 								// 	if(pre<left){
@@ -481,21 +482,21 @@ static void __pitchSTFTObj_stft(PitchSTFTObj pitchSTFTObj,float *dataArr,int dat
 				// right
 				right=nex;
 				if(j+2<fftLength/2){
-					v1=mRealArr[i*fftLength+j+2];
-					v2=mImageArr[i*fftLength+j+2];
+					v1=mRealArr[i*(fftLength/2+1)+j+2];
+					v2=mImageArr[i*(fftLength/2+1)+j+2];
 					right=v1*v1+v2*v2;
 
 					if(right<nex){
 						if(j+3<fftLength/2){
-							v1=mRealArr[i*fftLength+j+3];
-							v2=mImageArr[i*fftLength+j+3];
+							v1=mRealArr[i*(fftLength/2+1)+j+3];
+							v2=mImageArr[i*(fftLength/2+1)+j+3];
 							nex=v1*v1+v2*v2;
 
 							if(nex<right){
 								right=nex;
 								// if(j+4<fftLength/2){
-								// 	v1=mRealArr[i*fftLength+j+4];
-								// 	v2=mImageArr[i*fftLength+j+4];
+								// 	v1=mRealArr[i*(fftLength/2+1)+j+4];
+								// 	v2=mImageArr[i*(fftLength/2+1)+j+4];
 								// 	nex=v1*v1+v2*v2;
 
 								// 	if(nex<right){
@@ -681,8 +682,8 @@ static void __pitchSTFTObj_dealData(PitchSTFTObj pitchSTFTObj,int dataLength){
 		pitchSTFTObj->countArr2=__vnewi(timeLen, NULL);
 		pitchSTFTObj->lenArr=__vnewi(timeLen, NULL);
 
-		pitchSTFTObj->mRealArr=__vnew(timeLen*fftLength, NULL);
-		pitchSTFTObj->mImageArr=__vnew(timeLen*fftLength, NULL);
+		pitchSTFTObj->mRealArr=__vnew(timeLen*(fftLength/2+1), NULL);
+		pitchSTFTObj->mImageArr=__vnew(timeLen*(fftLength/2+1), NULL);
 	}
 	
 	pitchSTFTObj->timeLength=timeLen;
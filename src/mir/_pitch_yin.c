@@ -45,9 +45,11 @@ struct OpaquePitchYIN{
 	float *mDiffArr; // timeLength*diffLength
 	float *mMeanArr; // timeLength*maxIndex
 
+	float *mRealArr; // frame rfft timeLength*(fftLength/2+1)
+	float *mImageArr;
+
 	// cache data ->fftLength
 	float *realArr1; 
-	float *imageArr1;
 
 	float *realArr2; 
 	float *imageArr2;
@@ -67,6 +69,9 @@ struct OpaquePitchYIN{
 	float *curDataArr;
 	int curDataLength;
 
+	int workTimeLength; // >0 yin caches/curDataArr in caller workspace, capacity
+	int workDataLength;
+
 	int samplate;
 	float thresh; // 0.1 good
 
@@ -75,6 +80,9 @@ struct OpaquePitchYIN{
 
 static void __calTimeAndTailLen(int dataLength,int fftLength,int slideLength,int *timeLength,int *tailLength);
 
+static size_t __pitchYINObj_carveCache(PitchYINObj pitchYINObj,int timeLength,int dataLength,void *workArr);
+static void __pitchYINObj_freeCache(PitchYINObj pitchYINObj);
+
 static void __pitchYINObj_initData(PitchYINObj pitchYINObj,int length);
 
 static int __pitchYINObj_dealData(PitchYINObj pitchYINObj,float *dataArr,int dataLength);
@@ -197,7 +205,6 @@ int pitchYINObj_new(PitchYINObj *pitchYINObj,
 static void __pitchYINObj_initData(PitchYINObj pitchYINObj,int length){
 
 	pitchYINObj->realArr1=__vnew(length, NULL);
-	pitchYINObj->imageArr1=__vnew(length, NULL);
 
 	pitchYINObj->realArr2=__vnew(length, NULL);
 	pitchYINObj->imageArr2=__vnew(length, NULL);
@@ -293,8 +300,10 @@ static void __pitchYINObj_calDiff(PitchYINObj pitchYINObj){
 	float *mDiffArr=NULL;
 	float *mMeanArr=NULL;
 
+	float *mRealArr=NULL;
+	float *mImageArr=NULL;
+
 	float *realArr1=NULL; 
-	float *imageArr1=NULL;
 
 	float *realArr2=NULL; 
 	float *imageArr2=NULL;
@@ -331,8 +340,10 @@ static void __pitchYINObj_calDiff(PitchYINObj pitchYINObj){
 	mDiffArr=pitchYINObj->mDiffArr;
 	mMeanArr=pitchYINObj->mMeanArr;
 
+	mRealArr=pitchYINObj->mRealArr;
+	mImageArr=pitchYINObj->mImageArr;
+
 	realArr1=pitchYINObj->realArr1;
-	imageArr1=pitchYINObj->imageArr1;
 
 	realArr2=pitchYINObj->realArr2;
 	imageArr2=pitchYINObj->imageArr2;
@@ -347,30 +358,19 @@ static void __pitchYINObj_calDiff(PitchYINObj pitchYINObj){
 
 	curDataArr=pitchYINObj->curDataArr;
 
-	for(int i=0;i<timeLength;i++){
-		// 0. reset
-		memset(realArr1, 0, sizeof(float )*fftLength);
-		memset(imageArr1, 0, sizeof(float )*fftLength);
-
-		memset(realArr2, 0, sizeof(float )*fftLength);
-		memset(imageArr2, 0, sizeof(float )*fftLength);
-
-		memset(realArr3, 0, sizeof(float )*fftLength);
-		memset(imageArr3, 0, sizeof(float )*fftLength);
+	// 0. all frames rfft
+	fftObj_rfftBatch(fftObj,curDataArr,slideLength,timeLength,mRealArr,mImageArr,fftLength/2+1);
 
+	for(int i=0;i<timeLength;i++){
 		// 1. auto correlation --> realArr1
-		fftObj_fft(fftObj,curDataArr+i*slideLength,NULL,realArr1,imageArr1);
-
 		for(int j=0;j<=autoLength;j++){
 			dataArr1[j]=curDataArr[i*slideLength+autoLength-j];
 		}
-		fftObj_fft(fftObj,dataArr1,NULL,realArr2,imageArr2);
+		fftObj_rfft(fftObj,dataArr1,realArr2,imageArr2);
 
-		__vcmul(realArr1, imageArr1, realArr2, imageArr2, fftLength, realArr3, imageArr3);
+		__vcmul(mRealArr+i*(fftLength/2+1), mImageArr+i*(fftLength/2+1), realArr2, imageArr2, fftLength/2+1, realArr3, imageArr3);
 
-		memset(realArr1, 0, sizeof(float )*fftLength);
-		memset(imageArr1, 0, sizeof(float )*fftLength);
-		fftObj_ifft(fftObj, realArr3, imageArr3, realArr1, imageArr1);
+		fftObj_irfft(fftObj, realArr3, imageArr3, realArr1);
 
 		for(int j=autoLength,k=0;j<fftLength;j++,k++){
 			float _value=0;
@@ -717,6 +717,147 @@ static void __pitchYINObj_dealResult(PitchYINObj pitchYINObj,float *freArr,float
 	}
 }
 
+size_t pitchYINObj_calWorkspaceSize(PitchYINObj pitchYINObj,int maxDataLength){
+	int timeLength=0;
+
+	if(maxDataLength<=0){
+		return 0;
+	}
+
+	// continue tail<fftLength => totalLength<maxDataLength+fftLength
+	timeLength=maxDataLength/pitchYINObj->slideLength+1;
+
+	return __pitchYINObj_carveCache(pitchYINObj,timeLength,maxDataLength+2*pitchYINObj->fftLength,NULL)+64;
+}
+
+int pitchYINObj_useWorkspace(PitchYINObj pitchYINObj,void *workArr,size_t size,int maxDataLength){
+	int timeLength=0;
+	int dataLength=0;
+	size_t offset=0;
+
+	__pitchYINObj_freeCache(pitchYINObj);
+	if(!workArr){
+		return 0;
+	}
+
+	if(maxDataLength<=0||
+		size<pitchYINObj_calWorkspaceSize(pitchYINObj,maxDataLength)){
+		return -1;
+	}
+
+	timeLength=maxDataLength/pitchYINObj->slideLength+1;
+	dataLength=maxDataLength+2*pitchYINObj->fftLength;
+
+	offset=__pitchYINObj_carveCache(pitchYINObj,timeLength,dataLength,workArr);
+	memset(workArr, 0, offset);
+
+	pitchYINObj->workTimeLength=timeLength;
+	pitchYINObj->workDataLength=dataLength;
+
+	return 0;
+}
+
+// 11 yin caches+curDataArr, workArr NULL => only bytes
+static size_t __pitchYINObj_carveCache(PitchYINObj pitchYINObj,int timeLength,int dataLength,void *workArr){
+	size_t offset=0;
+
+	int fftLength=0;
+	int maxIndex=0;
+	int diffLength=0;
+	int yinLength=0;
+
+	float *arr=NULL;
+	int *arr1=NULL;
+
+	float **arrArr[10]={0};
+	int lengthArr[10]={0};
+
+	fftLength=pitchYINObj->fftLength;
+	maxIndex=pitchYINObj->maxIndex;
+	diffLength=pitchYINObj->diffLength;
+	yinLength=pitchYINObj->yinLength;
+
+	arrArr[0]=&pitchYINObj->mTroughArr;
+	arrArr[1]=&pitchYINObj->mFreArr;
+	arrArr[2]=&pitchYINObj->mYinArr;
+	arrArr[3]=&pitchYINObj->mInterpArr;
+	arrArr[4]=&pitchYINObj->mNumArr;
+	arrArr[5]=&pitchYINObj->mDenArr;
+	arrArr[6]=&pitchYINObj->mDiffArr;
+	arrArr[7]=&pitchYINObj->mMeanArr;
+	arrArr[8]=&pitchYINObj->mRealArr;
+	arrArr[9]=&pitchYINObj->mImageArr;
+
+	lengthArr[0]=lengthArr[1]=timeLength*(yinLength/2+1);
+	lengthArr[2]=lengthArr[3]=lengthArr[4]=lengthArr[5]=timeLength*yinLength;
+	lengthArr[6]=timeLength*diffLength;
+	lengthArr[7]=timeLength*maxIndex;
+	lengthArr[8]=lengthArr[9]=timeLength*(fftLength/2+1);
+
+	for(int i=0;i<10;i++){
+		arr=__vcarve(workArr,&offset,lengthArr[i]);
+		if(workArr){
+			*arrArr[i]=arr;
+		}
+	}
+
+	arr1=__vcarvei(workArr,&offset,timeLength);
+	arr=__vcarve(workArr,&offset,dataLength);
+	if(workArr){
+		pitchYINObj->lenArr=arr1;
+		pitchYINObj->curDataArr=arr;
+	}
+
+	return offset;
+}
+
+// own caches freed, workspace caches only detached; tailDataArr keep
+static void __pitchYINObj_freeCache(PitchYINObj pitchYINObj){
+
+	if(!pitchYINObj->workTimeLength){
+		free(pitchYINObj->mTroughArr);
+		free(pitchYINObj->mFreArr);
+		free(pitchYINObj->lenArr);
+
+		free(pitchYINObj->mYinArr);
+		free(pitchYINObj->mInterpArr);
+
+		free(pitchYINObj->mNumArr);
+		free(pitchYINObj->mDenArr);
+
+		free(pitchYINObj->mDiffArr);
+		free(pitchYINObj->mMeanArr);
+
+		free(pitchYINObj->mRealArr);
+		free(pitchYINObj->mImageArr);
+
+		free(pitchYINObj->curDataArr);
+	}
+
+	pitchYINObj->mTroughArr=NULL;
+	pitchYINObj->mFreArr=NULL;
+	pitchYINObj->lenArr=NULL;
+
+	pitchYINObj->mYinArr=NULL;
+	pitchYINObj->mInterpArr=NULL;
+
+	pitchYINObj->mNumArr=NULL;
+	pitchYINObj->mDenArr=NULL;
+
+	pitchYINObj->mDiffArr=NULL;
+	pitchYINObj->mMeanArr=NULL;
+
+	pitchYINObj->mRealArr=NULL;
+	pitchYINObj->mImageArr=NULL;
+
+	pitchYINObj->curDataArr=NULL;
+	pitchYINObj->curDataLength=0;
+
+	pitchYINObj->timeLength=0;
+	pitchYINObj->workTimeLength=0;
+	pitchYINObj->workDataLength=0;
+}
+
 int pitchYINObj_calTimeLength(PitchYINObj pitchYINObj,int dataLength){
 	int fftLength=0; 
 	int slideLength=0;
@@ -754,21 +895,9 @@ void pitchYINObj_free(PitchYINObj pitchYINObj){
 	if(pitchYINObj){
 		fftObj_free(pitchYINObj->fftObj);
 
-		free(pitchYINObj->mTroughArr);
-		free(pitchYINObj->mFreArr);
-		free(pitchYINObj->lenArr);
-
-		free(pitchYINObj->mYinArr);
-		free(pitchYINObj->mInterpArr);
-
-		free(pitchYINObj->mNumArr);
-		free(pitchYINObj->mDenArr);
-
-		free(pitchYINObj->mDiffArr);
-		free(pitchYINObj->mMeanArr);
+		__pitchYINObj_freeCache(pitchYINObj);
 
 		free(pitchYINObj->realArr1);
-		free(pitchYINObj->imageArr1);
 
 		free(pitchYINObj->realArr2);
 		free(pitchYINObj->imageArr2);
@@ -782,7 +911,6 @@ void pitchYINObj_free(PitchYINObj pitchYINObj){
 		free(pitchYINObj->dataArr1);
 
 		free(pitchYINObj->tailDataArr);
-		free(pitchYINObj->curDataArr);
 
 		free(pitchYINObj);
 	}
@@ -847,8 +975,18 @@ static int __pitchYINObj_dealData(PitchYINObj pitchYINObj,float *dataArr,int dat
 	}
 
 	if(status){ // 存在timeLen 计算curDataArr相关
-		if(totalLength>curDataLength||
-			curDataLength>2*totalLength){
+		if(pitchYINObj->workTimeLength&&
+			(timeLen>pitchYINObj->workTimeLength||
+			totalLength+fftLength>pitchYINObj->workDataLength)){ // over workspace, back to own cache
+			__pitchYINObj_freeCache(pitchYINObj);
+
+			curDataArr=NULL;
+			curDataLength=0;
+		}
+
+		if(!pitchYINObj->workDataLength&&
+			(totalLength>curDataLength||
+			curDataLength>2*totalLength)){
 
 			free(curDataArr);
 			curDataArr=(float *)calloc(totalLength+fftLength, sizeof(float ));
@@ -880,8 +1018,9 @@ static int __pitchYINObj_dealData(PitchYINObj pitchYINObj,float *dataArr,int dat
 		}
 
 		// yin 相关
-		if(pitchYINObj->timeLength<timeLen||
-			pitchYINObj->timeLength>timeLen*2){ // 更新缓存
+		if(!pitchYINObj->workTimeLength&&
+			(pitchYINObj->timeLength<timeLen||
+			pitchYINObj->timeLength>timeLen*2)){ // 更新缓存
 			free(pitchYINObj->mTroughArr);
 			free(pitchYINObj->mFreArr);
 			free(pitchYINObj->lenArr);
@@ -895,6 +1034,9 @@ static int __pitchYINObj_dealData(PitchYINObj pitchYINObj,float *dataArr,int dat
 			free(pitchYINObj->mDiffArr);
 			free(pitchYINObj->mMeanArr);
 
+			free(pitchYINObj->mRealArr);
+			free(pitchYINObj->mImageArr);
+
 			pitchYINObj->mTroughArr=__vnew(timeLen*(yinLength/2+1),NULL);
 			pitchYINObj->mFreArr=__vnew(timeLen*(yinLength/2+1),NULL);
 			pitchYINObj->lenArr=__vnewi(timeLen,NULL);
@@ -907,6 +1049,9 @@ static int __pitchYINObj_dealData(PitchYINObj pitchYINObj,float *dataArr,int dat
 
 			pitchYINObj->mDiffArr=__vnew(timeLen*diffLength,NULL);
 			pitchYINObj->mMeanArr=__vnew(timeLen*maxIndex,NULL);
+
+			pitchYINObj->mRealArr=__vnew(timeLen*(fftLength/2+1),NULL);
+			pitchYINObj->mImageArr=__vnew(timeLen*(fftLength/2+1),NULL);
 		}
 	}
 	else{
@@ -23,8 +23,9 @@ struct OpaqueHPSS{
 	int pOrder;
 
 	int timeLength;
+	int workTimeLength; // >0 caches in caller workspace, capacity
 
-	float *mRealArr; // timeLength*fftLength
+	float *mRealArr; // timeLength*(fftLength/2+1)
 	float *mImageArr;
 
 	float *mPhaseImageArr; // timeLength*(fftLength/2+1)
@@ -35,8 +36,14 @@ struct OpaqueHPSS{
 	float *mHArr; // filter&mask
 	float *mPArr;
 
+	float *filterArr; // median filter work, __hpssObj_calFilterLength
+
 };
 
+static size_t __hpssObj_carveCache(HPSSObj hpssObj,int timeLength,void *workArr);
+static void __hpssObj_freeCache(HPSSObj hpssObj);
+static int __hpssObj_calFilterLength(HPSSObj hpssObj,int timeLength);
+
 int hpssObj_new(HPSSObj *hpssObj,
 				int radix2Exp,WindowType *windowType,int *slideLength,
 				int *hOrder,int *pOrder){
@@ -81,6 +88,7 @@ int hpssObj_new(HPSSObj *hpssObj,
 	_slideLength=fftLength/4;
 
 	stftObj_new(&stftObj, radix2Exp, &_windowType, &_slideLength, NULL);
+	stftObj_enableHalfSpectrum(stftObj, 1);
 		
 	hpss->stftObj=stftObj;
 
@@ -150,22 +158,19 @@ void hpssObj_hpss(HPSSObj hpssObj,float *dataArr,int dataLength,float *hArr,floa
 	pOrder=hpssObj->pOrder;
 
 	timeLength=stftObj_calTimeLength(stftObj, dataLength);
-	if(timeLength>hpssObj->timeLength||
-		hpssObj->timeLength>2*timeLength){
+	if(hpssObj->workTimeLength&&
+		timeLength>hpssObj->workTimeLength){ // over workspace, back to own cache
+		__hpssObj_freeCache(hpssObj);
+	}
 
-		free(hpssObj->mRealArr);
-		free(hpssObj->mImageArr);
+	if(!hpssObj->workTimeLength&&
+		(timeLength>hpssObj->timeLength||
+		hpssObj->timeLength>2*timeLength)){
 
-		free(hpssObj->mPhaseImageArr);
-		free(hpssObj->mPhaseRealArr);
+		__hpssObj_freeCache(hpssObj);
 
-		free(hpssObj->mMagArr);
-
-		free(hpssObj->mHArr);
-		free(hpssObj->mPArr);
-
-		hpssObj->mRealArr=__vnew(timeLength*fftLength, NULL);
-		hpssObj->mImageArr=__vnew(timeLength*fftLength, NULL);
+		hpssObj->mRealArr=__vnew(timeLength*(fftLength/2+1), NULL);
+		hpssObj->mImageArr=__vnew(timeLength*(fftLength/2+1), NULL);
 
 		hpssObj->mPhaseImageArr=__vnew(timeLength*(fftLength/2+1), NULL);
 		hpssObj->mPhaseRealArr=__vnew(timeLength*(fftLength/2+1), NULL);
@@ -175,6 +180,8 @@ void hpssObj_hpss(HPSSObj hpssObj,float *dataArr,int dataLength,float *hArr,floa
 		hpssObj->mHArr=__vnew(timeLength*(fftLength/2+1), NULL);
 		hpssObj->mPArr=__vnew(timeLength*(fftLength/2+1), NULL);
 
+		hpssObj->filterArr=__vnew(__hpssObj_calFilterLength(hpssObj,timeLength), NULL);
+
 		hpssObj->timeLength=timeLength;
 	}
 
@@ -192,7 +199,7 @@ void hpssObj_hpss(HPSSObj hpssObj,float *dataArr,int dataLength,float *hArr,floa
 	// 1. stft&phase
 	stftObj_stft(stftObj, dataArr, dataLength, mRealArr, mImageArr);
 
-	__mcsquare2(mRealArr, mImageArr, timeLength, fftLength, fftLength/2+1, mMagArr); // S^2
+	__mcsquare2(mRealArr, mImageArr, timeLength, fftLength/2+1, fftLength/2+1, mMagArr); // S^2
 	__vsqrt(mMagArr, timeLength*(fftLength/2+1), NULL);
 
 	for(int i=0;i<timeLength;i++){
@@ -202,8 +209,8 @@ void hpssObj_hpss(HPSSObj hpssObj,float *dataArr,int dataLength,float *hArr,floa
 			float r1=0;
 			float i1=0;
 
-			r1=mRealArr[i*fftLength+j];
-			i1=mImageArr[i*fftLength+j];
+			r1=mRealArr[i*(fftLength/2+1)+j];
+			i1=mImageArr[i*(fftLength/2+1)+j];
 
 			v1=mMagArr[i*(fftLength/2+1)+j];
 			if(v1<1e-16){
@@ -230,8 +237,8 @@ void hpssObj_hpss(HPSSObj hpssObj,float *dataArr,int dataLength,float *hArr,floa
 	// }
 
 	// 2. filter&mask
-	__mmedianfilter(mMagArr, timeLength, fftLength/2+1,	0, hOrder, mHArr);
-	__mmedianfilter(mMagArr, timeLength, fftLength/2+1, 1, pOrder, mPArr);
+	__mmedianfilter1(mMagArr, timeLength, fftLength/2+1, 0, hOrder, hpssObj->filterArr, mHArr);
+	__mmedianfilter1(mMagArr, timeLength, fftLength/2+1, 1, pOrder, hpssObj->filterArr, mPArr);
 
 	// {
 	// 	printf("mHArr1 is :\n");
@@ -288,13 +295,8 @@ void hpssObj_hpss(HPSSObj hpssObj,float *dataArr,int dataLength,float *hArr,floa
 				r1=mPhaseRealArr[i*(fftLength/2+1)+j]*v1;
 				i1=mPhaseImageArr[i*(fftLength/2+1)+j]*v1;
 
-				mRealArr[i*fftLength+j]=r1;
-				mImageArr[i*fftLength+j]=i1;
-
-				if(j>0&&j<fftLength/2){
-					mRealArr[i*fftLength+(fftLength-j)]=r1;
-					mImageArr[i*fftLength+(fftLength-j)]=-i1;
-				}
+				mRealArr[i*(fftLength/2+1)+j]=r1;
+				mImageArr[i*(fftLength/2+1)+j]=i1;
 			}
 		}
 		stftObj_istft(stftObj, mRealArr, mImageArr, timeLength, 0, hArr);
@@ -313,13 +315,8 @@ void hpssObj_hpss(HPSSObj hpssObj,float *dataArr,int dataLength,float *hArr,floa
 				r1=mPhaseRealArr[i*(fftLength/2+1)+j]*v1;
 				i1=mPhaseImageArr[i*(fftLength/2+1)+j]*v1;
 
-				mRealArr[i*fftLength+j]=r1;
-				mImageArr[i*fftLength+j]=i1;
-
-				if(j>0&&j<fftLength/2){
-					mRealArr[i*fftLength+(fftLength-j)]=r1;
-					mImageArr[i*fftLength+(fftLength-j)]=-i1;
-				}
+				mRealArr[i*(fftLength/2+1)+j]=r1;
+				mImageArr[i*(fftLength/2+1)+j]=i1;
 			}
 		}
 		stftObj_istft(stftObj, mRealArr, mImageArr, timeLength, 0, pArr);
@@ -351,19 +348,132 @@ void hpssObj_free(HPSSObj hpssObj){
 	}
 
 	stftObj_free(hpssObj->stftObj);
+	__hpssObj_freeCache(hpssObj);
 
-	free(hpssObj->mRealArr);
-	free(hpssObj->mImageArr);
+	free(hpssObj);
+}
 
-	free(hpssObj->mPhaseImageArr);
-	free(hpssObj->mPhaseRealArr);
+// __mmedianfilter1 work for both axis
+static int __hpssObj_calFilterLength(HPSSObj hpssObj,int timeLength){
+	int len=0;
+	int order=0;
 
-	free(hpssObj->mMagArr);
+	len=hpssObj->fftLength/2+1;
+	if(timeLength>len){
+		len=timeLength;
+	}
 
-	free(hpssObj->mHArr);
-	free(hpssObj->mPArr);
+	order=hpssObj->hOrder;
+	if(hpssObj->pOrder>order){
+		order=hpssObj->pOrder;
+	}
 
-	free(hpssObj);
+	return 3*len+2*order;
+}
+
+// 7 caches timeLength*(fftLength/2+1)+median filter work, workArr NULL => only bytes
+static size_t __hpssObj_carveCache(HPSSObj hpssObj,int timeLength,void *workArr){
+	size_t offset=0;
+	float *arr=NULL;
+
+	float **arrArr[7]={0};
+
+	arrArr[0]=&hpssObj->mRealArr;
+	arrArr[1]=&hpssObj->mImageArr;
+	arrArr[2]=&hpssObj->mPhaseImageArr;
+	arrArr[3]=&hpssObj->mPhaseRealArr;
+	arrArr[4]=&hpssObj->mMagArr;
+	arrArr[5]=&hpssObj->mHArr;
+	arrArr[6]=&hpssObj->mPArr;
+
+	for(int i=0;i<7;i++){
+		arr=__vcarve(workArr,&offset,timeLength*(hpssObj->fftLength/2+1));
+		if(workArr){
+			*arrArr[i]=arr;
+		}
+	}
+
+	arr=__vcarve(workArr,&offset,__hpssObj_calFilterLength(hpssObj,timeLength));
+	if(workArr){
+		hpssObj->filterArr=arr;
+	}
+
+	return offset;
+}
+
+// own caches freed, workspace caches only detached
+static void __hpssObj_freeCache(HPSSObj hpssObj){
+
+	if(!hpssObj->workTimeLength){
+		free(hpssObj->mRealArr);
+		free(hpssObj->mImageArr);
+
+		free(hpssObj->mPhaseImageArr);
+		free(hpssObj->mPhaseRealArr);
+
+		free(hpssObj->mMagArr);
+
+		free(hpssObj->mHArr);
+		free(hpssObj->mPArr);
+
+		free(hpssObj->filterArr);
+	}
+
+	hpssObj->mRealArr=NULL;
+	hpssObj->mImageArr=NULL;
+
+	hpssObj->mPhaseImageArr=NULL;
+	hpssObj->mPhaseRealArr=NULL;
+
+	hpssObj->mMagArr=NULL;
+
+	hpssObj->mHArr=NULL;
+	hpssObj->mPArr=NULL;
+
+	hpssObj->filterArr=NULL;
+
+	hpssObj->timeLength=0;
+	hpssObj->workTimeLength=0;
+}
+
+size_t hpssObj_calWorkspaceSize(HPSSObj hpssObj,int maxDataLength){
+	int timeLength=0;
+	size_t size=0;
+
+	timeLength=stftObj_calTimeLength(hpssObj->stftObj, maxDataLength);
+	if(timeLength<=0){
+		return 0;
+	}
+
+	size=__hpssObj_carveCache(hpssObj,timeLength,NULL)+64;
+	size+=stftObj_calWorkspaceSize(hpssObj->stftObj,maxDataLength);
+
+	return size;
+}
+
+int hpssObj_useWorkspace(HPSSObj hpssObj,void *workArr,size_t size,int maxDataLength){
+	int timeLength=0;
+	size_t offset=0;
+
+	__hpssObj_freeCache(hpssObj);
+	if(!workArr){
+		stftObj_useWorkspace(hpssObj->stftObj,NULL,0,0);
+		return 0;
+	}
+
+	timeLength=stftObj_calTimeLength(hpssObj->stftObj, maxDataLength);
+	if(timeLength<=0||
+		size<hpssObj_calWorkspaceSize(hpssObj,maxDataLength)){
+		return -1;
+	}
+
+	offset=__hpssObj_carveCache(hpssObj,timeLength,workArr);
+	memset(workArr, 0, offset);
+
+	hpssObj->timeLength=timeLength;
+	hpssObj->workTimeLength=timeLength;
+
+	return stftObj_useWorkspace(hpssObj->stftObj,(char *)workArr+offset,size-offset,maxDataLength);
 }
 
 void hpssObj_debug(HPSSObj hpssObj){
@@ -24,6 +24,10 @@ int hpssObj_new(HPSSObj *hpssObj,
 
 int hpssObj_calDataLength(HPSSObj hpssObj,int dataLength);
 
+// caller workspace for stft/mask caches, contract see stftObj_useWorkspace
+size_t hpssObj_calWorkspaceSize(HPSSObj hpssObj,int maxDataLength);
+int hpssObj_useWorkspace(HPSSObj hpssObj,void *workArr,size_t size,int maxDataLength);
+
 void hpssObj_hpss(HPSSObj hpssObj,float *dataArr,int dataLength,float *hArr,float *pArr);
 
 void hpssObj_free(HPSSObj hpssObj);
@@ -11,8 +11,11 @@
 #include "dsp/fft_algorithm.h"
 #include "dsp/dft_algorithm.h"
 
+#include "util/flux_parallel.h"
+
 #include "filterbank/auditory_filterBank.h"
 #include "filterbank/nsgt_filterBank.h"
+#include "filterbank/filterBank_cache.h"
 
 #include "nsgt_algorithm.h"
 
@@ -28,10 +31,15 @@ struct OpaqueNSGT{
 	float *freBandArr;
 	int *offsetArr;
 
+	FilterBankCacheObj filterBankCacheObj; // own windowData/windowLength/binBand/freBand/offset
+
 	DFTObj *dftArr;
 	int *dftLenArr;
 	int dftLength;
 
+	int *startArr; // band start in cell data; num
+	int *dftIndexArr; // band dftArr index; num
+
 	int maxWindowLength;
 	int totalWindowLength;
 	int minWindowLength;
@@ -39,8 +47,9 @@ struct OpaqueNSGT{
 	float *realArr1; // fft data result
 	float *imageArr1;
 
-	float *realArr2; // reassign freData*windowData =>n/2~n,1~n/2
+	float *realArr2; // reassign freData*windowData =>n/2~n,1~n/2; workNum*fftLength
 	float *imageArr2;
+	int workNum;
 
 	float *realArr3; // cell result data
 	float *imageArr3;
@@ -65,10 +74,21 @@ struct OpaqueNSGT{
 static void __nsgtObj_init(NSGTObj nsgtObj);
 static void __nsgtObj_dealTime(NSGTObj nsgtObj);
 static void __nsgtObj_dealDFT(NSGTObj nsgtObj);
+static int __nsgtObj_checkFilterBank(FilterBankCacheObj cacheObj,int num);
 
 static int __arr_has(int *arr,int length,int value);
 static int __arr_getIndex(int *arr,int length,int value);
 
+static void __nsgtObj_idftChunk(void *arg,int start,int end,int threadIndex);
+static void __nsgtObj_matrixChunk(void *arg,int start,int end,int threadIndex);
+
+typedef struct{
+	NSGTObj nsgtObj;
+	float *mRealArr3;
+	float *mImageArr3;
+
+} NSGTChunkArg;
+
 int nsgtObj_new(NSGTObj *nsgtObj,int num,int radix2Exp,
 				int *samplate,float *lowFre,float *highFre,int *binPerOctave,
 				int *minLength,
@@ -233,6 +253,7 @@ int nsgtObj_new(NSGTObj *nsgtObj,int num,int radix2Exp,
 
 	nsgt->realArr2=realArr2;
 	nsgt->imageArr2=imageArr2;
+	nsgt->workNum=1;
 
 	nsgt->samplate=_samplate;
 	nsgt->lowFre=_lowFre;
@@ -297,6 +318,9 @@ static void __nsgtObj_dealDFT(NSGTObj nsgtObj){
 	int num=0;
 	int *windowLengthArr=NULL; 
 
+	int *startArr=NULL;
+	int *dftIndexArr=NULL;
+
 	int flag=0;
 
 	num=nsgtObj->num;
@@ -316,9 +340,54 @@ static void __nsgtObj_dealDFT(NSGTObj nsgtObj){
 		dftObj_new(dftArr+i, dftLenArr[i]);
 	}
 
+	startArr=__vnewi(num, NULL);
+	dftIndexArr=__vnewi(num, NULL);
+	for(int i=0;i<num;i++){
+		if(i){
+			startArr[i]=startArr[i-1]+windowLengthArr[i-1];
+		}
+
+		dftIndexArr[i]=__arr_getIndex(dftLenArr, dftLength, windowLengthArr[i]);
+	}
+
 	nsgtObj->dftArr=dftArr;
 	nsgtObj->dftLenArr=dftLenArr;
 	nsgtObj->dftLength=dftLength;
+
+	nsgtObj->startArr=startArr;
+	nsgtObj->dftIndexArr=dftIndexArr;
+}
+
+// imported entry shape must match what init indexes, windows sum to total
+static int __nsgtObj_checkFilterBank(FilterBankCacheObj cacheObj,int num){
+	int *windowLengthArr=NULL;
+	int *lenArr=NULL;
+
+	int total=0;
+
+	windowLengthArr=filterBankCacheObj_getIntArr(cacheObj,0);
+	lenArr=filterBankCacheObj_getIntArr(cacheObj,3);
+
+	if(!windowLengthArr||!lenArr||
+		filterBankCacheObj_getArrLength(cacheObj,1)!=num||
+		filterBankCacheObj_getIntArrLength(cacheObj,0)!=num||
+		filterBankCacheObj_getIntArrLength(cacheObj,1)!=num||
+		filterBankCacheObj_getIntArrLength(cacheObj,2)!=num||
+		filterBankCacheObj_getIntArrLength(cacheObj,3)!=2||
+		filterBankCacheObj_getArrLength(cacheObj,0)!=lenArr[1]){
+
+		return 0;
+	}
+
+	for(int i=0;i<num;i++){
+		if(windowLengthArr[i]<1||windowLengthArr[i]>lenArr[0]){
+			return 0;
+		}
+
+		total+=windowLengthArr[i];
+	}
+
+	return total==lenArr[1];
 }
 
 static void __nsgtObj_init(NSGTObj nsgtObj){
@@ -337,12 +406,9 @@ static void __nsgtObj_init(NSGTObj nsgtObj){
 	SpectralFilterBankStyleType filterStyleType;
 	SpectralFilterBankNormalType filterNormalType;
 
-	float *windowDataArr=NULL;
-	int *windowLengthArr=NULL; // timeLengthArr
-
-	int *binBandArr=NULL;
-	float *freBandArr=NULL;
-	int *offsetArr=NULL;
+	FilterBankCacheObj cacheObj=NULL;
+	double paramArr[11]={0};
+	int *lenArr=NULL; // maxWindowLength,totalWindowLength
 
 	int totalWindowLength=0;
 	int maxWindowLength=0; 
@@ -371,30 +437,76 @@ static void __nsgtObj_init(NSGTObj nsgtObj){
 		type=1;
 	}
 
-	windowLengthArr=__vnewi(num, NULL);
-	binBandArr=__vnewi(num, NULL);
-	freBandArr=__vnew(num, NULL);
-	offsetArr=__vnewi(num, NULL);
+	paramArr[0]=num;
+	paramArr[1]=fftLength;
+	paramArr[2]=samplate;
+	paramArr[3]=minWindowLength;
+	paramArr[4]=type;
+	paramArr[5]=filterScaleType;
+	paramArr[6]=filterStyleType;
+	paramArr[7]=filterNormalType;
+	paramArr[8]=lowFre;
+	paramArr[9]=highFre;
+	paramArr[10]=binPerOctave;
+
+	cacheObj=filterBankCache_find(FilterBankCache_NSGT,paramArr,11);
+	if(cacheObj&&!__nsgtObj_checkFilterBank(cacheObj,num)){
+		filterBankCacheObj_discard(cacheObj);
+		cacheObj=NULL;
+	}
+	if(!cacheObj){
+		float *arrArr[2]={0}; // windowDataArr,freBandArr
+		int lengthArr[2]={0};
+
+		int *iArrArr[4]={0}; // windowLengthArr,binBandArr,offsetArr,lenArr
+		int iLengthArr[4]={0};
+
+		iArrArr[0]=__vnewi(num, NULL);
+		iArrArr[1]=__vnewi(num, NULL);
+		arrArr[1]=__vnew(num, NULL);
+		iArrArr[2]=__vnewi(num, NULL);
+		iArrArr[3]=__vnewi(2, NULL);
+
+		nsgt_filterBank(num,fftLength,samplate, minWindowLength,
+						type,
+						filterScaleType,
+						filterStyleType,
+						filterNormalType,
+						lowFre,highFre,binPerOctave,
+						&arrArr[0],iArrArr[0],
+						arrArr[1],iArrArr[1],iArrArr[2],
+						&maxWindowLength,&totalWindowLength);
+
+		iArrArr[3][0]=maxWindowLength;
+		iArrArr[3][1]=totalWindowLength;
+
+		lengthArr[0]=totalWindowLength;
+		lengthArr[1]=num;
+		iLengthArr[0]=num;
+		iLengthArr[1]=num;
+		iLengthArr[2]=num;
+		iLengthArr[3]=2;
+
+		cacheObj=filterBankCache_insert(FilterBankCache_NSGT,paramArr,11,
+										arrArr,lengthArr,2,
+										iArrArr,iLengthArr,4);
+	}
 
-	nsgt_filterBank(num,fftLength,samplate, minWindowLength,
-					type,
-					filterScaleType,
-					filterStyleType,
-					filterNormalType,
-					lowFre,highFre,binPerOctave,
-					&windowDataArr,windowLengthArr,
-					freBandArr,binBandArr,offsetArr,
-					&maxWindowLength,&totalWindowLength);
+	lenArr=filterBankCacheObj_getIntArr(cacheObj,3);
+	maxWindowLength=lenArr[0];
+	totalWindowLength=lenArr[1];
 
 	realArr3=__vnew(totalWindowLength, NULL);
 	imageArr3=__vnew(totalWindowLength, NULL);
 
-	nsgtObj->windowDataArr=windowDataArr;
-	nsgtObj->windowLengthArr=windowLengthArr;
+	nsgtObj->filterBankCacheObj=cacheObj;
 
-	nsgtObj->binBandArr=binBandArr;
-	nsgtObj->freBandArr=freBandArr;
-	nsgtObj->offsetArr=offsetArr;
+	nsgtObj->windowDataArr=filterBankCacheObj_getArr(cacheObj,0);
+	nsgtObj->windowLengthArr=filterBankCacheObj_getIntArr(cacheObj,0);
+
+	nsgtObj->binBandArr=filterBankCacheObj_getIntArr(cacheObj,1);
+	nsgtObj->freBandArr=filterBankCacheObj_getArr(cacheObj,1);
+	nsgtObj->offsetArr=filterBankCacheObj_getIntArr(cacheObj,2);
 
 	nsgtObj->maxWindowLength=maxWindowLength;
 	nsgtObj->totalWindowLength=totalWindowLength;
@@ -429,13 +541,6 @@ static void __nsgtObj_init(NSGTObj nsgtObj){
 void nsgtObj_setMinLength(NSGTObj nsgtObj,int minLength){
 	int minWindowLength=0;
 
-	float *windowDataArr=NULL;
-	int *windowLengthArr=NULL; // timeLengthArr
-
-	int *binBandArr=NULL;
-	float *freBandArr=NULL;
-	int *offsetArr=NULL;
-
 	float *realArr3=NULL; // cell data result
 	float *imageArr3=NULL;
 
@@ -445,13 +550,6 @@ void nsgtObj_setMinLength(NSGTObj nsgtObj,int minLength){
 
 	minWindowLength=nsgtObj->minWindowLength;
 	if(minLength!=minWindowLength&&minLength>=1){
-		windowDataArr=nsgtObj->windowDataArr;
-		windowLengthArr=nsgtObj->windowLengthArr;
-
-		binBandArr=nsgtObj->binBandArr;
-		freBandArr=nsgtObj->freBandArr;
-		offsetArr=nsgtObj->offsetArr;
-
 		realArr3=nsgtObj->realArr3;
 		imageArr3=nsgtObj->imageArr3;
 
@@ -459,12 +557,8 @@ void nsgtObj_setMinLength(NSGTObj nsgtObj,int minLength){
 		dftLenArr=nsgtObj->dftLenArr;
 		dftLength=nsgtObj->dftLength;
 
-		free(windowDataArr);
-		free(windowLengthArr);
-
-		free(binBandArr);
-		free(freBandArr);
-		free(offsetArr);
+		filterBankCacheObj_release(nsgtObj->filterBankCacheObj);
+		nsgtObj->filterBankCacheObj=NULL;
 
 		free(realArr3);
 		free(imageArr3);
@@ -475,6 +569,9 @@ void nsgtObj_setMinLength(NSGTObj nsgtObj,int minLength){
 		free(dftArr);
 		free(dftLenArr);
 
+		free(nsgtObj->startArr);
+		free(nsgtObj->dftIndexArr);
+
 		nsgtObj->minWindowLength=minLength;
 		__nsgtObj_init(nsgtObj);
 	}
@@ -484,34 +581,76 @@ void nsgtObj_nsgt(NSGTObj nsgtObj,float *dataArr,float *mRealArr3,float *mImageA
 	FFTObj fftObj=NULL;
 	int fftLength=0;
 
+	int num=0;
+	int dftLength=0;
+
+	float *realArr1=NULL; // data fft/dft result
+	float *imageArr1=NULL;
+
+	int threadNum=0;
+	NSGTChunkArg chunkArg;
+
+	fftObj=nsgtObj->fftObj;
+	fftLength=nsgtObj->fftLength;
+
+	num=nsgtObj->num;
+	dftLength=nsgtObj->dftLength;
+
+	realArr1=nsgtObj->realArr1;
+	imageArr1=nsgtObj->imageArr1;
+
+	// reassign buffer per thread
+	threadNum=audioflux_getThreadNum();
+	if(threadNum>nsgtObj->workNum){
+		free(nsgtObj->realArr2);
+		free(nsgtObj->imageArr2);
+
+		nsgtObj->realArr2=__vnew(threadNum*fftLength, NULL);
+		nsgtObj->imageArr2=__vnew(threadNum*fftLength, NULL);
+		nsgtObj->workNum=threadNum;
+	}
+
+	chunkArg.nsgtObj=nsgtObj;
+	chunkArg.mRealArr3=mRealArr3;
+	chunkArg.mImageArr3=mImageArr3;
+
+	// 1. fft(dataLength)
+	fftObj_fft(fftObj, dataArr, NULL, realArr1, imageArr1);
+
+	// 2. ifft; dftObj not reentrant, one task per dft length
+	__parallel_for(dftLength,1,threadNum,__nsgtObj_idftChunk,&chunkArg);
+
+	// 3. to matrix
+	__parallel_for(num,0,threadNum,__nsgtObj_matrixChunk,&chunkArg);
+}
+
+static void __nsgtObj_idftChunk(void *arg,int start,int end,int threadIndex){
+	NSGTObj nsgtObj=NULL;
+	int fftLength=0;
+
 	int num=0;
 	float *windowDataArr=NULL;
 	int *windowLengthArr=NULL; 
 
-	float *realArr1=NULL; // data fft/dft result
+	float *realArr1=NULL;
 	float *imageArr1=NULL;
 
-	float *realArr2=NULL; // data fft/dft result
+	float *realArr2=NULL;
 	float *imageArr2=NULL;
 
-	float *realArr3=NULL; // data fft/dft result
+	float *realArr3=NULL;
 	float *imageArr3=NULL;
 
-	int *binBandArr=NULL;
 	int *offsetArr=NULL;
-
-	int maxWindowLength=0;
-	float *maxTimeArr=NULL;
-	float **timeArrArr=NULL;
+	int *startArr=NULL;
+	int *dftIndexArr=NULL;
 
 	DFTObj *dftArr=NULL;
-	int *dftLenArr=NULL;
-	int dftLength=0;
 
 	int curLen=0;
 	int index=0;
 
-	fftObj=nsgtObj->fftObj;
+	nsgtObj=((NSGTChunkArg *)arg)->nsgtObj;
 	fftLength=nsgtObj->fftLength;
 
 	num=nsgtObj->num;
@@ -521,44 +660,30 @@ void nsgtObj_nsgt(NSGTObj nsgtObj,float *dataArr,float *mRealArr3,float *mImageA
 	realArr1=nsgtObj->realArr1;
 	imageArr1=nsgtObj->imageArr1;
 
-	realArr2=nsgtObj->realArr2;
-	imageArr2=nsgtObj->imageArr2;
+	realArr2=nsgtObj->realArr2+threadIndex*fftLength;
+	imageArr2=nsgtObj->imageArr2+threadIndex*fftLength;
 
 	realArr3=nsgtObj->realArr3;
 	imageArr3=nsgtObj->imageArr3;
 
-	binBandArr=nsgtObj->binBandArr;
 	offsetArr=nsgtObj->offsetArr;
+	startArr=nsgtObj->startArr;
+	dftIndexArr=nsgtObj->dftIndexArr;
 
-	maxWindowLength=nsgtObj->maxWindowLength;
-	maxTimeArr=nsgtObj->maxTimeArr;
-	timeArrArr=nsgtObj->timeArrArr;
-	
 	dftArr=nsgtObj->dftArr;
-	dftLenArr=nsgtObj->dftLenArr;
-	dftLength=nsgtObj->dftLength;
-
-	// 1. fft(dataLength)
-	fftObj_fft(fftObj, dataArr, NULL, realArr1, imageArr1);
 
-	// 2. ifft
 	for(int i=0;i<num;i++){
-		int _dIndex=0;
 		int _offset=0;
 		float _value=0;
 
+		if(dftIndexArr[i]<start||dftIndexArr[i]>=end){
+			continue;
+		}
 
 		curLen=windowLengthArr[i];
+		index=startArr[i];
 		_offset=offsetArr[i];
 		for(int j=0,k=curLen-curLen/2;j<curLen;j++,k++){
-			// float r1=0;
-			// float i1=0;
-
-			// if(_offset>=0&&_offset<fftLength){
-			// 	r1=realArr1[_offset];
-			// 	i1=imageArr1[_offset];
-			// }
-
 			_value=windowDataArr[index+j];
 			if(k>=curLen){
 				k=0;
@@ -577,30 +702,59 @@ void nsgtObj_nsgt(NSGTObj nsgtObj,float *dataArr,float *mRealArr3,float *mImageA
 			_offset++;
 		}
 
-		_dIndex=__arr_getIndex(dftLenArr, dftLength, curLen);
-		dftObj_idft(dftArr[_dIndex], realArr2, imageArr2, realArr3+index, imageArr3+index);
-		index+=curLen;
+		dftObj_idft(dftArr[dftIndexArr[i]], realArr2, imageArr2, realArr3+index, imageArr3+index);
 	}
+}
 
-	// 3. to matrix
-	index=0;
-	for(int i=0;i<num;i++){
-		int start=0;
+static void __nsgtObj_matrixChunk(void *arg,int start,int end,int threadIndex){
+	NSGTObj nsgtObj=NULL;
+
+	float *mRealArr3=NULL;
+	float *mImageArr3=NULL;
+
+	int *windowLengthArr=NULL; 
+	int *startArr=NULL;
+
+	float *realArr3=NULL;
+	float *imageArr3=NULL;
+
+	int maxWindowLength=0;
+	float *maxTimeArr=NULL;
+	float **timeArrArr=NULL;
+
+	int curLen=0;
+	int index=0;
+
+	nsgtObj=((NSGTChunkArg *)arg)->nsgtObj;
+	mRealArr3=((NSGTChunkArg *)arg)->mRealArr3;
+	mImageArr3=((NSGTChunkArg *)arg)->mImageArr3;
+
+	windowLengthArr=nsgtObj->windowLengthArr;
+	startArr=nsgtObj->startArr;
+
+	realArr3=nsgtObj->realArr3;
+	imageArr3=nsgtObj->imageArr3;
+
+	maxWindowLength=nsgtObj->maxWindowLength;
+	maxTimeArr=nsgtObj->maxTimeArr;
+	timeArrArr=nsgtObj->timeArrArr;
+
+	for(int i=start;i<end;i++){
+		int _start=0;
 
 		curLen=windowLengthArr[i];
+		index=startArr[i];
 		for(int j=0;j<maxWindowLength;j++){
-			for(int k=start;k<curLen+1;k++){
+			for(int k=_start;k<curLen+1;k++){
 				if(maxTimeArr[j]<timeArrArr[i][k]){
 					mRealArr3[i*maxWindowLength+j]=realArr3[index+k-1];
 					mImageArr3[i*maxWindowLength+j]=imageArr3[index+k-1];
 					
-					start=k;
+					_start=k;
 					break;
 				}
 			}
 		}
-				
-		index+=curLen;
 	}
 }
 
@@ -640,12 +794,6 @@ void nsgtObj_free(NSGTObj nsgtObj){
 	FFTObj fftObj=NULL;
 
 	int num=0;
-	float *windowDataArr=NULL;
-	int *windowLengthArr=NULL; // timeLengthArr
-
-	int *binBandArr=NULL;
-	float *freBandArr=NULL;
-	int *offsetArr=NULL;
 
 	DFTObj *dftArr=NULL;
 	int *dftLenArr=NULL;
@@ -670,12 +818,6 @@ void nsgtObj_free(NSGTObj nsgtObj){
 	fftObj=nsgtObj->fftObj;
 
 	num=nsgtObj->num;
-	windowDataArr=nsgtObj->windowDataArr;
-	windowLengthArr=nsgtObj->windowLengthArr;
-
-	binBandArr=nsgtObj->binBandArr;
-	freBandArr=nsgtObj->freBandArr;
-	offsetArr=nsgtObj->offsetArr;
 
 	dftArr=nsgtObj->dftArr;
 	dftLenArr=nsgtObj->dftLenArr;
@@ -695,12 +837,7 @@ void nsgtObj_free(NSGTObj nsgtObj){
 
 	fftObj_free(fftObj);
 
-	free(windowDataArr);
-	free(windowLengthArr);
-
-	free(binBandArr);
-	free(freBandArr);
-	free(offsetArr);
+	filterBankCacheObj_release(nsgtObj->filterBankCacheObj);
 
 	for(int i=0;i<dftLength;i++){
 		dftObj_free(dftArr[i]);
@@ -708,6 +845,9 @@ void nsgtObj_free(NSGTObj nsgtObj){
 	free(dftArr);
 	free(dftLenArr);
 
+	free(nsgtObj->startArr);
+	free(nsgtObj->dftIndexArr);
+
 	free(realArr1);
 	free(imageArr1);
 
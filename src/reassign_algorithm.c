@@ -149,6 +149,7 @@ int reassignObj_new(ReassignObj *reassignObj,int radix2Exp,
 
 	stftObj_new(&stftObj, _radix2Exp, &_windowType, &_slideLength, &_isContinue);
 	stftObj_enablePadding(stftObj, _isPadding);
+	stftObj_enableHalfSpectrum(stftObj, 1);
 
 	re->isContinue=_isContinue;
 
@@ -235,8 +236,8 @@ void reassignObj_reassign(ReassignObj reassignObj,float *dataArr,int dataLength,
 			free(mRealArr1);
 			free(mImageArr1);
 
-			mRealArr1=__vnew(timeLength*fftLength, NULL);
-			mImageArr1=__vnew(timeLength*fftLength, NULL);
+			mRealArr1=__vnew(timeLength*(fftLength/2+1), NULL);
+			mImageArr1=__vnew(timeLength*(fftLength/2+1), NULL);
 
 			reassignObj->timeLength=timeLength;
 			reassignObj->mRealArr1=mRealArr1;
@@ -523,14 +524,14 @@ static void _reassignObj_dealTCorrData(ReassignObj reassignObj,int dataLength){
 
 		free(mTempIndexArr);
 
-		mRealArr1=__vnew(timeLength*fftLength, NULL);
-		mImageArr1=__vnew(timeLength*fftLength, NULL);
+		mRealArr1=__vnew(timeLength*(fftLength/2+1), NULL);
+		mImageArr1=__vnew(timeLength*(fftLength/2+1), NULL);
 
-		mRealArr2=__vnew(timeLength*fftLength, NULL);
-		mImageArr2=__vnew(timeLength*fftLength, NULL);
+		mRealArr2=__vnew(timeLength*(fftLength/2+1), NULL);
+		mImageArr2=__vnew(timeLength*(fftLength/2+1), NULL);
 
-		mRealArr3=__vnew(timeLength*fftLength, NULL);
-		mImageArr3=__vnew(timeLength*fftLength, NULL);
+		mRealArr3=__vnew(timeLength*(fftLength/2+1), NULL);
+		mImageArr3=__vnew(timeLength*(fftLength/2+1), NULL);
 
 		mReTimeArr=__vnew(timeLength*(fftLength/2+1), NULL);
 		mReFreArr=__vnew(timeLength*(fftLength/2+1), NULL);
@@ -577,9 +578,6 @@ static void _reassignObj_stft(ReassignObj reassignObj,float *dataArr,int dataLen
 	STFTObj stftObj=NULL;
 	float *winArr=NULL; 
 
-	int fftLength=0; 
-	int timeLength=0;
-
 	float *mRealArr1=NULL; // S_h
 	float *mImageArr1=NULL;
 
@@ -589,19 +587,9 @@ static void _reassignObj_stft(ReassignObj reassignObj,float *dataArr,int dataLen
 	mRealArr1=reassignObj->mRealArr1;
 	mImageArr1=reassignObj->mImageArr1;
 
-	fftLength=reassignObj->fftLength;
-	timeLength=reassignObj->timeLength;
-
 	// reset windData & stft
 	stftObj_useWindowDataArr(stftObj, winArr);
 	stftObj_stft(stftObj, dataArr, dataLength, mRealArr1, mImageArr1);
-
-	// timeLength*fftLength => timeLength*(fftLength/2+1) 
-	__mccut(mRealArr1,mImageArr1,
-			timeLength,fftLength,
-			0,timeLength,
-			0,fftLength/2+1,
-			mRealArr1,mImageArr1);
 }
 
 /***
@@ -664,26 +652,11 @@ static void _reassignObj_reassignTimeFre(ReassignObj reassignObj,float *dataArr,
 	if(resType==Reassign_Fre||resType==Reassign_All){
 		stftObj_useWindowDataArr(stftObj, winDerivativeArr+1); // +1
 		stftObj_stft(stftObj, dataArr, dataLength, mRealArr2, mImageArr2);
-
-		// timeLength*fftLength => timeLength*(fftLength/2+1) 
-		__mccut(mRealArr2,mImageArr2,
-				timeLength,fftLength,
-				0,timeLength,
-				0,fftLength/2+1,
-				mRealArr2,mImageArr2);
-
 	}
 
 	if(resType==Reassign_Time||resType==Reassign_All){
 		stftObj_useWindowDataArr(stftObj, winWeightArr);
 		stftObj_stft(stftObj, dataArr, dataLength, mRealArr3, mImageArr3);
-
-		// timeLength*fftLength => timeLength*(fftLength/2+1) 
-		__mccut(mRealArr3,mImageArr3,
-				timeLength,fftLength,
-				0,timeLength,
-				0,fftLength/2+1,
-				mRealArr3,mImageArr3);
 	}
 
 	// mReFreArr w=w-image(S_dh/S_h)
@@ -0,0 +1,228 @@
+//
+
+#include <string.h>
+#include <math.h>
+
+#include "vector/flux_vector.h"
+#include "vector/flux_complex.h"
+#include "vector/flux_vectorOp.h"
+
+#include "stft_algorithm.h"
+#include "spectrogram_algorithm.h"
+#include "spectrogramGraph_algorithm.h"
+
+struct OpaqueSpectrogramGraph{
+	STFTObj stftObj;
+
+	int fftLength;
+	int timeLength; // cache timeLength
+
+	float *mRealArr; // half stft timeLength*(fftLength/2+1)
+	float *mImageArr;
+
+	float *mPowerArr; // |X|^2 timeLength*(fftLength/2+1)
+	float *mMagArr; // |X|, only when isMag
+	int isMag; // some view filterBank input |X|
+
+	SpectrogramObj *viewArr; // not owned
+	int *ccNumArr;
+	CepstralRectifyType *rectifyTypeArr;
+	int viewLength;
+};
+
+int spectrogramGraphObj_new(SpectrogramGraphObj *spectrogramGraphObj,int radix2Exp,WindowType *windowType,int *slideLength,int *isContinue){
+	int status=0;
+	SpectrogramGraphObj graph=NULL;
+
+	STFTObj stftObj=NULL;
+	WindowType _windowType=Window_Hann;
+
+	if(radix2Exp<1||radix2Exp>30){
+		status=-100;
+		return status;
+	}
+
+	if(windowType){
+		_windowType=*windowType;
+	}
+
+	status=stftObj_new(&stftObj,radix2Exp,&_windowType,slideLength,isContinue);
+	if(status){
+		return status;
+	}
+
+	stftObj_enableHalfSpectrum(stftObj,1);
+
+	graph=*spectrogramGraphObj=(SpectrogramGraphObj )calloc(1, sizeof(struct OpaqueSpectrogramGraph ));
+
+	graph->stftObj=stftObj;
+	graph->fftLength=1<<radix2Exp;
+
+	return status;
+}
+
+int spectrogramGraphObj_addView(SpectrogramGraphObj spectrogramGraphObj,SpectrogramObj spectrogramObj,int ccNum,CepstralRectifyType *rectifyType){
+	int length=0;
+
+	SpectrogramObj *viewArr=NULL;
+	int *ccNumArr=NULL;
+	CepstralRectifyType *rectifyTypeArr=NULL;
+
+	if(!spectrogramObj||
+		spectrogramObj_getFFTLength(spectrogramObj)!=spectrogramGraphObj->fftLength){
+		return -1;
+	}
+
+	length=spectrogramGraphObj->viewLength;
+
+	viewArr=(SpectrogramObj *)calloc(length+1, sizeof(SpectrogramObj ));
+	ccNumArr=__vnewi(length+1, NULL);
+	rectifyTypeArr=(CepstralRectifyType *)calloc(length+1, sizeof(CepstralRectifyType ));
+
+	if(length){
+		memcpy(viewArr, spectrogramGraphObj->viewArr, sizeof(SpectrogramObj )*length);
+		memcpy(ccNumArr, spectrogramGraphObj->ccNumArr, sizeof(int )*length);
+		memcpy(rectifyTypeArr, spectrogramGraphObj->rectifyTypeArr, sizeof(CepstralRectifyType )*length);
+	}
+
+	viewArr[length]=spectrogramObj;
+	ccNumArr[length]=(ccNum>0?ccNum:0);
+	rectifyTypeArr[length]=(rectifyType?*rectifyType:CepstralRectify_Log);
+
+	free(spectrogramGraphObj->viewArr);
+	free(spectrogramGraphObj->ccNumArr);
+	free(spectrogramGraphObj->rectifyTypeArr);
+
+	spectrogramGraphObj->viewArr=viewArr;
+	spectrogramGraphObj->ccNumArr=ccNumArr;
+	spectrogramGraphObj->rectifyTypeArr=rectifyTypeArr;
+	spectrogramGraphObj->viewLength=length+1;
+
+	if(spectrogramObj_isMagInput(spectrogramObj)){
+		spectrogramGraphObj->isMag=1;
+	}
+
+	return length;
+}
+
+int spectrogramGraphObj_getViewNum(SpectrogramGraphObj spectrogramGraphObj){
+
+	return spectrogramGraphObj->viewLength;
+}
+
+int spectrogramGraphObj_calTimeLength(SpectrogramGraphObj spectrogramGraphObj,int dataLength){
+
+	return stftObj_calTimeLength(spectrogramGraphObj->stftObj,dataLength);
+}
+
+void spectrogramGraphObj_spectrogram(SpectrogramGraphObj spectrogramGraphObj,float *dataArr,int dataLength,
+									float **mSpectArrArr,float **mCepsArrArr){
+	STFTObj stftObj=NULL;
+
+	int fftLength=0;
+	int mLength=0;
+	int timeLength=0;
+
+	float *mRealArr=NULL;
+	float *mImageArr=NULL;
+
+	float *mPowerArr=NULL;
+	float *mMagArr=NULL;
+
+	if(!dataArr||dataLength<=0||!mSpectArrArr){
+		return;
+	}
+
+	stftObj=spectrogramGraphObj->stftObj;
+
+	fftLength=spectrogramGraphObj->fftLength;
+	mLength=fftLength/2+1;
+
+	timeLength=stftObj_calTimeLength(stftObj,dataLength);
+	if(timeLength<=0){
+		return;
+	}
+
+	if(spectrogramGraphObj->timeLength<timeLength||
+		spectrogramGraphObj->timeLength>timeLength*2){ // 更新缓存
+		free(spectrogramGraphObj->mRealArr);
+		free(spectrogramGraphObj->mImageArr);
+
+		free(spectrogramGraphObj->mPowerArr);
+		free(spectrogramGraphObj->mMagArr);
+
+		spectrogramGraphObj->mRealArr=__vnew(timeLength*mLength, NULL);
+		spectrogramGraphObj->mImageArr=__vnew(timeLength*mLength, NULL);
+
+		spectrogramGraphObj->mPowerArr=__vnew(timeLength*mLength, NULL);
+		spectrogramGraphObj->mMagArr=NULL;
+
+		spectrogramGraphObj->timeLength=timeLength;
+	}
+
+	if(spectrogramGraphObj->isMag&&!spectrogramGraphObj->mMagArr){
+		spectrogramGraphObj->mMagArr=__vnew(spectrogramGraphObj->timeLength*mLength, NULL);
+	}
+
+	mRealArr=spectrogramGraphObj->mRealArr;
+	mImageArr=spectrogramGraphObj->mImageArr;
+
+	mPowerArr=spectrogramGraphObj->mPowerArr;
+	mMagArr=spectrogramGraphObj->mMagArr;
+
+	// 1. stft, power, mag once
+	stftObj_stft(stftObj,dataArr,dataLength,mRealArr,mImageArr);
+	__mcsquare2(mRealArr, mImageArr, timeLength, mLength, mLength, mPowerArr);
+	if(mMagArr){
+		__vsqrt(mPowerArr, timeLength*mLength, mMagArr);
+	}
+
+	// 2. views project shared spectrum, then cepstrum
+	for(int i=0;i<spectrogramGraphObj->viewLength;i++){
+		SpectrogramObj viewObj=NULL;
+
+		viewObj=spectrogramGraphObj->viewArr[i];
+		if(!mSpectArrArr[i]){
+			continue;
+		}
+
+		spectrogramObj_spectrogram2(viewObj,mPowerArr,mMagArr,timeLength,mLength,mSpectArrArr[i]);
+
+		if(spectrogramGraphObj->ccNumArr[i]&&mCepsArrArr&&mCepsArrArr[i]){
+			spectrogramObj_xxcc(viewObj,mSpectArrArr[i],spectrogramGraphObj->ccNumArr[i],
+								spectrogramGraphObj->rectifyTypeArr+i,
+								mCepsArrArr[i]);
+		}
+	}
+}
+
+float *spectrogramGraphObj_getPowerArr(SpectrogramGraphObj spectrogramGraphObj){
+
+	return spectrogramGraphObj->mPowerArr;
+}
+
+float *spectrogramGraphObj_getMagArr(SpectrogramGraphObj spectrogramGraphObj){
+
+	return spectrogramGraphObj->mMagArr;
+}
+
+void spectrogramGraphObj_free(SpectrogramGraphObj spectrogramGraphObj){
+
+	if(!spectrogramGraphObj){
+		return;
+	}
+
+	stftObj_free(spectrogramGraphObj->stftObj);
+
+	free(spectrogramGraphObj->mRealArr);
+	free(spectrogramGraphObj->mImageArr);
+
+	free(spectrogramGraphObj->mPowerArr);
+	free(spectrogramGraphObj->mMagArr);
+
+	free(spectrogramGraphObj->viewArr);
+	free(spectrogramGraphObj->ccNumArr);
+	free(spectrogramGraphObj->rectifyTypeArr);
+
+	free(spectrogramGraphObj);
+}
@@ -5,8 +5,11 @@
 
 #include "vector/flux_vector.h"
 #include "vector/flux_complex.h"
+#include "vector/flux_vectorOp.h"
+#include "vector/_math_kernel.h"
 
 #include "util/flux_util.h"
+#include "util/flux_parallel.h"
 
 #include "dsp/flux_correct.h"
 #include "dsp/fft_algorithm.h"
@@ -15,6 +18,7 @@
 #include "filterbank/auditory_weight.h"
 #include "filterbank/auditory_filterBank.h"
 #include "filterbank/chroma_filterBank.h"
+#include "filterbank/filterBank_cache.h"
 
 #include "flux_spectral.h"
 #include "stft_algorithm.h"
@@ -36,16 +40,26 @@ struct OpaqueSpectrogram{
 
 	int fftLength; // fftLength,timeLength,num
 	int timeLength;
+	int workTimeLength; // >0 timeLength caches in caller workspace, capacity
 
 	int num;
 	float *mFilterBankArr; // num*(fftLength/2+1)/baseNum*(fftLength/2+1)
 	float *mChromaFilterBankArr; // num*baseNum
 
+	// banded mFilterBankArr for auditory scale, rows num/baseNum; NULL => dense
+	int *bandStartArr;
+	int *bandLengthArr;
+	int *bandOffsetArr;
+	float *bandWeightArr;
+
 	float *freBandArr;
 	int *binBandArr;
 
+	// filterBank/band/freBand/binBand/chroma owned by cache entry; NULL => owned by obj
+	FilterBankCacheObj filterBankCacheObj;
+
 	// stft相关
-	float *mRealArr; // stft r,i(timeLength*fftLength) -> power r(timeLength*(fftLength/2+1)) 
+	float *mRealArr; // half stft r,i(timeLength*(fftLength/2+1)) -> power r(timeLength*(fftLength/2+1)) 
 	float *mImageArr;
 	float *mSArr; // timeLength*(fftLength/2+1)
 
@@ -78,8 +92,8 @@ struct OpaqueSpectrogram{
 	int isDebug;
 
 	// dct相关
-	FFTObj fftObj; // dct加速
-	DCTObj dctObj; // 直接矩阵
+	float *mDCTArr; // 截断dct基 ccNum*num
+	int ccNum;
 
 	// params相关
 	int samplate; // filterBank 
@@ -128,8 +142,8 @@ struct OpaqueSpectrogram{
 	float *ampArr; // fftLength/2+1
 	float *weightArr;
 
-	int *salienceIndexArr; //  针对deep/deepChroma
-	int salienceLength; // max==endIndex-startIndex+1
+	int *salienceIndexArr; //  针对deep/deepChroma salienceNum*(endIndex-startIndex+1)
+	int salienceNum; // per thread
 
 	int startIndex; // stft index
 	int endIndex;
@@ -162,8 +176,9 @@ static void __spectrogramObj_calC2(SpectrogramObj spectrogramObj,float *mDataArr
 static void __spectrogramObj_calEntropy(SpectrogramObj spectrogramObj,float *mDataArr,int isNorm);
 static void __spectrogramObj_calMean(SpectrogramObj spectrogramObj,float *mDataArr);
 
+// input data|full stft r,i|half power(+mag) spectrum
 static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *dataArr,int dataLength,
-									float *mRealArr,float *mImageArr,int nLength,int mLength,
+									float *mRealArr,float *mImageArr,float *mPowerArr,float *mMagArr,int nLength,int mLength,
 									float *mSpectArr,float *mPhaseArr);
 
 // mfcc/gtcc ???
@@ -171,7 +186,18 @@ static void __spectrogramObj_xxcc(SpectrogramObj spectrogramObj,float *mDataArr1
 static void __spectrogramObj_dealDeconv(SpectrogramObj spectrogramObj);
 static void __spectrogramObj_deepFilter(SpectrogramObj spectrogramOb,float *mDataArr1,float *mDataArr2,int isDeep);
 
-static int __spectrogramObj_calSalience(SpectrogramObj spectrogramObj,float *ampDataArr);
+// S.dot(filterBank) frame chunks on library threads
+static void __spectrogramObj_filterDot(float *mDataArr1,float *mFilterBankArr,
+									int timeLength,int mLength,int num,int mLength2,
+									float *mDataArr2);
+// S.dot(banded filterBank), only nonzero bins
+static void __spectrogramObj_sparseDot(SpectrogramObj spectrogramObj,float *mDataArr1,
+									int timeLength,int mLength,int num,
+									float *mDataArr2);
+static void __spectrogramObj_dealAuditory(SpectrogramObj spectrogramObj,int rows);
+static int __spectrogramObj_checkFilterBank(FilterBankCacheObj cacheObj,int rows,int mLength,int num,int isLogChroma);
+
+static int __spectrogramObj_calSalience(SpectrogramObj spectrogramObj,float *ampDataArr,int *salienceIndexArr);
 static void __spectrogramObj_calLinearBandArr(SpectrogramObj spectrogramObj,float *freBandArr,int *binBandArr);
 static void __spectrogramObj_calLogBandArr(SpectrogramObj spectrogramObj,float *freBandArr,int *binBandArr);
 static void __spectrogramObj_calDeepBandArr(SpectrogramObj spectrogramObj,float *freBandArr,int *binBandArr);
@@ -180,8 +206,7 @@ static void _calKWeight(float *ampArr1,int start,int end,int fftLength,float *we
 
 static int _calBaseNum(float lowFre,float highFre,float binPerOctave);
 static float _calBaseFre(float lowFre,float binPerOctave);
-static void _calTone(float value1,float *value2,float *value3);
-static int _calRadix2(int length);
+static int _calTone(float value1,float *value2,float *value3);
 
 int spectrogramObj_newLinear(SpectrogramObj *spectrogramObj,int samplate,int radix2Exp,int *isContinue){
 	int status=0;
@@ -606,7 +631,6 @@ static void __spectrogramObj_init(SpectrogramObj spectrogramObj){
 	int lowIndex=0; 
 	int highIndex=0; 
 
-	int binPerOctave=0;
 	int baseNum=0;
 	float baseFre=0;
 
@@ -615,10 +639,6 @@ static void __spectrogramObj_init(SpectrogramObj spectrogramObj){
 	int slideLength=0;
 	int isContinue=0;
 
-	FFTObj fftObj=NULL;
-	DCTObj dctObj=NULL;
-	int r=0;
-
 	float *ampArr=NULL; // fftLength/2+1
 	float *weightArr=NULL;
 
@@ -632,8 +652,6 @@ static void __spectrogramObj_init(SpectrogramObj spectrogramObj){
 	int indexLength=0;
 
 	SpectralFilterBankScaleType filterScaleType;
-	SpectralFilterBankStyleType filterStyleType;
-	SpectralFilterBankNormalType filterNormalType;
 
 	num=spectrogramObj->num;
 	fftLength=spectrogramObj->fftLength;
@@ -645,7 +663,6 @@ static void __spectrogramObj_init(SpectrogramObj spectrogramObj){
 	lowIndex=spectrogramObj->lowIndex;
 	highIndex=spectrogramObj->highIndex;
 
-	binPerOctave=spectrogramObj->binPerOctave;
 	baseNum=spectrogramObj->baseNum;
 	baseFre=spectrogramObj->baseFre;
 
@@ -655,13 +672,12 @@ static void __spectrogramObj_init(SpectrogramObj spectrogramObj){
 	isContinue=spectrogramObj->isContinue;
 
 	filterScaleType=spectrogramObj->filterScaleType;
-	filterStyleType=spectrogramObj->filterStyleType;
-	filterNormalType=spectrogramObj->filterNormalType;
 
 	vArr1=__vnew(fftLength, NULL);
 
 	// 1. stft
 	stftObj_new(&stftObj,radix2Exp,&windowType,&slideLength,&isContinue);
+	stftObj_enableHalfSpectrum(stftObj,1);
 
 	// 2. filterBank
 	if(filterScaleType!=SpectralFilterBankScale_Linear){ // mel/bark/erb... chroma
@@ -673,16 +689,11 @@ static void __spectrogramObj_init(SpectrogramObj spectrogramObj){
 			filterScaleType==SpectralFilterBankScale_Linspace||
 			filterScaleType==SpectralFilterBankScale_Log){ // mel/bark/erb/log linespace/logspace
 
-			mFilterBankArr=__vnew(num*(fftLength/2+1), NULL);
-			freBandArr=__vnew(num+2, NULL); 
-			binBandArr=__vnewi(num+2, NULL);
+			__spectrogramObj_dealAuditory(spectrogramObj,num);
 
-			auditory_filterBank(num,fftLength,samplate,0,
-								filterScaleType,filterStyleType,filterNormalType,
-								lowFre,highFre,binPerOctave,
-								mFilterBankArr,
-								freBandArr,
-								binBandArr);
+			mFilterBankArr=spectrogramObj->mFilterBankArr;
+			freBandArr=spectrogramObj->freBandArr;
+			binBandArr=spectrogramObj->binBandArr;
 		}
 		else if(filterScaleType==SpectralFilterBankScale_Chroma){ // stft-chroma
 			mFilterBankArr=__vnew(num*(fftLength/2+1), NULL);
@@ -696,21 +707,12 @@ static void __spectrogramObj_init(SpectrogramObj spectrogramObj){
 			__spectrogramObj_calLinearBandArr(spectrogramObj,freBandArr,binBandArr);
 		}
 		else if(filterScaleType==SpectralFilterBankScale_LogChroma){ // Log-Chroma
-			mFilterBankArr=__vnew(baseNum*(fftLength/2+1), NULL);
-			freBandArr=__vnew(baseNum+2, NULL); 
-			binBandArr=__vnewi(baseNum+2, NULL);
+			__spectrogramObj_dealAuditory(spectrogramObj,baseNum);
 
-			auditory_filterBank(baseNum,fftLength,samplate,0,
-								filterScaleType,filterStyleType,filterNormalType,
-								lowFre,highFre,binPerOctave,
-								mFilterBankArr,
-								freBandArr,
-								binBandArr);
-
-			mChromaFilterBankArr=__vnew(num*baseNum, NULL);
-			chroma_cqtFilterBank(num,baseNum,binPerOctave,
-								&baseFre,
-								mChromaFilterBankArr);
+			mFilterBankArr=spectrogramObj->mFilterBankArr;
+			freBandArr=spectrogramObj->freBandArr;
+			binBandArr=spectrogramObj->binBandArr;
+			mChromaFilterBankArr=spectrogramObj->mChromaFilterBankArr;
 		}
 		else if(filterScaleType==SpectralFilterBankScale_DeepChroma){ // similar cqt-chroma 
 			mFilterBankArr=__vnew(num*baseNum, NULL);
@@ -743,16 +745,7 @@ static void __spectrogramObj_init(SpectrogramObj spectrogramObj){
 	__varangei(start,end+1,1,&indexArr);
 	indexLength=num;
 
-	// 3. dct
-	r=_calRadix2(num);
-	if(r){ // dct加速
-		fftObj_new(&fftObj, r);
-	}
-	else{ // 直接dct
-		dctObj_new(&dctObj, num,NULL);
-	}
-
-	// 4. deep相关
+	// 3. deep相关
 	ampArr=__vnew(fftLength/2+1, NULL);
 	weightArr=__vlinspace(0, samplate/2.0, fftLength/2+1, 0);
 	auditory_weightA(weightArr, fftLength/2+1, NULL);
@@ -775,13 +768,11 @@ static void __spectrogramObj_init(SpectrogramObj spectrogramObj){
 	spectrogramObj->start=start;
 	spectrogramObj->end=end;
 
-	spectrogramObj->fftObj=fftObj;
-	spectrogramObj->dctObj=dctObj;
-
 	spectrogramObj->ampArr=ampArr;
 	spectrogramObj->weightArr=weightArr;
 
 	spectrogramObj->salienceIndexArr=salienceIndexArr;
+	spectrogramObj->salienceNum=1;
 
 	spectrogramObj->startIndex=startIndex;
 	spectrogramObj->endIndex=endIndex;
@@ -852,6 +843,415 @@ int spectrogramObj_calTimeLength(SpectrogramObj spectrogramObj,int dataLength){
 	return timeLength;
 }	
 
+static size_t __spectrogramObj_carveCache(SpectrogramObj spectrogramObj,int timeLength,void *workArr);
+static void __spectrogramObj_freeCache(SpectrogramObj spectrogramObj);
+// per frame scale types, stftObj_stftFrame path
+static int __spectrogramObj_isTile(SpectrogramObj spectrogramObj);
+
+size_t spectrogramObj_calWorkspaceSize(SpectrogramObj spectrogramObj,int maxDataLength){
+	int timeLength=0;
+	size_t size=0;
+
+	if(maxDataLength<=0){
+		return 0;
+	}
+
+	// +fftLength cover continue tail/padding
+	timeLength=stftObj_calTimeLength(spectrogramObj->stftObj,maxDataLength+spectrogramObj->fftLength);
+
+	size=__spectrogramObj_carveCache(spectrogramObj,timeLength,NULL)+64;
+	size+=stftObj_calWorkspaceSize(spectrogramObj->stftObj,maxDataLength);
+
+	return size;
+}
+
+int spectrogramObj_useWorkspace(SpectrogramObj spectrogramObj,void *workArr,size_t size,int maxDataLength){
+	int timeLength=0;
+	size_t offset=0;
+
+	__spectrogramObj_freeCache(spectrogramObj);
+	if(!workArr){
+		stftObj_useWorkspace(spectrogramObj->stftObj,NULL,0,0);
+		return 0;
+	}
+
+	if(maxDataLength<=0||
+		size<spectrogramObj_calWorkspaceSize(spectrogramObj,maxDataLength)){
+		return -1;
+	}
+
+	timeLength=stftObj_calTimeLength(spectrogramObj->stftObj,maxDataLength+spectrogramObj->fftLength);
+
+	offset=__spectrogramObj_carveCache(spectrogramObj,timeLength,workArr);
+	memset(workArr, 0, offset);
+
+	spectrogramObj->workTimeLength=timeLength;
+	if(__spectrogramObj_isTile(spectrogramObj)){
+		stftObj_prepareFrame(spectrogramObj->stftObj);
+	}
+
+	return stftObj_useWorkspace(spectrogramObj->stftObj,(char *)workArr+offset,size-offset,maxDataLength);
+}
+
+
+/***
+	timeLength caches in order: mRealArr,mImageArr(timeLength*max(fftLength/2+1,baseNum)),mSArr,
+	energy/sum/c1/c2/entropy/meanFre/meanValue(timeLength), deep correct/tone(timeLength*baseNum)
+	workArr NULL => only bytes
+****/
+static size_t __spectrogramObj_carveCache(SpectrogramObj spectrogramObj,int timeLength,void *workArr){
+	size_t offset=0;
+
+	float **arrArr[13]={0};
+	int lengthArr[13]={0};
+	int arrLength=10;
+
+	int fftLength=0;
+	int baseNum=0;
+	int bLength=0;
+
+	fftLength=spectrogramObj->fftLength;
+	baseNum=spectrogramObj->baseNum;
+
+	bLength=fftLength/2+1;
+	if(baseNum>bLength){
+		bLength=baseNum;
+	}
+
+	arrArr[0]=&spectrogramObj->mRealArr;
+	arrArr[1]=&spectrogramObj->mImageArr;
+	arrArr[2]=&spectrogramObj->mSArr;
+	arrArr[3]=&spectrogramObj->energyArr;
+	arrArr[4]=&spectrogramObj->sumArr;
+	arrArr[5]=&spectrogramObj->cArr1;
+	arrArr[6]=&spectrogramObj->cArr2;
+	arrArr[7]=&spectrogramObj->entropyArr;
+	arrArr[8]=&spectrogramObj->meanFreArr;
+	arrArr[9]=&spectrogramObj->meanValueArr;
+
+	lengthArr[0]=timeLength*bLength;
+	lengthArr[1]=timeLength*bLength;
+	lengthArr[2]=timeLength*(fftLength/2+1);
+	for(int i=3;i<10;i++){
+		lengthArr[i]=timeLength;
+	}
+
+	if(spectrogramObj->filterScaleType==SpectralFilterBankScale_Deep||
+		spectrogramObj->filterScaleType==SpectralFilterBankScale_DeepChroma){
+		arrArr[10]=&spectrogramObj->mCorrectFreArr;
+		arrArr[11]=&spectrogramObj->mToneFreArr;
+		arrArr[12]=&spectrogramObj->mToneFreArr1;
+
+		lengthArr[10]=timeLength*baseNum;
+		lengthArr[11]=timeLength*baseNum;
+		lengthArr[12]=timeLength*baseNum;
+
+		arrLength=13;
+	}
+
+	for(int i=0;i<arrLength;i++){
+		float *arr=NULL;
+
+		arr=__vcarve(workArr,&offset,lengthArr[i]);
+		if(workArr){
+			*arrArr[i]=arr;
+		}
+	}
+
+	return offset;
+}
+
+// own caches freed, workspace caches only detached
+static void __spectrogramObj_freeCache(SpectrogramObj spectrogramObj){
+
+	if(!spectrogramObj->workTimeLength){
+		free(spectrogramObj->mRealArr);
+		free(spectrogramObj->mImageArr);
+		free(spectrogramObj->mSArr);
+
+		free(spectrogramObj->energyArr);
+
+		free(spectrogramObj->sumArr);
+		free(spectrogramObj->cArr1);
+		free(spectrogramObj->cArr2);
+		free(spectrogramObj->entropyArr);
+
+		free(spectrogramObj->meanFreArr);
+		free(spectrogramObj->meanValueArr);
+
+		free(spectrogramObj->mCorrectFreArr);
+		free(spectrogramObj->mToneFreArr);
+		free(spectrogramObj->mToneFreArr1);
+	}
+
+	spectrogramObj->mRealArr=NULL;
+	spectrogramObj->mImageArr=NULL;
+	spectrogramObj->mSArr=NULL;
+
+	spectrogramObj->energyArr=NULL;
+
+	spectrogramObj->sumArr=NULL;
+	spectrogramObj->cArr1=NULL;
+	spectrogramObj->cArr2=NULL;
+	spectrogramObj->entropyArr=NULL;
+
+	spectrogramObj->meanFreArr=NULL;
+	spectrogramObj->meanValueArr=NULL;
+
+	spectrogramObj->mCorrectFreArr=NULL;
+	spectrogramObj->mToneFreArr=NULL;
+	spectrogramObj->mToneFreArr1=NULL;
+
+	spectrogramObj->timeLength=0;
+	spectrogramObj->workTimeLength=0;
+}
+
+// timeLength caches(grow, or shrink below half; workspace fixed) and spectral state reset
+static void __spectrogramObj_dealCache(SpectrogramObj spectrogramObj,int timeLength){
+	int fftLength=0;
+	int baseNum=0;
+
+	int bLength=0; // fftLength/2+1 or baseNum
+
+	fftLength=spectrogramObj->fftLength;
+	baseNum=spectrogramObj->baseNum;
+
+	if(spectrogramObj->workTimeLength&&
+		timeLength>spectrogramObj->workTimeLength){ // over workspace, back to own cache
+		__spectrogramObj_freeCache(spectrogramObj);
+	}
+
+	if(!spectrogramObj->workTimeLength&&
+		(spectrogramObj->timeLength<timeLength||
+		spectrogramObj->timeLength>timeLength*2)){ // 更新缓存
+		__spectrogramObj_freeCache(spectrogramObj);
+		
+		// half stft; reused by logChroma/deepChroma/xxcc timeLength*baseNum/num
+		bLength=fftLength/2+1;
+		if(baseNum>bLength){
+			bLength=baseNum;
+		}
+
+		spectrogramObj->mRealArr=__vnew(timeLength*bLength, NULL);
+		spectrogramObj->mImageArr=__vnew(timeLength*bLength, NULL);
+		spectrogramObj->mSArr=__vnew(timeLength*(fftLength/2+1), NULL);
+
+		spectrogramObj->energyArr=__vnew(timeLength, NULL);
+
+		spectrogramObj->sumArr=__vnew(timeLength, NULL);
+		spectrogramObj->cArr1=__vnew(timeLength, NULL);
+		spectrogramObj->cArr2=__vnew(timeLength, NULL);
+		spectrogramObj->entropyArr=__vnew(timeLength, NULL);
+
+		spectrogramObj->meanFreArr=__vnew(timeLength, NULL);
+		spectrogramObj->meanValueArr=__vnew(timeLength, NULL);
+
+		if(spectrogramObj->filterScaleType==SpectralFilterBankScale_Deep||
+			spectrogramObj->filterScaleType==SpectralFilterBankScale_DeepChroma){
+			spectrogramObj->mCorrectFreArr=__vnew(timeLength*baseNum, NULL);
+			spectrogramObj->mToneFreArr=__vnew(timeLength*baseNum, NULL);
+			spectrogramObj->mToneFreArr1=__vnew(timeLength*baseNum, NULL);
+		}
+	}
+
+	// 针对deepFilter
+	spectrogramObj->timeLength=timeLength;
+
+	// 数据变换或内存变换 重置状态
+	spectrogramObj->isSum=0;
+	spectrogramObj->isC1=0;
+	spectrogramObj->isC2=0;
+	spectrogramObj->isEntropy=0;
+	spectrogramObj->isEnNorm=0;
+
+	spectrogramObj->isMean=0;
+}
+
+// __spectrogramObj_tileFrame arg
+typedef struct{
+	SpectrogramObj spectrogramObj;
+
+	float *mDataArr;
+	float *mPhaseArr;
+
+} TileFrameArg;
+
+// per frame scale types, no cross frame step
+static int __spectrogramObj_isTile(SpectrogramObj spectrogramObj){
+	SpectralFilterBankScaleType filterScaleType;
+
+	filterScaleType=spectrogramObj->filterScaleType;
+
+	return (filterScaleType==SpectralFilterBankScale_Linear||
+			filterScaleType==SpectralFilterBankScale_Mel||
+			filterScaleType==SpectralFilterBankScale_Bark||
+			filterScaleType==SpectralFilterBankScale_Erb||
+			filterScaleType==SpectralFilterBankScale_Octave||
+			filterScaleType==SpectralFilterBankScale_Linspace||
+			filterScaleType==SpectralFilterBankScale_Log||
+			filterScaleType==SpectralFilterBankScale_Chroma);
+}
+
+/***
+	frame block [start,start+length) half spectrum => mDataArr rows, same result as matrix path
+	mRealArr/mImageArr length*(fftLength/2+1) scratch, overwritten
+	mPhaseArr linear only, can NULL
+****/
+static void __spectrogramObj_dealTile(SpectrogramObj spectrogramObj,float *mRealArr,float *mImageArr,int start,int length,
+									float *mDataArr,float *mPhaseArr){
+	int mLength=0;
+	int num=0;
+	int len=0;
+
+	int lowIndex=0;
+	int highIndex=0;
+
+	float normValue=1;
+	int isMag=0;
+
+	float *outArr=NULL;
+
+	SpectralFilterBankScaleType filterScaleType;
+
+	mLength=spectrogramObj->fftLength/2+1;
+	num=spectrogramObj->num;
+
+	lowIndex=spectrogramObj->lowIndex;
+	highIndex=spectrogramObj->highIndex;
+	len=highIndex-lowIndex+1;
+
+	normValue=spectrogramObj->normValue;
+	isMag=(spectrogramObj->dataType==SpectralData_Mag);
+
+	filterScaleType=spectrogramObj->filterScaleType;
+	outArr=mDataArr+start*num;
+
+	if(mPhaseArr&&filterScaleType==SpectralFilterBankScale_Linear){
+		for(int i=0;i<length;i++){
+			float *realArr=NULL;
+			float *phaseArr=NULL;
+
+			realArr=mRealArr+i*mLength+lowIndex;
+			phaseArr=mPhaseArr+(start+i)*len;
+
+			for(int k=0;k<len;k++){
+				phaseArr[k]=(realArr[k]<1e-16?1e-16:realArr[k]);
+			}
+
+			__vatan2(mImageArr+i*mLength+lowIndex, phaseArr, len, phaseArr);
+		}
+	}
+
+	for(int i=0;i<length*mLength;i++){
+		mRealArr[i]=mRealArr[i]*mRealArr[i]+mImageArr[i]*mImageArr[i];
+	}
+
+	if(isMag){
+		__vsqrt(mRealArr, length*mLength, NULL);
+	}
+	else if(normValue!=1){
+		__vpow(mRealArr, normValue, length*mLength, NULL);
+	}
+
+	if(filterScaleType==SpectralFilterBankScale_Linear){
+		for(int i=0;i<length;i++){
+			memcpy(outArr+i*len, mRealArr+i*mLength+lowIndex, sizeof(float )*len);
+		}
+	}
+	else if(filterScaleType==SpectralFilterBankScale_Chroma){
+		int type1=0;
+		int p1=1;
+		ChromaDataNormalType _normType=ChromaDataNormal_Max;
+
+		if(lowIndex!=0||highIndex!=mLength-1){
+			for(int i=0;i<length;i++){
+				for(int j=0;j<mLength;j++){
+					if(j<lowIndex||j>highIndex){
+						mRealArr[i*mLength+j]=0;
+					}
+				}
+			}
+		}
+
+		__mdot1(mRealArr,spectrogramObj->mFilterBankArr,
+			length,mLength,
+			num,mLength,
+			outArr);
+
+		if(isMag&&normValue!=1){
+			__vpow(outArr, normValue, length*num, NULL);
+		}
+
+		_normType=spectrogramObj->dataNormType;
+		if(_normType!=ChromaDataNormal_None){
+			if(_normType==ChromaDataNormal_Max){
+				type1=1;
+			}
+			else if(_normType==ChromaDataNormal_Min){
+				type1=2;
+			}
+			else{
+				type1=0;
+				if(_normType==ChromaDataNormal_P2){
+					p1=2;
+				}
+			}
+
+			__mnormalize(outArr,length,num,1,type1,p1,outArr);
+		}
+
+		return;
+	}
+	else if(spectrogramObj->bandWeightArr){ // mel/bark/erb/octave/linspace/log
+		auditory_sparseDot(mRealArr,length,mLength,
+						num,spectrogramObj->bandStartArr,spectrogramObj->bandLengthArr,
+						spectrogramObj->bandOffsetArr,spectrogramObj->bandWeightArr,
+						outArr);
+	}
+	else{
+		__mdot1(mRealArr,spectrogramObj->mFilterBankArr,
+			length,mLength,
+			num,mLength,
+			outArr);
+	}
+
+	if(isMag&&normValue!=1){
+		__vpow(outArr, normValue, length*num, NULL);
+	}
+}
+
+static void __spectrogramObj_tileFrame(void *arg,float *mRealArr,float *mImageArr,int start,int length,int threadIndex){
+	TileFrameArg *tileArg=NULL;
+
+	tileArg=(TileFrameArg *)arg;
+
+	__spectrogramObj_dealTile(tileArg->spectrogramObj,mRealArr,mImageArr,start,length,
+							tileArg->mDataArr,tileArg->mPhaseArr);
+}
+
+/***
+	raw data per frame types, stft blocks of 8 frames(fftLength 4096 ~128KB r+i, in L2)
+	=> power/mag => projection straight to mDataArr; timeLength*fftLength matrix never built
+****/
+static void __spectrogramObj_tileSpectrogram(SpectrogramObj spectrogramObj,float *dataArr,int dataLength,
+											float *mDataArr,float *mPhaseArr){
+	int timeLength=0;
+
+	TileFrameArg tileArg;
+
+	timeLength=stftObj_calTimeLength(spectrogramObj->stftObj,dataLength);
+	if(timeLength<=0){
+		return;
+	}
+
+	__spectrogramObj_dealCache(spectrogramObj,timeLength);
+
+	tileArg.spectrogramObj=spectrogramObj;
+	tileArg.mDataArr=mDataArr;
+	tileArg.mPhaseArr=mPhaseArr;
+
+	stftObj_stftFrame(spectrogramObj->stftObj,dataArr,dataLength,__spectrogramObj_tileFrame,&tileArg);
+}
 
 // spectrogram方法
 /***
@@ -861,33 +1261,21 @@ int spectrogramObj_calTimeLength(SpectrogramObj spectrogramObj,int dataLength){
 	3. power/mag/db计算
 	4. S.dot(filterBank)
 ****/
-static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *dataArr,int dataLength,float *mRealArr1,float *mImageArr1,int nLength,int mLength,float *mDataArr,float *mPhaseArr){
+static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *dataArr,int dataLength,float *mRealArr1,float *mImageArr1,float *mPowerArr1,float *mMagArr1,int nLength,int mLength,float *mDataArr,float *mPhaseArr){
 	STFTObj stftObj=NULL;
 
 	int fftLength=0; // fftLength,timeLength,num
 	int timeLength=0;
 
-	int slideLength=0;
-
 	int num=0;
 	float *mFilterBankArr=NULL;
 	float *mChromaFilterBankArr=NULL;
 	float *freBandArr=NULL;
 
-	float *sumArr=NULL;
-	float *cArr1=NULL; // μ1
-	float *cArr2=NULL;
-	float *entropyArr=NULL;
-
-	float *meanFreArr=NULL; 
-	float *meanValueArr=NULL; 
-	
 	float *mRealArr=NULL;
 	float *mImageArr=NULL;
 	float *mSArr=NULL;
-
-	float *energyArr=NULL;
-	float *vArr1=NULL;
+	float *sArr=NULL; // mSArr or read only mPowerArr1/mMagArr1
 
 	int lowIndex=0; // 针对linear
 	int highIndex=0;
@@ -898,14 +1286,14 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 	float normValue=1;
 	int baseNum=0;
 
-	float *mCorrectFreArr=NULL; // 校正频率 timeLength*baseNum
-	float *mToneFreArr=NULL;
-	float *mToneFreArr1=NULL; // 临近参照
-
 	int deepOrder=1; 
 
 	int eFlag=0;
 	int sFlag=0;
+	int pFlag=0; // power input
+	int magFlag=0; // mag taken from mMagArr1
+	int isMag=0;
+
 	
 	stftObj=spectrogramObj->stftObj;
 
@@ -922,28 +1310,9 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 	mChromaFilterBankArr=spectrogramObj->mChromaFilterBankArr; 
 	freBandArr=spectrogramObj->freBandArr;
 
-	mRealArr=spectrogramObj->mRealArr; // timeLength*fftLength
-	mImageArr=spectrogramObj->mImageArr;
-	mSArr=spectrogramObj->mSArr; // timeLength*(fftLength/2+1)
-
-	energyArr=spectrogramObj->energyArr; // timeLength
-	vArr1=spectrogramObj->vArr1; // fftLength
-
-	sumArr=spectrogramObj->sumArr; // timeLength
-	cArr1=spectrogramObj->cArr1;
-	cArr2=spectrogramObj->cArr2;
-	entropyArr=spectrogramObj->entropyArr;
-
-	meanFreArr=spectrogramObj->meanFreArr;
-	meanValueArr=spectrogramObj->meanValueArr;
-	
 	lowIndex=spectrogramObj->lowIndex;
 	highIndex=spectrogramObj->highIndex;
 
-	mCorrectFreArr=spectrogramObj->mCorrectFreArr;
-	mToneFreArr=spectrogramObj->mToneFreArr;
-	mToneFreArr1=spectrogramObj->mToneFreArr1;
-
 	deepOrder=spectrogramObj->deepOrder;
 
 	if(dataArr&&dataLength){
@@ -955,6 +1324,11 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 			nLength>0&&mLength==fftLength){
 			eFlag=1;
 		}	
+		else if(mPowerArr1&&
+			nLength>0&&mLength==fftLength/2+1){
+			eFlag=1;
+			pFlag=1;
+		}
 	}
 
 	if(!eFlag){
@@ -968,62 +1342,20 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 		timeLength=nLength;
 	}
 	
-	slideLength=spectrogramObj->slideLength;
-	// det=(fftLength-slideLength)/slideLength+1; // 每次更新,避免第二次相同时溢出!!!
-	if(spectrogramObj->timeLength<timeLength||
-		spectrogramObj->timeLength>timeLength*2){ // 更新缓存
-		free(mRealArr);
-		free(mImageArr);
-		free(mSArr);
-
-		free(energyArr);
-
-		free(sumArr);
-		free(cArr1);
-		free(cArr2);
-		free(entropyArr);
-
-		free(meanFreArr);
-		free(meanValueArr);
-		
-		mRealArr=__vnew(timeLength*fftLength, NULL);
-		mImageArr=__vnew(timeLength*fftLength, NULL);
-		mSArr=__vnew(timeLength*(fftLength/2+1), NULL);
-
-		energyArr=__vnew(timeLength, NULL);
-
-		sumArr=__vnew(timeLength, NULL);
-		cArr1=__vnew(timeLength, NULL);
-		cArr2=__vnew(timeLength, NULL);
-		entropyArr=__vnew(timeLength, NULL);
-
-		meanFreArr=__vnew(timeLength, NULL);
-		meanValueArr=__vnew(timeLength, NULL);
-
-		if(spectrogramObj->filterScaleType==SpectralFilterBankScale_Deep||
-			spectrogramObj->filterScaleType==SpectralFilterBankScale_DeepChroma){
-			free(mCorrectFreArr);
-			free(mToneFreArr);
-			free(mToneFreArr1);
+	__spectrogramObj_dealCache(spectrogramObj,timeLength);
 
-			mCorrectFreArr=__vnew(timeLength*baseNum, NULL);
-			mToneFreArr=__vnew(timeLength*baseNum, NULL);
-			mToneFreArr1=__vnew(timeLength*baseNum, NULL);
-		}
-	}
-
-	// 针对deepFilter
-	spectrogramObj->timeLength=timeLength;
-	spectrogramObj->mCorrectFreArr=mCorrectFreArr;
-	spectrogramObj->mToneFreArr=mToneFreArr;
-	spectrogramObj->mToneFreArr1=mToneFreArr1;
+	mRealArr=spectrogramObj->mRealArr; // timeLength*(fftLength/2+1) or baseNum
+	mImageArr=spectrogramObj->mImageArr;
+	mSArr=spectrogramObj->mSArr; // timeLength*(fftLength/2+1)
 
 	if(sFlag){
 		stftObj_stft(stftObj,dataArr,dataLength,mRealArr,mImageArr);
 	}
-	else{
-		memcpy(mRealArr, mRealArr1, sizeof(float )*nLength*fftLength);
-		memcpy(mImageArr, mImageArr1, sizeof(float )*nLength*fftLength);
+	else if(!pFlag){ // full => half
+		for(int i=0;i<nLength;i++){
+			memcpy(mRealArr+i*(fftLength/2+1), mRealArr1+i*fftLength, sizeof(float )*(fftLength/2+1));
+			memcpy(mImageArr+i*(fftLength/2+1), mImageArr1+i*fftLength, sizeof(float )*(fftLength/2+1));
+		}
 	}
 
 //	// energyArr ->base stft reslut
@@ -1033,21 +1365,23 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 //	}
 
 	// phase ->base stft reslut
-	if(mPhaseArr&&filterScaleType==SpectralFilterBankScale_Linear){
+	if(!pFlag&&mPhaseArr&&filterScaleType==SpectralFilterBankScale_Linear){
 		int len=0;
 
 		len=highIndex-lowIndex+1;
 		for(int i=0;i<timeLength;i++){
-			for(int j=lowIndex,k=0;j<=highIndex;j++,k++){
-				float r1=0;
+			float *realArr=NULL;
+			float *phaseArr=NULL;
 
-				r1=mRealArr[i*fftLength+j];
-				if(r1<1e-16){
-					r1=1e-16;
-				}
+			realArr=mRealArr+i*(fftLength/2+1)+lowIndex;
+			phaseArr=mPhaseArr+i*len;
 
-				mPhaseArr[i*len+k]=atan2f(mImageArr[i*fftLength+j], r1);
+			// clamped real into phase row, then atan2 in place
+			for(int k=0;k<len;k++){
+				phaseArr[k]=(realArr[k]<1e-16?1e-16:realArr[k]);
 			}
+
+			__vatan2(mImageArr+i*(fftLength/2+1)+lowIndex, phaseArr, len, phaseArr);
 		}
 	}
 
@@ -1056,18 +1390,23 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 		spectrogramObj->lowIndex==0&&
 		spectrogramObj->highIndex==spectrogramObj->fftLength/2){ // linear 0~fftLength/2 特殊处理
 
-		__mcsquare2(mRealArr, mImageArr, timeLength, fftLength, fftLength/2+1, mDataArr); // S^2
+		if(!pFlag){
+			__mcsquare2(mRealArr, mImageArr, timeLength, fftLength/2+1, fftLength/2+1, mDataArr); // S^2
+		}
+		else if(dataType==SpectralData_Mag&&mMagArr1){
+			memcpy(mDataArr, mMagArr1, sizeof(float )*timeLength*(fftLength/2+1));
+			magFlag=1;
+		}
+		else{
+			memcpy(mDataArr, mPowerArr1, sizeof(float )*timeLength*(fftLength/2+1));
+		}
 
-		if(dataType==SpectralData_Mag){
-			for(int i=0;i<timeLength*(fftLength/2+1);i++){
-				mDataArr[i]=sqrtf(mDataArr[i]);
-			}
+		if(dataType==SpectralData_Mag&&!magFlag){
+			__vsqrt(mDataArr, timeLength*(fftLength/2+1), NULL);
 		}
 		else if(dataType==SpectralData_Power){
 			if(normValue!=1){
-				for(int i=0;i<timeLength*(fftLength/2+1);i++){
-					mDataArr[i]=powf(mDataArr[i], normValue);
-				}
+				__vpow(mDataArr, normValue, timeLength*(fftLength/2+1), NULL);
 			}
 		}
 
@@ -1078,27 +1417,47 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 		}
 	}
 	else{
-		__mcsquare2(mRealArr, mImageArr, timeLength, fftLength, fftLength/2+1, mSArr); // S^2
-
-		if(dataType==SpectralData_Mag||
+		isMag=(dataType==SpectralData_Mag||
 			filterScaleType==SpectralFilterBankScale_Deep||
-			filterScaleType==SpectralFilterBankScale_DeepChroma){ // deep/deepChroma必须先amp
+			filterScaleType==SpectralFilterBankScale_DeepChroma); // deep/deepChroma必须先amp
 
-			for(int i=0;i<timeLength*(fftLength/2+1);i++){
-				mSArr[i]=sqrtf(mSArr[i]);
+		sArr=mSArr;
+		if(!pFlag){
+			__mcsquare2(mRealArr, mImageArr, timeLength, fftLength/2+1, fftLength/2+1, mSArr); // S^2
+		}
+		else{ // shared spectrum read in place, copy only when changed below
+			if(isMag&&mMagArr1){
+				sArr=mMagArr1;
+				magFlag=1;
+			}
+			else{
+				sArr=mPowerArr1;
+			}
+
+			if((isMag&&!magFlag)||
+				(!isMag&&dataType==SpectralData_Power&&normValue!=1)||
+				(filterScaleType==SpectralFilterBankScale_Chroma&&
+					(lowIndex!=0||highIndex!=fftLength/2))){
+
+				memcpy(mSArr, sArr, sizeof(float )*timeLength*(fftLength/2+1));
+				sArr=mSArr;
+			}
+		}
+
+		if(isMag){
+			if(!magFlag){
+				__vsqrt(sArr, timeLength*(fftLength/2+1), NULL);
 			}
 		}
 		else if(dataType==SpectralData_Power){
 			if(normValue!=1){ 
-				for(int i=0;i<timeLength*(fftLength/2+1);i++){
-					mSArr[i]=powf(mSArr[i], normValue);
-				}
+				__vpow(sArr, normValue, timeLength*(fftLength/2+1), NULL);
 			}
 		}
 
 		if(spectrogramObj->isDebug){
 			printf("stft power spectrogram is :\n");
-			__mdebug(mSArr, timeLength, fftLength/2+1, 1);
+			__mdebug(sArr, timeLength, fftLength/2+1, 1);
 			printf("\n\n");
 		}
 
@@ -1110,9 +1469,9 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 			filterScaleType==SpectralFilterBankScale_Linspace||
 			filterScaleType==SpectralFilterBankScale_Log){ // mel/bark/erb/log linspace/logspace
 
-			__mdot1(mSArr,mFilterBankArr,
+			__spectrogramObj_sparseDot(spectrogramObj,sArr,
 				timeLength,fftLength/2+1,
-				num,fftLength/2+1,
+				num,
 				mDataArr);
 
 			if(spectrogramObj->isDebug){
@@ -1132,22 +1491,20 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 				for(int i=0;i<timeLength;i++){
 					for(int j=0;j<fftLength/2+1;j++){
 						if(j<spectrogramObj->lowIndex||j>spectrogramObj->highIndex){
-							mSArr[i*(fftLength/2+1)+j]=0;
+							sArr[i*(fftLength/2+1)+j]=0;
 						}
 					}
 				}
 			}
 
-			__mdot1(mSArr,mFilterBankArr,
+			__spectrogramObj_filterDot(sArr,mFilterBankArr,
 				timeLength,fftLength/2+1,
 				num,fftLength/2+1,
 				mDataArr);
 
 			if(dataType==SpectralData_Mag){
 				if(normValue!=1){
-					for(int i=0;i<timeLength*num;i++){
-						mDataArr[i]=powf(mDataArr[i],normValue);
-					}
+					__vpow(mDataArr, normValue, timeLength*num, NULL);
 				}
 			}
 
@@ -1180,21 +1537,19 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 			int p1=1;
 			ChromaDataNormalType _normType=ChromaDataNormal_Max;
 
-			__mdot1(mSArr,mFilterBankArr,
+			__spectrogramObj_sparseDot(spectrogramObj,sArr,
 				timeLength,fftLength/2+1,
-				baseNum,fftLength/2+1,
+				baseNum,
 				mImageArr);
 
-			__mdot1(mImageArr,mChromaFilterBankArr,
+			__spectrogramObj_filterDot(mImageArr,mChromaFilterBankArr,
 				timeLength,baseNum,
 				num,baseNum,
 				mDataArr);
 
 			if(dataType==SpectralData_Mag){
 				if(normValue!=1){
-					for(int i=0;i<timeLength*num;i++){
-						mDataArr[i]=powf(mDataArr[i],normValue);
-					}
+					__vpow(mDataArr, normValue, timeLength*num, NULL);
 				}
 			}
 
@@ -1236,7 +1591,9 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 				k=5;
 			}
 
-			__spectrogramObj_deepFilter(spectrogramObj,mSArr,mDataArr,1);
+			// deepFilter only max-update, output not assume zero
+			memset(mDataArr, 0, sizeof(float )*k*timeLength*num);
+			__spectrogramObj_deepFilter(spectrogramObj,sArr,mDataArr,1);
 
 			if(dataType==SpectralData_Power){
 				for(int i=0;i<k*timeLength*num;i++){
@@ -1244,16 +1601,12 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 				}
 
 				if(normValue!=1){
-					for(int i=0;i<k*timeLength*num;i++){
-						mDataArr[i]=powf(mDataArr[i], normValue);
-					}
+					__vpow(mDataArr, normValue, k*timeLength*num, NULL);
 				}
 			}
 			else if(dataType==SpectralData_Mag){
 				if(normValue!=1){
-					for(int i=0;i<k*timeLength*num;i++){
-						mDataArr[i]=powf(mDataArr[i],normValue);
-					}
+					__vpow(mDataArr, normValue, k*timeLength*num, NULL);
 				}
 			}
 		}
@@ -1263,7 +1616,7 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 			ChromaDataNormalType _normType=ChromaDataNormal_Max;
 
 			memset(mImageArr, 0, sizeof(float )*timeLength*baseNum);
-			__spectrogramObj_deepFilter(spectrogramObj,mSArr,mImageArr,0);
+			__spectrogramObj_deepFilter(spectrogramObj,sArr,mImageArr,0);
 
 			if(dataType==SpectralData_Power){
 				for(int i=0;i<timeLength*baseNum;i++){
@@ -1271,22 +1624,18 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 				}
 
 				if(normValue!=1){
-					for(int i=0;i<timeLength*baseNum;i++){
-						mImageArr[i]=powf(mImageArr[i], normValue);
-					}
+					__vpow(mImageArr, normValue, timeLength*baseNum, NULL);
 				}
 			}
 
-			__mdot1(mImageArr,mFilterBankArr,
+			__spectrogramObj_filterDot(mImageArr,mFilterBankArr,
 				timeLength,baseNum,
 				num,baseNum,
 				mDataArr);
 
 			if(dataType==SpectralData_Mag){
 				if(normValue!=1){
-					for(int i=0;i<timeLength*num;i++){
-						mDataArr[i]=powf(mDataArr[i],normValue);
-					}
+					__vpow(mDataArr, normValue, timeLength*num, NULL);
 				}
 			}
 
@@ -1320,7 +1669,7 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 			len=highIndex-lowIndex+1;
 			for(int i=0;i<timeLength;i++){
 				for(int j=lowIndex,k=0;j<=highIndex;j++,k++){
-					mDataArr[i*len+k]=mSArr[i*(fftLength/2+1)+j];
+					mDataArr[i*len+k]=sArr[i*(fftLength/2+1)+j];
 				}
 			}
 		}
@@ -1333,9 +1682,7 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 
 		if(dataType==SpectralData_Mag){
 			if(normValue!=1){
-				for(int i=0;i<timeLength*num;i++){
-					mDataArr[i]=powf(mDataArr[i],normValue);
-				}
+				__vpow(mDataArr, normValue, timeLength*num, NULL);
 			}
 		}
 	}
@@ -1362,72 +1709,196 @@ static void __spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *da
 		__mdebug(mDataArr, timeLength, num, 1);
 		printf("\n\n");
 	}
-
-	spectrogramObj->mRealArr=mRealArr;
-	spectrogramObj->mImageArr=mImageArr;
-	spectrogramObj->mSArr=mSArr;
-
-	spectrogramObj->energyArr=energyArr;
-
-	spectrogramObj->sumArr=sumArr;
-	spectrogramObj->cArr1=cArr1;
-	spectrogramObj->cArr2=cArr2;
-	spectrogramObj->entropyArr=entropyArr;
-
-	spectrogramObj->meanFreArr=meanFreArr;
-	spectrogramObj->meanValueArr=meanValueArr;
-
-	// 数据变换或内存变换 重置状态
-	spectrogramObj->isSum=0;
-	spectrogramObj->isC1=0;
-	spectrogramObj->isC2=0;
-	spectrogramObj->isEntropy=0;
-	spectrogramObj->isEnNorm=0;
-
-	spectrogramObj->isMean=0;
 }
 
 void spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *dataArr,int dataLength,float *mSpectArr,float *mPhaseArr){
 	
+	if(dataArr&&dataLength>0&&
+		!spectrogramObj->isDebug&&
+		__spectrogramObj_isTile(spectrogramObj)){
+
+		__spectrogramObj_tileSpectrogram(spectrogramObj,dataArr,dataLength,mSpectArr,mPhaseArr);
+		return;
+	}
+
 	__spectrogramObj_spectrogram(spectrogramObj,dataArr,dataLength,
-								NULL,NULL,0,0,
+								NULL,NULL,NULL,NULL,0,0,
 								mSpectArr,mPhaseArr);
 }
 
 void spectrogramObj_spectrogram1(SpectrogramObj spectrogramObj,float *mRealArr,float *mImageArr,int nLength,int mLength,float *mSpectArr,float *mPhaseArr){
 	
 	__spectrogramObj_spectrogram(spectrogramObj,NULL,0,
-								mRealArr,mImageArr,nLength,mLength,
+								mRealArr,mImageArr,NULL,NULL,nLength,mLength,
 								mSpectArr,mPhaseArr);
 }
 
+void spectrogramObj_spectrogram2(SpectrogramObj spectrogramObj,float *mPowerArr,float *mMagArr,int nLength,int mLength,float *mSpectArr){
+	
+	__spectrogramObj_spectrogram(spectrogramObj,NULL,0,
+								NULL,NULL,mPowerArr,mMagArr,nLength,mLength,
+								mSpectArr,NULL);
+}
+
+// __spectrogramObj_dbFrame arg
+typedef struct{
+	SpectrogramObj spectrogramObj;
+
+	float *mDataArr;
+
+	float factor; // 10 power, 20 mag
+	float aminValue;
+	float offValue; // factor*log10(max(ref,amin))
+
+} DBFrameArg;
+
+// vArr=factor*log10(max(vArr,amin))-offValue in place
+static void __spectrogramObj_toDB(float *vArr,int length,float factor,float aminValue,float offValue){
+
+	for(int i=0;i<length;i++){
+		if(vArr[i]<aminValue){
+			vArr[i]=aminValue;
+		}
+	}
+
+	__vlog10(vArr, length, NULL);
+
+	for(int i=0;i<length;i++){
+		vArr[i]=factor*vArr[i]-offValue;
+	}
+}
+
+// tile rows then dB while still in cache
+static void __spectrogramObj_dbFrame(void *arg,float *mRealArr,float *mImageArr,int start,int length,int threadIndex){
+	DBFrameArg *frameArg=NULL;
+	SpectrogramObj spectrogramObj=NULL;
+
+	int num=0;
+
+	frameArg=(DBFrameArg *)arg;
+	spectrogramObj=frameArg->spectrogramObj;
+
+	num=spectrogramObj->num;
+
+	__spectrogramObj_dealTile(spectrogramObj,mRealArr,mImageArr,start,length,
+							frameArg->mDataArr,NULL);
+
+	__spectrogramObj_toDB(frameArg->mDataArr+start*num,length*num,
+						frameArg->factor,frameArg->aminValue,frameArg->offValue);
+}
+
+void spectrogramObj_spectrogramDB(SpectrogramObj spectrogramObj,float *dataArr,int dataLength,
+								float *refValue,float *aminValue,float *topDB,
+								float *mDataArr){
+	SpectralFilterBankScaleType filterScaleType;
+
+	int timeLength=0;
+	int length=0;
+
+	float _refValue=1;
+	float _aminValue=1e-10;
+	float _topDB=80;
+
+	float maxValue=0;
+
+	DBFrameArg frameArg;
+
+	if(!dataArr||dataLength<=0||!mDataArr){
+		return;
+	}
+
+	filterScaleType=spectrogramObj->filterScaleType;
+
+	frameArg.spectrogramObj=spectrogramObj;
+	frameArg.mDataArr=mDataArr;
+
+	frameArg.factor=10;
+	if(spectrogramObj->dataType==SpectralData_Mag){
+		frameArg.factor=20;
+		_aminValue=1e-5;
+	}
+
+	if(refValue){
+		_refValue=*refValue;
+	}
+
+	if(aminValue){
+		if(*aminValue>0){
+			_aminValue=*aminValue;
+		}
+	}
+
+	if(topDB){
+		_topDB=*topDB;
+	}
+
+	frameArg.aminValue=_aminValue;
+	frameArg.offValue=0;
+	if(_refValue>0){
+		frameArg.offValue=frameArg.factor*log10f(_refValue>_aminValue?_refValue:_aminValue);
+	}
+
+	if(__spectrogramObj_isTile(spectrogramObj)){ // fused, no timeLength*fftLength matrix
+
+		timeLength=stftObj_stftFrame(spectrogramObj->stftObj,dataArr,dataLength,
+									__spectrogramObj_dbFrame,&frameArg);
+		length=timeLength*spectrogramObj->num;
+	}
+	else{ // full spectrogram then dB
+		spectrogramObj_spectrogram(spectrogramObj,dataArr,dataLength,mDataArr,NULL);
+
+		timeLength=spectrogramObj->timeLength;
+		length=timeLength*spectrogramObj->num;
+		if(filterScaleType==SpectralFilterBankScale_Deep){
+			length*=(spectrogramObj->deepOrder<=2?3:5);
+		}
+
+		if(length>0){
+			__spectrogramObj_toDB(mDataArr,length,frameArg.factor,frameArg.aminValue,frameArg.offValue);
+		}
+	}
+
+	if(length<=0){
+		return;
+	}
+
+	// ref max/top dB, one pass on output
+	if(_refValue<=0||_topDB>0){
+		__vmax(mDataArr, length, &maxValue);
+
+		if(_refValue<=0){
+			for(int i=0;i<length;i++){
+				mDataArr[i]-=maxValue;
+			}
+
+			maxValue=0;
+		}
+
+		if(_topDB>0){
+			for(int i=0;i<length;i++){
+				if(mDataArr[i]<maxValue-_topDB){
+					mDataArr[i]=maxValue-_topDB;
+				}
+			}
+		}
+	}
+}
+
 // mfcc/gtcc/???
 /***
 	1. log&DCT
 	2. delta/deltaDelta
 ****/
 static void __spectrogramObj_xxcc(SpectrogramObj spectrogramObj,float *mDataArr1,int mLength,CepstralRectifyType *rectifyType,float *mDataArr2){
-	FFTObj fftObj=NULL;
-	DCTObj dctObj=NULL;
-
 	CepstralRectifyType recType=CepstralRectify_Log;
 
 	int num=0;
 	int timeLength=0;
 
-	float *mRealArr=NULL; 
-	float *mImageArr=NULL;
-
 	num=spectrogramObj->num;
 	timeLength=spectrogramObj->timeLength;
 
-	mRealArr=spectrogramObj->mRealArr;
-	mImageArr=spectrogramObj->mImageArr;
-
-	fftObj=spectrogramObj->fftObj;
-	dctObj=spectrogramObj->dctObj;
-
-	if(mLength>num){
+	if(mLength>num||mLength<1){
 		return;
 	}
 
@@ -1435,44 +1906,16 @@ static void __spectrogramObj_xxcc(SpectrogramObj spectrogramObj,float *mDataArr1
 		recType=*rectifyType;
 	}
 
-	if(recType==CepstralRectify_CubicRoot){
-		for(int i=0;i<timeLength*num;i++){
-			mRealArr[i]=powf(mDataArr1[i], 1.0/3);
-		}
-	}
-	else { // log
-		for(int i=0;i<timeLength*num;i++){
-			float _value=0;
-
-			_value=mDataArr1[i];
-			if(_value<1e-8){
-				_value=1e-8;
-			}
-
-			mRealArr[i]=log10f(_value); // matlab canonic
-		}
-	}
-
-	for(int i=0;i<timeLength;i++){
-		if(fftObj){
-			fftObj_dct(fftObj, mRealArr+i*num, mImageArr+i*num, 1);
-		}
-		else{
-			dctObj_dct(dctObj, mRealArr+i*num,1,mImageArr+i*num);
-		}
-	}
-
-	for(int i=0;i<timeLength;i++){
-		for(int j=0;j<mLength;j++){
-			mDataArr2[i*mLength+j]=mImageArr[i*num+j];
-		}
+	// 截断dct基 只算ccNum行
+	if(!spectrogramObj->mDCTArr||spectrogramObj->ccNum!=mLength){
+		free(spectrogramObj->mDCTArr);
+		spectrogramObj->mDCTArr=dct_createMatrix(num,mLength);
+		spectrogramObj->ccNum=mLength;
 	}
 
-	if(spectrogramObj->isDebug){
-		printf("xxcc is :\n");
-		__mdebug(mDataArr2, timeLength, mLength, 1);
-		printf("\n\n");
-	}
+	dct_cepstrum(mDataArr1,timeLength,num,
+				spectrogramObj->mDCTArr,mLength,recType,
+				spectrogramObj->mRealArr,mDataArr2);
 }
 
 // mel/erb ==> mfcc/gtcc
@@ -1673,14 +2116,83 @@ static void __spectrogramObj_dealDeconv(SpectrogramObj spectrogramObj){
 	}
 }
 
+// __spectrogramObj_deepFilter __parallel_for arg
+typedef struct{
+	SpectrogramObj spectrogramObj;
+
+	float *mDataArr1;
+	float *mDataArr2;
+
+	int isDeep;
+
+} DeepFilterChunkArg;
+
+static void __spectrogramObj_deepFilterChunk(void *arg,int start,int end,int threadIndex);
+static void __spectrogramObj_deepFrame(SpectrogramObj spectrogramObj,int i,float *ampArr,float *mDataArr2,int isDeep,int *salienceIndexArr);
+
 /***
 	deepFilter 基于amp的filter模型
 	mDataArr1 timeLength*(fftLength/2+1)
 	mDataArr2 timeLength*baseNum+timeLength*baseNum...
 	mDataArr2 布局max+left1+right1+left2+right2
-
+	frame独立(只写第index行), 按frame并行, salience每线程一段
 ****/
 static void __spectrogramObj_deepFilter(SpectrogramObj spectrogramObj,float *mDataArr1,float *mDataArr2,int isDeep){
+	int timeLength=0;
+	int threadNum=0;
+	int chunkLength=0;
+
+	int len=0;
+
+	DeepFilterChunkArg chunkArg;
+
+	timeLength=spectrogramObj->timeLength;
+	if(timeLength<=0){
+		return;
+	}
+
+	len=spectrogramObj->endIndex-spectrogramObj->startIndex+1;
+	threadNum=audioflux_getThreadNum();
+	if(spectrogramObj->salienceNum<threadNum){
+		free(spectrogramObj->salienceIndexArr);
+
+		spectrogramObj->salienceIndexArr=__vnewi(threadNum*len, NULL);
+		spectrogramObj->salienceNum=threadNum;
+	}
+
+	chunkArg.spectrogramObj=spectrogramObj;
+	chunkArg.mDataArr1=mDataArr1;
+	chunkArg.mDataArr2=mDataArr2;
+	chunkArg.isDeep=isDeep;
+
+	chunkLength=(timeLength+threadNum*4-1)/(threadNum*4);
+	__parallel_for(timeLength,chunkLength,threadNum,__spectrogramObj_deepFilterChunk,&chunkArg);
+}
+
+static void __spectrogramObj_deepFilterChunk(void *arg,int start,int end,int threadIndex){
+	DeepFilterChunkArg *chunkArg=NULL;
+	SpectrogramObj spectrogramObj=NULL;
+
+	int fftLength=0;
+	int *salienceIndexArr=NULL;
+
+	chunkArg=(DeepFilterChunkArg *)arg;
+	spectrogramObj=chunkArg->spectrogramObj;
+
+	fftLength=spectrogramObj->fftLength;
+	salienceIndexArr=spectrogramObj->salienceIndexArr+
+					threadIndex*(spectrogramObj->endIndex-spectrogramObj->startIndex+1);
+
+	for(int i=start;i<end;i++){
+		__spectrogramObj_deepFrame(spectrogramObj,i,
+								chunkArg->mDataArr1+i*(fftLength/2+1),
+								chunkArg->mDataArr2,chunkArg->isDeep,
+								salienceIndexArr);
+	}
+}
+
+// frame i
+static void __spectrogramObj_deepFrame(SpectrogramObj spectrogramObj,int i,float *ampArr,float *mDataArr2,int isDeep,int *salienceIndexArr){
 	int fftLength=0; // fftLength,timeLength,num
 	int timeLength=0;
 
@@ -1690,11 +2202,9 @@ static void __spectrogramObj_deepFilter(SpectrogramObj spectrogramObj,float *mDa
 	WindowType windowType=Window_Hamm;
 	int deepOrder=1; // 1
 
-	int *salienceIndexArr=NULL; //  针对deep/deepChroma
 	int salienceLength=0;
 
 	int midiStart=0;
-	int midiEnd=0;
 
 	float det=0;
 
@@ -1712,131 +2222,369 @@ static void __spectrogramObj_deepFilter(SpectrogramObj spectrogramObj,float *mDa
 	deepOrder=spectrogramObj->deepOrder;
 
 	midiStart=spectrogramObj->midiStart;
-	midiEnd=spectrogramObj->midiEnd;
 
 	mCorrectFreArr=spectrogramObj->mCorrectFreArr;
 	mToneFreArr=spectrogramObj->mToneFreArr;
 	mToneFreArr1=spectrogramObj->mToneFreArr1;
 
 	det=samplate/(float )fftLength;
-	salienceIndexArr=spectrogramObj->salienceIndexArr;
-	for(int i=0;i<timeLength;i++){
-		float *ampArr=NULL;
-
-		ampArr=mDataArr1+i*(fftLength/2+1);
-		salienceLength=__spectrogramObj_calSalience(spectrogramObj,ampArr);
-		for(int j=0;j<salienceLength;j++){
-			float correctFre=0;
-			float toneFre=0;
-			float toneFre1=0;
-
-			int stftIndex=0;
-			int leftIndex1=0;
-			int rightIndex1=0;
-			int leftIndex2=0;
-			int rightIndex2=0;
-
-			int midiIndex=0; 
-			int deepIndex=0;
-
-			float cur=0;
-			float left1=0;
-			float right1=0;
-			float left2=0;
-			float right2=0;
-
-			float scale=0;
-			float value=0;
-
-			float flag=0;
+	salienceLength=__spectrogramObj_calSalience(spectrogramObj,ampArr,salienceIndexArr);
+	for(int j=0;j<salienceLength;j++){
+		float correctFre=0;
+		float toneFre=0;
+		float toneFre1=0;
+
+		int stftIndex=0;
+		int leftIndex1=0;
+		int rightIndex1=0;
+		int leftIndex2=0;
+		int rightIndex2=0;
+
+		int midiIndex=0; 
+		int deepIndex=0;
+
+		float cur=0;
+		float left1=0;
+		float right1=0;
+		float left2=0;
+		float right2=0;
+
+		float scale=0;
+
+		float flag=0;
+
+		stftIndex=salienceIndexArr[j];
+		leftIndex1=stftIndex-1;
+		rightIndex1=stftIndex+1;
+
+		cur=ampArr[stftIndex];
+		left1=ampArr[leftIndex1];
+		right1=ampArr[rightIndex1];
+
+		// det only, amp value not use
+		if(windowType==Window_Hamm){
+			correct_hamm(cur,left1,right1,&scale,NULL);
+		}
+		else if(windowType==Window_Hann){
+			correct_hann(cur,left1,right1,&scale,NULL);
+		}
+		else if(windowType==Window_Rect){
+			correct_rect(cur,left1,right1,&scale,NULL);
+		}
 
-			stftIndex=salienceIndexArr[j];
-			leftIndex1=stftIndex-1;
-			rightIndex1=stftIndex+1;
+		correctFre=(stftIndex+scale)*det;
+		midiIndex=_calTone(correctFre, &toneFre, &toneFre1);
 
-			cur=ampArr[stftIndex];
-			left1=ampArr[leftIndex1];
-			right1=ampArr[rightIndex1];
+		deepIndex=midiIndex-midiStart;
 
-			if(windowType==Window_Hamm){
-				correct_hamm(cur,left1,right1,&scale,&value);
-			}
-			else if(windowType==Window_Hann){
-				correct_hann(cur,left1,right1,&scale,&value);
-			}
-			else if(windowType==Window_Rect){
-				correct_rect(cur,left1,right1,&scale,&value);
+		if(deepIndex>=0&&deepIndex<baseNum){
+			if(mDataArr2[i*baseNum+deepIndex]<cur){
+				mDataArr2[i*baseNum+deepIndex]=cur;
+				flag=1;
 			}
 
-			correctFre=(stftIndex+scale)*det;
-			_calTone(correctFre, &toneFre, &toneFre1);
-
-			midiIndex=auditory_freToMidi(toneFre);
-			deepIndex=midiIndex-midiStart;
-
-			if(deepIndex>=0&&deepIndex<baseNum){
-				if(mDataArr2[i*baseNum+deepIndex]<cur){
-					mDataArr2[i*baseNum+deepIndex]=cur;
-					flag=1;
-				}
-
-				mCorrectFreArr[i*baseNum+deepIndex]=correctFre;
-				mToneFreArr[i*baseNum+deepIndex]=toneFre;
-				mToneFreArr1[i*baseNum+deepIndex]=toneFre1;
-			}
+			mCorrectFreArr[i*baseNum+deepIndex]=correctFre;
+			mToneFreArr[i*baseNum+deepIndex]=toneFre;
+			mToneFreArr1[i*baseNum+deepIndex]=toneFre1;
+		}
 
-			if(isDeep&&flag){ 
-				if(deepOrder==1){ // left1+right1
-					if(left1>right1){
-						mDataArr2[timeLength*baseNum+i*baseNum+deepIndex]=left1;
-					}
-					else{
-						mDataArr2[2*timeLength*baseNum+i*baseNum+deepIndex]=right1;
-					}
-				}
-				else if(deepOrder==2){ // left1+right1
+		if(isDeep&&flag){ 
+			if(deepOrder==1){ // left1+right1
+				if(left1>right1){
 					mDataArr2[timeLength*baseNum+i*baseNum+deepIndex]=left1;
-					mDataArr2[2*timeLength*baseNum+i*baseNum+deepIndex]=right1;
 				}
-				else{ // left1+right1+left2+right2
-					mDataArr2[timeLength*baseNum+i*baseNum+deepIndex]=left1;
+				else{
 					mDataArr2[2*timeLength*baseNum+i*baseNum+deepIndex]=right1;
-
-					leftIndex2=leftIndex1-1;
-					if(leftIndex2>=0){
-						left2=ampArr[leftIndex2];
-						if(left2>left1){
-							left2=0;
-						}
+				}
+			}
+			else if(deepOrder==2){ // left1+right1
+				mDataArr2[timeLength*baseNum+i*baseNum+deepIndex]=left1;
+				mDataArr2[2*timeLength*baseNum+i*baseNum+deepIndex]=right1;
+			}
+			else{ // left1+right1+left2+right2
+				mDataArr2[timeLength*baseNum+i*baseNum+deepIndex]=left1;
+				mDataArr2[2*timeLength*baseNum+i*baseNum+deepIndex]=right1;
+
+				leftIndex2=leftIndex1-1;
+				if(leftIndex2>=0){
+					left2=ampArr[leftIndex2];
+					if(left2>left1){
+						left2=0;
 					}
+				}
 
-					rightIndex2=rightIndex1+1;
-					if(rightIndex2<(fftLength/2+1)){
-						right2=ampArr[rightIndex2];
-						if(right2>right1){
-							right2=0;
-						}
+				rightIndex2=rightIndex1+1;
+				if(rightIndex2<(fftLength/2+1)){
+					right2=ampArr[rightIndex2];
+					if(right2>right1){
+						right2=0;
 					}
+				}
 
-					if(deepOrder==3){
-						if(left2>right2){
-							mDataArr2[3*timeLength*baseNum+i*baseNum+deepIndex]=left2;
-						}
-						else{
-							mDataArr2[4*timeLength*baseNum+i*baseNum+deepIndex]=right2;
-						}
+				if(deepOrder==3){
+					if(left2>right2){
+						mDataArr2[3*timeLength*baseNum+i*baseNum+deepIndex]=left2;
 					}
 					else{
-						mDataArr2[3*timeLength*baseNum+i*baseNum+deepIndex]=left2;
 						mDataArr2[4*timeLength*baseNum+i*baseNum+deepIndex]=right2;
 					}
 				}
+				else{
+					mDataArr2[3*timeLength*baseNum+i*baseNum+deepIndex]=left2;
+					mDataArr2[4*timeLength*baseNum+i*baseNum+deepIndex]=right2;
+				}
 			}
 		}
 	}
 }
 
-static int __spectrogramObj_calSalience(SpectrogramObj spectrogramObj,float *ampDataArr){
+// __spectrogramObj_filterDot __parallel_for arg
+typedef struct{
+	float *mDataArr1;
+	float *mFilterBankArr;
+	float *mDataArr2;
+
+	int mLength;
+	int num;
+
+} FilterDotChunkArg;
+
+static void __spectrogramObj_filterDotChunk(void *arg,int start,int end,int threadIndex){
+	FilterDotChunkArg *chunkArg=NULL;
+
+	int mLength=0;
+	int num=0;
+
+	chunkArg=(FilterDotChunkArg *)arg;
+
+	mLength=chunkArg->mLength;
+	num=chunkArg->num;
+
+	__mdot1(chunkArg->mDataArr1+start*mLength,chunkArg->mFilterBankArr,
+		end-start,mLength,
+		num,mLength,
+		chunkArg->mDataArr2+start*num);
+}
+
+static void __spectrogramObj_filterDot(float *mDataArr1,float *mFilterBankArr,
+									int timeLength,int mLength,int num,int mLength2,
+									float *mDataArr2){
+	FilterDotChunkArg chunkArg;
+
+	if(mLength!=mLength2){
+		return;
+	}
+
+	chunkArg.mDataArr1=mDataArr1;
+	chunkArg.mFilterBankArr=mFilterBankArr;
+	chunkArg.mDataArr2=mDataArr2;
+
+	chunkArg.mLength=mLength;
+	chunkArg.num=num;
+
+	__parallel_for(timeLength,0,0,__spectrogramObj_filterDotChunk,&chunkArg);
+}
+
+// __spectrogramObj_sparseDot __parallel_for arg
+typedef struct{
+	SpectrogramObj spectrogramObj;
+
+	float *mDataArr1;
+	float *mDataArr2;
+
+	int mLength;
+	int num;
+
+} SparseDotChunkArg;
+
+static void __spectrogramObj_sparseDotChunk(void *arg,int start,int end,int threadIndex){
+	SparseDotChunkArg *chunkArg=NULL;
+	SpectrogramObj spectrogramObj=NULL;
+
+	int mLength=0;
+	int num=0;
+
+	chunkArg=(SparseDotChunkArg *)arg;
+	spectrogramObj=chunkArg->spectrogramObj;
+
+	mLength=chunkArg->mLength;
+	num=chunkArg->num;
+
+	auditory_sparseDot(chunkArg->mDataArr1+start*mLength,end-start,mLength,
+					num,spectrogramObj->bandStartArr,spectrogramObj->bandLengthArr,
+					spectrogramObj->bandOffsetArr,spectrogramObj->bandWeightArr,
+					chunkArg->mDataArr2+start*num);
+}
+
+static void __spectrogramObj_sparseDot(SpectrogramObj spectrogramObj,float *mDataArr1,
+									int timeLength,int mLength,int num,
+									float *mDataArr2){
+	SparseDotChunkArg chunkArg;
+
+	if(!spectrogramObj->bandWeightArr){
+		__spectrogramObj_filterDot(mDataArr1,spectrogramObj->mFilterBankArr,
+								timeLength,mLength,num,mLength,
+								mDataArr2);
+		return;
+	}
+
+	chunkArg.spectrogramObj=spectrogramObj;
+
+	chunkArg.mDataArr1=mDataArr1;
+	chunkArg.mDataArr2=mDataArr2;
+
+	chunkArg.mLength=mLength;
+	chunkArg.num=num;
+
+	__parallel_for(timeLength,0,0,__spectrogramObj_sparseDotChunk,&chunkArg);
+}
+
+// imported entry shape must match what dealAuditory indexes
+static int __spectrogramObj_checkFilterBank(FilterBankCacheObj cacheObj,int rows,int mLength,int num,int isLogChroma){
+	int *startArr=NULL;
+	int *bLengthArr=NULL;
+	int *offsetArr=NULL;
+
+	int weightLength=0;
+
+	startArr=filterBankCacheObj_getIntArr(cacheObj,1);
+	bLengthArr=filterBankCacheObj_getIntArr(cacheObj,2);
+	offsetArr=filterBankCacheObj_getIntArr(cacheObj,3);
+
+	weightLength=filterBankCacheObj_getArrLength(cacheObj,2);
+
+	if(!startArr||!bLengthArr||!offsetArr||
+		filterBankCacheObj_getArrLength(cacheObj,0)!=rows*mLength||
+		filterBankCacheObj_getArrLength(cacheObj,1)!=rows+2||
+		weightLength<1||
+		filterBankCacheObj_getArrLength(cacheObj,3)!=(isLogChroma?num*rows:0)||
+		filterBankCacheObj_getIntArrLength(cacheObj,0)!=rows+2||
+		filterBankCacheObj_getIntArrLength(cacheObj,1)!=rows||
+		filterBankCacheObj_getIntArrLength(cacheObj,2)!=rows||
+		filterBankCacheObj_getIntArrLength(cacheObj,3)!=rows){
+
+		return 0;
+	}
+
+	for(int i=0;i<rows;i++){
+		if(startArr[i]<0||bLengthArr[i]<0||offsetArr[i]<0||
+			startArr[i]+bLengthArr[i]>mLength||
+			offsetArr[i]+bLengthArr[i]>weightLength){
+
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/***
+	auditory_filterBank rows num/baseNum(logChroma)+banded weights(+chroma)
+	shared through filterBank cache, key all filterBank params
+****/
+static void __spectrogramObj_dealAuditory(SpectrogramObj spectrogramObj,int rows){
+	FilterBankCacheObj cacheObj=NULL;
+	double paramArr[11]={0};
+
+	int num=0;
+	int fftLength=0;
+	int mLength=0;
+	float baseFre=0;
+
+	SpectralFilterBankScaleType filterScaleType;
+
+	float *arrArr[4]={0}; // mFilterBankArr,freBandArr,bandWeightArr,mChromaFilterBankArr
+	int lengthArr[4]={0};
+
+	int *iArrArr[4]={0}; // binBandArr,bandStartArr,bandLengthArr,bandOffsetArr
+	int iLengthArr[4]={0};
+
+	num=spectrogramObj->num;
+	fftLength=spectrogramObj->fftLength;
+	mLength=fftLength/2+1;
+	baseFre=spectrogramObj->baseFre;
+
+	filterScaleType=spectrogramObj->filterScaleType;
+
+	paramArr[0]=num;
+	paramArr[1]=rows;
+	paramArr[2]=fftLength;
+	paramArr[3]=spectrogramObj->samplate;
+	paramArr[4]=filterScaleType;
+	paramArr[5]=spectrogramObj->filterStyleType;
+	paramArr[6]=spectrogramObj->filterNormalType;
+	paramArr[7]=spectrogramObj->lowFre;
+	paramArr[8]=spectrogramObj->highFre;
+	paramArr[9]=spectrogramObj->binPerOctave;
+	paramArr[10]=baseFre;
+
+	cacheObj=filterBankCache_find(FilterBankCache_Auditory,paramArr,11);
+	if(cacheObj&&!__spectrogramObj_checkFilterBank(cacheObj,rows,mLength,num,
+													filterScaleType==SpectralFilterBankScale_LogChroma)){
+		filterBankCacheObj_discard(cacheObj);
+		cacheObj=NULL;
+	}
+	if(!cacheObj){
+		int weightLength=0;
+
+		arrArr[0]=__vnew(rows*mLength, NULL);
+		arrArr[1]=__vnew(rows+2, NULL); 
+		iArrArr[0]=__vnewi(rows+2, NULL);
+
+		auditory_filterBank(rows,fftLength,spectrogramObj->samplate,0,
+							filterScaleType,spectrogramObj->filterStyleType,spectrogramObj->filterNormalType,
+							spectrogramObj->lowFre,spectrogramObj->highFre,spectrogramObj->binPerOctave,
+							arrArr[0],
+							arrArr[1],
+							iArrArr[0]);
+
+		// triangle/window style span few bins
+		iArrArr[1]=__vnewi(rows, NULL);
+		iArrArr[2]=__vnewi(rows, NULL);
+		iArrArr[3]=__vnewi(rows, NULL);
+
+		weightLength=auditory_sparseFilterBank(arrArr[0],rows,mLength,
+											iArrArr[1],iArrArr[2],iArrArr[3],
+											&arrArr[2]);
+
+		if(filterScaleType==SpectralFilterBankScale_LogChroma){
+			arrArr[3]=__vnew(num*rows, NULL);
+			chroma_cqtFilterBank(num,rows,spectrogramObj->binPerOctave,
+								&baseFre,
+								arrArr[3]);
+
+			lengthArr[3]=num*rows;
+		}
+
+		lengthArr[0]=rows*mLength;
+		lengthArr[1]=rows+2;
+		lengthArr[2]=(weightLength>0?weightLength:1);
+
+		iLengthArr[0]=rows+2;
+		iLengthArr[1]=rows;
+		iLengthArr[2]=rows;
+		iLengthArr[3]=rows;
+
+		cacheObj=filterBankCache_insert(FilterBankCache_Auditory,paramArr,11,
+										arrArr,lengthArr,4,
+										iArrArr,iLengthArr,4);
+	}
+
+	spectrogramObj->filterBankCacheObj=cacheObj;
+
+	spectrogramObj->mFilterBankArr=filterBankCacheObj_getArr(cacheObj,0);
+	spectrogramObj->freBandArr=filterBankCacheObj_getArr(cacheObj,1);
+	spectrogramObj->bandWeightArr=filterBankCacheObj_getArr(cacheObj,2);
+	spectrogramObj->mChromaFilterBankArr=filterBankCacheObj_getArr(cacheObj,3);
+
+	spectrogramObj->binBandArr=filterBankCacheObj_getIntArr(cacheObj,0);
+	spectrogramObj->bandStartArr=filterBankCacheObj_getIntArr(cacheObj,1);
+	spectrogramObj->bandLengthArr=filterBankCacheObj_getIntArr(cacheObj,2);
+	spectrogramObj->bandOffsetArr=filterBankCacheObj_getIntArr(cacheObj,3);
+}
+
+// salienceIndexArr endIndex-startIndex+1
+static int __spectrogramObj_calSalience(SpectrogramObj spectrogramObj,float *ampDataArr,int *salienceIndexArr){
 	int fftLength=0;
 
 	int start=0; 
@@ -1850,9 +2598,6 @@ static int __spectrogramObj_calSalience(SpectrogramObj spectrogramObj,float *amp
 	float max=0;
 	float min=0;
 
-	int *salienceIndexArr=NULL; //  针对deep/deepChroma
-	int salienceLength=0;
-
 	start=spectrogramObj->startIndex;
 	end=spectrogramObj->endIndex;
 
@@ -1862,16 +2607,7 @@ static int __spectrogramObj_calSalience(SpectrogramObj spectrogramObj,float *amp
 	ratio=spectrogramObj->ratio;
 	fftLength=spectrogramObj->fftLength;
 
-	salienceIndexArr=spectrogramObj->salienceIndexArr;
-	memset(salienceIndexArr, 0, sizeof(int )*(end-start+1));
-
-	// {
-	// 	printf("ampArr is:\n");
-	// 	__vdebug(ampDataArr, fftLength/2+1, 1);
-	// 	printf("\n");
-	// }
-
-	__vmax(ampDataArr+start, end-start+1, &max);
+	max=__mathKernel_max(ampDataArr+start, end-start+1);
 	if(max<maxMin){
 		return 0;
 	}
@@ -1889,20 +2625,7 @@ static int __spectrogramObj_calSalience(SpectrogramObj spectrogramObj,float *amp
 		end=fftLength/2-1;
 	}
 
-	for(int i=start;i<=end;i++){
-		float _value=0;
-
-		_value=ampDataArr[i];
-		if(_value>ampDataArr[i-1]&&_value>ampDataArr[i+1]){
-			if(_value>=min){
-				salienceIndexArr[salienceLength]=i;
-				salienceLength++;
-			}
-		}
-	}
-
-	spectrogramObj->salienceLength=salienceLength;
-	return salienceLength;
+	return __mathKernel_peak(ampDataArr, start, end, min, salienceIndexArr);
 }
 
 // Linear/Chroma
@@ -3035,24 +3758,8 @@ void spectrogramObj_free(SpectrogramObj spectrogramObj){
 
 	int *indexArr=NULL;
 
-	float *sumArr=NULL;
-	float *cArr1=NULL; // μ1
-	float *cArr2=NULL;
-	float *entropyArr=NULL;
-
-	float *meanFreArr=NULL; 
-	float *meanValueArr=NULL; 
-	
-	float *mRealArr=NULL;
-	float *mImageArr=NULL;
-	float *mSArr=NULL;
-
-	float *energyArr=NULL;
 	float *vArr1=NULL;
 
-	FFTObj fftObj=NULL;
-	DCTObj dctObj=NULL;
-
 	FFTObj devFFTObj=NULL;
 
 	float *devDataArr=NULL; // spectral mag&fft mag
@@ -3068,10 +3775,6 @@ void spectrogramObj_free(SpectrogramObj spectrogramObj){
 
 	int *salienceIndexArr=NULL;
 
-	float *mCorrectFreArr=NULL; // 校正频率 timeLength*baseNum
-	float *mToneFreArr=NULL;
-	float *mToneFreArr1=NULL; 
-
 	if(!spectrogramObj){
 		return;
 	}
@@ -3084,24 +3787,8 @@ void spectrogramObj_free(SpectrogramObj spectrogramObj){
 
 	indexArr=spectrogramObj->indexArr;
 
-	sumArr=spectrogramObj->sumArr;
-	cArr1=spectrogramObj->cArr1;
-	cArr2=spectrogramObj->cArr2;
-	entropyArr=spectrogramObj->entropyArr;
-
-	meanFreArr=spectrogramObj->meanFreArr;
-	meanValueArr=spectrogramObj->meanValueArr;
-
-	mRealArr=spectrogramObj->mRealArr;
-	mImageArr=spectrogramObj->mImageArr;
-	mSArr=spectrogramObj->mSArr;
-
-	energyArr=spectrogramObj->energyArr;
 	vArr1=spectrogramObj->vArr1;
 
-	fftObj=spectrogramObj->fftObj;
-	dctObj=spectrogramObj->dctObj;
-
 	devFFTObj=spectrogramObj->devFFTObj;
 	devDataArr=spectrogramObj->devDataArr;
 
@@ -3116,35 +3803,22 @@ void spectrogramObj_free(SpectrogramObj spectrogramObj){
 
 	salienceIndexArr=spectrogramObj->salienceIndexArr;
 
-	mCorrectFreArr=spectrogramObj->mCorrectFreArr;
-	mToneFreArr=spectrogramObj->mToneFreArr;
-	mToneFreArr1=spectrogramObj->mToneFreArr1;
-
+	__spectrogramObj_freeCache(spectrogramObj);
 	stftObj_free(stftObj);
 
-	free(mFilterBankArr);
-	free(freBandArr);
-	free(binBandArr);
+	if(spectrogramObj->filterBankCacheObj){
+		filterBankCacheObj_release(spectrogramObj->filterBankCacheObj);
+	}
+	else{
+		free(mFilterBankArr);
+		free(freBandArr);
+		free(binBandArr);
+	}
 
 	free(indexArr);
-
-	free(sumArr);
-	free(cArr1);
-	free(cArr2);
-	free(entropyArr);
-
-	free(meanFreArr);
-	free(meanValueArr);
-	
-	free(mRealArr);
-	free(mImageArr);
-	free(mSArr);
-
-	free(energyArr);
 	free(vArr1);
 
-	fftObj_free(fftObj);
-	dctObj_free(dctObj);
+	free(spectrogramObj->mDCTArr);
 
 	fftObj_free(devFFTObj);
 	free(devDataArr);
@@ -3160,10 +3834,6 @@ void spectrogramObj_free(SpectrogramObj spectrogramObj){
 
 	free(salienceIndexArr);
 
-	free(mCorrectFreArr);
-	free(mToneFreArr);
-	free(mToneFreArr1);
-
 	free(spectrogramObj);
 }
 
@@ -3194,6 +3864,18 @@ int spectrogramObj_getBinBandLength(SpectrogramObj spectrogramObj){
 	return spectrogramObj->num;
 }
 
+int spectrogramObj_getFFTLength(SpectrogramObj spectrogramObj){
+
+	return spectrogramObj->fftLength;
+}
+
+int spectrogramObj_isMagInput(SpectrogramObj spectrogramObj){
+
+	return (spectrogramObj->dataType==SpectralData_Mag||
+			spectrogramObj->filterScaleType==SpectralFilterBankScale_Deep||
+			spectrogramObj->filterScaleType==SpectralFilterBankScale_DeepChroma);
+}
+
 static void _calKWeight(float *ampArr1,int start,int end,int fftLength,float *weightArr,float *ampArr2){
 	float value1=0;
 	float value2=0;
@@ -3221,10 +3903,13 @@ static int _calBaseNum(float lowFre,float highFre,float binPerOctave){
 	return length;
 }
 
-static void _calTone(float value1,float *value2,float *value3){
+// value1 fre => value2 nearest tone fre, value3 neighbour tone fre; return nearest midi
+static int _calTone(float value1,float *value2,float *value3){
 	float _value2=0;
 	float _value3=0;
 
+	double midi=0;
+
 	float floorIndex=0;
 	float ceilIndex=0;
 
@@ -3232,38 +3917,34 @@ static void _calTone(float value1,float *value2,float *value3){
 	float ceilValue=0;
 
 	float curIndex=0;
-	float nextIndex=0;
 	float preIndex=0;
 
 	float preValue=0;
-	float nextValue=0;
 
-	floorIndex=floorf(12*log2(value1/440)+69);
-	ceilIndex=ceilf(12*log2(value1/440)+69);
+	midi=12*log2(value1/440)+69;
+	floorIndex=floorf(midi);
+	ceilIndex=ceilf(midi);
 
 	floorValue=powf(2,(floorIndex-69)/12)*440;
 	ceilValue=powf(2,(ceilIndex-69)/12)*440;
 
 	if(fabsf(value1-floorValue)<fabsf(value1-ceilValue)){
 		curIndex=floorIndex;
+		_value2=floorValue;
+		_value3=ceilValue;
 
 		preIndex=curIndex-1;
-		nextIndex=ceilIndex;
-
 		preValue=powf(2,(preIndex-69)/12)*440;
-		nextValue=powf(2,(nextIndex-69)/12)*440;
-		if(fabsf(value1-preValue)<fabsf(value1-nextValue)){
-			nextIndex=preIndex;
+		if(fabsf(value1-preValue)<fabsf(value1-ceilValue)){
+			_value3=preValue;
 		}
 	}
 	else{
 		curIndex=ceilIndex;
-		nextIndex=floorIndex;
+		_value2=ceilValue;
+		_value3=floorValue;
 	}
 
-	_value2=powf(2,(curIndex-69)/12)*440;
-	_value3=powf(2,(nextIndex-69)/12)*440;
-
 	if(value2){
 		*value2=_value2;
 	}
@@ -3271,6 +3952,12 @@ static void _calTone(float value1,float *value2,float *value3){
 	if(value3){
 		*value3=_value3;
 	}
+
+	if(!isfinite(curIndex)){ // fre<=0, out of any band
+		return -1;
+	}
+
+	return (int )curIndex; // ==auditory_freToMidi(_value2)
 }
 
 static float _calBaseFre(float lowFre,float binPerOctave){
@@ -3284,28 +3971,6 @@ static float _calBaseFre(float lowFre,float binPerOctave){
 	return fre;
 }
 
-static int _calRadix2(int length){
-	int r=0;
-	int m=0;
-
-	while(1){
-		m=length%2;
-		if(!m){ //
-			r++;
-			length=length/2;
-			if(length==1){
-				break;
-			}
-		}
-		else{
-			r=0;
-			break;
-		}
-	}
-
-	return r;
-}
-
 
 
 
@@ -80,10 +80,34 @@ int *spectrogramObj_getBinBandArr(SpectrogramObj spectrogramObj);
 // linear => num
 int spectrogramObj_getBandNum(SpectrogramObj spectrogramObj);
 int spectrogramObj_getBinBandLength(SpectrogramObj spectrogramObj);
+int spectrogramObj_getFFTLength(SpectrogramObj spectrogramObj);
+// 1 filterBank input |X|(dataType mag or deep/deepChroma), 0 |X|^2
+int spectrogramObj_isMagInput(SpectrogramObj spectrogramObj);
+
+// caller workspace for timeLength caches(+stft), contract see stftObj_useWorkspace
+size_t spectrogramObj_calWorkspaceSize(SpectrogramObj spectrogramObj,int maxDataLength);
+int spectrogramObj_useWorkspace(SpectrogramObj spectrogramObj,void *workArr,size_t size,int maxDataLength);
 
 // spectrogram方法 mPhaseArr can NULL; timeLength*(fftLength/2+1)
+// per frame scale(linear/mel/bark/erb/octave/linspace/log/chroma) run by frame tiles, no timeLength*fftLength matrix
 void spectrogramObj_spectrogram(SpectrogramObj spectrogramObj,float *dataArr,int dataLength,float *mSpectArr,float *mPhaseArr);
 void spectrogramObj_spectrogram1(SpectrogramObj spectrogramObj,float *mRealArr,float *mImageArr,int nLength,int mLength,float *mSpectArr,float *mPhaseArr);
+// half power spectrum(|X|^2) mPowerArr nLength*(fftLength/2+1), mMagArr sqrt of it or NULL; read only, no stft
+void spectrogramObj_spectrogram2(SpectrogramObj spectrogramObj,float *mPowerArr,float *mMagArr,int nLength,int mLength,float *mSpectArr);
+
+/***
+	log spectrogram(dB) from raw data, same size as spectrogramObj_spectrogram
+	linear/mel/bark/erb/octave/linspace/log/chroma fused frame by frame
+		stft block=>power/mag=>filterBank=>dB, only output written, no timeLength*fftLength cache
+	other scale spectrogramObj_spectrogram then dB
+	dB factor*log10(max(S,amin)/max(ref,amin)), factor 10 power/20 mag
+	refValue 1, <=0 => max(S)
+	aminValue 1e-10 power, 1e-5 mag
+	topDB 80, <=0 no clamp
+****/
+void spectrogramObj_spectrogramDB(SpectrogramObj spectrogramObj,float *dataArr,int dataLength,
+								float *refValue,float *aminValue,float *topDB,
+								float *mDataArr);
 
 // mel/erb/bark ==> mfcc/gtcc/bfcc......
 void spectrogramObj_mfcc(SpectrogramObj spectrogramObj,float *mDataArr1,int ccNum,float *mDataArr2);
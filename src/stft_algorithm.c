@@ -9,14 +9,10 @@
 #include "dsp/flux_window.h"
 #include "dsp/fft_algorithm.h"
 
-#include "stft_algorithm.h"
+#include "util/flux_parallel.h"
 
-#ifdef HAVE_OMP
-#include <omp.h>
-#endif
+#include "stft_algorithm.h"
 
-// cpu core number
-int __kernelNum=0;
 
 typedef enum{
 	STFTExec_None=0,
@@ -30,16 +26,17 @@ struct OpaqueSTFT{
 	STFTExecType execType;
 	int useFlag;
 
-	FFTObj fftObj;
-	FFTObj *fftObjArr;
+	FFTObj fftObj; // shared plan
+	FFTWorkObj *workObjArr; // per thread fft workspace, grow to thread number
+	int workNum;
 
 	WindowType windowType;
 	float *windowDataArr;
-	float *addDataArr;
 
 	int fftLength; // y=fftLength ???
 	int slideLength;
 	int isContinue;
+	int isHalf; // half spectrum timeLength*(fftLength/2+1)
 
 	int isPad; 
 	PaddingPositionType positionType; // center
@@ -53,11 +50,17 @@ struct OpaqueSTFT{
 
 	float *curDataArr;
 	int curDataLength; // >=dataLength
+	int workDataLength; // >0 curDataArr/normArr in caller workspace, capacity
 
 	int timeLength; // x=timeLength
 
 	float *realArr; // fft r cache
 
+	// frame callback scratch, per thread STFT_FRAME_BLOCK*fftLength
+	float *frameRealArr;
+	float *frameImageArr;
+	int frameNum;
+
 	// inverse 
 	int methodType; // 0 'overlap-add' 1 'weight overlap-add'
 
@@ -67,6 +70,19 @@ struct OpaqueSTFT{
 	int timeLength1;
 	float *normArr; // (timeLength1-1)*slideLength+fftLength
 
+	// stream stft; mirrored ring, sample at i and i+streamCapacity => every frame contiguous
+	float *streamArr; // 2*streamCapacity
+	int streamCapacity; // 2 power
+	int streamPos; // next frame start
+	int streamLength; // buffered from streamPos
+	int streamSkip; // slideLength>fftLength, samples to drop before next frame
+
+	// stream istft overlap-add
+	float *olaArr; // max(fftLength,slideLength)
+	float *olaNormArr;
+	int olaLength;
+	float *imageArr; // ifft i cache
+
 	// int _weakFlag; // curDataArr weak flag
 };
 
@@ -81,30 +97,25 @@ static void __stftObj_stft(STFTObj stftObj,float *dataArr,float *mRealArr,float
 
 static int __isCOA(float *winArr,int winLength,int overlapLength);
 
+static void __stftObj_dealISTFTWindow(STFTObj stftObj,int methodType);
+static void __stftObj_growStream(STFTObj stftObj,int length);
+static void __stftObj_dropWorkspace(STFTObj stftObj);
+
+static void __fft(STFTObj stftObj,FFTWorkObj workObj,int step,float *dataArr,float *mRealArr,float *mImageArr);
+
+// stftObj_stftFrame block, fft batch
+#define STFT_FRAME_BLOCK 8
+
 int stftObj_new(STFTObj *stftObj,int radix2Exp,WindowType *windowType,int *slideLength,int *isContinue){
 	int status=0;
 
 	int _isContinue=0;
 	WindowType _windowType=Window_Rect;
 	float *windowDataArr=NULL;
-	float *addDataArr=NULL;
 
 	STFTObj stft=NULL;
 	FFTObj fftObj=NULL;
 
-	if (__kernelNum==0){
-        #ifdef HAVE_OMP
-        __kernelNum=omp_get_max_threads()/2;
-        if (__kernelNum==0){
-            __kernelNum=1;
-        }
-        #else
-        __kernelNum=1;
-        #endif
-	}
-
-	FFTObj *fftObjArr=(FFTObj *)calloc(__kernelNum, sizeof(FFTObj ));
-
 	int fftLength=0;
 	int _slideLength=0;
 	float *realArr=NULL;
@@ -135,14 +146,8 @@ int stftObj_new(STFTObj *stftObj,int radix2Exp,WindowType *windowType,int *slide
 	stft=*stftObj=(STFTObj )calloc(1, sizeof(struct OpaqueSTFT ));
 
 	windowDataArr=window_calFFTWindow(_windowType,fftLength);
-	addDataArr=__vnew(fftLength, NULL);
 	fftObj_new(&fftObj, radix2Exp);
 
-    #pragma omp parallel for
-	for(int i=0;i<__kernelNum;i++){
-		fftObj_new(fftObjArr+i, radix2Exp);
-	}
-
 	realArr=(float *)calloc(fftLength, sizeof(float ));
 	tailDataArr=(float *)calloc(fftLength, sizeof(float ));
 
@@ -150,7 +155,6 @@ int stftObj_new(STFTObj *stftObj,int radix2Exp,WindowType *windowType,int *slide
 
 	stft->windowType=_windowType;
 	stft->windowDataArr=windowDataArr;
-	stft->addDataArr=addDataArr;
 
 	stft->fftObj=fftObj;
 	stft->fftLength=fftLength;
@@ -162,7 +166,6 @@ int stftObj_new(STFTObj *stftObj,int radix2Exp,WindowType *windowType,int *slide
 	stft->isPad=0;
 	stft->positionType=PaddingPosition_Center;
 	stft->modeType=PaddingMode_Constant;
-	stft->fftObjArr=fftObjArr;
 
 	return status;
 }
@@ -188,6 +191,12 @@ void stftObj_enablePadding(STFTObj stftObj,int flag){
 	stftObj->isPad=flag;
 }
 
+// half spectrum, stft/istft matrix timeLength*(fftLength/2+1)
+void stftObj_enableHalfSpectrum(STFTObj stftObj,int flag){
+
+	stftObj->isHalf=flag;
+}
+
 // value1 => constant/left
 void stftObj_setPadding(STFTObj stftObj,
 					PaddingPositionType *positionType,PaddingModeType *modeType,
@@ -286,6 +295,170 @@ void stftObj_stft(STFTObj stftObj,float *dataArr,int dataLength,float *mRealArr,
 
 }
 
+// __stftObj_frameChunk arg
+typedef struct{
+	STFTObj stftObj;
+
+	float *dataArr;
+	STFTFrameFunc func;
+	void *arg;
+
+} STFTFrameChunkArg;
+
+static void __stftObj_frameChunk(void *arg,int start,int end,int threadIndex){
+	STFTFrameChunkArg *chunkArg=NULL;
+	STFTObj stftObj=NULL;
+
+	float *realArr=NULL;
+	float *imageArr=NULL;
+
+	int step=0;
+
+	chunkArg=(STFTFrameChunkArg *)arg;
+	stftObj=chunkArg->stftObj;
+
+	realArr=stftObj->frameRealArr+threadIndex*STFT_FRAME_BLOCK*stftObj->fftLength;
+	imageArr=stftObj->frameImageArr+threadIndex*STFT_FRAME_BLOCK*stftObj->fftLength;
+
+	for(int i=start;i<end;i+=STFT_FRAME_BLOCK){
+		step=(end-i<STFT_FRAME_BLOCK?end-i:STFT_FRAME_BLOCK);
+
+		__fft(stftObj,stftObj->workObjArr[threadIndex],step,
+			chunkArg->dataArr+i*stftObj->slideLength,
+			realArr,imageArr);
+
+		chunkArg->func(chunkArg->arg,realArr,imageArr,i,step,threadIndex);
+	}
+}
+
+int stftObj_stftFrame(STFTObj stftObj,float *dataArr,int dataLength,STFTFrameFunc func,void *arg){
+	int status=0;
+
+	int timeLength=0;
+	int threadNum=0;
+	int chunkLength=0;
+
+	STFTFrameChunkArg chunkArg;
+
+	if(!dataArr||dataLength<=0||!func){
+		return 0;
+	}
+
+	if(stftObj->isPad||stftObj->isContinue){
+		status=__stftObj_dealData(stftObj,dataArr,dataLength);
+		if(!status){
+			return 0;
+		}
+
+		chunkArg.dataArr=stftObj->curDataArr;
+	}
+	else{
+		stftObj->timeLength=stftObj_calTimeLength(stftObj,dataLength);
+		chunkArg.dataArr=dataArr;
+	}
+
+	timeLength=stftObj->timeLength;
+	if(timeLength<=0){
+		return 0;
+	}
+
+	threadNum=audioflux_getThreadNum();
+	stftObj_prepareFrame(stftObj);
+
+	chunkArg.stftObj=stftObj;
+	chunkArg.func=func;
+	chunkArg.arg=arg;
+
+	// same chunk policy as __stftObj_stft
+	chunkLength=(timeLength+threadNum*4-1)/(threadNum*4);
+	chunkLength=(chunkLength+STFT_FRAME_BLOCK-1)/STFT_FRAME_BLOCK*STFT_FRAME_BLOCK;
+
+	__parallel_for(timeLength,chunkLength,threadNum,__stftObj_frameChunk,&chunkArg);
+
+	stftObj->execType=STFTExec_STFT;
+
+	return timeLength;
+}
+
+void stftObj_prepareFrame(STFTObj stftObj){
+	int threadNum=0;
+
+	threadNum=audioflux_getThreadNum();
+	fftWorkObj_growArr(&stftObj->workObjArr,&stftObj->workNum,threadNum,stftObj->fftObj);
+
+	if(stftObj->frameNum<threadNum){
+		free(stftObj->frameRealArr);
+		free(stftObj->frameImageArr);
+
+		stftObj->frameRealArr=__vnew(threadNum*STFT_FRAME_BLOCK*stftObj->fftLength, NULL);
+		stftObj->frameImageArr=__vnew(threadNum*STFT_FRAME_BLOCK*stftObj->fftLength, NULL);
+		stftObj->frameNum=threadNum;
+	}
+}
+
+size_t stftObj_calWorkspaceSize(STFTObj stftObj,int maxDataLength){
+	size_t size=0;
+
+	if(maxDataLength<=0){
+		return 0;
+	}
+
+	// padding/continue copy(tail<fftLength+padding), istft normArr
+	__vcarve(NULL,&size,maxDataLength+2*stftObj->fftLength);
+	__vcarve(NULL,&size,maxDataLength+2*stftObj->fftLength);
+
+	return size+64;
+}
+
+int stftObj_useWorkspace(STFTObj stftObj,void *workArr,size_t size,int maxDataLength){
+	size_t offset=0;
+	int length=0;
+
+	if(!stftObj->workDataLength){
+		free(stftObj->curDataArr);
+		free(stftObj->normArr);
+	}
+
+	__stftObj_dropWorkspace(stftObj);
+	if(!workArr){
+		return 0;
+	}
+
+	if(maxDataLength<=0||
+		size<stftObj_calWorkspaceSize(stftObj,maxDataLength)){
+		return -1;
+	}
+
+	length=maxDataLength+2*stftObj->fftLength;
+
+	stftObj->curDataArr=__vcarve(workArr,&offset,length);
+	stftObj->normArr=__vcarve(workArr,&offset,length);
+	memset(stftObj->curDataArr, 0, sizeof(float )*length);
+
+	// per thread fft work, istft window/ifft cache, else first call allocate
+	fftWorkObj_growArr(&stftObj->workObjArr,&stftObj->workNum,audioflux_getThreadNum(),stftObj->fftObj);
+	if(!stftObj->imageArr){
+		stftObj->imageArr=__vnew(stftObj->fftLength, NULL);
+	}
+
+	__stftObj_dealISTFTWindow(stftObj,stftObj->methodType);
+
+	stftObj->workDataLength=length;
+	return 0;
+}
+
+// workspace arrays detached, next call use own cache
+static void __stftObj_dropWorkspace(STFTObj stftObj){
+
+	stftObj->curDataArr=NULL;
+	stftObj->curDataLength=0;
+
+	stftObj->normArr=NULL;
+	stftObj->timeLength1=0;
+
+	stftObj->workDataLength=0;
+}
+
 int stftObj_calDataLength(STFTObj stftObj,int timeLength){
 	int fftLength=0; // y=fftLength ???
 	int slideLength=0;
@@ -303,7 +476,6 @@ int stftObj_calDataLength(STFTObj stftObj,int timeLength){
 // type 0(deault) 'weight overlap-add' 1 'overlap-add'
 void stftObj_istft(STFTObj stftObj,float *mRealArr,float *mImageArr,int timeLength1,int methodType,float *dataArr){
 	FFTObj fftObj=NULL;
-	float *windowDataArr=NULL;
 
 	int fftLength=0; // y=fftLength ???
 	int slideLength=0;
@@ -318,64 +490,43 @@ void stftObj_istft(STFTObj stftObj,float *mRealArr,float *mImageArr,int timeLeng
 	float *realArr=NULL;
 	float *imageArr=NULL;
 
+	int isHalf=0;
+	int mLength=0;
+
 	fftObj=stftObj->fftObj;
-	windowDataArr=stftObj->windowDataArr;
 
 	fftLength=stftObj->fftLength;
 	slideLength=stftObj->slideLength;
 
-	dataLength=(timeLength1-1)*slideLength+fftLength;
+	isHalf=stftObj->isHalf;
+	mLength=(isHalf?fftLength/2+1:fftLength);
 
-	normArr=stftObj->normArr;
-
-	realArr=__vnew(fftLength, NULL);
-	imageArr=__vnew(fftLength, NULL);
-
-	// 1. winArr1/winArr2
-	if(!stftObj->winArr1){
-		float e=0;
-
-		winArr1=__vnew(fftLength, NULL);
-		winArr2=__vnew(fftLength, NULL);
-		
-		if(methodType==0){ // 'weight'
-			e=1;
-		}
-		else{ // 'overlap-add' 
-			e=0;
-		}
+	dataLength=(timeLength1-1)*slideLength+fftLength;
 
-		__vpow(windowDataArr, e, fftLength, winArr1);
-		__vpow(windowDataArr, e+1, fftLength, winArr2);
+	if(stftObj->workDataLength&&
+		dataLength>stftObj->workDataLength){ // over workspace, back to own cache
+		__stftObj_dropWorkspace(stftObj);
+	}
 
-		stftObj->winArr1=winArr1;
-		stftObj->winArr2=winArr2;
+	normArr=stftObj->normArr;
 
-		stftObj->methodType=methodType;
+	// ifft cache shared with stream istft
+	if(!stftObj->imageArr){
+		stftObj->imageArr=__vnew(fftLength, NULL);
 	}
-	else{
-		winArr1=stftObj->winArr1;
-		winArr2=stftObj->winArr2;
-		if(stftObj->methodType!=methodType){
-			float e=0;
 
-			if(methodType==0){ // 'weight'
-				e=1;
-			}
-			else{ // 'overlap-add'
-				e=0;
-			}
-
-			__vpow(windowDataArr, e, fftLength, winArr1);
-			__vpow(windowDataArr, e+1, fftLength, winArr2);
+	realArr=stftObj->realArr;
+	imageArr=stftObj->imageArr;
 
-			stftObj->methodType=methodType;
-		}
-	}
+	// 1. winArr1/winArr2
+	__stftObj_dealISTFTWindow(stftObj,methodType);
+	winArr1=stftObj->winArr1;
+	winArr2=stftObj->winArr2;
 
 	// 2. normArr
-	if(timeLength1>stftObj->timeLength1||
-		stftObj->timeLength1>2*timeLength1){
+	if(!stftObj->workDataLength&&
+		(timeLength1>stftObj->timeLength1||
+		stftObj->timeLength1>2*timeLength1)){
 
 		free(normArr);
 		normArr=__vnew(dataLength, NULL);
@@ -387,7 +538,12 @@ void stftObj_istft(STFTObj stftObj,float *mRealArr,float *mImageArr,int timeLeng
 	// 3. ifft&overlap add
 	memset(normArr, 0, sizeof(float )*dataLength);
 	for(int i=0;i<timeLength1;i++){
-		fftObj_ifft(fftObj, mRealArr+i*fftLength, mImageArr+i*fftLength, realArr, imageArr);
+		if(isHalf){
+			fftObj_irfft(fftObj, mRealArr+i*mLength, mImageArr+i*mLength, realArr);
+		}
+		else{
+			fftObj_ifft(fftObj, mRealArr+i*mLength, mImageArr+i*mLength, realArr, imageArr);
+		}
 		
 		for(int j=i*slideLength,k=0;j<i*slideLength+fftLength;j++,k++){
 			dataArr[j]=dataArr[j]+realArr[k]*winArr1[k];
@@ -403,17 +559,241 @@ void stftObj_istft(STFTObj stftObj,float *mRealArr,float *mImageArr,int timeLeng
 	}
 
 	__vdiv(dataArr, normArr, dataLength, NULL);
+}
 
-	free(realArr);
-	free(imageArr);
+/***
+	stream: push any size block, pull frames once fftLength samples buffered
+	frame i start i*slideLength of pushed data, no padding; isPad/isContinue not used
+	buffered samples never moved except when ring grow
+****/
+void stftObj_resetStream(STFTObj stftObj){
+
+	stftObj->streamPos=0;
+	stftObj->streamLength=0;
+	stftObj->streamSkip=0;
+
+	if(stftObj->olaArr){
+		memset(stftObj->olaArr, 0, sizeof(float )*stftObj->olaLength);
+		memset(stftObj->olaNormArr, 0, sizeof(float )*stftObj->olaLength);
+	}
+}
+
+void stftObj_pushData(STFTObj stftObj,float *dataArr,int dataLength){
+	int capacity=0;
+	int index=0;
+	int len=0;
+
+	float *streamArr=NULL;
+
+	if(!dataArr||dataLength<=0){
+		return;
+	}
+
+	if(stftObj->streamSkip){
+		len=(stftObj->streamSkip<dataLength?stftObj->streamSkip:dataLength);
+
+		dataArr+=len;
+		dataLength-=len;
+		stftObj->streamSkip-=len;
+	}
+
+	if(stftObj->streamLength+dataLength>stftObj->streamCapacity){
+		__stftObj_growStream(stftObj,stftObj->streamLength+dataLength);
+	}
+
+	capacity=stftObj->streamCapacity;
+	streamArr=stftObj->streamArr;
+
+	// write both halves, split at ring end
+	index=(stftObj->streamPos+stftObj->streamLength)&(capacity-1);
+	while(dataLength>0){
+		len=(capacity-index<dataLength?capacity-index:dataLength);
+
+		memcpy(streamArr+index, dataArr, sizeof(float )*len);
+		memcpy(streamArr+capacity+index, dataArr, sizeof(float )*len);
+
+		dataArr+=len;
+		dataLength-=len;
+		stftObj->streamLength+=len;
+		index=0;
+	}
+}
+
+int stftObj_getStreamTimeLength(STFTObj stftObj){
+	int fftLength=0;
+	int timeLength=0;
+
+	fftLength=stftObj->fftLength;
+	if(stftObj->streamLength>=fftLength){
+		timeLength=(stftObj->streamLength-fftLength)/stftObj->slideLength+1;
+	}
+
+	return timeLength;
+}
+
+// mRealArr/mImageArr maxTimeLength*mLength; return frame number written
+int stftObj_pullSTFT(STFTObj stftObj,int maxTimeLength,float *mRealArr,float *mImageArr){
+	int fftLength=0;
+	int slideLength=0;
+	int capacity=0;
+	int mLength=0;
+
+	int timeLength=0;
+	int step=0;
+	int length=0;
+
+	fftLength=stftObj->fftLength;
+	slideLength=stftObj->slideLength;
+	capacity=stftObj->streamCapacity;
+	mLength=(stftObj->isHalf?fftLength/2+1:fftLength);
+
+	timeLength=stftObj_getStreamTimeLength(stftObj);
+	if(timeLength>maxTimeLength){
+		timeLength=maxTimeLength;
+	}
+
+	if(timeLength<=0){
+		return 0;
+	}
+
+	fftWorkObj_growArr(&stftObj->workObjArr,&stftObj->workNum,1,stftObj->fftObj);
+
+	// frames read in place; batch limited to the mirrored span
+	for(int i=0;i<timeLength;i+=step){
+		step=(2*capacity-stftObj->streamPos-fftLength)/slideLength+1;
+		if(step>timeLength-i){
+			step=timeLength-i;
+		}
+
+		__fft(stftObj,stftObj->workObjArr[0],step,
+			stftObj->streamArr+stftObj->streamPos,
+			mRealArr+i*mLength,mImageArr+i*mLength);
+
+		length=step*slideLength;
+		if(length>stftObj->streamLength){
+			stftObj->streamSkip=length-stftObj->streamLength;
+			length=stftObj->streamLength;
+		}
+
+		stftObj->streamPos=(stftObj->streamPos+length)&(capacity-1);
+		stftObj->streamLength-=length;
+	}
+
+	return timeLength;
+}
+
+/***
+	stream istft, frame by frame overlap-add
+	each frame complete slideLength samples, latency fftLength-slideLength
+	return sample number written to dataArr(timeLength*slideLength)
+****/
+int stftObj_pushISTFT(STFTObj stftObj,float *mRealArr,float *mImageArr,int timeLength,int methodType,float *dataArr){
+	FFTObj fftObj=NULL;
+	FFTWorkObj workObj=NULL;
+
+	int fftLength=0;
+	int slideLength=0;
+	int mLength=0;
+
+	float *winArr1=NULL;
+	float *winArr2=NULL;
+
+	float *olaArr=NULL;
+	float *olaNormArr=NULL;
+	int olaLength=0;
+
+	float *realArr=NULL;
+	float *imageArr=NULL;
+
+	fftObj=stftObj->fftObj;
+
+	fftLength=stftObj->fftLength;
+	slideLength=stftObj->slideLength;
+	mLength=(stftObj->isHalf?fftLength/2+1:fftLength);
+
+	if(timeLength<=0){
+		return 0;
+	}
+
+	__stftObj_dealISTFTWindow(stftObj,methodType);
+	winArr1=stftObj->winArr1;
+	winArr2=stftObj->winArr2;
+
+	olaLength=(fftLength>slideLength?fftLength:slideLength);
+	if(!stftObj->olaArr||stftObj->olaLength!=olaLength){
+		free(stftObj->olaArr);
+		free(stftObj->olaNormArr);
+
+		stftObj->olaArr=__vnew(olaLength, NULL);
+		stftObj->olaNormArr=__vnew(olaLength, NULL);
+		stftObj->olaLength=olaLength;
+	}
+
+	if(!stftObj->imageArr){
+		stftObj->imageArr=__vnew(fftLength, NULL);
+	}
+
+	fftWorkObj_growArr(&stftObj->workObjArr,&stftObj->workNum,1,fftObj);
+	workObj=stftObj->workObjArr[0];
+
+	olaArr=stftObj->olaArr;
+	olaNormArr=stftObj->olaNormArr;
+
+	realArr=stftObj->realArr;
+	imageArr=stftObj->imageArr;
+
+	for(int i=0;i<timeLength;i++){
+		if(stftObj->isHalf){
+			fftObj_irfftWork(fftObj, workObj, mRealArr+i*mLength, mImageArr+i*mLength, realArr);
+		}
+		else{
+			fftObj_ifftWork(fftObj, workObj, mRealArr+i*mLength, mImageArr+i*mLength, realArr, imageArr);
+		}
+
+		for(int j=0;j<fftLength;j++){
+			olaArr[j]+=realArr[j]*winArr1[j];
+			olaNormArr[j]+=winArr2[j];
+		}
+
+		// head slideLength done
+		for(int j=0;j<slideLength;j++){
+			dataArr[i*slideLength+j]=olaArr[j]/(olaNormArr[j]<1e-6?1:olaNormArr[j]);
+		}
+
+		memmove(olaArr, olaArr+slideLength, sizeof(float )*(olaLength-slideLength));
+		memmove(olaNormArr, olaNormArr+slideLength, sizeof(float )*(olaLength-slideLength));
+
+		memset(olaArr+olaLength-slideLength, 0, sizeof(float )*slideLength);
+		memset(olaNormArr+olaLength-slideLength, 0, sizeof(float )*slideLength);
+	}
+
+	return timeLength*slideLength;
+}
+
+// rest fftLength-slideLength samples of stream istft, then reset
+int stftObj_flushISTFT(STFTObj stftObj,float *dataArr){
+	int length=0;
+
+	if(!stftObj->olaArr){
+		return 0;
+	}
+
+	length=stftObj->fftLength-stftObj->slideLength;
+	for(int i=0;i<length;i++){
+		dataArr[i]=stftObj->olaArr[i]/(stftObj->olaNormArr[i]<1e-6?1:stftObj->olaNormArr[i]);
+	}
+
+	memset(stftObj->olaArr, 0, sizeof(float )*stftObj->olaLength);
+	memset(stftObj->olaNormArr, 0, sizeof(float )*stftObj->olaLength);
+
+	return (length>0?length:0);
 }
 
 void stftObj_free(STFTObj stftObj){
 	FFTObj fftObj=NULL;
-	FFTObj *fftObjArr=NULL;
+	FFTWorkObj *workObjArr=NULL;
 
 	float *windowDataArr=NULL;
-	float *addDataArr=NULL;
 	float *tailDataArr=NULL;
 	float *curDataArr=NULL;
 
@@ -429,10 +809,9 @@ void stftObj_free(STFTObj stftObj){
 	}
 
 	fftObj=stftObj->fftObj;
-	fftObjArr=stftObj->fftObjArr;
+	workObjArr=stftObj->workObjArr;
 
 	windowDataArr=stftObj->windowDataArr;
-	addDataArr=stftObj->addDataArr;
 	tailDataArr=stftObj->tailDataArr;
 	curDataArr=stftObj->curDataArr;
 
@@ -443,29 +822,87 @@ void stftObj_free(STFTObj stftObj){
 
 	normArr=stftObj->normArr;
 
-	fftObj_free(fftObj);
-
-    #pragma omp parallel for
-	for(int i=0;i<__kernelNum;i++){
-		fftObj_free(fftObjArr[i]);
+	for(int i=0;i<stftObj->workNum;i++){
+		fftWorkObj_free(workObjArr[i]);
 	}
-	free(fftObjArr);
+	free(workObjArr);
+
+	fftObj_free(fftObj);
 
 	free(windowDataArr);
-	free(addDataArr);
 	free(tailDataArr);
-	free(curDataArr);
+	if(!stftObj->workDataLength){
+		free(curDataArr);
+		free(normArr);
+	}
 
 	free(realArr);
 
+	free(stftObj->frameRealArr);
+	free(stftObj->frameImageArr);
+
 	free(winArr1);
 	free(winArr2);
 
-	free(normArr);
+	free(stftObj->streamArr);
+
+	free(stftObj->olaArr);
+	free(stftObj->olaNormArr);
+	free(stftObj->imageArr);
 
 	free(stftObj);
 }
 
+static void __stftObj_dealISTFTWindow(STFTObj stftObj,int methodType){
+	int fftLength=0;
+	float e=0;
+
+	fftLength=stftObj->fftLength;
+	if(stftObj->winArr1&&stftObj->methodType==methodType){
+		return;
+	}
+
+	if(!stftObj->winArr1){
+		stftObj->winArr1=__vnew(fftLength, NULL);
+		stftObj->winArr2=__vnew(fftLength, NULL);
+	}
+	
+	if(methodType==0){ // 'weight'
+		e=1;
+	}
+	else{ // 'overlap-add' 
+		e=0;
+	}
+
+	__vpow(stftObj->windowDataArr, e, fftLength, stftObj->winArr1);
+	__vpow(stftObj->windowDataArr, e+1, fftLength, stftObj->winArr2);
+
+	stftObj->methodType=methodType;
+}
+
+// capacity 2 power >=max(length,2*fftLength), buffered samples move to 0
+static void __stftObj_growStream(STFTObj stftObj,int length){
+	int capacity=0;
+	float *streamArr=NULL;
+
+	capacity=2*stftObj->fftLength;
+	while(capacity<length){
+		capacity*=2;
+	}
+
+	streamArr=__vnew(2*capacity, NULL);
+	if(stftObj->streamLength){
+		memcpy(streamArr, stftObj->streamArr+stftObj->streamPos, sizeof(float )*stftObj->streamLength);
+		memcpy(streamArr+capacity, streamArr, sizeof(float )*stftObj->streamLength);
+	}
+
+	free(stftObj->streamArr);
+
+	stftObj->streamArr=streamArr;
+	stftObj->streamCapacity=capacity;
+	stftObj->streamPos=0;
+}
+
 /***
 	1. 根据isContinue处理curDataArr
 	2. 计算stftLength
@@ -531,11 +968,21 @@ static int __stftObj_dealData(STFTObj stftObj,float *dataArr,int dataLength){
 	}
 
 	if(status){ // 存在timeLen 计算curDataArr相关
-		if(totalLength>curDataLength||
-			curDataLength>2*totalLength){
+		if(stftObj->workDataLength&&
+			totalLength+fftLength>stftObj->workDataLength){ // over workspace, back to own cache
+			__stftObj_dropWorkspace(stftObj);
+
+			curDataArr=NULL;
+			curDataLength=0;
+		}
+
+		if(!stftObj->workDataLength&&
+			(totalLength>curDataLength||
+			curDataLength>2*totalLength)){
 
 			free(curDataArr);
 			curDataArr=(float *)calloc(totalLength+fftLength, sizeof(float ));
+			stftObj->curDataLength=totalLength; // capacity, not padded length
 		}
 
 		curDataLength=0;
@@ -592,7 +1039,6 @@ static int __stftObj_dealData(STFTObj stftObj,float *dataArr,int dataLength){
 	stftObj->tailDataLength=tailDataLength;
 
 	stftObj->curDataArr=curDataArr;
-	stftObj->curDataLength=curDataLength;
 
 	stftObj->timeLength=timeLen;
 	return status;
@@ -693,113 +1139,99 @@ static int __stftObj_dealPadData(STFTObj stftObj,float *dataArr,int dataLength,i
 	return totalLength;
 }
 
-static void __fft(STFTObj stftObj,FFTObj fftObj,int step,float *dataArr,float *mRealArr,float *mImageArr){
+// step frames => rfft batch, window applied in fft input load; workObj one per thread
+static void __fft(STFTObj stftObj,FFTWorkObj workObj,int step,float *dataArr,float *mRealArr,float *mImageArr){
 	int fftLength=0;
 	int slideLength=0;
 
+	int isHalf=0;
+	int mLength=0;
+
+	FFTObj fftObj=NULL;
 	float *windowDataArr=NULL;
-	float *addDataArr=NULL;
+
+	fftObj=stftObj->fftObj;
 
 	fftLength=stftObj->fftLength;
 	slideLength=stftObj->slideLength;
 	windowDataArr=stftObj->windowDataArr;
-	addDataArr=__vnew(fftLength, NULL);
 
-	for(int i=0;i<step;i++){
-		__vmul(dataArr+i*slideLength, windowDataArr, fftLength, addDataArr);
-//		__vdebug(addDataArr, fftLength, 1);
-		fftObj_fft(fftObj,addDataArr,NULL,mRealArr+i*fftLength,mImageArr+i*fftLength);
+	isHalf=stftObj->isHalf;
+	mLength=(isHalf?fftLength/2+1:fftLength);
+
+	if(stftObj->useFlag||stftObj->windowType!=Window_Rect){
+		fftObj_rfftBatchWindowWork(fftObj,workObj,dataArr,slideLength,step,windowDataArr,mRealArr,mImageArr,mLength);
+	}
+	else{
+		fftObj_rfftBatchWork(fftObj,workObj,dataArr,slideLength,step,mRealArr,mImageArr,mLength);
 	}
 
-	free(addDataArr);
+	if(!isHalf){ // conj mirror
+		for(int i=0;i<step;i++){
+			for(int j=fftLength/2+1;j<fftLength;j++){
+				mRealArr[i*mLength+j]=mRealArr[i*mLength+fftLength-j];
+				mImageArr[i*mLength+j]=-mImageArr[i*mLength+fftLength-j];
+			}
+		}
+	}
 }
 
-static void __stftObj_stft(STFTObj stftObj,float *dataArr, float *mRealArr,float *mImageArr){
-	FFTObj fftObj=NULL;
-	FFTObj *fftObjArr=NULL;
-	int useFlag=0;
+// __parallel_for arg
+typedef struct{
+	STFTObj stftObj;
 
-	WindowType windowType=Window_Rect;
+	float *dataArr;
+	float *mRealArr;
+	float *mImageArr;
 
-	float *curDataArr=NULL;
-	float *windowDataArr=NULL;
-	float *addDataArr=NULL;
+} STFTChunkArg;
 
-	int fftLength=0;
-	int slideLength=0;
-	int timeLength=0;// x=curSTFTCount
+// chunk of frames per task, thread own fft workspace
+static void __stftObj_fftChunk(void *arg,int start,int end,int threadIndex){
+	STFTChunkArg *chunkArg=NULL;
+	STFTObj stftObj=NULL;
 
-	int k=0;
-	int block=0;
-	int mod=0;
+	int mLength=0;
 
-//	float *realArr=NULL;
-    float *_arr = NULL;
+	chunkArg=(STFTChunkArg *)arg;
+	stftObj=chunkArg->stftObj;
 
-	fftObj=stftObj->fftObj;
-	fftObjArr=stftObj->fftObjArr;
+	mLength=(stftObj->isHalf?stftObj->fftLength/2+1:stftObj->fftLength);
 
-	useFlag=stftObj->useFlag;
-
-	windowType=stftObj->windowType;
+	__fft(stftObj,stftObj->workObjArr[threadIndex],end-start,
+		chunkArg->dataArr+start*stftObj->slideLength,
+		chunkArg->mRealArr+start*mLength,chunkArg->mImageArr+start*mLength);
+}
 
-	curDataArr=stftObj->curDataArr;
-	windowDataArr=stftObj->windowDataArr;
-	addDataArr=stftObj->addDataArr;
+static void __stftObj_stft(STFTObj stftObj,float *dataArr, float *mRealArr,float *mImageArr){
+	int timeLength=0;// x=curSTFTCount
 
-	fftLength=stftObj->fftLength;
-	slideLength=stftObj->slideLength;
-	timeLength=stftObj->timeLength;
+	int threadNum=0;
+	int chunkLength=0;
 
-//	realArr=stftObj->realArr;
+	STFTChunkArg chunkArg;
 
-	k=__kernelNum;
-    block=timeLength/k;
-    mod=timeLength%k;
+	timeLength=stftObj->timeLength;
 
-    if (stftObj->isPad||stftObj->isContinue){
-        _arr=curDataArr;
-    }
-    else{
-        _arr=dataArr;
-    }
+	chunkArg.stftObj=stftObj;
+	chunkArg.mRealArr=mRealArr;
+	chunkArg.mImageArr=mImageArr;
 
-    #ifdef HAVE_OMP
-    if(timeLength==1){
-        __fft(stftObj,fftObj,1,_arr,mRealArr,mImageArr);
-    }else if(timeLength<__kernelNum){
-        omp_set_num_threads(timeLength);
+	if(stftObj->isPad||stftObj->isContinue){
+		chunkArg.dataArr=stftObj->curDataArr;
+	}
+	else{
+		chunkArg.dataArr=dataArr;
+	}
 
-        #pragma omp parallel for
-        for(int i=0;i<timeLength;i++){
-            __fft(stftObj,fftObjArr[i],1,_arr+i*slideLength,mRealArr+i*fftLength,mImageArr+i*fftLength);
-        }
-    }else{
-        omp_set_num_threads(__kernelNum);
+	threadNum=audioflux_getThreadNum();
+	fftWorkObj_growArr(&stftObj->workObjArr,&stftObj->workNum,threadNum,stftObj->fftObj);
 
-        #pragma omp parallel for
-        for(int i=0;i<k;i++){
-            __fft(stftObj,fftObjArr[i],block,_arr+i*block*slideLength,mRealArr+i*block*fftLength,mImageArr+i*block*fftLength);
-        }
+	// about 4 chunks per thread, multiple of fft batch 8
+	chunkLength=(timeLength+threadNum*4-1)/(threadNum*4);
+	chunkLength=(chunkLength+7)/8*8;
 
-        if(mod){
-            __fft(stftObj,fftObj,mod,_arr+k*block*slideLength,mRealArr+k*block*fftLength,mImageArr+k*block*fftLength);
-        }
-    }
-    #else
-    for(int i=0;i<timeLength;i++){
-        // memcpy(realArr, curDataArr+i*slideLength, sizeof(float )*fftLength);
-        // fftObj_fft(fftObj,realArr,NULL,mRealArr+i*fftLength,mImageArr+i*fftLength);
-
-        if(useFlag||windowType!=Window_Rect){
-            __vmul(_arr+i*slideLength, windowDataArr, fftLength, addDataArr);
-            fftObj_fft(fftObj,addDataArr,NULL,mRealArr+i*fftLength,mImageArr+i*fftLength);
-        }
-        else{
-            fftObj_fft(fftObj,_arr+i*slideLength,NULL,mRealArr+i*fftLength,mImageArr+i*fftLength);
-        }
-    }
-    #endif
+	__parallel_for(timeLength,chunkLength,threadNum,__stftObj_fftChunk,&chunkArg);
 }
 
 /***
@@ -0,0 +1,193 @@
+/***
+	workspace-backed call => zero malloc/calloc/realloc, first call included
+	cqt serial/parallel/half-band, continue 0/1; spectrogram, hpss
+	gcc -O2 workspace_alloc.c -I.. -L<lib dir> -laudioflux -lm -o workspace_alloc && ./workspace_alloc
+	glibc only(__libc_malloc), return 0 pass
+****/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../spectrogram_algorithm.h"
+#include "../cqt_algorithm.h"
+#include "../mir/hpss_algorithm.h"
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t num,size_t size);
+extern void *__libc_realloc(void *ptr,size_t size);
+
+static long __allocNum=0;
+static int __isCount=0;
+
+void *malloc(size_t size){
+
+	__allocNum+=__isCount;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t num,size_t size){
+
+	__allocNum+=__isCount;
+	return __libc_calloc(num,size);
+}
+
+void *realloc(void *ptr,size_t size){
+
+	__allocNum+=__isCount;
+	return __libc_realloc(ptr,size);
+}
+
+// <=maxDataLength, shrink/grow between call
+static int __lengthArr[]={48000,30000,20000,48000,5000,47000};
+static int __maxDataLength=48000;
+
+static int _checkCQT(float *dataArr,int isParallel,int isHalfBand,int isContinue){
+	CQTObj cqtObj=NULL;
+
+	void *workArr=NULL;
+	size_t size=0;
+
+	long allocNum=0;
+
+	cqtObj_new(&cqtObj,84,32000,32.703,&isContinue);
+	cqtObj_enableParallel(cqtObj,isParallel);
+	cqtObj_enableHalfBand(cqtObj,isHalfBand);
+
+	size=cqtObj_calWorkspaceSize(cqtObj,__maxDataLength);
+	workArr=malloc(size);
+	cqtObj_useWorkspace(cqtObj,workArr,size,__maxDataLength);
+
+	for(int i=0;i<sizeof(__lengthArr)/sizeof(int);i++){
+		int timeLength=0;
+		float *mRealArr=NULL;
+		float *mImageArr=NULL;
+
+		timeLength=cqtObj_calTimeLength(cqtObj,__lengthArr[i]);
+		mRealArr=(float *)calloc(timeLength*84+1, sizeof(float ));
+		mImageArr=(float *)calloc(timeLength*84+1, sizeof(float ));
+
+		__allocNum=0;
+		__isCount=1;
+		cqtObj_cqt(cqtObj,dataArr,__lengthArr[i],mRealArr,mImageArr);
+		__isCount=0;
+		allocNum+=__allocNum;
+
+		free(mRealArr);
+		free(mImageArr);
+	}
+
+	cqtObj_free(cqtObj);
+	free(workArr);
+
+	printf("cqt parallel %d halfBand %d continue %d: %ld alloc\n",isParallel,isHalfBand,isContinue,allocNum);
+	return (allocNum?1:0);
+}
+
+static int _checkSpectrogram(float *dataArr,int isContinue){
+	SpectrogramObj spectrogramObj=NULL;
+
+	int samplate=32000;
+	int radix2Exp=11;
+
+	void *workArr=NULL;
+	size_t size=0;
+
+	long allocNum=0;
+
+	spectrogramObj_new(&spectrogramObj,128,&samplate,NULL,NULL,NULL,
+					&radix2Exp,NULL,NULL,&isContinue,
+					NULL,NULL,NULL,NULL);
+
+	size=spectrogramObj_calWorkspaceSize(spectrogramObj,__maxDataLength);
+	workArr=malloc(size);
+	spectrogramObj_useWorkspace(spectrogramObj,workArr,size,__maxDataLength);
+
+	for(int i=0;i<sizeof(__lengthArr)/sizeof(int);i++){
+		int timeLength=0;
+		float *mDataArr=NULL;
+
+		timeLength=spectrogramObj_calTimeLength(spectrogramObj,__lengthArr[i]);
+		mDataArr=(float *)calloc(timeLength*1025+1, sizeof(float ));
+
+		__allocNum=0;
+		__isCount=1;
+		spectrogramObj_spectrogram(spectrogramObj,dataArr,__lengthArr[i],mDataArr,NULL);
+		__isCount=0;
+		allocNum+=__allocNum;
+
+		free(mDataArr);
+	}
+
+	spectrogramObj_free(spectrogramObj);
+	free(workArr);
+
+	printf("spectrogram continue %d: %ld alloc\n",isContinue,allocNum);
+	return (allocNum?1:0);
+}
+
+static int _checkHPSS(float *dataArr){
+	HPSSObj hpssObj=NULL;
+
+	void *workArr=NULL;
+	size_t size=0;
+
+	long allocNum=0;
+
+	hpssObj_new(&hpssObj,11,NULL,NULL,NULL,NULL);
+
+	size=hpssObj_calWorkspaceSize(hpssObj,__maxDataLength);
+	workArr=malloc(size);
+	hpssObj_useWorkspace(hpssObj,workArr,size,__maxDataLength);
+
+	for(int i=0;i<sizeof(__lengthArr)/sizeof(int);i++){
+		int length=0;
+		float *hArr=NULL;
+		float *pArr=NULL;
+
+		length=hpssObj_calDataLength(hpssObj,__lengthArr[i]);
+		hArr=(float *)calloc(length+1, sizeof(float ));
+		pArr=(float *)calloc(length+1, sizeof(float ));
+
+		__allocNum=0;
+		__isCount=1;
+		hpssObj_hpss(hpssObj,dataArr,__lengthArr[i],hArr,pArr);
+		__isCount=0;
+		allocNum+=__allocNum;
+
+		free(hArr);
+		free(pArr);
+	}
+
+	hpssObj_free(hpssObj);
+	free(workArr);
+
+	printf("hpss: %ld alloc\n",allocNum);
+	return (allocNum?1:0);
+}
+
+int main(){
+	float *dataArr=NULL;
+	int failNum=0;
+
+	dataArr=(float *)calloc(__maxDataLength, sizeof(float ));
+	for(int i=0;i<__maxDataLength;i++){
+		dataArr[i]=sinf(i*0.05f)+0.3f*sinf(i*0.77f);
+	}
+
+	for(int i=0;i<8;i++){
+		failNum+=_checkCQT(dataArr,i&1,(i>>1)&1,i>>2);
+	}
+
+	for(int i=0;i<2;i++){
+		failNum+=_checkSpectrogram(dataArr,i);
+	}
+
+	failNum+=_checkHPSS(dataArr);
+
+	free(dataArr);
+
+	printf("%s\n",(failNum?"FAIL":"PASS"));
+	return (failNum?1:0);
+}
@@ -0,0 +1,101 @@
+// 
+
+#ifdef HAVE_OMP
+#include <omp.h>
+#endif
+
+#include <pthread.h>
+
+#include "flux_parallel.h"
+
+// default init once, set/get guard by __threadMutex
+static int __threadNum=1;
+static pthread_once_t __threadOnce=PTHREAD_ONCE_INIT;
+static pthread_mutex_t __threadMutex=PTHREAD_MUTEX_INITIALIZER;
+
+static int __parallel_defaultThreadNum();
+static void __parallel_initThreadNum();
+
+void audioflux_setThreadNum(int threadNum){
+
+	if(threadNum<1){
+		threadNum=__parallel_defaultThreadNum();
+	}
+
+	pthread_once(&__threadOnce,__parallel_initThreadNum);
+
+	pthread_mutex_lock(&__threadMutex);
+	__threadNum=threadNum;
+	pthread_mutex_unlock(&__threadMutex);
+}
+
+int audioflux_getThreadNum(){
+	int threadNum=0;
+
+	pthread_once(&__threadOnce,__parallel_initThreadNum);
+
+	pthread_mutex_lock(&__threadMutex);
+	threadNum=__threadNum;
+	pthread_mutex_unlock(&__threadMutex);
+
+	return threadNum;
+}
+
+void __parallel_for(int total,int chunkLength,int threadNum,ParallelFunc func,void *arg){
+	int chunkNum=0;
+
+	if(total<1){
+		return;
+	}
+
+	if(threadNum<1){
+		threadNum=audioflux_getThreadNum();
+	}
+
+	if(chunkLength<1){
+		chunkLength=(total+threadNum*4-1)/(threadNum*4);
+	}
+
+	chunkNum=(total+chunkLength-1)/chunkLength;
+	if(threadNum>chunkNum){
+		threadNum=chunkNum;
+	}
+
+	#ifdef HAVE_OMP
+	if(threadNum>1&&!omp_in_parallel()){
+		// num_threads clause, never touch global omp_set_num_threads
+		#pragma omp parallel for num_threads(threadNum) schedule(dynamic,1)
+		for(int i=0;i<chunkNum;i++){
+			int start=0;
+			int end=0;
+
+			start=i*chunkLength;
+			end=(start+chunkLength<total?start+chunkLength:total);
+
+			func(arg,start,end,omp_get_thread_num());
+		}
+
+		return;
+	}
+	#endif
+
+	func(arg,0,total,0);
+}
+
+static void __parallel_initThreadNum(){
+
+	__threadNum=__parallel_defaultThreadNum();
+}
+
+static int __parallel_defaultThreadNum(){
+	int threadNum=1;
+
+	#ifdef HAVE_OMP
+	threadNum=omp_get_max_threads()/2;
+	if(threadNum<1){
+		threadNum=1;
+	}
+	#endif
+
+	return threadNum;
+}
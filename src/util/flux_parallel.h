@@ -0,0 +1,35 @@
+
+#ifndef FLUX_PARALLEL_H
+#define FLUX_PARALLEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/***
+	library thread number, shared by stft/spectrogram/cqt/cwt/nsgt
+	threadNum<1 => default omp max threads/2; 1 serial
+	without HAVE_OMP always serial
+****/
+void audioflux_setThreadNum(int threadNum);
+int audioflux_getThreadNum();
+
+// [start,end) of total, threadIndex<threadNum of __parallel_for
+typedef void (*ParallelFunc)(void *arg,int start,int end,int threadIndex);
+
+/***
+	chunks of chunkLength pulled by idle thread(dynamic), persistent omp team
+	chunkLength<1 => about 4 chunks per thread
+	threadNum<1 => audioflux_getThreadNum(); per-thread buffer caller pass the count it sized with
+	serial in caller thread when 1 thread/1 chunk/already in parallel region
+****/
+void __parallel_for(int total,int chunkLength,int threadNum,ParallelFunc func,void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -5,6 +5,7 @@
 
 #include "../vector/flux_vector.h"
 #include "../vector/flux_vectorOp.h"
+#include "../vector/_math_kernel.h"
 
 #include "../dsp/filterDesign_fir.h"
 
@@ -562,12 +563,7 @@ void util_powerToDB(float *pArr,int length,float min,float *dArr){
 	}
 
 	__vmax(pArr, length, &max);
-	for(int i=0;i<length;i++){
-		float _value=0;
-
-		_value=10*log10f(pArr[i]/max);
-		arr[i]=(_value>min?_value:min);
-	}
+	__mathKernel_db(pArr,max,10,min,length,arr);
 }
 
 void util_powerToAbsDB(float *pArr,int length,int fftLength,int isNorm,float min,float *dArr){
@@ -589,12 +585,7 @@ void util_powerToAbsDB(float *pArr,int length,int fftLength,int isNorm,float min
 	}
 
 	fLen=fftLength*fftLength;
-	for(int i=0;i<length;i++){
-		float _value=0;
-
-		_value=10*log10f(pArr[i]/fLen);
-		arr[i]=(_value>min?_value:min);
-	}
+	__mathKernel_db(pArr,fLen,10,min,length,arr);
 
 	if(isNorm){
 		maxIndex=__vmax(pArr, length, NULL);
@@ -622,12 +613,7 @@ void util_magToAbsDB(float *pArr,int length,int fftLength,int isNorm,float min,f
 		min=-80;
 	}
 
-	for(int i=0;i<length;i++){
-		float _value=0;
-
-		_value=20*log10f(pArr[i]/fftLength);
-		arr[i]=(_value>min?_value:min);
-	}
+	__mathKernel_db(pArr,fftLength,20,min,length,arr);
 
 	if(isNorm){
 		maxIndex=__vmax(pArr, length, NULL);
@@ -0,0 +1,1403 @@
+//
+
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <pthread.h>
+
+#if defined(__GNUC__)&&(defined(__x86_64__)||defined(__i386__))
+#include <immintrin.h>
+#define MATH_KERNEL_X86
+
+#elif defined(__aarch64__)&&defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MATH_KERNEL_NEON
+
+#endif
+
+#include "_math_kernel.h"
+
+/***
+	cephes single precision, range reduce
+	log x=2^e*m, m in [sqrt(1/2),sqrt(2)); ln(m)=f-f^2/2+f^3*P(f), f=m-1
+	exp x=n*ln2+r, |r|<=ln2/2; ln2 split hi/lo
+	pow 2^(y*e+y*log2(m)), y*e and y*log2(m) carry hi/lo by fma, then exp2 |r|<=1/2
+	atan2 t=min/max in [0,1], t>tan(pi/8) => pi/4+atan((min-max)/(min+max)), then octant
+****/
+#define MK_SQRTHF 0.707106781186547524f
+
+#define MK_LN2_HI 0.693359375f
+#define MK_LN2_LO -2.12194440e-4f
+
+#define MK_LOG2E 1.44269504088896341f
+#define MK_LOG2E_LO 1.925963033500011e-8f
+#define MK_LOG10E 0.434294481903251828f
+#define MK_LOG10_2_HI 3.00781250e-1f
+#define MK_LOG10_2_LO 2.48745663981195213739e-4f
+
+#define MK_LOG_P0 7.0376836292E-2f
+#define MK_LOG_P1 -1.1514610310E-1f
+#define MK_LOG_P2 1.1676998740E-1f
+#define MK_LOG_P3 -1.2420140846E-1f
+#define MK_LOG_P4 1.4249322787E-1f
+#define MK_LOG_P5 -1.6668057665E-1f
+#define MK_LOG_P6 2.0000714765E-1f
+#define MK_LOG_P7 -2.4999993993E-1f
+#define MK_LOG_P8 3.3333331174E-1f
+
+#define MK_EXP_P0 1.9875691500E-4f
+#define MK_EXP_P1 1.3981999507E-3f
+#define MK_EXP_P2 8.3334519073E-3f
+#define MK_EXP_P3 4.1665795894E-2f
+#define MK_EXP_P4 1.6666665459E-1f
+#define MK_EXP_P5 5.0000001201E-1f
+
+#define MK_EXP2_P0 1.535336188319500E-4f
+#define MK_EXP2_P1 1.339887440266574E-3f
+#define MK_EXP2_P2 9.618437357674640E-3f
+#define MK_EXP2_P3 5.550332471162809E-2f
+#define MK_EXP2_P4 2.402264791363012E-1f
+#define MK_EXP2_P5 6.931472028550421E-1f
+
+#define MK_ATAN_P0 8.05374449538E-2f
+#define MK_ATAN_P1 -1.38776856032E-1f
+#define MK_ATAN_P2 1.99777106478E-1f
+#define MK_ATAN_P3 -3.33329491539E-1f
+
+#define MK_TAN_PI8 0.414213562373095f
+#define MK_PI 3.14159265358979f
+#define MK_PI2 1.57079632679490f
+#define MK_PI4 0.785398163397448f
+
+// exp clamp, beyond => 0/inf after scale
+#define MK_EXP_MIN -104.0f
+#define MK_EXP_MAX 89.0f
+
+// pow exp2 exponent clamp
+#define MK_POW_MIN -152.0f
+#define MK_POW_MAX 130.0f
+
+// resolve once, concurrent first call from library threads
+static int __level=0; // 0 scalar 1 avx2 2 neon
+static pthread_once_t __levelOnce=PTHREAD_ONCE_INIT;
+
+static int __mathKernel_dispatch();
+static void __mathKernel_initLevel();
+
+// y=exp, 1 odd integer, 0 even integer, -1 not integer
+static int __mathKernel_powParity(float exp);
+
+#ifdef MATH_KERNEL_X86
+static void __mathKernel_logAVX(float *vArr1,int length,float *vArr2,int isLog10);
+static void __mathKernel_dbAVX(float *vArr1,float div,float mul,float min,int length,float *vArr2);
+static void __mathKernel_expAVX(float *vArr1,int length,float *vArr2);
+static void __mathKernel_powAVX(float *vArr1,float exp,int parity,int length,float *vArr2);
+static void __mathKernel_sqrtAVX(float *vArr1,int length,float *vArr2);
+static void __mathKernel_atan2AVX(float *vArr1,float *vArr2,int length,float *vArr3);
+
+static float __mathKernel_maxAVX(float *vArr1,int length);
+static int __mathKernel_peakAVX(float *vArr1,int start,int end,float minValue,int *indexArr);
+static void __mathKernel_firAVX(float *vArr1,float *cArr,int cLength,int length,float *vArr2);
+static float __mathKernel_dotAVX(float *vArr1,float *vArr2,int length);
+
+#elif defined MATH_KERNEL_NEON
+static void __mathKernel_logNEON(float *vArr1,int length,float *vArr2,int isLog10);
+static void __mathKernel_dbNEON(float *vArr1,float div,float mul,float min,int length,float *vArr2);
+static void __mathKernel_expNEON(float *vArr1,int length,float *vArr2);
+static void __mathKernel_powNEON(float *vArr1,float exp,int parity,int length,float *vArr2);
+static void __mathKernel_sqrtNEON(float *vArr1,int length,float *vArr2);
+static void __mathKernel_atan2NEON(float *vArr1,float *vArr2,int length,float *vArr3);
+
+static float __mathKernel_maxNEON(float *vArr1,int length);
+static int __mathKernel_peakNEON(float *vArr1,int start,int end,float minValue,int *indexArr);
+static void __mathKernel_firNEON(float *vArr1,float *cArr,int cLength,int length,float *vArr2);
+static float __mathKernel_dotNEON(float *vArr1,float *vArr2,int length);
+
+#endif
+
+void __mathKernel_log(float *vArr1,int length,float *vArr2){
+	float *arr=NULL;
+
+	arr=(vArr2?vArr2:vArr1);
+	pthread_once(&__levelOnce,__mathKernel_initLevel);
+
+	#ifdef MATH_KERNEL_X86
+	if(__level==1){
+		__mathKernel_logAVX(vArr1,length,arr,0);
+		return;
+	}
+
+	#elif defined MATH_KERNEL_NEON
+	__mathKernel_logNEON(vArr1,length,arr,0);
+	return;
+
+	#endif
+
+	for(int i=0;i<length;i++){
+		arr[i]=logf(vArr1[i]);
+	}
+}
+
+void __mathKernel_log10(float *vArr1,int length,float *vArr2){
+	float *arr=NULL;
+
+	arr=(vArr2?vArr2:vArr1);
+	pthread_once(&__levelOnce,__mathKernel_initLevel);
+
+	#ifdef MATH_KERNEL_X86
+	if(__level==1){
+		__mathKernel_logAVX(vArr1,length,arr,1);
+		return;
+	}
+
+	#elif defined MATH_KERNEL_NEON
+	__mathKernel_logNEON(vArr1,length,arr,1);
+	return;
+
+	#endif
+
+	for(int i=0;i<length;i++){
+		arr[i]=log10f(vArr1[i]);
+	}
+}
+
+void __mathKernel_db(float *vArr1,float div,float mul,float min,int length,float *vArr2){
+	float *arr=NULL;
+
+	arr=(vArr2?vArr2:vArr1);
+	pthread_once(&__levelOnce,__mathKernel_initLevel);
+
+	#ifdef MATH_KERNEL_X86
+	if(__level==1){
+		__mathKernel_dbAVX(vArr1,div,mul,min,length,arr);
+		return;
+	}
+
+	#elif defined MATH_KERNEL_NEON
+	__mathKernel_dbNEON(vArr1,div,mul,min,length,arr);
+	return;
+
+	#endif
+
+	for(int i=0;i<length;i++){
+		float _value=0;
+
+		_value=mul*log10f(vArr1[i]/div);
+		arr[i]=(_value>min?_value:min);
+	}
+}
+
+void __mathKernel_exp(float *vArr1,int length,float *vArr2){
+	float *arr=NULL;
+
+	arr=(vArr2?vArr2:vArr1);
+	pthread_once(&__levelOnce,__mathKernel_initLevel);
+
+	#ifdef MATH_KERNEL_X86
+	if(__level==1){
+		__mathKernel_expAVX(vArr1,length,arr);
+		return;
+	}
+
+	#elif defined MATH_KERNEL_NEON
+	__mathKernel_expNEON(vArr1,length,arr);
+	return;
+
+	#endif
+
+	for(int i=0;i<length;i++){
+		arr[i]=expf(vArr1[i]);
+	}
+}
+
+void __mathKernel_pow(float *vArr1,float exp,int length,float *vArr2){
+	float *arr=NULL;
+	int parity=0;
+
+	arr=(vArr2?vArr2:vArr1);
+	pthread_once(&__levelOnce,__mathKernel_initLevel);
+
+	// exact cases, libm agree
+	if(exp==0){
+		for(int i=0;i<length;i++){
+			arr[i]=1;
+		}
+		return;
+	}
+	else if(exp==1){
+		if(arr!=vArr1){
+			memcpy(arr, vArr1, sizeof(float )*length);
+		}
+		return;
+	}
+	else if(exp==2){
+		for(int i=0;i<length;i++){
+			arr[i]=vArr1[i]*vArr1[i];
+		}
+		return;
+	}
+
+	parity=__mathKernel_powParity(exp);
+
+	#ifdef MATH_KERNEL_X86
+	if(__level==1&&!isnan(exp)&&!isinf(exp)){
+		__mathKernel_powAVX(vArr1,exp,parity,length,arr);
+		return;
+	}
+
+	#elif defined MATH_KERNEL_NEON
+	if(!isnan(exp)&&!isinf(exp)){
+		__mathKernel_powNEON(vArr1,exp,parity,length,arr);
+		return;
+	}
+
+	#endif
+
+	for(int i=0;i<length;i++){
+		arr[i]=powf(vArr1[i],exp);
+	}
+}
+
+void __mathKernel_sqrt(float *vArr1,int length,float *vArr2){
+	float *arr=NULL;
+
+	arr=(vArr2?vArr2:vArr1);
+	pthread_once(&__levelOnce,__mathKernel_initLevel);
+
+	#ifdef MATH_KERNEL_X86
+	if(__level==1){
+		__mathKernel_sqrtAVX(vArr1,length,arr);
+		return;
+	}
+
+	#elif defined MATH_KERNEL_NEON
+	__mathKernel_sqrtNEON(vArr1,length,arr);
+	return;
+
+	#endif
+
+	for(int i=0;i<length;i++){
+		arr[i]=sqrtf(vArr1[i]);
+	}
+}
+
+void __mathKernel_atan2(float *vArr1,float *vArr2,int length,float *vArr3){
+	float *arr=NULL;
+
+	arr=(vArr3?vArr3:vArr1);
+	pthread_once(&__levelOnce,__mathKernel_initLevel);
+
+	#ifdef MATH_KERNEL_X86
+	if(__level==1){
+		__mathKernel_atan2AVX(vArr1,vArr2,length,arr);
+		return;
+	}
+
+	#elif defined MATH_KERNEL_NEON
+	__mathKernel_atan2NEON(vArr1,vArr2,length,arr);
+	return;
+
+	#endif
+
+	for(int i=0;i<length;i++){
+		arr[i]=atan2f(vArr1[i],vArr2[i]);
+	}
+}
+
+float __mathKernel_max(float *vArr1,int length){
+	float value=0;
+
+	pthread_once(&__levelOnce,__mathKernel_initLevel);
+
+	#ifdef MATH_KERNEL_X86
+	if(__level==1){
+		return __mathKernel_maxAVX(vArr1,length);
+	}
+
+	#elif defined MATH_KERNEL_NEON
+	return __mathKernel_maxNEON(vArr1,length);
+
+	#endif
+
+	value=vArr1[0];
+	for(int i=1;i<length;i++){
+		if(value<vArr1[i]){
+			value=vArr1[i];
+		}
+	}
+
+	return value;
+}
+
+int __mathKernel_peak(float *vArr1,int start,int end,float minValue,int *indexArr){
+	int len=0;
+
+	pthread_once(&__levelOnce,__mathKernel_initLevel);
+
+	#ifdef MATH_KERNEL_X86
+	if(__level==1){
+		return __mathKernel_peakAVX(vArr1,start,end,minValue,indexArr);
+	}
+
+	#elif defined MATH_KERNEL_NEON
+	return __mathKernel_peakNEON(vArr1,start,end,minValue,indexArr);
+
+	#endif
+
+	for(int i=start;i<=end;i++){
+		float _value=0;
+
+		_value=vArr1[i];
+		if(_value>vArr1[i-1]&&_value>vArr1[i+1]&&_value>=minValue){
+			indexArr[len]=i;
+			len++;
+		}
+	}
+
+	return len;
+}
+
+void __mathKernel_fir(float *vArr1,float *cArr,int cLength,int length,float *vArr2){
+
+	pthread_once(&__levelOnce,__mathKernel_initLevel);
+
+	#ifdef MATH_KERNEL_X86
+	if(__level==1){
+		__mathKernel_firAVX(vArr1,cArr,cLength,length,vArr2);
+		return;
+	}
+
+	#elif defined MATH_KERNEL_NEON
+	__mathKernel_firNEON(vArr1,cArr,cLength,length,vArr2);
+	return;
+
+	#endif
+
+	for(int i=0;i<length;i++){
+		float _value=0;
+
+		for(int k=0;k<cLength;k++){
+			_value+=cArr[k]*vArr1[i+k];
+		}
+
+		vArr2[i]+=_value;
+	}
+}
+
+float __mathKernel_dot(float *vArr1,float *vArr2,int length){
+	float value=0;
+
+	pthread_once(&__levelOnce,__mathKernel_initLevel);
+
+	#ifdef MATH_KERNEL_X86
+	if(__level==1){
+		return __mathKernel_dotAVX(vArr1,vArr2,length);
+	}
+
+	#elif defined MATH_KERNEL_NEON
+	return __mathKernel_dotNEON(vArr1,vArr2,length);
+
+	#endif
+
+	for(int i=0;i<length;i++){
+		value+=vArr1[i]*vArr2[i];
+	}
+
+	return value;
+}
+
+static int __mathKernel_powParity(float exp){
+	float _value=0;
+
+	if(isnan(exp)||isinf(exp)||floorf(exp)!=exp){
+		return -1;
+	}
+
+	if(fabsf(exp)>=16777216.0f){ // 2^24, all even
+		return 0;
+	}
+
+	_value=fmodf(fabsf(exp), 2);
+	return (_value==1?1:0);
+}
+
+#ifdef MATH_KERNEL_X86
+#define MK_AVX __attribute__((target("avx2,fma")))
+#define MK_AVX_INLINE __attribute__((target("avx2,fma"),always_inline))
+
+// 2^n, n in [-126,127]
+MK_AVX_INLINE static inline __m256 __pow2iAVX(__m256i n){
+
+	return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n,_mm256_set1_epi32(127)),23));
+}
+
+// x*2^n, n in [-252,254], denormal result round once
+MK_AVX_INLINE static inline __m256 __ldexpAVX(__m256 x,__m256i n){
+	__m256i n1,n2;
+
+	n1=_mm256_srai_epi32(n,1);
+	n2=_mm256_sub_epi32(n,n1);
+
+	return _mm256_mul_ps(_mm256_mul_ps(x,__pow2iAVX(n1)),__pow2iAVX(n2));
+}
+
+// x>0 => x=2^e*(1+f), 1+f in [sqrt(1/2),sqrt(2))
+MK_AVX_INLINE static inline void __logReduceAVX(__m256 x,__m256 *f,__m256 *e){
+	__m256 tiny,bias,m,mask;
+	__m256i bits;
+
+	tiny=_mm256_cmp_ps(x,_mm256_set1_ps(FLT_MIN),_CMP_LT_OQ);
+	x=_mm256_blendv_ps(x,_mm256_mul_ps(x,_mm256_set1_ps(8388608.0f)),tiny); // denormal *2^23
+	bias=_mm256_and_ps(tiny,_mm256_set1_ps(23.0f));
+
+	bits=_mm256_castps_si256(x);
+	*e=_mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits,23),_mm256_set1_epi32(126)));
+	m=_mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits,_mm256_set1_epi32(0x007FFFFF)),
+										_mm256_set1_epi32(0x3F000000))); // [0.5,1)
+
+	mask=_mm256_cmp_ps(m,_mm256_set1_ps(MK_SQRTHF),_CMP_LT_OQ);
+	*e=_mm256_sub_ps(_mm256_sub_ps(*e,bias),_mm256_and_ps(mask,_mm256_set1_ps(1.0f)));
+	*f=_mm256_add_ps(_mm256_sub_ps(m,_mm256_set1_ps(1.0f)),_mm256_and_ps(mask,m));
+}
+
+// ln(1+f)-f
+MK_AVX_INLINE static inline __m256 __logPolyAVX(__m256 f){
+	__m256 z,p;
+
+	z=_mm256_mul_ps(f,f);
+
+	p=_mm256_set1_ps(MK_LOG_P0);
+	p=_mm256_fmadd_ps(p,f,_mm256_set1_ps(MK_LOG_P1));
+	p=_mm256_fmadd_ps(p,f,_mm256_set1_ps(MK_LOG_P2));
+	p=_mm256_fmadd_ps(p,f,_mm256_set1_ps(MK_LOG_P3));
+	p=_mm256_fmadd_ps(p,f,_mm256_set1_ps(MK_LOG_P4));
+	p=_mm256_fmadd_ps(p,f,_mm256_set1_ps(MK_LOG_P5));
+	p=_mm256_fmadd_ps(p,f,_mm256_set1_ps(MK_LOG_P6));
+	p=_mm256_fmadd_ps(p,f,_mm256_set1_ps(MK_LOG_P7));
+	p=_mm256_fmadd_ps(p,f,_mm256_set1_ps(MK_LOG_P8));
+
+	p=_mm256_mul_ps(_mm256_mul_ps(p,f),z);
+
+	return _mm256_fmadd_ps(_mm256_set1_ps(-0.5f),z,p);
+}
+
+// 0 => -inf, inf => inf, <0||nan => nan
+MK_AVX_INLINE static inline __m256 __logFixAVX(__m256 x,__m256 r){
+	r=_mm256_blendv_ps(r,_mm256_set1_ps(-INFINITY),_mm256_cmp_ps(x,_mm256_setzero_ps(),_CMP_EQ_OQ));
+	r=_mm256_blendv_ps(r,_mm256_set1_ps(INFINITY),_mm256_cmp_ps(x,_mm256_set1_ps(INFINITY),_CMP_EQ_OQ));
+	r=_mm256_blendv_ps(r,_mm256_set1_ps(NAN),_mm256_cmp_ps(x,_mm256_setzero_ps(),_CMP_NGE_UQ));
+
+	return r;
+}
+
+MK_AVX_INLINE static inline __m256 __logAVX(__m256 x){
+	__m256 f,e,y,r;
+
+	__logReduceAVX(x,&f,&e);
+	y=__logPolyAVX(f);
+
+	r=_mm256_fmadd_ps(e,_mm256_set1_ps(MK_LN2_LO),y);
+	r=_mm256_add_ps(r,f);
+	r=_mm256_fmadd_ps(e,_mm256_set1_ps(MK_LN2_HI),r);
+
+	return __logFixAVX(x,r);
+}
+
+MK_AVX_INLINE static inline __m256 __log10AVX(__m256 x){
+	__m256 f,e,y,r;
+
+	__logReduceAVX(x,&f,&e);
+	y=__logPolyAVX(f);
+
+	r=_mm256_mul_ps(y,_mm256_set1_ps(MK_LOG10E));
+	r=_mm256_fmadd_ps(f,_mm256_set1_ps(MK_LOG10E),r);
+	r=_mm256_fmadd_ps(e,_mm256_set1_ps(MK_LOG10_2_LO),r);
+	r=_mm256_fmadd_ps(e,_mm256_set1_ps(MK_LOG10_2_HI),r);
+
+	return __logFixAVX(x,r);
+}
+
+// 2^r, |r|<=1/2
+MK_AVX_INLINE static inline __m256 __exp2PolyAVX(__m256 r){
+	__m256 p;
+
+	p=_mm256_set1_ps(MK_EXP2_P0);
+	p=_mm256_fmadd_ps(p,r,_mm256_set1_ps(MK_EXP2_P1));
+	p=_mm256_fmadd_ps(p,r,_mm256_set1_ps(MK_EXP2_P2));
+	p=_mm256_fmadd_ps(p,r,_mm256_set1_ps(MK_EXP2_P3));
+	p=_mm256_fmadd_ps(p,r,_mm256_set1_ps(MK_EXP2_P4));
+	p=_mm256_fmadd_ps(p,r,_mm256_set1_ps(MK_EXP2_P5));
+
+	return _mm256_fmadd_ps(p,r,_mm256_set1_ps(1.0f));
+}
+
+MK_AVX_INLINE static inline __m256 __expAVX(__m256 x){
+	__m256 v,n,z,p,r;
+
+	v=_mm256_min_ps(_mm256_max_ps(x,_mm256_set1_ps(MK_EXP_MIN)),_mm256_set1_ps(MK_EXP_MAX));
+	n=_mm256_round_ps(_mm256_mul_ps(v,_mm256_set1_ps(MK_LOG2E)),_MM_FROUND_TO_NEAREST_INT|_MM_FROUND_NO_EXC);
+
+	v=_mm256_fnmadd_ps(n,_mm256_set1_ps(MK_LN2_HI),v);
+	v=_mm256_fnmadd_ps(n,_mm256_set1_ps(MK_LN2_LO),v);
+
+	z=_mm256_mul_ps(v,v);
+
+	p=_mm256_set1_ps(MK_EXP_P0);
+	p=_mm256_fmadd_ps(p,v,_mm256_set1_ps(MK_EXP_P1));
+	p=_mm256_fmadd_ps(p,v,_mm256_set1_ps(MK_EXP_P2));
+	p=_mm256_fmadd_ps(p,v,_mm256_set1_ps(MK_EXP_P3));
+	p=_mm256_fmadd_ps(p,v,_mm256_set1_ps(MK_EXP_P4));
+	p=_mm256_fmadd_ps(p,v,_mm256_set1_ps(MK_EXP_P5));
+
+	r=_mm256_add_ps(_mm256_fmadd_ps(p,z,v),_mm256_set1_ps(1.0f));
+	r=__ldexpAVX(r,_mm256_cvtps_epi32(n));
+
+	return _mm256_blendv_ps(r,x,_mm256_cmp_ps(x,x,_CMP_UNORD_Q)); // nan
+}
+
+MK_AVX_INLINE static inline __m256 __powAVX(__m256 x,float exp,int parity){
+	__m256 ax,f,e,l2,l2Lo,y,a,aLo,b,bLo,w,n,r;
+	__m256 signMask,zeroValue,infValue;
+
+	signMask=_mm256_set1_ps(-0.0f);
+	y=_mm256_set1_ps(exp);
+
+	ax=_mm256_andnot_ps(signMask,x);
+	__logReduceAVX(ax,&f,&e);
+
+	// log2(m)=l2+l2Lo
+	l2=_mm256_mul_ps(f,_mm256_set1_ps(MK_LOG2E));
+	l2Lo=_mm256_fmadd_ps(f,_mm256_set1_ps(MK_LOG2E_LO),_mm256_mul_ps(__logPolyAVX(f),_mm256_set1_ps(MK_LOG2E)));
+	l2Lo=_mm256_add_ps(_mm256_fmsub_ps(f,_mm256_set1_ps(MK_LOG2E),l2),l2Lo);
+
+	a=_mm256_mul_ps(y,e);
+	aLo=_mm256_fmsub_ps(y,e,a); // y*e-a exact
+	b=_mm256_mul_ps(y,l2);
+	bLo=_mm256_fmadd_ps(y,l2Lo,_mm256_fmsub_ps(y,l2,b));
+	w=_mm256_add_ps(a,_mm256_add_ps(b,bLo));
+
+	n=_mm256_round_ps(_mm256_min_ps(_mm256_max_ps(w,_mm256_set1_ps(MK_POW_MIN)),_mm256_set1_ps(MK_POW_MAX)),
+					_MM_FROUND_TO_NEAREST_INT|_MM_FROUND_NO_EXC);
+	r=_mm256_add_ps(_mm256_add_ps(_mm256_sub_ps(a,n),b),_mm256_add_ps(aLo,bLo));
+	r=_mm256_min_ps(_mm256_max_ps(r,_mm256_set1_ps(-1.0f)),_mm256_set1_ps(1.0f));
+
+	r=__ldexpAVX(__exp2PolyAVX(r),_mm256_cvtps_epi32(n));
+
+	// |x|=0 & |x|=inf
+	zeroValue=_mm256_set1_ps(exp>0?0:INFINITY);
+	infValue=_mm256_set1_ps(exp>0?INFINITY:0);
+	r=_mm256_blendv_ps(r,zeroValue,_mm256_cmp_ps(ax,_mm256_setzero_ps(),_CMP_EQ_OQ));
+	r=_mm256_blendv_ps(r,infValue,_mm256_cmp_ps(ax,_mm256_set1_ps(INFINITY),_CMP_EQ_OQ));
+
+	// negative base
+	if(parity==1){
+		r=_mm256_or_ps(r,_mm256_and_ps(x,signMask));
+	}
+	else if(parity<0){ // -inf^y not nan
+		r=_mm256_blendv_ps(r,_mm256_set1_ps(NAN),_mm256_and_ps(_mm256_cmp_ps(x,_mm256_setzero_ps(),_CMP_LT_OQ),
+																_mm256_cmp_ps(x,_mm256_set1_ps(-INFINITY),_CMP_NEQ_OQ)));
+	}
+
+	return _mm256_blendv_ps(r,x,_mm256_cmp_ps(x,x,_CMP_UNORD_Q)); // nan
+}
+
+MK_AVX_INLINE static inline __m256 __atan2AVX(__m256 y,__m256 x){
+	__m256 signMask,ax,ay,mx,mn,t,t1,r0,z,p,r,mask;
+
+	signMask=_mm256_set1_ps(-0.0f);
+
+	ax=_mm256_andnot_ps(signMask,x);
+	ay=_mm256_andnot_ps(signMask,y);
+	mx=_mm256_max_ps(ax,ay);
+	mn=_mm256_min_ps(ax,ay);
+
+	t=_mm256_div_ps(mn,mx);
+	t=_mm256_blendv_ps(t,_mm256_setzero_ps(),_mm256_cmp_ps(mx,_mm256_setzero_ps(),_CMP_EQ_OQ)); // 0/0
+	t=_mm256_blendv_ps(t,_mm256_set1_ps(1.0f),_mm256_cmp_ps(mn,_mm256_set1_ps(INFINITY),_CMP_EQ_OQ)); // inf/inf
+
+	mask=_mm256_cmp_ps(t,_mm256_set1_ps(MK_TAN_PI8),_CMP_GT_OQ);
+	r0=_mm256_and_ps(mask,_mm256_set1_ps(MK_PI4));
+	t1=_mm256_div_ps(_mm256_sub_ps(mn,mx),_mm256_add_ps(mn,mx)); // one rounding
+	t1=_mm256_blendv_ps(t1,_mm256_setzero_ps(),_mm256_cmp_ps(mn,_mm256_set1_ps(INFINITY),_CMP_EQ_OQ));
+	t=_mm256_blendv_ps(t,t1,mask);
+
+	z=_mm256_mul_ps(t,t);
+	p=_mm256_set1_ps(MK_ATAN_P0);
+	p=_mm256_fmadd_ps(p,z,_mm256_set1_ps(MK_ATAN_P1));
+	p=_mm256_fmadd_ps(p,z,_mm256_set1_ps(MK_ATAN_P2));
+	p=_mm256_fmadd_ps(p,z,_mm256_set1_ps(MK_ATAN_P3));
+	p=_mm256_mul_ps(_mm256_mul_ps(p,z),t);
+	r=_mm256_add_ps(r0,_mm256_add_ps(p,t));
+
+	r=_mm256_blendv_ps(r,_mm256_sub_ps(_mm256_set1_ps(MK_PI2),r),_mm256_cmp_ps(ay,ax,_CMP_GT_OQ));
+	r=_mm256_blendv_ps(r,_mm256_sub_ps(_mm256_set1_ps(MK_PI),r),x); // sign bit x
+	r=_mm256_or_ps(r,_mm256_and_ps(y,signMask));
+
+	return _mm256_blendv_ps(r,_mm256_add_ps(x,y),_mm256_cmp_ps(x,y,_CMP_UNORD_Q)); // nan
+}
+
+MK_AVX static void __mathKernel_logAVX(float *vArr1,int length,float *vArr2,int isLog10){
+	int i=0;
+
+	for(;i+8<=length;i+=8){
+		__m256 x;
+
+		x=_mm256_loadu_ps(vArr1+i);
+		_mm256_storeu_ps(vArr2+i,(isLog10?__log10AVX(x):__logAVX(x)));
+	}
+
+	if(i<length){
+		float buf[8]={1,1,1,1,1,1,1,1};
+		__m256 x;
+
+		memcpy(buf, vArr1+i, sizeof(float )*(length-i));
+		x=_mm256_loadu_ps(buf);
+		_mm256_storeu_ps(buf,(isLog10?__log10AVX(x):__logAVX(x)));
+		memcpy(vArr2+i, buf, sizeof(float )*(length-i));
+	}
+}
+
+// max(x,min) => min when x nan, same as scalar compare
+MK_AVX static void __mathKernel_dbAVX(float *vArr1,float div,float mul,float min,int length,float *vArr2){
+	int i=0;
+
+	__m256 d;
+	__m256 m;
+	__m256 low;
+
+	d=_mm256_set1_ps(div);
+	m=_mm256_set1_ps(mul);
+	low=_mm256_set1_ps(min);
+
+	for(;i+8<=length;i+=8){
+		__m256 x;
+
+		x=_mm256_div_ps(_mm256_loadu_ps(vArr1+i),d);
+		x=_mm256_mul_ps(m,__log10AVX(x));
+		_mm256_storeu_ps(vArr2+i,_mm256_max_ps(x,low));
+	}
+
+	if(i<length){
+		float buf[8]={1,1,1,1,1,1,1,1};
+		__m256 x;
+
+		memcpy(buf, vArr1+i, sizeof(float )*(length-i));
+		x=_mm256_div_ps(_mm256_loadu_ps(buf),d);
+		x=_mm256_mul_ps(m,__log10AVX(x));
+		_mm256_storeu_ps(buf,_mm256_max_ps(x,low));
+		memcpy(vArr2+i, buf, sizeof(float )*(length-i));
+	}
+}
+
+MK_AVX static void __mathKernel_expAVX(float *vArr1,int length,float *vArr2){
+	int i=0;
+
+	for(;i+8<=length;i+=8){
+		_mm256_storeu_ps(vArr2+i,__expAVX(_mm256_loadu_ps(vArr1+i)));
+	}
+
+	if(i<length){
+		float buf[8]={0};
+
+		memcpy(buf, vArr1+i, sizeof(float )*(length-i));
+		_mm256_storeu_ps(buf,__expAVX(_mm256_loadu_ps(buf)));
+		memcpy(vArr2+i, buf, sizeof(float )*(length-i));
+	}
+}
+
+MK_AVX static void __mathKernel_powAVX(float *vArr1,float exp,int parity,int length,float *vArr2){
+	int i=0;
+
+	for(;i+8<=length;i+=8){
+		_mm256_storeu_ps(vArr2+i,__powAVX(_mm256_loadu_ps(vArr1+i),exp,parity));
+	}
+
+	if(i<length){
+		float buf[8]={1,1,1,1,1,1,1,1};
+
+		memcpy(buf, vArr1+i, sizeof(float )*(length-i));
+		_mm256_storeu_ps(buf,__powAVX(_mm256_loadu_ps(buf),exp,parity));
+		memcpy(vArr2+i, buf, sizeof(float )*(length-i));
+	}
+}
+
+MK_AVX static void __mathKernel_sqrtAVX(float *vArr1,int length,float *vArr2){
+	int i=0;
+
+	for(;i+8<=length;i+=8){
+		_mm256_storeu_ps(vArr2+i,_mm256_sqrt_ps(_mm256_loadu_ps(vArr1+i)));
+	}
+
+	for(;i<length;i++){ // ieee exact, scalar same
+		vArr2[i]=sqrtf(vArr1[i]);
+	}
+}
+
+MK_AVX static void __mathKernel_atan2AVX(float *vArr1,float *vArr2,int length,float *vArr3){
+	int i=0;
+
+	for(;i+8<=length;i+=8){
+		_mm256_storeu_ps(vArr3+i,__atan2AVX(_mm256_loadu_ps(vArr1+i),_mm256_loadu_ps(vArr2+i)));
+	}
+
+	if(i<length){
+		float buf1[8]={0};
+		float buf2[8]={1,1,1,1,1,1,1,1};
+
+		memcpy(buf1, vArr1+i, sizeof(float )*(length-i));
+		memcpy(buf2, vArr2+i, sizeof(float )*(length-i));
+		_mm256_storeu_ps(buf1,__atan2AVX(_mm256_loadu_ps(buf1),_mm256_loadu_ps(buf2)));
+		memcpy(vArr3+i, buf1, sizeof(float )*(length-i));
+	}
+}
+
+MK_AVX static float __mathKernel_maxAVX(float *vArr1,int length){
+	int i=0;
+	float value=0;
+
+	float buf[8]={0};
+	__m256 m;
+
+	if(length<8){
+		value=vArr1[0];
+		for(i=1;i<length;i++){
+			if(value<vArr1[i]){
+				value=vArr1[i];
+			}
+		}
+
+		return value;
+	}
+
+	m=_mm256_loadu_ps(vArr1);
+	for(i=8;i+8<=length;i+=8){
+		m=_mm256_max_ps(m,_mm256_loadu_ps(vArr1+i));
+	}
+
+	if(i<length){ // overlap last 8, max not depend on position
+		m=_mm256_max_ps(m,_mm256_loadu_ps(vArr1+length-8));
+	}
+
+	_mm256_storeu_ps(buf,m);
+	value=buf[0];
+	for(i=1;i<8;i++){
+		if(value<buf[i]){
+			value=buf[i];
+		}
+	}
+
+	return value;
+}
+
+// 8 lane compare, movemask then bit scan; most lane not peak
+MK_AVX static int __mathKernel_peakAVX(float *vArr1,int start,int end,float minValue,int *indexArr){
+	int i=0;
+	int len=0;
+
+	__m256 minVec;
+
+	minVec=_mm256_set1_ps(minValue);
+	for(i=start;i+8<=end+1;i+=8){
+		__m256 c,l,r,mask;
+		unsigned int bit=0;
+
+		c=_mm256_loadu_ps(vArr1+i);
+		l=_mm256_loadu_ps(vArr1+i-1);
+		r=_mm256_loadu_ps(vArr1+i+1);
+
+		mask=_mm256_and_ps(_mm256_cmp_ps(c,l,_CMP_GT_OQ),_mm256_cmp_ps(c,r,_CMP_GT_OQ));
+		mask=_mm256_and_ps(mask,_mm256_cmp_ps(c,minVec,_CMP_GE_OQ));
+
+		bit=_mm256_movemask_ps(mask);
+		while(bit){
+			indexArr[len]=i+__builtin_ctz(bit);
+			len++;
+
+			bit&=bit-1;
+		}
+	}
+
+	for(;i<=end;i++){
+		float _value=0;
+
+		_value=vArr1[i];
+		if(_value>vArr1[i-1]&&_value>vArr1[i+1]&&_value>=minValue){
+			indexArr[len]=i;
+			len++;
+		}
+	}
+
+	return len;
+}
+
+// 32 output in 4 register, tap broadcast; tail 8 then scalar
+MK_AVX static void __mathKernel_firAVX(float *vArr1,float *cArr,int cLength,int length,float *vArr2){
+	int i=0;
+
+	__m256 c,s1,s2,s3,s4;
+
+	for(i=0;i+32<=length;i+=32){
+		s1=_mm256_setzero_ps();
+		s2=_mm256_setzero_ps();
+		s3=_mm256_setzero_ps();
+		s4=_mm256_setzero_ps();
+
+		for(int k=0;k<cLength;k++){
+			c=_mm256_broadcast_ss(cArr+k);
+
+			s1=_mm256_fmadd_ps(c,_mm256_loadu_ps(vArr1+i+k),s1);
+			s2=_mm256_fmadd_ps(c,_mm256_loadu_ps(vArr1+i+k+8),s2);
+			s3=_mm256_fmadd_ps(c,_mm256_loadu_ps(vArr1+i+k+16),s3);
+			s4=_mm256_fmadd_ps(c,_mm256_loadu_ps(vArr1+i+k+24),s4);
+		}
+
+		_mm256_storeu_ps(vArr2+i,_mm256_add_ps(_mm256_loadu_ps(vArr2+i),s1));
+		_mm256_storeu_ps(vArr2+i+8,_mm256_add_ps(_mm256_loadu_ps(vArr2+i+8),s2));
+		_mm256_storeu_ps(vArr2+i+16,_mm256_add_ps(_mm256_loadu_ps(vArr2+i+16),s3));
+		_mm256_storeu_ps(vArr2+i+24,_mm256_add_ps(_mm256_loadu_ps(vArr2+i+24),s4));
+	}
+
+	for(;i+8<=length;i+=8){
+		s1=_mm256_setzero_ps();
+		for(int k=0;k<cLength;k++){
+			s1=_mm256_fmadd_ps(_mm256_broadcast_ss(cArr+k),_mm256_loadu_ps(vArr1+i+k),s1);
+		}
+
+		_mm256_storeu_ps(vArr2+i,_mm256_add_ps(_mm256_loadu_ps(vArr2+i),s1));
+	}
+
+	for(;i<length;i++){
+		float _value=0;
+
+		for(int k=0;k<cLength;k++){
+			_value=fmaf(cArr[k],vArr1[i+k],_value);
+		}
+
+		vArr2[i]+=_value;
+	}
+}
+
+// 4 accumulator 32 per step, then 8, scalar tail
+MK_AVX static float __mathKernel_dotAVX(float *vArr1,float *vArr2,int length){
+	int i=0;
+	float value=0;
+
+	float buf[8]={0};
+	__m256 s1,s2,s3,s4;
+
+	s1=_mm256_setzero_ps();
+	s2=_mm256_setzero_ps();
+	s3=_mm256_setzero_ps();
+	s4=_mm256_setzero_ps();
+
+	for(i=0;i+32<=length;i+=32){
+		s1=_mm256_fmadd_ps(_mm256_loadu_ps(vArr1+i),_mm256_loadu_ps(vArr2+i),s1);
+		s2=_mm256_fmadd_ps(_mm256_loadu_ps(vArr1+i+8),_mm256_loadu_ps(vArr2+i+8),s2);
+		s3=_mm256_fmadd_ps(_mm256_loadu_ps(vArr1+i+16),_mm256_loadu_ps(vArr2+i+16),s3);
+		s4=_mm256_fmadd_ps(_mm256_loadu_ps(vArr1+i+24),_mm256_loadu_ps(vArr2+i+24),s4);
+	}
+
+	for(;i+8<=length;i+=8){
+		s1=_mm256_fmadd_ps(_mm256_loadu_ps(vArr1+i),_mm256_loadu_ps(vArr2+i),s1);
+	}
+
+	s1=_mm256_add_ps(_mm256_add_ps(s1,s2),_mm256_add_ps(s3,s4));
+	_mm256_storeu_ps(buf,s1);
+
+	value=((buf[0]+buf[4])+(buf[1]+buf[5]))+((buf[2]+buf[6])+(buf[3]+buf[7]));
+	for(;i<length;i++){
+		value=fmaf(vArr1[i],vArr2[i],value);
+	}
+
+	return value;
+}
+
+#elif defined MATH_KERNEL_NEON
+
+__attribute__((always_inline)) static inline float32x4_t __pow2iNEON(int32x4_t n){
+
+	return vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(n,vdupq_n_s32(127)),23));
+}
+
+__attribute__((always_inline)) static inline float32x4_t __ldexpNEON(float32x4_t x,int32x4_t n){
+	int32x4_t n1,n2;
+
+	n1=vshrq_n_s32(n,1);
+	n2=vsubq_s32(n,n1);
+
+	return vmulq_f32(vmulq_f32(x,__pow2iNEON(n1)),__pow2iNEON(n2));
+}
+
+__attribute__((always_inline)) static inline void __logReduceNEON(float32x4_t x,float32x4_t *f,float32x4_t *e){
+	uint32x4_t tiny,mask,bits;
+	float32x4_t bias,m;
+
+	tiny=vcltq_f32(x,vdupq_n_f32(FLT_MIN));
+	x=vbslq_f32(tiny,vmulq_f32(x,vdupq_n_f32(8388608.0f)),x);
+	bias=vreinterpretq_f32_u32(vandq_u32(tiny,vreinterpretq_u32_f32(vdupq_n_f32(23.0f))));
+
+	bits=vreinterpretq_u32_f32(x);
+	*e=vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits,23)),vdupq_n_s32(126)));
+	m=vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits,vdupq_n_u32(0x007FFFFF)),vdupq_n_u32(0x3F000000)));
+
+	mask=vcltq_f32(m,vdupq_n_f32(MK_SQRTHF));
+	*e=vsubq_f32(vsubq_f32(*e,bias),vreinterpretq_f32_u32(vandq_u32(mask,vreinterpretq_u32_f32(vdupq_n_f32(1.0f)))));
+	*f=vaddq_f32(vsubq_f32(m,vdupq_n_f32(1.0f)),vreinterpretq_f32_u32(vandq_u32(mask,vreinterpretq_u32_f32(m))));
+}
+
+__attribute__((always_inline)) static inline float32x4_t __logPolyNEON(float32x4_t f){
+	float32x4_t z,p;
+
+	z=vmulq_f32(f,f);
+
+	p=vdupq_n_f32(MK_LOG_P0);
+	p=vfmaq_f32(vdupq_n_f32(MK_LOG_P1),p,f);
+	p=vfmaq_f32(vdupq_n_f32(MK_LOG_P2),p,f);
+	p=vfmaq_f32(vdupq_n_f32(MK_LOG_P3),p,f);
+	p=vfmaq_f32(vdupq_n_f32(MK_LOG_P4),p,f);
+	p=vfmaq_f32(vdupq_n_f32(MK_LOG_P5),p,f);
+	p=vfmaq_f32(vdupq_n_f32(MK_LOG_P6),p,f);
+	p=vfmaq_f32(vdupq_n_f32(MK_LOG_P7),p,f);
+	p=vfmaq_f32(vdupq_n_f32(MK_LOG_P8),p,f);
+
+	p=vmulq_f32(vmulq_f32(p,f),z);
+
+	return vfmaq_f32(p,vdupq_n_f32(-0.5f),z);
+}
+
+__attribute__((always_inline)) static inline float32x4_t __logFixNEON(float32x4_t x,float32x4_t r){
+	r=vbslq_f32(vceqq_f32(x,vdupq_n_f32(0)),vdupq_n_f32(-INFINITY),r);
+	r=vbslq_f32(vceqq_f32(x,vdupq_n_f32(INFINITY)),vdupq_n_f32(INFINITY),r);
+	r=vbslq_f32(vmvnq_u32(vcgeq_f32(x,vdupq_n_f32(0))),vdupq_n_f32(NAN),r);
+
+	return r;
+}
+
+__attribute__((always_inline)) static inline float32x4_t __logNEON(float32x4_t x){
+	float32x4_t f,e,y,r;
+
+	__logReduceNEON(x,&f,&e);
+	y=__logPolyNEON(f);
+
+	r=vfmaq_f32(y,e,vdupq_n_f32(MK_LN2_LO));
+	r=vaddq_f32(r,f);
+	r=vfmaq_f32(r,e,vdupq_n_f32(MK_LN2_HI));
+
+	return __logFixNEON(x,r);
+}
+
+__attribute__((always_inline)) static inline float32x4_t __log10NEON(float32x4_t x){
+	float32x4_t f,e,y,r;
+
+	__logReduceNEON(x,&f,&e);
+	y=__logPolyNEON(f);
+
+	r=vmulq_f32(y,vdupq_n_f32(MK_LOG10E));
+	r=vfmaq_f32(r,f,vdupq_n_f32(MK_LOG10E));
+	r=vfmaq_f32(r,e,vdupq_n_f32(MK_LOG10_2_LO));
+	r=vfmaq_f32(r,e,vdupq_n_f32(MK_LOG10_2_HI));
+
+	return __logFixNEON(x,r);
+}
+
+__attribute__((always_inline)) static inline float32x4_t __exp2PolyNEON(float32x4_t r){
+	float32x4_t p;
+
+	p=vdupq_n_f32(MK_EXP2_P0);
+	p=vfmaq_f32(vdupq_n_f32(MK_EXP2_P1),p,r);
+	p=vfmaq_f32(vdupq_n_f32(MK_EXP2_P2),p,r);
+	p=vfmaq_f32(vdupq_n_f32(MK_EXP2_P3),p,r);
+	p=vfmaq_f32(vdupq_n_f32(MK_EXP2_P4),p,r);
+	p=vfmaq_f32(vdupq_n_f32(MK_EXP2_P5),p,r);
+
+	return vfmaq_f32(vdupq_n_f32(1.0f),p,r);
+}
+
+__attribute__((always_inline)) static inline float32x4_t __expNEON(float32x4_t x){
+	float32x4_t v,n,z,p,r;
+
+	v=vminq_f32(vmaxq_f32(x,vdupq_n_f32(MK_EXP_MIN)),vdupq_n_f32(MK_EXP_MAX));
+	n=vrndnq_f32(vmulq_f32(v,vdupq_n_f32(MK_LOG2E)));
+
+	v=vfmsq_f32(v,n,vdupq_n_f32(MK_LN2_HI));
+	v=vfmsq_f32(v,n,vdupq_n_f32(MK_LN2_LO));
+
+	z=vmulq_f32(v,v);
+
+	p=vdupq_n_f32(MK_EXP_P0);
+	p=vfmaq_f32(vdupq_n_f32(MK_EXP_P1),p,v);
+	p=vfmaq_f32(vdupq_n_f32(MK_EXP_P2),p,v);
+	p=vfmaq_f32(vdupq_n_f32(MK_EXP_P3),p,v);
+	p=vfmaq_f32(vdupq_n_f32(MK_EXP_P4),p,v);
+	p=vfmaq_f32(vdupq_n_f32(MK_EXP_P5),p,v);
+
+	r=vaddq_f32(vfmaq_f32(v,p,z),vdupq_n_f32(1.0f));
+	r=__ldexpNEON(r,vcvtq_s32_f32(n));
+
+	return vbslq_f32(vceqq_f32(x,x),r,x); // nan
+}
+
+__attribute__((always_inline)) static inline float32x4_t __powNEON(float32x4_t x,float exp,int parity){
+	float32x4_t ax,f,e,l2,l2Lo,y,a,aLo,b,bLo,w,n,r;
+	uint32x4_t signMask;
+
+	signMask=vdupq_n_u32(0x80000000);
+	y=vdupq_n_f32(exp);
+
+	ax=vabsq_f32(x);
+	__logReduceNEON(ax,&f,&e);
+
+	l2=vmulq_f32(f,vdupq_n_f32(MK_LOG2E));
+	l2Lo=vfmaq_f32(vmulq_f32(__logPolyNEON(f),vdupq_n_f32(MK_LOG2E)),f,vdupq_n_f32(MK_LOG2E_LO));
+	l2Lo=vaddq_f32(vfmaq_f32(vnegq_f32(l2),f,vdupq_n_f32(MK_LOG2E)),l2Lo);
+
+	a=vmulq_f32(y,e);
+	aLo=vfmaq_f32(vnegq_f32(a),y,e);
+	b=vmulq_f32(y,l2);
+	bLo=vfmaq_f32(vfmaq_f32(vnegq_f32(b),y,l2),y,l2Lo);
+	w=vaddq_f32(a,vaddq_f32(b,bLo));
+
+	n=vrndnq_f32(vminq_f32(vmaxq_f32(w,vdupq_n_f32(MK_POW_MIN)),vdupq_n_f32(MK_POW_MAX)));
+	r=vaddq_f32(vaddq_f32(vsubq_f32(a,n),b),vaddq_f32(aLo,bLo));
+	r=vminq_f32(vmaxq_f32(r,vdupq_n_f32(-1.0f)),vdupq_n_f32(1.0f));
+
+	r=__ldexpNEON(__exp2PolyNEON(r),vcvtq_s32_f32(n));
+
+	r=vbslq_f32(vceqq_f32(ax,vdupq_n_f32(0)),vdupq_n_f32(exp>0?0:INFINITY),r);
+	r=vbslq_f32(vceqq_f32(ax,vdupq_n_f32(INFINITY)),vdupq_n_f32(exp>0?INFINITY:0),r);
+
+	if(parity==1){
+		r=vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(r),
+										vandq_u32(vreinterpretq_u32_f32(x),signMask)));
+	}
+	else if(parity<0){
+		r=vbslq_f32(vandq_u32(vcltq_f32(x,vdupq_n_f32(0)),vcgtq_f32(x,vdupq_n_f32(-INFINITY))),vdupq_n_f32(NAN),r);
+	}
+
+	return vbslq_f32(vceqq_f32(x,x),r,x);
+}
+
+__attribute__((always_inline)) static inline float32x4_t __atan2NEON(float32x4_t y,float32x4_t x){
+	float32x4_t ax,ay,mx,mn,t,t1,r0,z,p,r;
+	uint32x4_t signMask,mask;
+
+	signMask=vdupq_n_u32(0x80000000);
+
+	ax=vabsq_f32(x);
+	ay=vabsq_f32(y);
+	mx=vmaxq_f32(ax,ay);
+	mn=vminq_f32(ax,ay);
+
+	t=vdivq_f32(mn,mx);
+	t=vbslq_f32(vceqq_f32(mx,vdupq_n_f32(0)),vdupq_n_f32(0),t);
+	t=vbslq_f32(vceqq_f32(mn,vdupq_n_f32(INFINITY)),vdupq_n_f32(1.0f),t);
+
+	mask=vcgtq_f32(t,vdupq_n_f32(MK_TAN_PI8));
+	r0=vbslq_f32(mask,vdupq_n_f32(MK_PI4),vdupq_n_f32(0));
+	t1=vdivq_f32(vsubq_f32(mn,mx),vaddq_f32(mn,mx));
+	t1=vbslq_f32(vceqq_f32(mn,vdupq_n_f32(INFINITY)),vdupq_n_f32(0),t1);
+	t=vbslq_f32(mask,t1,t);
+
+	z=vmulq_f32(t,t);
+	p=vdupq_n_f32(MK_ATAN_P0);
+	p=vfmaq_f32(vdupq_n_f32(MK_ATAN_P1),p,z);
+	p=vfmaq_f32(vdupq_n_f32(MK_ATAN_P2),p,z);
+	p=vfmaq_f32(vdupq_n_f32(MK_ATAN_P3),p,z);
+	p=vmulq_f32(vmulq_f32(p,z),t);
+	r=vaddq_f32(r0,vaddq_f32(p,t));
+
+	r=vbslq_f32(vcgtq_f32(ay,ax),vsubq_f32(vdupq_n_f32(MK_PI2),r),r);
+	mask=vtstq_u32(vreinterpretq_u32_f32(x),signMask);
+	r=vbslq_f32(mask,vsubq_f32(vdupq_n_f32(MK_PI),r),r);
+	r=vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(r),
+									vandq_u32(vreinterpretq_u32_f32(y),signMask)));
+
+	mask=vandq_u32(vceqq_f32(x,x),vceqq_f32(y,y));
+	return vbslq_f32(mask,r,vaddq_f32(x,y));
+}
+
+static void __mathKernel_logNEON(float *vArr1,int length,float *vArr2,int isLog10){
+	int i=0;
+
+	for(;i+4<=length;i+=4){
+		float32x4_t x;
+
+		x=vld1q_f32(vArr1+i);
+		vst1q_f32(vArr2+i,(isLog10?__log10NEON(x):__logNEON(x)));
+	}
+
+	if(i<length){
+		float buf[4]={1,1,1,1};
+		float32x4_t x;
+
+		memcpy(buf, vArr1+i, sizeof(float )*(length-i));
+		x=vld1q_f32(buf);
+		vst1q_f32(buf,(isLog10?__log10NEON(x):__logNEON(x)));
+		memcpy(vArr2+i, buf, sizeof(float )*(length-i));
+	}
+}
+
+// x>min ? x : min, nan => min
+static void __mathKernel_dbNEON(float *vArr1,float div,float mul,float min,int length,float *vArr2){
+	int i=0;
+
+	float32x4_t d;
+	float32x4_t m;
+	float32x4_t low;
+
+	d=vdupq_n_f32(div);
+	m=vdupq_n_f32(mul);
+	low=vdupq_n_f32(min);
+
+	for(;i+4<=length;i+=4){
+		float32x4_t x;
+
+		x=vdivq_f32(vld1q_f32(vArr1+i),d);
+		x=vmulq_f32(m,__log10NEON(x));
+		vst1q_f32(vArr2+i,vbslq_f32(vcgtq_f32(x,low),x,low));
+	}
+
+	if(i<length){
+		float buf[4]={1,1,1,1};
+		float32x4_t x;
+
+		memcpy(buf, vArr1+i, sizeof(float )*(length-i));
+		x=vdivq_f32(vld1q_f32(buf),d);
+		x=vmulq_f32(m,__log10NEON(x));
+		vst1q_f32(buf,vbslq_f32(vcgtq_f32(x,low),x,low));
+		memcpy(vArr2+i, buf, sizeof(float )*(length-i));
+	}
+}
+
+static void __mathKernel_expNEON(float *vArr1,int length,float *vArr2){
+	int i=0;
+
+	for(;i+4<=length;i+=4){
+		vst1q_f32(vArr2+i,__expNEON(vld1q_f32(vArr1+i)));
+	}
+
+	if(i<length){
+		float buf[4]={0};
+
+		memcpy(buf, vArr1+i, sizeof(float )*(length-i));
+		vst1q_f32(buf,__expNEON(vld1q_f32(buf)));
+		memcpy(vArr2+i, buf, sizeof(float )*(length-i));
+	}
+}
+
+static void __mathKernel_powNEON(float *vArr1,float exp,int parity,int length,float *vArr2){
+	int i=0;
+
+	for(;i+4<=length;i+=4){
+		vst1q_f32(vArr2+i,__powNEON(vld1q_f32(vArr1+i),exp,parity));
+	}
+
+	if(i<length){
+		float buf[4]={1,1,1,1};
+
+		memcpy(buf, vArr1+i, sizeof(float )*(length-i));
+		vst1q_f32(buf,__powNEON(vld1q_f32(buf),exp,parity));
+		memcpy(vArr2+i, buf, sizeof(float )*(length-i));
+	}
+}
+
+static void __mathKernel_sqrtNEON(float *vArr1,int length,float *vArr2){
+	int i=0;
+
+	for(;i+4<=length;i+=4){
+		vst1q_f32(vArr2+i,vsqrtq_f32(vld1q_f32(vArr1+i)));
+	}
+
+	for(;i<length;i++){
+		vArr2[i]=sqrtf(vArr1[i]);
+	}
+}
+
+static void __mathKernel_atan2NEON(float *vArr1,float *vArr2,int length,float *vArr3){
+	int i=0;
+
+	for(;i+4<=length;i+=4){
+		vst1q_f32(vArr3+i,__atan2NEON(vld1q_f32(vArr1+i),vld1q_f32(vArr2+i)));
+	}
+
+	if(i<length){
+		float buf1[4]={0};
+		float buf2[4]={1,1,1,1};
+
+		memcpy(buf1, vArr1+i, sizeof(float )*(length-i));
+		memcpy(buf2, vArr2+i, sizeof(float )*(length-i));
+		vst1q_f32(buf1,__atan2NEON(vld1q_f32(buf1),vld1q_f32(buf2)));
+		memcpy(vArr3+i, buf1, sizeof(float )*(length-i));
+	}
+}
+
+static float __mathKernel_maxNEON(float *vArr1,int length){
+	int i=0;
+	float value=0;
+
+	float32x4_t m;
+
+	if(length<4){
+		value=vArr1[0];
+		for(i=1;i<length;i++){
+			if(value<vArr1[i]){
+				value=vArr1[i];
+			}
+		}
+
+		return value;
+	}
+
+	m=vld1q_f32(vArr1);
+	for(i=4;i+4<=length;i+=4){
+		m=vmaxq_f32(m,vld1q_f32(vArr1+i));
+	}
+
+	if(i<length){
+		m=vmaxq_f32(m,vld1q_f32(vArr1+length-4));
+	}
+
+	return vmaxvq_f32(m);
+}
+
+static int __mathKernel_peakNEON(float *vArr1,int start,int end,float minValue,int *indexArr){
+	int i=0;
+	int len=0;
+
+	float32x4_t minVec;
+
+	minVec=vdupq_n_f32(minValue);
+	for(i=start;i+4<=end+1;i+=4){
+		float32x4_t c;
+		uint32x4_t mask;
+
+		uint32_t bitArr[4]={0};
+
+		c=vld1q_f32(vArr1+i);
+		mask=vandq_u32(vcgtq_f32(c,vld1q_f32(vArr1+i-1)),vcgtq_f32(c,vld1q_f32(vArr1+i+1)));
+		mask=vandq_u32(mask,vcgeq_f32(c,minVec));
+		if(!vmaxvq_u32(mask)){
+			continue;
+		}
+
+		vst1q_u32(bitArr,mask);
+		for(int j=0;j<4;j++){
+			if(bitArr[j]){
+				indexArr[len]=i+j;
+				len++;
+			}
+		}
+	}
+
+	for(;i<=end;i++){
+		float _value=0;
+
+		_value=vArr1[i];
+		if(_value>vArr1[i-1]&&_value>vArr1[i+1]&&_value>=minValue){
+			indexArr[len]=i;
+			len++;
+		}
+	}
+
+	return len;
+}
+
+static void __mathKernel_firNEON(float *vArr1,float *cArr,int cLength,int length,float *vArr2){
+	int i=0;
+
+	float32x4_t c,s1,s2,s3,s4;
+
+	for(i=0;i+16<=length;i+=16){
+		s1=vdupq_n_f32(0);
+		s2=vdupq_n_f32(0);
+		s3=vdupq_n_f32(0);
+		s4=vdupq_n_f32(0);
+
+		for(int k=0;k<cLength;k++){
+			c=vdupq_n_f32(cArr[k]);
+
+			s1=vfmaq_f32(s1,c,vld1q_f32(vArr1+i+k));
+			s2=vfmaq_f32(s2,c,vld1q_f32(vArr1+i+k+4));
+			s3=vfmaq_f32(s3,c,vld1q_f32(vArr1+i+k+8));
+			s4=vfmaq_f32(s4,c,vld1q_f32(vArr1+i+k+12));
+		}
+
+		vst1q_f32(vArr2+i,vaddq_f32(vld1q_f32(vArr2+i),s1));
+		vst1q_f32(vArr2+i+4,vaddq_f32(vld1q_f32(vArr2+i+4),s2));
+		vst1q_f32(vArr2+i+8,vaddq_f32(vld1q_f32(vArr2+i+8),s3));
+		vst1q_f32(vArr2+i+12,vaddq_f32(vld1q_f32(vArr2+i+12),s4));
+	}
+
+	for(;i+4<=length;i+=4){
+		s1=vdupq_n_f32(0);
+		for(int k=0;k<cLength;k++){
+			s1=vfmaq_f32(s1,vdupq_n_f32(cArr[k]),vld1q_f32(vArr1+i+k));
+		}
+
+		vst1q_f32(vArr2+i,vaddq_f32(vld1q_f32(vArr2+i),s1));
+	}
+
+	for(;i<length;i++){
+		float _value=0;
+
+		for(int k=0;k<cLength;k++){
+			_value=fmaf(cArr[k],vArr1[i+k],_value);
+		}
+
+		vArr2[i]+=_value;
+	}
+}
+
+static float __mathKernel_dotNEON(float *vArr1,float *vArr2,int length){
+	int i=0;
+	float value=0;
+
+	float32x4_t s1,s2,s3,s4;
+
+	s1=vdupq_n_f32(0);
+	s2=vdupq_n_f32(0);
+	s3=vdupq_n_f32(0);
+	s4=vdupq_n_f32(0);
+
+	for(i=0;i+16<=length;i+=16){
+		s1=vfmaq_f32(s1,vld1q_f32(vArr1+i),vld1q_f32(vArr2+i));
+		s2=vfmaq_f32(s2,vld1q_f32(vArr1+i+4),vld1q_f32(vArr2+i+4));
+		s3=vfmaq_f32(s3,vld1q_f32(vArr1+i+8),vld1q_f32(vArr2+i+8));
+		s4=vfmaq_f32(s4,vld1q_f32(vArr1+i+12),vld1q_f32(vArr2+i+12));
+	}
+
+	for(;i+4<=length;i+=4){
+		s1=vfmaq_f32(s1,vld1q_f32(vArr1+i),vld1q_f32(vArr2+i));
+	}
+
+	value=vaddvq_f32(vaddq_f32(vaddq_f32(s1,s2),vaddq_f32(s3,s4)));
+	for(;i<length;i++){
+		value=fmaf(vArr1[i],vArr2[i],value);
+	}
+
+	return value;
+}
+
+#endif
+
+static int __mathKernel_dispatch(){
+	int level=0;
+
+	#ifdef MATH_KERNEL_X86
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2")&&__builtin_cpu_supports("fma")){
+		level=1;
+	}
+
+	#elif defined MATH_KERNEL_NEON
+	level=2;
+
+	#endif
+
+	return level;
+}
+
+static void __mathKernel_initLevel(){
+
+	__level=__mathKernel_dispatch();
+}
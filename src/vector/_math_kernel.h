@@ -0,0 +1,51 @@
+#ifndef _MATH_KERNEL_H
+#define _MATH_KERNEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/***
+	element math hot loops; AVX2+FMA/NEON(aarch64) by runtime cpu, scalar libm fallback
+	vArr2 NULL => in place; tail use same vector path(result not depend on position)
+	simd path max ulp error(measured, vs double reference):
+		log 0.8, log10 1.1, exp 1.0(normal result), sqrt 0.5(ieee)
+		pow 1.3 |exp|<=4, 1.9 |exp|<=8, then ~|exp|/4
+		atan2 2.8
+	denormal input ok, special value(0/inf/nan/negative base) same as libm
+****/
+void __mathKernel_log(float *vArr1,int length,float *vArr2);
+void __mathKernel_log10(float *vArr1,int length,float *vArr2);
+void __mathKernel_exp(float *vArr1,int length,float *vArr2);
+void __mathKernel_pow(float *vArr1,float exp,int length,float *vArr2);
+void __mathKernel_sqrt(float *vArr1,int length,float *vArr2);
+
+// vArr2=max(mul*log10(vArr1/div),min) one pass, nan => min; vArr2 NULL => in place
+void __mathKernel_db(float *vArr1,float div,float mul,float min,int length,float *vArr2);
+
+// vArr3=atan2(vArr1,vArr2) y/x; vArr3 NULL => vArr1
+void __mathKernel_atan2(float *vArr1,float *vArr2,int length,float *vArr3);
+
+// length>0
+float __mathKernel_max(float *vArr1,int length);
+
+/***
+	local peak index, i in [start,end] ascending
+	vArr1[i]>vArr1[i-1]&&vArr1[i]>vArr1[i+1]&&vArr1[i]>=minValue
+	vArr1[start-1]~vArr1[end+1] must valid; return count
+****/
+int __mathKernel_peak(float *vArr1,int start,int end,float minValue,int *indexArr);
+
+// fir correlation accumulate, vArr2[i]+=sum cArr[k]*vArr1[i+k]; vArr1 valid to length+cLength-1
+void __mathKernel_fir(float *vArr1,float *cArr,int cLength,int length,float *vArr2);
+
+float __mathKernel_dot(float *vArr1,float *vArr2,int length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
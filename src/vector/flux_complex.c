@@ -3,13 +3,9 @@
 #include <string.h>
 #include <math.h>
 
-#include "flux_complex.h"
-
-#ifdef HAVE_OMP
-#include <omp.h>
-#endif
+#include "../util/flux_parallel.h"
 
-extern int __kernelNum;
+#include "flux_complex.h"
 
 // 针对 type 0即符合乘法
 void __mcdot(float *mRealArr1,float *mImageArr1,
@@ -546,9 +542,49 @@ void __mcsquare1(float *mRealArr,float *mImageArr,int nLength,int mLength,int ax
 	}
 }
 
+// __mcsquare2 __parallel_for arg
+typedef struct{
+	float *mRealArr;
+	float *mImageArr;
+	float *mArr;
+
+	int mLength;
+	int mLength2;
+
+} MCSquareChunkArg;
+
+static void __mcsquare2Chunk(void *arg,int start,int end,int threadIndex){
+	MCSquareChunkArg *chunkArg=NULL;
+
+	float *mRealArr=NULL;
+	float *mImageArr=NULL;
+	float *mArr=NULL;
+
+	int mLength=0;
+	int mLength2=0;
+
+	chunkArg=(MCSquareChunkArg *)arg;
+
+	mRealArr=chunkArg->mRealArr;
+	mImageArr=chunkArg->mImageArr;
+	mArr=chunkArg->mArr;
+
+	mLength=chunkArg->mLength;
+	mLength2=chunkArg->mLength2;
+
+	for(int i=start;i<end;i++){
+		for(int j=0;j<mLength2;j++){
+			mArr[i*mLength2+j]=mRealArr[i*mLength+j]*mRealArr[i*mLength+j]+
+								mImageArr[i*mLength+j]*mImageArr[i*mLength+j];
+		}
+	}
+}
+
 void __mcsquare2(float *mRealArr,float *mImageArr,int nLength,int mLength,int mLength2,float *mArr2){
 	float *mArr=NULL;
 
+	MCSquareChunkArg chunkArg;
+
 	if(mArr2){
 		mArr=mArr2;
 	}
@@ -560,27 +596,19 @@ void __mcsquare2(float *mRealArr,float *mImageArr,int nLength,int mLength,int mL
 		return;
 	}
 
-    #ifdef HAVE_OMP
-    if(nLength<__kernelNum){
-        omp_set_num_threads(nLength);
-    }else{
-        omp_set_num_threads(__kernelNum);
-    }
-    #endif
-
-    if(nLength==1){
-        for(int j=0;j<mLength2;j++){
-            mArr2[j]=mRealArr[j]*mRealArr[j]+mImageArr[j]*mImageArr[j];
-        }
-    }else{
-        #pragma omp parallel for
-        for(int i=0;i<nLength;i++){
-            for(int j=0;j<mLength2;j++){
-                mArr2[i*mLength2+j]=mRealArr[i*mLength+j]*mRealArr[i*mLength+j]+
-                                            mImageArr[i*mLength+j]*mImageArr[i*mLength+j];
-            }
-        }
-    }
+	chunkArg.mRealArr=mRealArr;
+	chunkArg.mImageArr=mImageArr;
+	chunkArg.mArr=mArr;
+
+	chunkArg.mLength=mLength;
+	chunkArg.mLength2=mLength2;
+
+	if(mArr2){ // rows independent
+		__parallel_for(nLength,0,0,__mcsquare2Chunk,&chunkArg);
+	}
+	else{ // in place, row order matter
+		__mcsquare2Chunk(&chunkArg,0,nLength,0);
+	}
 }
 
 // add/sub/mul/div
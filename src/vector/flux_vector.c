@@ -19,6 +19,9 @@ static float __arr_max(float *vArr,int length);
 static void __mREZ(float *mArr1,int nLength,int mLength,int axis,float *vArr3,float (*func)(float *,int ));
 static void __vunwrap1(float **vArr1,int length);
 
+static void __vmedianfilterWork(float *vArr1,int length,int order,float *workArr,float *vArr3);
+static float __vselect(float *vArr1,int length,int k);
+
 // 针对 type 0即符合乘法
 void __mdot(float *mArr1,float *mArr2,
 			int nLength1,int mLength1,
@@ -1074,9 +1077,12 @@ void __mnormalize(float *mArr1,int nLength,int mLength,int axis,int type,float p
 		nLen=mLength;
 		mLen=nLength;
 	}
-	else{
-		nLen=nLength;
-		mLen=mLength;
+	else{ // row by row, no buffer
+		for(int i=0;i<nLength;i++){
+			__vnormalize(mArr1+i*mLength,mLength,type,p,arr+i*mLength);
+		}
+
+		return;
 	}
 
 	vArr=__vnew(nLen, NULL);
@@ -2141,6 +2147,20 @@ float *__vnew(int length,float *value){
 	return arr;
 }
 
+float *__vcarve(void *workArr,size_t *offset,int length){
+	size_t addr=0;
+	float *arr=NULL;
+
+	addr=(size_t )workArr+*offset;
+	addr=(addr+63)&~(size_t )63;
+	if(workArr){
+		arr=(float *)addr;
+	}
+
+	*offset=addr-(size_t )workArr+sizeof(float )*length;
+	return arr;
+}
+
 // type 0 has stop 1 no stop
 float *__vlinspace(float start,float stop,int length,int type){
 	float *arr=NULL;
@@ -2941,12 +2961,14 @@ void __mdiff3(float *mArr1,float *mArr2,int nLength,int mLength,int axis,int *st
 }
 
 // type 0 max 1 median
-static void __mxfilter(float *mArr1,int nLength,int mLength,int type,int axis,int order,float *mArr3){
+// workArr 3*len+2*order(len nLength axis 0, mLength axis 1), NULL => internal
+static void __mxfilter(float *mArr1,int nLength,int mLength,int type,int axis,int order,float *workArr,float *mArr3){
 	int nLen=0;
 	int mLen=0;
 
 	float *vArr1=NULL;
 	float *vArr2=NULL;
+	float *arr=NULL;
 
 	if(!mArr3||order<1){
 		return;
@@ -2961,8 +2983,13 @@ static void __mxfilter(float *mArr1,int nLength,int mLength,int type,int axis,in
 		mLen=mLength;
 	}
 
-	vArr1=__vnew(mLen, NULL);
-	vArr2=__vnew(mLen, NULL);
+	arr=workArr;
+	if(!workArr){
+		arr=__vnew(3*mLen+2*order, NULL);
+	}
+
+	vArr1=arr;
+	vArr2=arr+mLen;
 
 	for(int i=0;i<nLen;i++){
 		if(axis==0){ // 1*m
@@ -2974,7 +3001,7 @@ static void __mxfilter(float *mArr1,int nLength,int mLength,int type,int axis,in
 				__vmaxfilter(vArr1,mLen,order,vArr2);
 			}
 			else{
-				__vmedianfilter(vArr1,mLen,order,vArr2);
+				__vmedianfilterWork(vArr1,mLen,order,arr+2*mLen,vArr2);
 			}
 
 			for(int j=0;j<mLen;j++){
@@ -2986,7 +3013,7 @@ static void __mxfilter(float *mArr1,int nLength,int mLength,int type,int axis,in
 				__vmaxfilter(mArr1+i*mLength,mLen,order,vArr2);
 			}
 			else{
-				__vmedianfilter(mArr1+i*mLength,mLen,order,vArr2);
+				__vmedianfilterWork(mArr1+i*mLength,mLen,order,arr+2*mLen,vArr2);
 			}
 
 			for(int j=0;j<mLen;j++){
@@ -2995,19 +3022,24 @@ static void __mxfilter(float *mArr1,int nLength,int mLength,int type,int axis,in
 		}
 	}
 
-	free(vArr1);
-	free(vArr2);
+	if(!workArr){
+		free(arr);
+	}
 }
 
 void __mmaxfilter(float *mArr1,int nLength,int mLength,int axis,int order,float *mArr3){
-	
-	__mxfilter(mArr1,nLength,mLength,0,axis,order,mArr3);
+
+	__mxfilter(mArr1,nLength,mLength,0,axis,order,NULL,mArr3);
 }
 
 void __mmedianfilter(float *mArr1,int nLength,int mLength,int axis,int order,float *mArr3){
-	
+
+	__mmedianfilter1(mArr1,nLength,mLength,axis,order,NULL,mArr3);
+}
+
+void __mmedianfilter1(float *mArr1,int nLength,int mLength,int axis,int order,float *workArr,float *mArr3){
 	if(order>1&&(order&1)){
-		__mxfilter(mArr1,nLength,mLength,1,axis,order,mArr3);
+		__mxfilter(mArr1,nLength,mLength,1,axis,order,workArr,mArr3);
 	}
 }
 
@@ -3081,26 +3113,88 @@ void __vmaxfilter(float *vArr1,int length,int order,float *vArr3){
 }
 
 void __vmedianfilter(float *vArr1,int length,int order,float *vArr3){
-	float *arr1=NULL;
-
-	int len=0;
+	float *workArr=NULL;
 
 	if((order&1)==0||order<2||!vArr3){
 		return;
 	}
 
+	workArr=__vnew(length+2*order, NULL);
+	__vmedianfilterWork(vArr1,length,order,workArr,vArr3);
+
+	free(workArr);
+}
+
+// odd order, zero padding; workArr length+2*order
+static void __vmedianfilterWork(float *vArr1,int length,int order,float *workArr,float *vArr3){
+	float *arr1=NULL;
+	float *winArr=NULL;
+
+	int len=0;
+
 	len=order/2;
-	arr1=__vnew(length+2*len, NULL);
+	arr1=workArr;
+	winArr=workArr+length+2*len;
+
+	memset(arr1, 0, sizeof(float )*len);
 	memcpy(arr1+len, vArr1, sizeof(float )*length);
+	memset(arr1+len+length, 0, sizeof(float )*len);
+
+	for(int j=0;j<length;j++){
+		memcpy(winArr, arr1+j, sizeof(float )*order);
+		vArr3[j]=__vselect(winArr,order,len);
+	}
+}
+
+// k-th smallest, vArr1 reordered(quickselect); same value as sort
+static float __vselect(float *vArr1,int length,int k){
+	int left=0;
+	int right=0;
+
+	left=0;
+	right=length-1;
+	while(left<right){
+		float pivot=0;
 
-	for(int i=len,j=0;i<length+len;i++,j++){
-		float value=0;
+		int i=0;
+		int j=0;
 
-		value=__vmedian(arr1+(i-len), order);
-		vArr3[j]=value;
+		pivot=vArr1[(left+right)/2];
+		i=left;
+		j=right;
+		while(i<=j){
+			while(vArr1[i]<pivot){
+				i++;
+			}
+
+			while(vArr1[j]>pivot){
+				j--;
+			}
+
+			if(i<=j){
+				float value=0;
+
+				value=vArr1[i];
+				vArr1[i]=vArr1[j];
+				vArr1[j]=value;
+
+				i++;
+				j--;
+			}
+		}
+
+		if(k<=j){
+			right=j;
+		}
+		else if(k>=i){
+			left=i;
+		}
+		else{
+			break;
+		}
 	}
 
-	free(arr1);
+	return vArr1[k];
 }
 
 static float __arr_max(float *vArr,int length){
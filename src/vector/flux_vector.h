@@ -66,6 +66,8 @@ void __mdiff2(float *mArr1,int nLength,int mLength,int axis,int *step,float *mAr
 
 void __mmaxfilter(float *mArr1,int nLength,int mLength,int axis,int order,float *mArr3);
 void __mmedianfilter(float *mArr1,int nLength,int mLength,int axis,int order,float *mArr3);
+// workArr 3*len+2*order(len nLength axis 0, mLength axis 1), NULL => internal
+void __mmedianfilter1(float *mArr1,int nLength,int mLength,int axis,int order,float *workArr,float *mArr3);
 
 /***
 	axis 0 row 1 col -1/other all
@@ -167,6 +169,13 @@ void __vmap1(float *vArr1,int length,void *callback1,float value,float *vArr2);
 float *__vnew(int length,float *value);
 int *__vnewi(int length,int *value);
 
+/***
+	caller workspace arena, length items at *offset 64 byte aligned, *offset moved past
+	workArr NULL => NULL, only count bytes; count+64 covers any workArr alignment
+****/
+float *__vcarve(void *workArr,size_t *offset,int length);
+int *__vcarvei(void *workArr,size_t *offset,int length);
+
 float *__vlinspace(float start,float stop,int length,int type);
 float *__vlogspace(float start,float stop,int length,int type);
 int __varange(float start,float stop,float step,float **outArr);
@@ -23,6 +23,20 @@ int *__vnewi(int length,int *value){
 	return arr;
 }
 
+int *__vcarvei(void *workArr,size_t *offset,int length){
+	size_t addr=0;
+	int *arr=NULL;
+
+	addr=(size_t )workArr+*offset;
+	addr=(addr+63)&~(size_t )63;
+	if(workArr){
+		arr=(int *)addr;
+	}
+
+	*offset=addr-(size_t )workArr+sizeof(int )*length;
+	return arr;
+}
+
 int __varangei(int start,int stop,int step,int **outArr){
 	int *arr=NULL;
 	int length=0;
@@ -5,6 +5,7 @@
 
 #include "flux_vector.h"
 #include "flux_vectorOp.h"
+#include "_math_kernel.h"
 
 // element math相关
 // abs/ng/floor/ceil/round
@@ -175,6 +176,12 @@ void __vatan(float *vArr1,int length,float *vArr2){
 	}
 }
 
+// atan2(vArr1,vArr2) y/x
+void __vatan2(float *vArr1,float *vArr2,int length,float *vArr3){
+
+	__mathKernel_atan2(vArr1,vArr2,length,vArr3);
+}
+
 // exp/exp2/pow/sqrt
 void __vexp(float *vArr1,int length,float *vArr2){
 	float *arr=NULL;
@@ -186,9 +193,7 @@ void __vexp(float *vArr1,int length,float *vArr2){
 		arr=vArr1;
 	}
 
-	for(int i=0;i<length;i++){
-		arr[i]=expf(vArr1[i]);
-	}
+	__mathKernel_exp(vArr1,length,arr);
 }
 
 void __vexp2(float *vArr1,int length,float *vArr2){
@@ -216,9 +221,7 @@ void __vpow(float *vArr1,float exp,int length,float *vArr2){
 		arr=vArr1;
 	}
 
-	for(int i=0;i<length;i++){
-		arr[i]=powf(vArr1[i],exp);
-	}
+	__mathKernel_pow(vArr1,exp,length,arr);
 }
 
 void __vsqrt(float *vArr1,int length,float *vArr2){
@@ -231,9 +234,7 @@ void __vsqrt(float *vArr1,int length,float *vArr2){
 		arr=vArr1;
 	}
 
-	for(int i=0;i<length;i++){
-		arr[i]=sqrtf(vArr1[i]);
-	}
+	__mathKernel_sqrt(vArr1,length,arr);
 }
 
 
@@ -248,9 +249,7 @@ void __vlog(float *vArr1,int length,float *vArr2){
 		arr=vArr1;
 	}
 
-	for(int i=0;i<length;i++){
-		arr[i]=logf(vArr1[i]);
-	}
+	__mathKernel_log(vArr1,length,arr);
 }
 
 void __vlog10(float *vArr1,int length,float *vArr2){
@@ -263,9 +262,7 @@ void __vlog10(float *vArr1,int length,float *vArr2){
 		arr=vArr1;
 	}
 
-	for(int i=0;i<length;i++){
-		arr[i]=log10f(vArr1[i]);
-	}
+	__mathKernel_log10(vArr1,length,arr);
 }
 
 void __vlog2(float *vArr1,int length,float *vArr2){
@@ -310,8 +307,9 @@ void __vlog_compress(float *vArr1,float *gamma,float *base,int length,float *vAr
 	}
 
 	for(int i=0;i<length;i++){
-		arr[i]=logf(vArr1[i]*_gamma+_base);
+		arr[i]=vArr1[i]*_gamma+_base;
 	}
+	__mathKernel_log(arr,length,NULL);
 }
 
 void __vlog10_compress(float *vArr1,float *gamma,float *base,int length,float *vArr2){
@@ -340,8 +338,9 @@ void __vlog10_compress(float *vArr1,float *gamma,float *base,int length,float *v
 	}
 
 	for(int i=0;i<length;i++){
-		arr[i]=log10f(vArr1[i]*_gamma+_base);
+		arr[i]=vArr1[i]*_gamma+_base;
 	}
+	__mathKernel_log10(arr,length,NULL);
 }
 
 void __vlog2_compress(float *vArr1,float *gamma,float *base,int length,float *vArr2){
@@ -25,8 +25,9 @@ void __vtan(float *vArr1,int length,float *vArr2);
 void __vacos(float *vArr1,int length,float *vArr2);
 void __vasin(float *vArr1,int length,float *vArr2);
 void __vatan(float *vArr1,int length,float *vArr2);
+void __vatan2(float *vArr1,float *vArr2,int length,float *vArr3);
 
-// exp/exp2/pow/sqrt
+// exp/exp2/pow/sqrt; exp/pow/sqrt/log/log10/atan2 simd kernel(_math_kernel.h)
 void __vexp(float *vArr1,int length,float *vArr2);
 void __vexp2(float *vArr1,int length,float *vArr2);
 void __vpow(float *vArr1,float exp,int length,float *vArr2);